@@ -0,0 +1,464 @@
+# Copyright (c) 2024 Contributors to the Eclipse Foundation
+#
+# This program and the accompanying materials are made available under the
+# terms of the Apache License, Version 2.0 which is available at
+# https://www.apache.org/licenses/LICENSE-2.0.
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+
+"""Generates C++ payload structs with JSON serializers from the payload schemas.
+
+Each schema file describes one MQTT payload:
+
+    {
+        "name": "SetPositionRequest",
+        "description": "Request to move a seat to a position.",
+        "topics": ["seatadjuster/setDriverPosition/request"],
+        "fields": [
+            {"name": "requestId", "type": "int32"},
+            {"name": "position", "type": "int32", "optional": true}
+        ]
+    }
+
+Field types are bool, int32, uint32, int64, uint64, double, string, signalValue
+(boolean, number or string) or the name of another payload. Arrays of the scalar
+types have a "[]" suffix per dimension, e.g. int64[][] (std::vector). Fields are
+required unless they are "optional" (std::optional) or have a "default".
+
+For every schema a header "<output>/<name>.h" is generated with the struct, an
+inline function to append it to a JSON string, a reader filling it from the
+events of a SAX parser, and functions to parse and serialize it as a whole.
+Parsing does not build a JSON document, the fields are read into the struct as
+they are parsed:
+
+    python3 generate_payloads.py --output build/gens/payloads app/schemas/*.json
+"""
+
+import argparse
+import json
+import os
+import sys
+
+SCALAR_TYPES = {
+    "bool": "bool",
+    "int32": "int32_t",
+    "uint32": "uint32_t",
+    "int64": "int64_t",
+    "uint64": "uint64_t",
+    "double": "double",
+    "string": "std::string",
+    "signalValue": "SignalValue",
+}
+
+# Rough upper bound of the serialized size of a value, to reserve the output once
+SCALAR_SIZES = {
+    "bool": 5,
+    "int32": 11,
+    "uint32": 10,
+    "int64": 20,
+    "uint64": 20,
+    "double": 24,
+    "string": 32,
+    "signalValue": 32,
+}
+
+
+class SchemaError(Exception):
+    pass
+
+
+def load_schemas(paths):
+    schemas = {}
+    for path in paths:
+        with open(path, encoding="utf-8") as schema_file:
+            schema = json.load(schema_file)
+        name = schema.get("name")
+        if not name or not name.isidentifier():
+            raise SchemaError(f"{path}: missing or invalid name")
+        if os.path.splitext(os.path.basename(path))[0] != name:
+            raise SchemaError(f"{path}: file name does not match payload name {name}")
+        if not schema.get("fields"):
+            raise SchemaError(f"{path}: no fields")
+        schema["path"] = path
+        schemas[name] = schema
+
+    for schema in schemas.values():
+        names = set()
+        for field in schema["fields"]:
+            if not field.get("name", "").isidentifier() or field["name"] in names:
+                raise SchemaError(f"{schema['path']}: missing, invalid or duplicate field name")
+            names.add(field["name"])
+            element_type, dimensions = split_array_type(field.get("type", ""))
+            if element_type not in SCALAR_TYPES and (dimensions or element_type not in schemas):
+                raise SchemaError(
+                    f"{schema['path']}: unknown type {field.get('type')} of {field['name']}"
+                )
+            if "default" in field and (field.get("optional") or field["type"] not in SCALAR_TYPES):
+                raise SchemaError(
+                    f"{schema['path']}: {field['name']} cannot have a default value"
+                )
+    return schemas
+
+
+def split_array_type(type_name):
+    """Return the element type and the number of array dimensions of a field type."""
+    dimensions = 0
+    while type_name.endswith("[]"):
+        type_name = type_name[: -len("[]")]
+        dimensions += 1
+    return type_name, dimensions
+
+
+def is_payload(field):
+    return field["type"] not in SCALAR_TYPES and not split_array_type(field["type"])[1]
+
+
+def cpp_type(field):
+    element_type, dimensions = split_array_type(field["type"])
+    value_type = SCALAR_TYPES.get(element_type, element_type)
+    for _ in range(dimensions):
+        value_type = f"std::vector<{value_type}>"
+    return f"std::optional<{value_type}>" if field.get("optional") else value_type
+
+
+def cpp_literal(text):
+    return json.dumps(text)
+
+
+def is_required(field):
+    return not field.get("optional") and "default" not in field
+
+
+def presence_flag(field):
+    return "has" + field["name"][0].upper() + field["name"][1:]
+
+
+def member_declaration(field):
+    initializer = "{}"
+    if field.get("optional"):
+        initializer = ""
+    elif "default" in field:
+        initializer = "{" + json.dumps(field["default"]) + "}"
+    return cpp_type(field), f"{field['name']}{initializer};"
+
+
+def generate_struct(schema):
+    lines = ["/**", f" * @brief {schema.get('description', schema['name'])}"]
+    if schema.get("topics"):
+        lines.append(f" * @details Topics: {', '.join(schema['topics'])}")
+    lines += [" */", f"struct {schema['name']} {{"]
+
+    declarations = [member_declaration(field) for field in schema["fields"]]
+    width = max(len(type_name) for type_name, _ in declarations)
+    for type_name, member in declarations:
+        lines.append(f"    {type_name.ljust(width)} {member}")
+    lines.append("};")
+    return lines
+
+
+def generate_append(schema):
+    # Required fields come first, so the separators of all fields are known at compile time
+    fields = sorted(schema["fields"], key=lambda field: 1 if field.get("optional") else 0)
+    has_fixed_start = not fields[0].get("optional")
+
+    lines = [
+        f"inline void appendJson(std::string& out, const {schema['name']}& payload) {{",
+    ]
+    if not has_fixed_start:
+        lines.append("    char separator = '{';")
+    for index, field in enumerate(fields):
+        name = field["name"]
+        if field.get("optional"):
+            lines.append(f"    if (payload.{name}) {{")
+            if has_fixed_start:
+                lines.append(f"        out += {cpp_literal(',' + json.dumps(name) + ':')};")
+            else:
+                lines.append("        out += separator;")
+                lines.append(f"        out += {cpp_literal(json.dumps(name) + ':')};")
+                lines.append("        separator = ',';")
+            lines.append(f"        appendJson(out, *payload.{name});")
+            lines.append("    }")
+        else:
+            prefix = "{" if index == 0 else ","
+            lines.append(f"    out += {cpp_literal(prefix + json.dumps(name) + ':')};")
+            lines.append(f"    appendJson(out, payload.{name});")
+    if not has_fixed_start:
+        lines.append("    if (separator == '{') {")
+        lines.append("        out += '{';")
+        lines.append("    }")
+    lines.append("    out += '}';")
+    lines.append("}")
+    return lines
+
+
+def generate_reader(schema):
+    name = schema["name"]
+    fields = schema["fields"]
+    required = [field for field in fields if is_required(field)]
+    nested = [field for field in fields if is_payload(field)]
+
+    lines = [
+        "/**",
+        f" * @brief Reads a {name} from the events of the SaxParser.",
+        " */",
+        f"class {name}Reader final : public ObjectReader {{",
+        "public:",
+        f"    explicit {name}Reader({name}* payload = nullptr)",
+        "        : m_payload(payload) {}",
+        "",
+        f"    void bind({name}& payload) {{ m_payload = &payload; }}",
+        "",
+        "    void begin() override {",
+        "        m_field = Field::None;",
+    ]
+    lines += [f"        m_{presence_flag(field)} = false;" for field in required]
+    lines += ["    }", ""]
+    lines += generate_select_field(fields)
+    lines.append("")
+    lines += generate_read_value(fields)
+    lines.append("")
+    lines += generate_read_object(nested)
+    lines.append("")
+    lines.append("    std::optional<std::string> end() override {")
+    for field in required:
+        lines += [
+            f"        if (!m_{presence_flag(field)}) {{",
+            f"            return std::string({cpp_literal('Missing field ' + field['name'])});",
+            "        }",
+        ]
+    lines += ["        return std::nullopt;", "    }", "", "private:"]
+    lines.append(
+        "    enum class Field { None, " + ", ".join(field["name"] for field in fields) + " };"
+    )
+    lines.append("")
+
+    members = [(f"{name}*", "m_payload;"), ("Field", "m_field{Field::None};")]
+    members += [("bool", f"m_{presence_flag(field)}{{false}};") for field in required]
+    members += [(f"{field['type']}Reader", f"m_{field['name']}Reader;") for field in nested]
+    width = max(len(type_name) for type_name, _ in members)
+    lines += [f"    {type_name.ljust(width)} {member}" for type_name, member in members]
+    lines.append("};")
+    return lines
+
+
+def generate_select_field(fields):
+    # Keys are dispatched on their length first, so at most a few keys are compared
+    by_length = {}
+    for field in fields:
+        by_length.setdefault(len(field["name"]), []).append(field)
+
+    lines = [
+        "    bool selectField(const std::string& key) override {",
+        "        m_field = Field::None;",
+        "        switch (key.size()) {",
+    ]
+    for length in sorted(by_length):
+        lines.append(f"        case {length}:")
+        for position, field in enumerate(by_length[length]):
+            keyword = "if" if position == 0 else "} else if"
+            lines.append(f"            {keyword} (key == {cpp_literal(field['name'])}) {{")
+            lines.append(f"                m_field = Field::{field['name']};")
+        lines.append("            }")
+        lines.append("            break;")
+    lines += [
+        "        default:",
+        "            break;",
+        "        }",
+        "        return m_field != Field::None;",
+        "    }",
+    ]
+    return lines
+
+
+def generate_read_value(fields):
+    uses_value = any(not is_payload(field) or field.get("optional") for field in fields)
+    parameter = "value" if uses_value else "/*value*/"
+    lines = [
+        f"    std::optional<std::string> readValue(const nlohmann::json& {parameter}) override {{",
+        "        switch (m_field) {",
+    ]
+    for field in fields:
+        lines.append(f"        case Field::{field['name']}:")
+        lines += [f"            {line}" for line in generate_read_field(field)]
+    lines += [
+        "        case Field::None:",
+        "            break;",
+        "        }",
+        "        return std::nullopt;",
+        "    }",
+    ]
+    return lines
+
+
+def generate_read_field(field):
+    name = field["name"]
+    target = f"m_payload->{name}"
+    if is_payload(field):
+        # Objects are read by the nested reader, only an absent optional payload gets here
+        error = cpp_literal(f"{name}: {field['type']} has to be an object")
+        if not field.get("optional"):
+            return [f"return std::string({error});"]
+        return [
+            "if (!value.is_null()) {",
+            f"    return std::string({error});",
+            "}",
+            f"{target}.reset();",
+            "break;",
+        ]
+
+    error = cpp_literal(f"Field {name} has to be of type {field['type']}")
+    if field.get("optional"):
+        # null is treated like an absent field
+        lines = [
+            "if (value.is_null()) {",
+            f"    {target}.reset();",
+            f"}} else if (!readJson(value, {target}.emplace())) {{",
+            f"    return std::string({error});",
+            "}",
+        ]
+    else:
+        lines = [
+            f"if (!readJson(value, {target})) {{",
+            f"    return std::string({error});",
+            "}",
+        ]
+    if is_required(field):
+        lines.append(f"m_{presence_flag(field)} = true;")
+    lines.append("break;")
+    return lines
+
+
+def generate_read_object(nested):
+    lines = ["    ObjectReader* readObject() override {"]
+    if not nested:
+        return lines + ["        return nullptr;", "    }"]
+
+    lines.append("        switch (m_field) {")
+    for field in nested:
+        target = f"m_payload->{field['name']}"
+        if field.get("optional"):
+            target += ".emplace()"
+        lines.append(f"        case Field::{field['name']}:")
+        if is_required(field):
+            lines.append(f"            m_{presence_flag(field)} = true;")
+        lines += [
+            f"            m_{field['name']}Reader.bind({target});",
+            f"            return &m_{field['name']}Reader;",
+        ]
+    lines += [
+        "        default:",
+        "            return nullptr;",
+        "        }",
+        "    }",
+    ]
+    return lines
+
+
+def estimate_size(schema, schemas):
+    size = 2
+    for field in schema["fields"]:
+        size += len(field["name"]) + 4
+        if field["type"] in SCALAR_SIZES:
+            size += SCALAR_SIZES[field["type"]]
+        elif not is_payload(field):
+            size += 2  # arrays are often empty, the string grows for the others
+        else:
+            size += estimate_size(schemas[field["type"]], schemas)
+    return size
+
+
+def generate_header(schema, schemas):
+    name = schema["name"]
+    guard = f"VEHICLE_APP_SDK_SEATADJUSTER_PAYLOADS_{name.upper()}_H"
+    nested = sorted({field["type"] for field in schema["fields"] if is_payload(field)})
+    has_arrays = any(split_array_type(field["type"])[1] for field in schema["fields"])
+
+    lines = [
+        f"// Generated by generate_payloads.py from {os.path.basename(schema['path'])}.",
+        "// Do not edit, change the schema instead.",
+        "",
+        f"#ifndef {guard}",
+        f"#define {guard}",
+        "",
+        '#include "PayloadJson.h"',
+    ]
+    lines += [f'#include "payloads/{nested_name}.h"' for nested_name in nested]
+    lines += [
+        "",
+        "#include <cstdint>",
+        "#include <optional>",
+        "#include <string>",
+    ]
+    if has_arrays:
+        lines.append("#include <vector>")
+    lines += [
+        "",
+        "namespace example::payloads {",
+        "",
+    ]
+    lines += generate_struct(schema)
+    lines.append("")
+    lines += generate_append(schema)
+    lines.append("")
+    lines += generate_reader(schema)
+    lines += [
+        "",
+        f"inline std::string serialize(const {name}& payload) {{",
+        "    std::string out;",
+        f"    out.reserve({estimate_size(schema, schemas)});",
+        "    appendJson(out, payload);",
+        "    return out;",
+        "}",
+        "",
+        f"inline std::optional<std::string> parse(const std::string& data, {name}& payload) {{",
+        f"    {name}Reader reader(&payload);",
+        f"    SaxParser parser(reader, {cpp_literal(name + ' has to be an object')});",
+        "    nlohmann::json::sax_parse(data, &parser);",
+        "    return parser.getError();",
+        "}",
+        "",
+        "} // namespace example::payloads",
+        "",
+        f"#endif // {guard}",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def write_if_changed(path, content):
+    # Unchanged headers keep their timestamp, so dependent sources are not rebuilt
+    if os.path.exists(path):
+        with open(path, encoding="utf-8") as existing:
+            if existing.read() == content:
+                return
+    with open(path, "w", encoding="utf-8") as header:
+        header.write(content)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--output", required=True, help="directory of the generated headers")
+    parser.add_argument("schemas", nargs="+", help="payload schema files")
+    args = parser.parse_args()
+
+    try:
+        schemas = load_schemas(args.schemas)
+    except (OSError, ValueError, SchemaError) as error:
+        print(f"generate_payloads.py: {error}", file=sys.stderr)
+        return 1
+
+    os.makedirs(args.output, exist_ok=True)
+    for name, schema in schemas.items():
+        write_if_changed(os.path.join(args.output, f"{name}.h"), generate_header(schema, schemas))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
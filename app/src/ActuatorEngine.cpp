@@ -0,0 +1,262 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "ActuatorEngine.h"
+#include "Json.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fmt/core.h>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <variant>
+
+namespace example {
+
+namespace {
+
+constexpr auto ACTUATOR_TOPIC_PREFIX = "seatadjuster/actuators/";
+
+struct TypeInfo {
+    ActuatorEngine::ValueType type;
+    double                    min;
+    double                    max;
+};
+
+template <typename T> TypeInfo makeIntegerType() {
+    return {ActuatorEngine::ValueType::Integer, static_cast<double>(std::numeric_limits<T>::min()),
+            static_cast<double>(std::numeric_limits<T>::max())};
+}
+
+TypeInfo getTypeInfo(const std::string& typeName) {
+    // Type names as used for the VSS datatypes
+    static const std::unordered_map<std::string, TypeInfo> TYPES{
+        {"boolean", {ActuatorEngine::ValueType::Boolean, 0, 0}},
+        {"string", {ActuatorEngine::ValueType::String, 0, 0}},
+        {"float",
+         {ActuatorEngine::ValueType::Float, std::numeric_limits<float>::lowest(),
+          std::numeric_limits<float>::max()}},
+        {"double",
+         {ActuatorEngine::ValueType::Float, std::numeric_limits<double>::lowest(),
+          std::numeric_limits<double>::max()}},
+        {"int8", makeIntegerType<int8_t>()},
+        {"uint8", makeIntegerType<uint8_t>()},
+        {"int16", makeIntegerType<int16_t>()},
+        {"uint16", makeIntegerType<uint16_t>()},
+        {"int32", makeIntegerType<int32_t>()},
+        {"uint32", makeIntegerType<uint32_t>()}};
+
+    const auto typeIterator = TYPES.find(typeName);
+    if (typeIterator == TYPES.end()) {
+        throw std::invalid_argument(fmt::format("Unsupported type \"{}\"", typeName));
+    }
+    return typeIterator->second;
+}
+
+} // namespace
+
+ActuatorEngine::ActuatorEngine(const nlohmann::json& config) {
+    try {
+        for (const auto& actuatorConfig : config.at("actuators")) {
+            m_actuators.push_back(parseActuator(actuatorConfig));
+            m_actuatorsBySignal[m_actuators.back().signal].push_back(m_actuators.size() - 1);
+        }
+    } catch (const nlohmann::json::exception& exception) {
+        throw std::invalid_argument(
+            fmt::format("Invalid actuator configuration: {}", exception.what()));
+    }
+    if (m_actuators.size() > MAX_ACTUATORS) {
+        throw std::invalid_argument(
+            fmt::format("Invalid actuator configuration: more than {} actuators", MAX_ACTUATORS));
+    }
+    m_writeStates.resize(m_actuators.size());
+}
+
+std::unique_ptr<ActuatorEngine> ActuatorEngine::fromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::invalid_argument(
+            fmt::format("Unable to open actuator configuration \"{}\"", path));
+    }
+    try {
+        return std::make_unique<ActuatorEngine>(nlohmann::json::parse(file));
+    } catch (const nlohmann::json::parse_error& exception) {
+        throw std::invalid_argument(
+            fmt::format("Invalid actuator configuration \"{}\": {}", path, exception.what()));
+    }
+}
+
+ActuatorEngine::Actuator ActuatorEngine::parseActuator(const nlohmann::json& actuatorConfig) {
+    Actuator actuator;
+    actuator.name   = actuatorConfig.at("name").get<std::string>();
+    actuator.signal = actuatorConfig.at("signal").get<std::string>();
+
+    try {
+        const auto typeInfo = getTypeInfo(actuatorConfig.at("type").get<std::string>());
+        actuator.type       = typeInfo.type;
+        actuator.min        = actuatorConfig.value("min", typeInfo.min);
+        actuator.max        = actuatorConfig.value("max", typeInfo.max);
+        if (actuator.min < typeInfo.min || actuator.max > typeInfo.max ||
+            actuator.min > actuator.max) {
+            throw std::invalid_argument(
+                fmt::format("Range [{}, {}] not supported by type", actuator.min, actuator.max));
+        }
+
+        actuator.allowedValues = actuatorConfig.value("allowed", std::vector<std::string>());
+        if (!actuator.allowedValues.empty() && actuator.type != ValueType::String) {
+            throw std::invalid_argument("Allowed values are only supported for strings");
+        }
+
+        for (const auto& interlockConfig :
+             actuatorConfig.value("interlocks", nlohmann::json::array())) {
+            actuator.interlocks.push_back(SignalCondition::fromJson(interlockConfig));
+        }
+    } catch (const std::invalid_argument& exception) {
+        throw std::invalid_argument(
+            fmt::format("Actuator \"{}\": {}", actuator.name, exception.what()));
+    }
+
+    const auto topicPrefix = ACTUATOR_TOPIC_PREFIX + actuator.name;
+    actuator.requestTopic  = topicPrefix + "/request";
+    actuator.responseTopic = topicPrefix + "/response";
+    actuator.currentTopic  = topicPrefix + "/current";
+    return actuator;
+}
+
+std::set<std::string> ActuatorEngine::getReferencedSignals() const {
+    std::set<std::string> signals;
+    for (const auto& actuator : m_actuators) {
+        signals.insert(actuator.signal);
+        for (const auto& interlock : actuator.interlocks) {
+            signals.insert(interlock.signal);
+        }
+    }
+    return signals;
+}
+
+ActuatorEngine::Submission
+ActuatorEngine::submit(std::size_t actuatorIndex, int requestId, const SignalValue& value) {
+    const auto& actuator = m_actuators[actuatorIndex];
+    Submission  submission;
+
+    if (auto error = checkValue(actuator, value)) {
+        submission.error = std::move(error);
+        return submission;
+    }
+
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    if (auto error = checkInterlocks(actuator)) {
+        submission.error = std::move(error);
+        return submission;
+    }
+
+    auto& writeState = m_writeStates[actuatorIndex];
+    if (!writeState.isWriting) {
+        writeState.isWriting = true;
+        submission.write     = Write{requestId, value};
+        return submission;
+    }
+    if (writeState.pending) {
+        submission.superseded = std::move(writeState.pending);
+    }
+    writeState.pending = Write{requestId, value};
+    return submission;
+}
+
+std::optional<ActuatorEngine::Write> ActuatorEngine::completeWrite(std::size_t actuatorIndex) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    auto&                          writeState = m_writeStates[actuatorIndex];
+    auto                           next       = std::move(writeState.pending);
+    writeState.pending.reset();
+    writeState.isWriting = next.has_value();
+    return next;
+}
+
+std::vector<std::size_t> ActuatorEngine::onSignalChanged(const std::string& signal,
+                                                         const SignalValue& value) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    auto [cacheIterator, isNew] = m_signalCache.try_emplace(signal, value);
+    if (!isNew) {
+        if (cacheIterator->second == value) {
+            return {};
+        }
+        cacheIterator->second = value;
+    }
+
+    const auto actuatorsIterator = m_actuatorsBySignal.find(signal);
+    if (actuatorsIterator == m_actuatorsBySignal.end()) {
+        return {};
+    }
+    return actuatorsIterator->second;
+}
+
+std::optional<std::string> ActuatorEngine::checkValue(const Actuator&    actuator,
+                                                      const SignalValue& value) {
+    switch (actuator.type) {
+    case ValueType::Boolean:
+        if (!std::holds_alternative<bool>(value)) {
+            return fmt::format("Value of {} has to be a boolean", actuator.name);
+        }
+        return std::nullopt;
+    case ValueType::String: {
+        const auto* stringValue = std::get_if<std::string>(&value);
+        if (stringValue == nullptr) {
+            return fmt::format("Value of {} has to be a string", actuator.name);
+        }
+        if (!actuator.allowedValues.empty() &&
+            std::find(actuator.allowedValues.begin(), actuator.allowedValues.end(),
+                      *stringValue) == actuator.allowedValues.end()) {
+            return fmt::format("Value \"{}\" of {} is not allowed", *stringValue, actuator.name);
+        }
+        return std::nullopt;
+    }
+    case ValueType::Integer:
+    case ValueType::Float:
+        break;
+    }
+
+    const auto* number = std::get_if<double>(&value);
+    if (number == nullptr) {
+        return fmt::format("Value of {} has to be a number", actuator.name);
+    }
+    if (actuator.type == ValueType::Integer && std::trunc(*number) != *number) {
+        return fmt::format("Value {} of {} has to be an integer", *number, actuator.name);
+    }
+    if (!(*number >= actuator.min && *number <= actuator.max)) {
+        return fmt::format("Value {} of {} out of range [{}, {}]", *number, actuator.name,
+                           actuator.min, actuator.max);
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> ActuatorEngine::checkInterlocks(const Actuator& actuator) const {
+    for (const auto& interlock : actuator.interlocks) {
+        const auto cacheIterator = m_signalCache.find(interlock.signal);
+        if (cacheIterator == m_signalCache.end()) {
+            return fmt::format("Interlock blocks {}: value of {} is unknown", actuator.name,
+                               interlock.signal);
+        }
+        if (!interlock.isMetBy(cacheIterator->second)) {
+            return fmt::format("Interlock blocks {}: {} is {}", actuator.name, interlock.signal,
+                               toJson(cacheIterator->second).dump());
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace example
@@ -0,0 +1,165 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_ACTUATORENGINE_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_ACTUATORENGINE_H
+
+#include "ProfiledMutex.h"
+#include "SignalCondition.h"
+
+#include <cstddef>
+#include <memory>
+#include <nlohmann/json_fwd.hpp>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace example {
+
+/**
+ * @brief Generic request handling for allowlisted VSS actuators.
+ * @details Actuators are configured declaratively:
+ *
+ *      {"actuators": [{
+ *          "name": "wiperTargetPosition",
+ *          "signal": "Vehicle.Body.Windshield.Front.Wiping.System.TargetPosition",
+ *          "type": "float", "min": 0, "max": 180,
+ *          "interlocks": [{"signal": "Vehicle.Speed", "op": "==", "value": 0}]
+ *      }]}
+ *
+ *      Each actuator gets the topics "seatadjuster/actuators/<name>/request",
+ *      ".../response" and ".../current". Requested values are validated against
+ *      the type ("boolean", "string", "float", "double" or an integer type like
+ *      "uint8"), the optional "min"/"max" range and the optional list of
+ *      "allowed" values. All interlocks have to hold for the cached signal
+ *      values when a request is received, an unknown signal value blocks.
+ *
+ *      Only one write per actuator is in flight. Requests received meanwhile
+ *      are coalesced: only the latest one is written once the write completes,
+ *      the ones it replaced are superseded.
+ */
+class ActuatorEngine {
+public:
+    enum class ValueType { Boolean, Integer, Float, String };
+
+    // The audit log stores the index of an actuator in one byte
+    static constexpr std::size_t MAX_ACTUATORS = 256;
+
+    struct Actuator {
+        std::string                  name;
+        std::string                  signal;
+        ValueType                    type;
+        double                       min;
+        double                       max;
+        std::vector<std::string>     allowedValues;
+        std::vector<SignalCondition> interlocks;
+        std::string                  requestTopic;
+        std::string                  responseTopic;
+        std::string                  currentTopic;
+    };
+
+    /**
+     * @brief A value to write to an actuator, on behalf of a request.
+     */
+    struct Write {
+        int         requestId;
+        SignalValue value;
+    };
+
+    /**
+     * @brief Outcome of a submitted request.
+     */
+    struct Submission {
+        // Reason why the request was rejected, the other fields are unset then
+        std::optional<std::string> error;
+        // The caller has to perform this write, and all writes returned by completeWrite
+        std::optional<Write> write;
+        // A queued request which has been replaced by this one
+        std::optional<Write> superseded;
+    };
+
+    /**
+     * @brief Create the engine from an actuator configuration.
+     *
+     * @param config  The actuator configuration.
+     * @throws std::invalid_argument  If the configuration is malformed or has more than
+     *      MAX_ACTUATORS actuators.
+     */
+    explicit ActuatorEngine(const nlohmann::json& config);
+
+    /**
+     * @brief Create the engine from a JSON actuator configuration file.
+     *
+     * @throws std::invalid_argument  If the file cannot be read or is malformed.
+     */
+    static std::unique_ptr<ActuatorEngine> fromFile(const std::string& path);
+
+    const std::vector<Actuator>& getActuators() const { return m_actuators; }
+
+    /**
+     * @brief Return all actuator and interlock signals.
+     */
+    std::set<std::string> getReferencedSignals() const;
+
+    /**
+     * @brief Validate a requested value, check the interlocks and queue the write.
+     *
+     * @param actuatorIndex  Index of the actuator in getActuators().
+     * @param requestId      Id of the request, echoed in the responses.
+     * @param value          The requested value.
+     */
+    Submission submit(std::size_t actuatorIndex, int requestId, const SignalValue& value);
+
+    /**
+     * @brief Mark the write in flight as completed.
+     *
+     * @return The latest request queued meanwhile, which the caller has to write next.
+     */
+    std::optional<Write> completeWrite(std::size_t actuatorIndex);
+
+    /**
+     * @brief Update the cached value of a signal.
+     *
+     * @return Indices of the actuators whose current value changed.
+     */
+    std::vector<std::size_t> onSignalChanged(const std::string& signal, const SignalValue& value);
+
+private:
+    struct WriteState {
+        bool                 isWriting{false};
+        std::optional<Write> pending;
+    };
+
+    static Actuator parseActuator(const nlohmann::json& actuatorConfig);
+
+    static std::optional<std::string> checkValue(const Actuator&    actuator,
+                                                 const SignalValue& value);
+
+    std::optional<std::string> checkInterlocks(const Actuator& actuator) const;
+
+    std::vector<Actuator>                                     m_actuators;
+    std::unordered_map<std::string, std::vector<std::size_t>> m_actuatorsBySignal;
+    std::unordered_map<std::string, SignalValue>              m_signalCache;
+    std::vector<WriteState>                                   m_writeStates;
+    ProfiledMutex                                             m_mutex{"ActuatorEngine"};
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_ACTUATORENGINE_H
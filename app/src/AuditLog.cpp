@@ -0,0 +1,384 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "AuditLog.h"
+#include "ThreadStatistics.h"
+#include "sdk/Logger.h"
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <optional>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace example {
+
+namespace {
+
+constexpr char     AUDIT_LOG_MAGIC[8]  = {'S', 'A', 'A', 'U', 'D', 'I', 'T', '\0'};
+constexpr uint32_t AUDIT_LOG_VERSION   = 1;
+constexpr auto     AUDIT_HEADER_SIZE   = sizeof(AuditLogHeader);
+constexpr auto     AUDIT_RECORD_SIZE   = sizeof(AuditRecord);
+constexpr auto     AUDIT_CHECKED_BYTES = offsetof(AuditRecord, checksum);
+
+// Writers block once this many batches are waiting to be flushed
+constexpr std::size_t MAX_BUFFERED_BATCHES = 4;
+
+constexpr std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < table.size(); ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1U) != 0 ? (crc >> 1U) ^ 0xEDB88320U : crc >> 1U;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr auto CRC_TABLE = makeCrcTable();
+
+std::string getRotatedPath(const std::string& path, std::size_t index) {
+    return index == 0 ? path : path + "." + std::to_string(index);
+}
+
+int64_t getUnixTimeNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+bool writeAll(int fd, const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        const auto written = ::write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+uint32_t computeAuditChecksum(const AuditRecord& record) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&record);
+    uint32_t    crc   = 0xFFFFFFFFU;
+    for (std::size_t i = 0; i < AUDIT_CHECKED_BYTES; ++i) {
+        crc = CRC_TABLE[(crc ^ bytes[i]) & 0xFFU] ^ (crc >> 8U);
+    }
+    return crc ^ 0xFFFFFFFFU;
+}
+
+namespace {
+
+std::optional<AuditRecord> readLastRecord(const std::string& path) {
+    const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    std::optional<AuditRecord> lastRecord;
+    struct stat                fileStat {};
+    if (::fstat(fd, &fileStat) == 0 &&
+        static_cast<std::size_t>(fileStat.st_size) >= AUDIT_HEADER_SIZE + AUDIT_RECORD_SIZE) {
+        const auto  recordCount =
+            (static_cast<std::size_t>(fileStat.st_size) - AUDIT_HEADER_SIZE) / AUDIT_RECORD_SIZE;
+        AuditRecord record{};
+        const auto  offset = AUDIT_HEADER_SIZE + (recordCount - 1) * AUDIT_RECORD_SIZE;
+        if (::pread(fd, &record, sizeof(record), static_cast<off_t>(offset)) ==
+                static_cast<ssize_t>(sizeof(record)) &&
+            record.checksum == computeAuditChecksum(record)) {
+            lastRecord = record;
+        }
+    }
+    ::close(fd);
+    return lastRecord;
+}
+
+} // namespace
+
+AuditLog::AuditLog(Config config)
+    : m_config(std::move(config)) {
+    m_buffer.reserve(m_config.flushRecords * MAX_BUFFERED_BATCHES);
+    m_flushing.reserve(m_config.flushRecords * MAX_BUFFERED_BATCHES);
+    openFile();
+
+    // Continue the sequence, the current file may have just been rotated
+    for (const std::size_t index : {0, 1}) {
+        if (const auto lastRecord = readLastRecord(getRotatedPath(m_config.path, index))) {
+            m_nextSequence    = lastRecord->sequence + 1;
+            m_durableSequence = lastRecord->sequence;
+            break;
+        }
+    }
+    m_thread = std::thread([this]() { run(); });
+}
+
+AuditLog::~AuditLog() {
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_flushNeeded.notify_one();
+    m_thread.join();
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+void AuditLog::openFile() {
+    const auto& path = m_config.path;
+    m_fd             = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0640);
+    if (m_fd < 0) {
+        throw std::system_error(errno, std::generic_category(), path);
+    }
+    const auto fail = [this, &path]() {
+        const auto error = errno;
+        ::close(m_fd);
+        m_fd = -1;
+        throw std::system_error(error, std::generic_category(), path);
+    };
+
+    struct stat fileStat {};
+    if (::fstat(m_fd, &fileStat) < 0) {
+        fail();
+    }
+    m_fileSize = static_cast<std::size_t>(fileStat.st_size);
+
+    if (m_fileSize < AUDIT_HEADER_SIZE) {
+        AuditLogHeader header{};
+        std::memcpy(header.magic, AUDIT_LOG_MAGIC, sizeof(header.magic));
+        header.version    = AUDIT_LOG_VERSION;
+        header.recordSize = AUDIT_RECORD_SIZE;
+        if (::ftruncate(m_fd, 0) < 0 || !writeAll(m_fd, &header, sizeof(header)) ||
+            ::fdatasync(m_fd) < 0) {
+            fail();
+        }
+        m_fileSize = AUDIT_HEADER_SIZE;
+        return;
+    }
+
+    // Cut off a record torn by a crash
+    const auto recordCount = (m_fileSize - AUDIT_HEADER_SIZE) / AUDIT_RECORD_SIZE;
+    if (AUDIT_HEADER_SIZE + recordCount * AUDIT_RECORD_SIZE != m_fileSize) {
+        m_fileSize = AUDIT_HEADER_SIZE + recordCount * AUDIT_RECORD_SIZE;
+        if (::ftruncate(m_fd, static_cast<off_t>(m_fileSize)) < 0) {
+            fail();
+        }
+    }
+}
+
+void AuditLog::append(CommandSource source, SeatId seat, int position, int status,
+                      uint32_t requestId) {
+    AuditRecord record{};
+    record.requestId = requestId;
+    record.position  = position;
+    record.source    = static_cast<uint8_t>(source);
+    record.seat      = static_cast<uint8_t>(seat);
+    record.status    = static_cast<uint8_t>(status);
+    record.kind      = static_cast<uint8_t>(AuditRecordKind::Seat);
+    appendRecord(record);
+}
+
+void AuditLog::appendActuator(CommandSource source, std::size_t actuatorIndex,
+                              AuditRecordKind kind, int32_t value, int status,
+                              uint32_t requestId) {
+    AuditRecord record{};
+    record.requestId = requestId;
+    record.position  = value;
+    record.source    = static_cast<uint8_t>(source);
+    record.seat      = static_cast<uint8_t>(actuatorIndex);
+    record.status    = static_cast<uint8_t>(status);
+    record.kind      = static_cast<uint8_t>(kind);
+    appendRecord(record);
+}
+
+void AuditLog::appendRecord(AuditRecord record) {
+    record.timestamp = getUnixTimeNs();
+
+    bool isFirstOrBatchFull;
+    {
+        std::unique_lock<ProfiledMutex> lock(m_mutex);
+        while (m_buffer.size() >= m_config.flushRecords * MAX_BUFFERED_BATCHES) {
+            if (m_failing) {
+                // Blocking would stall the seat control until the disk is back
+                ++m_nextSequence;
+                ++m_droppedRecords;
+                return;
+            }
+            m_bufferAvailable.wait(lock);
+        }
+        record.sequence = m_nextSequence++;
+        record.checksum = computeAuditChecksum(record);
+        if (m_buffer.empty()) {
+            m_oldestBuffered = std::chrono::steady_clock::now();
+        }
+        m_buffer.push_back(record);
+        isFirstOrBatchFull = m_buffer.size() == 1 || m_buffer.size() == m_config.flushRecords;
+    }
+    // The flusher only needs to know when to start its flush interval, and when a batch is full
+    if (isFirstOrBatchFull) {
+        m_flushNeeded.notify_one();
+    }
+}
+
+void AuditLog::run() {
+    setCurrentThreadName("sa-audit");
+
+    std::unique_lock<ProfiledMutex> lock(m_mutex);
+    for (;;) {
+        if (!m_flushing.empty()) {
+            // The batch which failed is written before any later record
+            if (!m_stopping && std::chrono::steady_clock::now() < m_retryAt) {
+                m_flushNeeded.wait_until(lock, m_retryAt);
+                continue;
+            }
+        } else if (m_buffer.empty()) {
+            if (m_stopping) {
+                return;
+            }
+            m_flushNeeded.wait(lock);
+            continue;
+        } else {
+            const auto flushDeadline = m_oldestBuffered + m_config.flushInterval;
+            if (!m_stopping && m_buffer.size() < m_config.flushRecords &&
+                std::chrono::steady_clock::now() < flushDeadline) {
+                m_flushNeeded.wait_until(lock, flushDeadline);
+                continue;
+            }
+            m_flushing.swap(m_buffer);
+            m_bufferAvailable.notify_all();
+        }
+
+        lock.unlock();
+        const auto isWritten = writeRecords(m_flushing);
+        lock.lock();
+
+        if (isWritten) {
+            m_flushing.clear();
+            if (m_failing) {
+                velocitas::logger().info("Audit log \"{}\" written again, {} records were dropped",
+                                         m_config.path, m_droppedRecords);
+                m_droppedRecords = 0;
+                m_failing        = false;
+            }
+            continue;
+        }
+
+        m_failing = true;
+        m_retryAt = std::chrono::steady_clock::now() + m_config.retryInterval;
+        m_bufferAvailable.notify_all();
+        if (m_stopping) {
+            velocitas::logger().error("Audit log \"{}\" closed, {} records were not written",
+                                      m_config.path, m_flushing.size() + m_buffer.size());
+            return;
+        }
+    }
+}
+
+bool AuditLog::writeRecords(const std::vector<AuditRecord>& records) {
+    // A failed rotation leaves no file open
+    if (m_fd < 0) {
+        try {
+            openFile();
+        } catch (const std::system_error& exception) {
+            velocitas::logger().error("Unable to open audit log: {}", exception.what());
+            return false;
+        }
+    }
+
+    const auto size = records.size() * AUDIT_RECORD_SIZE;
+    if (!writeAll(m_fd, records.data(), size) || ::fdatasync(m_fd) < 0) {
+        const auto error = errno;
+        velocitas::logger().error("Unable to write audit log \"{}\": {}", m_config.path,
+                                  std::strerror(error));
+        // Cut off the written part of the batch, it is written again as a whole. If that
+        // fails too, a torn record is cut off when the file is opened again.
+        if (::ftruncate(m_fd, static_cast<off_t>(m_fileSize)) < 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+        return false;
+    }
+    m_fileSize += size;
+    m_durableSequence = records.back().sequence;
+
+    if (m_fileSize >= m_config.maxFileBytes) {
+        rotate();
+    }
+    return true;
+}
+
+void AuditLog::rotate() {
+    ::close(m_fd);
+    for (auto index = m_config.maxFiles - 1; index > 0; --index) {
+        ::rename(getRotatedPath(m_config.path, index - 1).c_str(),
+                 getRotatedPath(m_config.path, index).c_str());
+    }
+    try {
+        openFile();
+    } catch (const std::system_error& exception) {
+        velocitas::logger().error("Unable to rotate audit log: {}", exception.what());
+    }
+}
+
+AuditLogReadResult readAuditLog(const std::string&                              path,
+                                const std::function<void(const AuditRecord&)>& onRecord) {
+    const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), path);
+    }
+
+    AuditLogReadResult result;
+    AuditLogHeader     header{};
+    result.validHeader = ::read(fd, &header, sizeof(header)) == sizeof(header) &&
+                         std::memcmp(header.magic, AUDIT_LOG_MAGIC, sizeof(header.magic)) == 0 &&
+                         header.version == AUDIT_LOG_VERSION &&
+                         header.recordSize == AUDIT_RECORD_SIZE;
+    if (result.validHeader) {
+        std::array<AuditRecord, 256> records{};
+        for (;;) {
+            const auto bytesRead = ::read(fd, records.data(), sizeof(records));
+            if (bytesRead <= 0) {
+                break;
+            }
+            for (std::size_t i = 0; i < static_cast<std::size_t>(bytesRead) / AUDIT_RECORD_SIZE;
+                 ++i) {
+                if (records[i].checksum != computeAuditChecksum(records[i])) {
+                    ++result.corruptRecords;
+                    continue;
+                }
+                ++result.records;
+                onRecord(records[i]);
+            }
+        }
+    }
+    ::close(fd);
+    return result;
+}
+
+} // namespace example
@@ -0,0 +1,189 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_AUDITLOG_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_AUDITLOG_H
+
+#include "ProfiledMutex.h"
+#include "Seat.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace example {
+
+/**
+ * @brief Kind of command stored in an audit record.
+ */
+enum class AuditRecordKind : uint8_t {
+    Seat           = 0,
+    ActuatorNumber = 1, // the value is a float, booleans are stored as 0 or 1
+    ActuatorText   = 2, // the value is the index in the allowed values, -1 if not listed
+};
+
+/**
+ * @brief One command as stored in the audit log, in host byte order.
+ */
+struct AuditRecord {
+    uint64_t sequence;  // continuous across flushes, rotations and restarts
+    int64_t  timestamp; // nanoseconds since the Unix epoch
+    uint32_t requestId; // 0 if the interface has none
+    int32_t  position;  // of an actuator: its value, encoded as given by the kind
+    uint8_t  source;    // CommandSource
+    uint8_t  seat;      // SeatId, of an actuator: its index in the configuration
+    uint8_t  status;    // STATUS_OK if the command was sent to the vehicle
+    uint8_t  kind;      // AuditRecordKind, was reserved (0) before actuators were audited
+    uint32_t checksum;  // CRC-32 of all preceding bytes
+};
+
+static_assert(sizeof(AuditRecord) == 32);
+
+/**
+ * @brief Header at the start of every audit log file.
+ */
+struct AuditLogHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+/**
+ * @brief Append-only, durable log of all seat and actuator commands.
+ * @details Writers only copy the record into an in-memory buffer. A single
+ *      flusher thread writes all buffered records with one write and one
+ *      fdatasync (group commit), once either the flush interval has passed since
+ *      the oldest buffered record or enough records are buffered. A record is
+ *      therefore durable at most one flush interval (plus the sync itself) after
+ *      it has been appended. If the disk cannot keep up, writers block once the
+ *      buffer holds a few batches.
+ *
+ *      If a batch cannot be written or synced, the part of it which made it into
+ *      the file is cut off again and the whole batch is retried in the retry
+ *      interval. Until it succeeds, isFailing() is true and writers no longer
+ *      block on a full buffer: their records are dropped, which shows as a gap
+ *      in the sequence numbers when the log is read.
+ *
+ *      The file is rotated once it exceeds the size limit: "<path>" becomes
+ *      "<path>.1", "<path>.1" becomes "<path>.2" and so on, the oldest file is
+ *      dropped. A record torn by a crash at the end of the file is cut off when
+ *      the log is opened again.
+ */
+class AuditLog {
+public:
+    struct Config {
+        std::string               path;
+        std::chrono::milliseconds flushInterval{100};
+        std::size_t               flushRecords{1024};
+        std::size_t               maxFileBytes{16 * 1024 * 1024};
+        std::size_t               maxFiles{8};
+        std::chrono::milliseconds retryInterval{1000};
+    };
+
+    /**
+     * @brief Open (or create) the log file and start the flusher thread.
+     *
+     * @throws std::system_error  If the file cannot be opened.
+     */
+    explicit AuditLog(Config config);
+
+    /**
+     * @brief Flush all buffered records and stop the flusher thread.
+     */
+    ~AuditLog();
+
+    AuditLog(const AuditLog&)            = delete;
+    AuditLog& operator=(const AuditLog&) = delete;
+
+    void append(CommandSource source, SeatId seat, int position, int status, uint32_t requestId);
+
+    /**
+     * @brief Append a command to an actuator.
+     *
+     * @param actuatorIndex  Index of the actuator in its configuration, below 256.
+     * @param kind           How the value is encoded, one of the actuator kinds.
+     */
+    void appendActuator(CommandSource source, std::size_t actuatorIndex, AuditRecordKind kind,
+                        int32_t value, int status, uint32_t requestId);
+
+    /**
+     * @brief Return the sequence number of the last record known to be on disk.
+     */
+    uint64_t getDurableSequence() const { return m_durableSequence.load(); }
+
+    /**
+     * @brief Return whether the last batch could not be written, i.e. records appended
+     *      now may not become durable.
+     */
+    bool isFailing() const { return m_failing.load(); }
+
+private:
+    void appendRecord(AuditRecord record);
+    void openFile();
+    void run();
+    bool writeRecords(const std::vector<AuditRecord>& records);
+    void rotate();
+
+    const Config                          m_config;
+    ProfiledMutex                         m_mutex{"AuditLog"};
+    ProfiledConditionVariable             m_flushNeeded;
+    ProfiledConditionVariable             m_bufferAvailable;
+    std::vector<AuditRecord>              m_buffer;
+    std::vector<AuditRecord>              m_flushing; // only accessed by the flusher thread
+    std::chrono::steady_clock::time_point m_oldestBuffered;
+    std::chrono::steady_clock::time_point m_retryAt;
+    uint64_t                              m_nextSequence{1};
+    std::size_t                           m_droppedRecords{0};
+    bool                                  m_stopping{false};
+    std::atomic<bool>                     m_failing{false};
+    std::atomic<uint64_t>                 m_durableSequence{0};
+    int                                   m_fd{-1}; // owned by the flusher thread once started
+    std::size_t                           m_fileSize{0};
+    std::thread                           m_thread;
+};
+
+/**
+ * @brief Compute the checksum of an audit record.
+ */
+uint32_t computeAuditChecksum(const AuditRecord& record);
+
+/**
+ * @brief Result of reading an audit log file.
+ */
+struct AuditLogReadResult {
+    std::size_t records{0};
+    std::size_t corruptRecords{0};
+    bool        validHeader{false};
+};
+
+/**
+ * @brief Read all records of an audit log file in order.
+ *      Records with a wrong checksum are counted, but not passed to the callback.
+ *
+ * @throws std::system_error  If the file cannot be read.
+ */
+AuditLogReadResult readAuditLog(const std::string&                              path,
+                                const std::function<void(const AuditRecord&)>& onRecord);
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_AUDITLOG_H
@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "AutomationEngine.h"
+#include "Json.h"
+
+#include <fmt/core.h>
+#include <fstream>
+#include <stdexcept>
+
+namespace example {
+
+namespace {
+
+SeatId toSeatId(const std::string& seatName) {
+    if (seatName == toString(SeatId::Driver)) {
+        return SeatId::Driver;
+    }
+    if (seatName == toString(SeatId::CoDriver)) {
+        return SeatId::CoDriver;
+    }
+    throw std::invalid_argument(fmt::format("Unknown seat \"{}\"", seatName));
+}
+
+} // namespace
+
+AutomationEngine::AutomationEngine(const nlohmann::json& config) {
+    try {
+        for (const auto& ruleConfig : config.at("rules")) {
+            m_rules.push_back(parseRule(ruleConfig));
+            m_rulesByTrigger[m_rules.back().triggerSignal].push_back(m_rules.size() - 1);
+        }
+    } catch (const nlohmann::json::exception& exception) {
+        throw std::invalid_argument(
+            fmt::format("Invalid automation configuration: {}", exception.what()));
+    }
+}
+
+std::unique_ptr<AutomationEngine> AutomationEngine::fromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::invalid_argument(
+            fmt::format("Unable to open automation configuration \"{}\"", path));
+    }
+    try {
+        return std::make_unique<AutomationEngine>(nlohmann::json::parse(file));
+    } catch (const nlohmann::json::parse_error& exception) {
+        throw std::invalid_argument(
+            fmt::format("Invalid automation configuration \"{}\": {}", path, exception.what()));
+    }
+}
+
+AutomationEngine::Rule AutomationEngine::parseRule(const nlohmann::json& ruleConfig) {
+    Rule rule;
+    rule.name = ruleConfig.at("name").get<std::string>();
+
+    const auto& trigger = ruleConfig.at("trigger");
+    rule.triggerSignal  = trigger.at("signal").get<std::string>();
+    if (trigger.contains("equals")) {
+        rule.triggerValue = parseSignalValue(trigger.at("equals"));
+    }
+
+    for (const auto& conditionConfig : ruleConfig.value("conditions", nlohmann::json::array())) {
+        try {
+            rule.conditions.push_back(SignalCondition::fromJson(conditionConfig));
+        } catch (const std::invalid_argument& exception) {
+            throw std::invalid_argument(
+                fmt::format("Rule \"{}\": {}", rule.name, exception.what()));
+        }
+    }
+
+    const auto& action   = ruleConfig.at("action");
+    rule.action.ruleName = rule.name;
+    rule.action.seat     = toSeatId(action.at("seat").get<std::string>());
+    rule.action.position = action.at("position").get<int>();
+    if (rule.action.position < SEAT_POSITION_MIN || rule.action.position > SEAT_POSITION_MAX) {
+        throw std::invalid_argument(fmt::format("Rule \"{}\": position {} out of range [{}, {}]",
+                                                rule.name, rule.action.position,
+                                                SEAT_POSITION_MIN, SEAT_POSITION_MAX));
+    }
+    return rule;
+}
+
+std::set<std::string> AutomationEngine::getReferencedSignals() const {
+    std::set<std::string> signals;
+    for (const auto& rule : m_rules) {
+        signals.insert(rule.triggerSignal);
+        for (const auto& condition : rule.conditions) {
+            signals.insert(condition.signal);
+        }
+    }
+    return signals;
+}
+
+std::vector<AutomationAction> AutomationEngine::onSignalChanged(const std::string& signal,
+                                                                const SignalValue& value) {
+    std::vector<AutomationAction> actions;
+
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    auto cacheIterator = m_signalCache.find(signal);
+    if (cacheIterator == m_signalCache.end()) {
+        m_signalCache.emplace(signal, value);
+        return actions;
+    }
+    if (cacheIterator->second == value) {
+        return actions;
+    }
+    cacheIterator->second = value;
+
+    const auto rulesIterator = m_rulesByTrigger.find(signal);
+    if (rulesIterator == m_rulesByTrigger.end()) {
+        return actions;
+    }
+    for (const auto ruleIndex : rulesIterator->second) {
+        const auto& rule = m_rules[ruleIndex];
+        if (rule.triggerValue && value != *rule.triggerValue) {
+            continue;
+        }
+        if (areConditionsMet(rule)) {
+            actions.push_back(rule.action);
+        }
+    }
+    return actions;
+}
+
+bool AutomationEngine::areConditionsMet(const Rule& rule) const {
+    for (const auto& condition : rule.conditions) {
+        const auto cacheIterator = m_signalCache.find(condition.signal);
+        if (cacheIterator == m_signalCache.end() || !condition.isMetBy(cacheIterator->second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace example
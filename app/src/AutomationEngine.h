@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_AUTOMATIONENGINE_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_AUTOMATIONENGINE_H
+
+#include "ProfiledMutex.h"
+#include "Seat.h"
+#include "SignalCondition.h"
+
+#include <cstddef>
+#include <memory>
+#include <nlohmann/json_fwd.hpp>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace example {
+
+/**
+ * @brief Seat movement requested by an automation rule.
+ */
+struct AutomationAction {
+    std::string ruleName;
+    SeatId      seat;
+    int         position;
+};
+
+/**
+ * @brief Local, event-driven comfort automation.
+ * @details Rules are configured declaratively:
+ *
+ *      {"rules": [{
+ *          "name": "slideBackOnDriverDoorOpen",
+ *          "trigger": {"signal": "Vehicle.Cabin.Door.Row1.DriverSide.IsOpen", "equals": true},
+ *          "conditions": [{"signal": "Vehicle.Speed", "op": "==", "value": 0}],
+ *          "action": {"seat": "Driver", "position": 1000}
+ *      }]}
+ *
+ *      A rule fires when its trigger signal changes (to the "equals" value, if
+ *      given) and all conditions hold for the cached signal values. The first
+ *      value received for a signal only initializes the cache and never fires.
+ */
+class AutomationEngine {
+public:
+    /**
+     * @brief Create the engine from a rule configuration.
+     *
+     * @param config  The rule configuration.
+     * @throws std::invalid_argument  If the configuration is malformed.
+     */
+    explicit AutomationEngine(const nlohmann::json& config);
+
+    /**
+     * @brief Create the engine from a JSON rule configuration file.
+     *
+     * @throws std::invalid_argument  If the file cannot be read or is malformed.
+     */
+    static std::unique_ptr<AutomationEngine> fromFile(const std::string& path);
+
+    /**
+     * @brief Return all signals referenced as trigger or condition.
+     */
+    std::set<std::string> getReferencedSignals() const;
+
+    /**
+     * @brief Update the cached value of a signal and evaluate the rules triggered by it.
+     *
+     * @param signal  The VSS path of the signal.
+     * @param value   The new value of the signal.
+     * @return The actions of all rules which fired.
+     */
+    std::vector<AutomationAction> onSignalChanged(const std::string& signal,
+                                                  const SignalValue& value);
+
+    std::size_t getRuleCount() const { return m_rules.size(); }
+
+private:
+    struct Rule {
+        std::string                  name;
+        std::string                  triggerSignal;
+        std::optional<SignalValue>   triggerValue;
+        std::vector<SignalCondition> conditions;
+        AutomationAction             action;
+    };
+
+    static Rule parseRule(const nlohmann::json& ruleConfig);
+
+    bool areConditionsMet(const Rule& rule) const;
+
+    std::vector<Rule>                                         m_rules;
+    std::unordered_map<std::string, std::vector<std::size_t>> m_rulesByTrigger;
+    std::unordered_map<std::string, SignalValue>              m_signalCache;
+    ProfiledMutex                                             m_mutex{"AutomationEngine"};
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_AUTOMATIONENGINE_H
@@ -0,0 +1,217 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "FairRequestQueue.h"
+#include "ThreadStatistics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace example {
+
+static_assert((FairRequestQueue::TABLE_SIZE & (FairRequestQueue::TABLE_SIZE - 1)) == 0,
+              "The table size must be a power of two");
+
+FairRequestQueue::FairRequestQueue(Config config, TimerService& timerService, ManualDispatch)
+    : m_config(std::move(config))
+    , m_timerService(timerService) {
+    if (!(m_config.rate > 0.0) || !(m_config.burst >= 1.0) || !(m_config.newClientRate > 0.0) ||
+        !(m_config.newClientBurst >= 1.0)) {
+        throw std::invalid_argument("The client rates must be positive and the bursts at least 1");
+    }
+    if (m_config.anonymousRate > 0.0 && !(m_config.anonymousBurst >= 1.0)) {
+        throw std::invalid_argument("The anonymous burst must be at least 1");
+    }
+
+    const auto now = m_timerService.now();
+    for (const auto slot : {OVERFLOW_SLOT, ANONYMOUS_SLOT}) {
+        m_clients[slot].isUsed = true;
+        m_clients[slot].bucket = {slot == OVERFLOW_SLOT ? m_config.burst : m_config.anonymousBurst,
+                                  now};
+    }
+    m_newClients = {m_config.newClientBurst, now};
+}
+
+FairRequestQueue::FairRequestQueue(Config config, TimerService& timerService)
+    : FairRequestQueue(std::move(config), timerService, ManualDispatch{}) {
+    m_thread = std::thread([this]() { run(); });
+}
+
+FairRequestQueue::~FairRequestQueue() {
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_requestQueued.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+FairRequestQueue::Admission FairRequestQueue::submit(std::string_view clientId,
+                                                     std::size_t cost, Task task) {
+    const auto now = m_timerService.now();
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        const auto slot   = clientId.empty() ? ANONYMOUS_SLOT : findSlot(clientId, now);
+        auto&      client = m_clients[slot];
+        if (slot == ANONYMOUS_SLOT) {
+            if (client.queue.size() >= m_config.maxQueuedAnonymous) {
+                return Admission::QueueFull;
+            }
+            if (m_config.anonymousRate > 0.0 &&
+                !client.bucket.take(now, m_config.anonymousRate, m_config.anonymousBurst)) {
+                return Admission::RateLimited;
+            }
+        } else {
+            if (client.queue.size() >= m_config.maxQueuedPerClient) {
+                return Admission::QueueFull;
+            }
+            if (!client.bucket.take(now, m_config.rate, m_config.burst)) {
+                return Admission::RateLimited;
+            }
+        }
+        client.queue.push_back({std::clamp<std::size_t>(cost, 1, QUANTUM), std::move(task)});
+        if (!client.isActive) {
+            client.isActive = true;
+            m_activeClients.push_back(slot);
+        }
+    }
+    m_requestQueued.notify_one();
+    return Admission::Queued;
+}
+
+std::size_t FairRequestQueue::findSlot(std::string_view clientId, Clock::time_point now) {
+    const auto  hash     = std::hash<std::string_view>{}(clientId);
+    std::size_t reusable = OVERFLOW_SLOT;
+    for (std::size_t probe = 0; probe < MAX_PROBES; ++probe) {
+        const auto slot   = (hash + probe) & (TABLE_SIZE - 1);
+        auto&      client = m_clients[slot];
+        if (client.isUsed && client.id == clientId) {
+            return slot;
+        }
+        // Slots are never freed, so the client can't be stored behind a free slot
+        if (!client.isUsed) {
+            reusable = slot;
+            break;
+        }
+        const auto isIdleLonger = reusable == OVERFLOW_SLOT ||
+                                  client.bucket.lastRefill < m_clients[reusable].bucket.lastRefill;
+        if (isIdle(client, now) && isIdleLonger) {
+            reusable = slot;
+        }
+    }
+    // A client changing its id for every request ends up in the overflow slot
+    if (reusable == OVERFLOW_SLOT ||
+        !m_newClients.take(now, m_config.newClientRate, m_config.newClientBurst)) {
+        return OVERFLOW_SLOT;
+    }
+
+    // Enough for the request creating the client, the rest is earned at the rate
+    auto& client  = m_clients[reusable];
+    client.id     = clientId;
+    client.isUsed = true;
+    client.bucket = {1.0, now};
+    return reusable;
+}
+
+void FairRequestQueue::TokenBucket::refill(Clock::time_point now, double rate, double capacity) {
+    const std::chrono::duration<double> elapsed = now - lastRefill;
+    tokens     = std::min(capacity, tokens + elapsed.count() * rate);
+    lastRefill = now;
+}
+
+bool FairRequestQueue::TokenBucket::take(Clock::time_point now, double rate, double capacity) {
+    refill(now, rate, capacity);
+    if (tokens < 1.0) {
+        return false;
+    }
+    tokens -= 1.0;
+    return true;
+}
+
+bool FairRequestQueue::isIdle(const Client& client, Clock::time_point now) const {
+    // Nothing queued and a full bucket, so forgetting the client changes nothing
+    const std::chrono::duration<double> elapsed = now - client.bucket.lastRefill;
+    return !client.isActive &&
+           client.bucket.tokens + elapsed.count() * m_config.rate >= m_config.burst;
+}
+
+std::optional<FairRequestQueue::Task> FairRequestQueue::popNext() {
+    // Requests cost at most one quantum, so this loops at most twice
+    while (!m_activeClients.empty()) {
+        const auto slot   = m_activeClients.front();
+        auto&      client = m_clients[slot];
+        if (!client.isInTurn) {
+            client.deficit += QUANTUM;
+            client.isInTurn = true;
+        }
+
+        auto& request = client.queue.front();
+        if (request.cost <= client.deficit) {
+            client.deficit -= request.cost;
+            auto task = std::move(request.task);
+            client.queue.pop_front();
+            if (client.queue.empty()) {
+                // An idle client doesn't save up its deficit
+                client.deficit  = 0;
+                client.isInTurn = false;
+                client.isActive = false;
+                m_activeClients.pop_front();
+            }
+            return task;
+        }
+
+        client.isInTurn = false;
+        m_activeClients.pop_front();
+        m_activeClients.push_back(slot);
+    }
+    return std::nullopt;
+}
+
+bool FairRequestQueue::runNext() {
+    std::optional<Task> task;
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        task = popNext();
+    }
+    if (!task) {
+        return false;
+    }
+    (*task)();
+    return true;
+}
+
+void FairRequestQueue::run() {
+    setCurrentThreadName("sa-requests");
+
+    std::unique_lock<ProfiledMutex> lock(m_mutex);
+    while (!m_stopping) {
+        auto task = popNext();
+        if (!task) {
+            m_requestQueued.wait(lock);
+            continue;
+        }
+        lock.unlock();
+        (*task)();
+        lock.lock();
+    }
+}
+
+} // namespace example
@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_FAIRREQUESTQUEUE_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_FAIRREQUESTQUEUE_H
+
+#include "ProfiledMutex.h"
+#include "TimerService.h"
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace example {
+
+/**
+ * @brief Per-client rate limiting and fair queuing of requests.
+ * @details Each client, told apart by an id like the clientId field of the
+ *      request payloads, has a token bucket refilled at a fixed rate. A request
+ *      finding the bucket empty is rejected right away, so a misbehaving client
+ *      only ever uses up its own share.
+ *
+ *      The client id is advisory: nothing stops a client from claiming another
+ *      one, so the limits protect against faulty clients, not hostile ones. To
+ *      keep a client from evading its limit by changing its id, a new client
+ *      starts with a single token and earns the rest at the rate, and only
+ *      newClientRate clients per second get a slot of their own; the others
+ *      share the overflow slot. Requests without client id (e.g. of clients
+ *      predating the field) are queued as one anonymous client, which is only
+ *      rate limited if anonymousRate is set.
+ *
+ *      Admitted requests are queued per client and run one at a time on the
+ *      dispatcher thread, in deficit round-robin order: a client may spend a
+ *      quantum of request cost (e.g. payload bytes) per turn, so clients sending
+ *      large requests don't get more than their share either.
+ *
+ *      The clients are kept in a fixed-size open-addressed table. If all slots
+ *      a client id hashes to are taken, the slot of the longest idle client with
+ *      a full bucket is reused; if there is none, the client shares the overflow
+ *      slot with all other such clients. All operations take constant time.
+ *
+ *      A queue created with ManualDispatch starts no thread, queued requests are
+ *      run by calling runNext() instead.
+ */
+class FairRequestQueue {
+public:
+    using Task = std::function<void()>;
+
+    struct Config {
+        double      rate{20.0};  // requests per second and client
+        double      burst{40.0}; // bucket capacity, requests a client may send at once
+        std::size_t maxQueuedPerClient{64};
+        double      newClientRate{2.0}; // clients per second getting a slot of their own
+        double      newClientBurst{16.0};
+        double      anonymousRate{0.0}; // requests per second without client id, 0: unlimited
+        double      anonymousBurst{0.0};
+        std::size_t maxQueuedAnonymous{1024};
+    };
+
+    enum class Admission { Queued, RateLimited, QueueFull };
+
+    static constexpr std::size_t TABLE_SIZE = 256;
+    static constexpr std::size_t MAX_PROBES = 8;
+
+    // Request cost a client may spend per turn, larger requests are capped to it
+    static constexpr std::size_t QUANTUM = 1024;
+
+    /**
+     * @brief Tag selecting dispatching on the caller's thread, see runNext().
+     */
+    struct ManualDispatch {};
+
+    /**
+     * @throws std::invalid_argument  If a rate or burst is not positive.
+     */
+    FairRequestQueue(Config config, TimerService& timerService);
+    FairRequestQueue(Config config, TimerService& timerService, ManualDispatch);
+
+    /**
+     * @brief Stop the dispatcher thread, dropping all queued requests.
+     */
+    ~FairRequestQueue();
+
+    FairRequestQueue(const FairRequestQueue&)            = delete;
+    FairRequestQueue& operator=(const FairRequestQueue&) = delete;
+
+    /**
+     * @brief Queue a request of the given client, unless it exceeds the client's rate.
+     *
+     * @param clientId  Id the client claims to have, empty for anonymous clients.
+     * @param cost      Cost of the request for fair queuing, e.g. the payload size.
+     * @param task      Handler of the request, run on the dispatcher thread.
+     */
+    Admission submit(std::string_view clientId, std::size_t cost, Task task);
+
+    /**
+     * @brief Run the next queued request on the calling thread.
+     * @return false if no request was queued.
+     */
+    bool runNext();
+
+    const Config& getConfig() const { return m_config; }
+
+private:
+    using Clock = TimerService::Clock;
+
+    struct Request {
+        std::size_t cost;
+        Task        task;
+    };
+
+    struct TokenBucket {
+        double            tokens{0.0};
+        Clock::time_point lastRefill;
+
+        void refill(Clock::time_point now, double rate, double capacity);
+
+        /**
+         * @brief Refill the bucket and take a token, if there is one.
+         */
+        bool take(Clock::time_point now, double rate, double capacity);
+    };
+
+    struct Client {
+        std::string         id;
+        bool                isUsed{false};
+        TokenBucket         bucket;
+        std::deque<Request> queue;
+        std::size_t         deficit{0};
+        bool                isActive{false}; // in the round-robin list
+        bool                isInTurn{false}; // got the quantum of its current turn
+    };
+
+    static constexpr std::size_t OVERFLOW_SLOT  = TABLE_SIZE;
+    static constexpr std::size_t ANONYMOUS_SLOT = TABLE_SIZE + 1;
+
+    std::size_t         findSlot(std::string_view clientId, Clock::time_point now);
+    bool                isIdle(const Client& client, Clock::time_point now) const;
+    std::optional<Task> popNext();
+    void                run();
+
+    const Config                       m_config;
+    TimerService&                      m_timerService;
+    ProfiledMutex                      m_mutex{"FairRequestQueue"};
+    ProfiledConditionVariable          m_requestQueued;
+    std::array<Client, TABLE_SIZE + 2> m_clients; // followed by the overflow and anonymous slot
+    TokenBucket                        m_newClients;
+    std::deque<std::size_t>            m_activeClients;
+    bool                               m_stopping{false};
+    std::thread                        m_thread;
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_FAIRREQUESTQUEUE_H
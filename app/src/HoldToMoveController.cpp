@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "HoldToMoveController.h"
+
+#include <utility>
+#include <vector>
+
+namespace example {
+
+HoldToMoveController::HoldToMoveController(TimerService&             timerService,
+                                           std::chrono::milliseconds leaseDuration,
+                                           LeaseExpiredCallback      onLeaseExpired)
+    : m_timerService(timerService)
+    , m_leaseDuration(leaseDuration)
+    , m_onLeaseExpired(std::move(onLeaseExpired)) {}
+
+HoldToMoveController::~HoldToMoveController() {
+    // cancel() waits for a running onTimer(), which takes the lock and may re-arm the timer
+    while (true) {
+        std::vector<TimerService::TimerId> timerIds;
+        for (auto& session : m_sessions) {
+            std::lock_guard<ProfiledMutex> lock(session.mutex);
+            session.active = false;
+            if (session.timerId) {
+                timerIds.push_back(*session.timerId);
+                session.timerId.reset();
+            }
+        }
+        if (timerIds.empty()) {
+            break;
+        }
+        for (const auto timerId : timerIds) {
+            m_timerService.cancel(timerId);
+        }
+    }
+}
+
+void HoldToMoveController::start(SeatId seat, MoveDirection direction) {
+    auto&                          session = m_sessions[toIndex(seat)];
+    std::lock_guard<ProfiledMutex> lock(session.mutex);
+    if (!session.active) {
+        ++session.sessionId;
+    }
+    session.active        = true;
+    session.direction     = direction;
+    session.leaseDeadline = m_timerService.now() + m_leaseDuration;
+    if (!session.timerId) {
+        armTimer(seat, session);
+    }
+}
+
+bool HoldToMoveController::renew(SeatId seat) {
+    auto&                          session = m_sessions[toIndex(seat)];
+    std::lock_guard<ProfiledMutex> lock(session.mutex);
+    if (!session.active) {
+        return false;
+    }
+    session.leaseDeadline = m_timerService.now() + m_leaseDuration;
+    return true;
+}
+
+bool HoldToMoveController::stop(SeatId seat) {
+    std::optional<TimerService::TimerId> timerId;
+    {
+        auto&                          session = m_sessions[toIndex(seat)];
+        std::lock_guard<ProfiledMutex> lock(session.mutex);
+        if (!session.active) {
+            return false;
+        }
+        session.active = false;
+        timerId        = std::exchange(session.timerId, std::nullopt);
+    }
+    // Outside the lock, as cancel() waits for a running onTimer()
+    if (timerId) {
+        m_timerService.cancel(*timerId);
+    }
+    return true;
+}
+
+std::optional<MoveDirection> HoldToMoveController::getActiveDirection(SeatId seat) const {
+    const auto&                    session = m_sessions[toIndex(seat)];
+    std::lock_guard<ProfiledMutex> lock(session.mutex);
+    if (!session.active) {
+        return std::nullopt;
+    }
+    return session.direction;
+}
+
+bool HoldToMoveController::isCurrentSession(SeatId seat, SessionId sessionId) const {
+    const auto&                    session = m_sessions[toIndex(seat)];
+    std::lock_guard<ProfiledMutex> lock(session.mutex);
+    return session.sessionId == sessionId;
+}
+
+void HoldToMoveController::armTimer(SeatId seat, Session& session) {
+    const auto generation = ++session.timerGeneration;
+    session.timerId       = m_timerService.scheduleAt(
+        session.leaseDeadline, [this, seat, generation]() { onTimer(seat, generation); });
+}
+
+void HoldToMoveController::onTimer(SeatId seat, uint64_t generation) {
+    SessionId expiredSession;
+    {
+        auto&                          session = m_sessions[toIndex(seat)];
+        std::lock_guard<ProfiledMutex> lock(session.mutex);
+        // A timer stopped while this one waited for the lock may have been replaced already
+        if (generation != session.timerGeneration) {
+            return;
+        }
+        session.timerId.reset();
+        if (!session.active) {
+            return;
+        }
+        // The lease has been renewed meanwhile, wait for the new deadline
+        if (m_timerService.now() < session.leaseDeadline) {
+            armTimer(seat, session);
+            return;
+        }
+        session.active = false;
+        expiredSession = session.sessionId;
+    }
+    // Outside the lock, so the seat's requests and other timers are not held up by the stop
+    m_onLeaseExpired(seat, expiredSession);
+}
+
+} // namespace example
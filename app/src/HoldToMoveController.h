@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_HOLDTOMOVECONTROLLER_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_HOLDTOMOVECONTROLLER_H
+
+#include "ProfiledMutex.h"
+#include "Seat.h"
+#include "TimerService.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+namespace example {
+
+enum class MoveDirection { Forward, Backward };
+
+/**
+ * @brief Tracks "hold the button to move" sessions of the seats.
+ * @details A session is started with a direction and kept alive by renewing
+ *      its lease via heartbeats. Once the lease is not renewed in time, the
+ *      session expires and the expiry callback is invoked on the timer thread
+ *      so the seat can be stopped at its current position. The callback runs
+ *      without any lock held, but must not block the timer thread: it should
+ *      hand the stop over to another thread.
+ *
+ *      Heartbeats only move the lease deadline; the lease timer re-arms itself
+ *      lazily when it fires before the (extended) deadline.
+ *
+ *      Every started session gets a new id, which is passed to the expiry
+ *      callback. Before stopping the seat, the handler checks with
+ *      isCurrentSession() that no session has been started meanwhile, so a new
+ *      session is not stopped by the expiry of the previous one.
+ */
+class HoldToMoveController {
+public:
+    using SessionId            = uint64_t;
+    using LeaseExpiredCallback = std::function<void(SeatId, SessionId)>;
+
+    HoldToMoveController(TimerService& timerService, std::chrono::milliseconds leaseDuration,
+                         LeaseExpiredCallback onLeaseExpired);
+    ~HoldToMoveController();
+
+    /**
+     * @brief Start a move session or change the direction of a running one.
+     *      The lease is (re-)started in both cases.
+     */
+    void start(SeatId seat, MoveDirection direction);
+
+    /**
+     * @brief Renew the lease of a running session.
+     *
+     * @return true   The lease was renewed.
+     * @return false  There is no running session for the seat.
+     */
+    bool renew(SeatId seat);
+
+    /**
+     * @brief End a running session without invoking the expiry callback.
+     *
+     * @return true   A session was running and has been stopped.
+     * @return false  There is no running session for the seat.
+     */
+    bool stop(SeatId seat);
+
+    /**
+     * @brief Return the direction of the running session, if any.
+     */
+    std::optional<MoveDirection> getActiveDirection(SeatId seat) const;
+
+    /**
+     * @brief Check that no session has been started since the given one.
+     */
+    bool isCurrentSession(SeatId seat, SessionId sessionId) const;
+
+    std::chrono::milliseconds getLeaseDuration() const { return m_leaseDuration; }
+
+private:
+    struct Session {
+        mutable ProfiledMutex                mutex{"HoldToMoveSession"};
+        bool                                 active{false};
+        MoveDirection                        direction{MoveDirection::Forward};
+        TimerService::Clock::time_point      leaseDeadline;
+        std::optional<TimerService::TimerId> timerId;
+        uint64_t                             timerGeneration{0}; // of the last armed timer
+        SessionId                            sessionId{0};       // of the last started session
+    };
+
+    void armTimer(SeatId seat, Session& session);
+    void onTimer(SeatId seat, uint64_t generation);
+
+    TimerService&                   m_timerService;
+    const std::chrono::milliseconds m_leaseDuration;
+    LeaseExpiredCallback            m_onLeaseExpired;
+    std::array<Session, SEAT_COUNT> m_sessions;
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_HOLDTOMOVECONTROLLER_H
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "IdempotencyCache.h"
+
+#include <algorithm>
+
+namespace example {
+
+IdempotencyCache::IdempotencyCache(TimerService::Clock::duration retention)
+    : m_retention(retention) {}
+
+std::optional<int> IdempotencyCache::find(SeatId seat, int requestId, int position,
+                                          TimerService::Clock::time_point now) const {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    for (std::size_t i = 0; i < m_size; ++i) {
+        const auto& entry = m_entries[i];
+        if (entry.seat == seat && entry.requestId == requestId && entry.position == position &&
+            !isExpired(entry, now)) {
+            return entry.status;
+        }
+    }
+    return std::nullopt;
+}
+
+void IdempotencyCache::insert(const Entry& entry) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_entries[m_next] = entry;
+    m_next            = (m_next + 1) % CAPACITY;
+    m_size            = std::min(m_size + 1, CAPACITY);
+}
+
+std::vector<IdempotencyCache::Entry>
+IdempotencyCache::getEntries(TimerService::Clock::time_point now) const {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    std::vector<Entry>             entries;
+    entries.reserve(m_size);
+    // Once the cache is full, m_next points to the oldest entry
+    const auto oldest = m_size == CAPACITY ? m_next : 0;
+    for (std::size_t i = 0; i < m_size; ++i) {
+        const auto& entry = m_entries[(oldest + i) % CAPACITY];
+        if (!isExpired(entry, now)) {
+            entries.push_back(entry);
+        }
+    }
+    return entries;
+}
+
+} // namespace example
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_IDEMPOTENCYCACHE_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_IDEMPOTENCYCACHE_H
+
+#include "ProfiledMutex.h"
+#include "Seat.h"
+#include "TimerService.h"
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace example {
+
+/**
+ * @brief Remembers the outcome of recently executed seat requests.
+ * @details MQTT delivers messages at least once, so a request may be received
+ *      again, e.g. after a reconnect. A request with the same seat, request id
+ *      and position within the retention time is considered such a retry and
+ *      must not be executed again. Only executed requests are remembered, a
+ *      refused one is evaluated again when it is retried.
+ *
+ *      The cache holds a fixed number of entries, the oldest one is replaced
+ *      when it is full.
+ */
+class IdempotencyCache {
+public:
+    static constexpr std::size_t CAPACITY = 32;
+
+    struct Entry {
+        SeatId                          seat{SeatId::Driver};
+        int                             requestId{0};
+        int                             position{0};
+        int                             status{STATUS_OK};
+        TimerService::Clock::time_point receivedAt;
+    };
+
+    explicit IdempotencyCache(TimerService::Clock::duration retention);
+
+    /**
+     * @brief Return the status of an identical request received within the retention time.
+     */
+    std::optional<int> find(SeatId seat, int requestId, int position,
+                            TimerService::Clock::time_point now) const;
+
+    void insert(const Entry& entry);
+
+    /**
+     * @brief Return all entries still within the retention time, oldest first.
+     */
+    std::vector<Entry> getEntries(TimerService::Clock::time_point now) const;
+
+private:
+    bool isExpired(const Entry& entry, TimerService::Clock::time_point now) const {
+        return entry.receivedAt + m_retention <= now;
+    }
+
+    const TimerService::Clock::duration m_retention;
+    mutable ProfiledMutex               m_mutex{"IdempotencyCache"};
+    std::array<Entry, CAPACITY>         m_entries;
+    std::size_t                         m_size{0};
+    std::size_t                         m_next{0};
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_IDEMPOTENCYCACHE_H
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "IdleMonitor.h"
+
+#include <utility>
+
+namespace example {
+
+namespace {
+
+TimerService::Clock::rep toTicks(TimerService::Clock::time_point timePoint) {
+    return timePoint.time_since_epoch().count();
+}
+
+TimerService::Clock::time_point fromTicks(TimerService::Clock::rep ticks) {
+    return TimerService::Clock::time_point(TimerService::Clock::duration(ticks));
+}
+
+} // namespace
+
+const char* toString(PowerMode mode) { return mode == PowerMode::Idle ? "idle" : "active"; }
+
+IdleMonitor::IdleMonitor(TimerService& timerService, TimerService::Clock::duration idleTimeout,
+                         ModeChangedCallback onModeChanged)
+    : m_timerService(timerService)
+    , m_idleTimeout(idleTimeout)
+    , m_onModeChanged(std::move(onModeChanged)) {}
+
+IdleMonitor::~IdleMonitor() {
+    // cancel() waits for a running onTimer(), which takes the lock and may re-arm the timer
+    while (true) {
+        std::optional<TimerService::TimerId> timerId;
+        {
+            std::lock_guard<ProfiledMutex> lock(m_mutex);
+            timerId = std::exchange(m_timerId, std::nullopt);
+        }
+        if (!timerId) {
+            break;
+        }
+        m_timerService.cancel(*timerId);
+    }
+}
+
+void IdleMonitor::start() {
+    const auto now = m_timerService.now();
+    m_lastActivity.store(toTicks(now));
+
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    if (!m_timerId) {
+        armTimer(now + m_idleTimeout);
+    }
+}
+
+void IdleMonitor::onActivity() {
+    // Sequentially consistent, pairs with onTimer(): either the timer sees this activity
+    // or we see the idle mode
+    const auto now = m_timerService.now();
+    m_lastActivity.store(toTicks(now));
+    if (m_mode.load() == PowerMode::Active) {
+        return;
+    }
+
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    if (m_mode.load() == PowerMode::Active) {
+        return;
+    }
+    m_mode.store(PowerMode::Active);
+    armTimer(now + m_idleTimeout);
+    m_onModeChanged(PowerMode::Active);
+}
+
+void IdleMonitor::armTimer(TimerService::Clock::time_point deadline) {
+    m_timerId = m_timerService.scheduleAt(deadline, [this]() { onTimer(); });
+}
+
+void IdleMonitor::onTimer() {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_timerId.reset();
+
+    // Idle is entered tentatively before looking at the last activity, see onActivity()
+    m_mode.store(PowerMode::Idle);
+    const auto idleDeadline = fromTicks(m_lastActivity.load()) + m_idleTimeout;
+    if (m_timerService.now() < idleDeadline) {
+        // There has been activity meanwhile, wait for the timeout counted from the last one
+        m_mode.store(PowerMode::Active);
+        armTimer(idleDeadline);
+        return;
+    }
+    m_onModeChanged(PowerMode::Idle);
+}
+
+} // namespace example
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_IDLEMONITOR_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_IDLEMONITOR_H
+
+#include "ProfiledMutex.h"
+#include "TimerService.h"
+
+#include <atomic>
+#include <functional>
+#include <optional>
+
+namespace example {
+
+enum class PowerMode { Active, Idle };
+
+const char* toString(PowerMode mode);
+
+/**
+ * @brief Detects when nobody is using the seats anymore.
+ * @details The monitor switches to PowerMode::Idle once no activity has been
+ *      reported for the idle timeout, and back to PowerMode::Active with the
+ *      next activity. Reporting activity is a single atomic store while active,
+ *      so it can be done on every request.
+ *
+ *      Like the HoldToMoveController lease, the idle timer re-arms itself
+ *      lazily, so an active app wakes up about once per idle timeout and an
+ *      idle one not at all.
+ *
+ *      The mode change callback is invoked with the internal lock held, so
+ *      changes are reported in order. It must not call back into the monitor.
+ */
+class IdleMonitor {
+public:
+    using ModeChangedCallback = std::function<void(PowerMode)>;
+
+    IdleMonitor(TimerService& timerService, TimerService::Clock::duration idleTimeout,
+                ModeChangedCallback onModeChanged);
+    ~IdleMonitor();
+
+    IdleMonitor(const IdleMonitor&)            = delete;
+    IdleMonitor& operator=(const IdleMonitor&) = delete;
+
+    /**
+     * @brief Start watching, the idle timeout starts now.
+     */
+    void start();
+
+    /**
+     * @brief Report that the seats are in use, leaving idle mode if needed.
+     */
+    void onActivity();
+
+    PowerMode getMode() const { return m_mode.load(); }
+
+private:
+    void armTimer(TimerService::Clock::time_point deadline);
+    void onTimer();
+
+    TimerService&                         m_timerService;
+    const TimerService::Clock::duration   m_idleTimeout;
+    ModeChangedCallback                   m_onModeChanged;
+    std::atomic<PowerMode>                m_mode{PowerMode::Active};
+    std::atomic<TimerService::Clock::rep> m_lastActivity{0};
+    ProfiledMutex                         m_mutex{"IdleMonitor"};
+    std::optional<TimerService::TimerId>  m_timerId;
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_IDLEMONITOR_H
@@ -0,0 +1,29 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_JSON_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_JSON_H
+
+#include <nlohmann/json.hpp>
+
+/**
+ * @brief The nlohmann::json specialization is instantiated once in Json.cpp.
+ * @details Include this header instead of <nlohmann/json.hpp>, so the translation units
+ *      using nlohmann::json don't instantiate and emit its member functions again.
+ */
+extern template class nlohmann::basic_json<>;
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_JSON_H
@@ -15,22 +15,35 @@
  */
 
 #include "SeatAdjusterApp.h"
+#include "Supervisor.h"
 #include "sdk/Logger.h"
 
 #include <csignal>
+#include <cstdlib>
 #include <memory>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+// Run the app under a supervisor keeping a hot standby process if set (to any value)
+const auto ENV_SUPERVISOR = "SEATADJUSTER_SUPERVISOR";
+
+const auto ENV_SNAPSHOT_PATH = "SEATADJUSTER_SNAPSHOT_PATH";
 
 std::unique_ptr<example::SeatAdjusterApp> myApp;
+std::unique_ptr<example::Supervisor>      mySupervisor;
 
 void signal_handler(int sig) {
     velocitas::logger().info("App terminated due to: Signal {}", sig);
-    myApp->stop();
+    if (myApp) {
+        myApp->stop();
+    } else if (mySupervisor) {
+        mySupervisor->stop();
+    }
 }
 
-int main(int argc, char** argv) {
-    signal(SIGINT, signal_handler);
-
-    myApp = std::make_unique<example::SeatAdjusterApp>();
+int runApp(example::SeatAdjusterApp::TakeoverGate waitForTakeover) {
+    myApp = std::make_unique<example::SeatAdjusterApp>(std::move(waitForTakeover));
     try {
         myApp->run();
     } catch (const std::exception& e) {
@@ -40,3 +53,49 @@ int main(int argc, char** argv) {
     }
     return 0;
 }
+
+int runSupervised() {
+    // The state is handed over to the standby via a snapshot file, so one is always needed
+    std::string ownSnapshotPath;
+    if (std::getenv(ENV_SNAPSHOT_PATH) == nullptr) {
+        ownSnapshotPath = "/dev/shm/seatadjuster-" + std::to_string(::getpid()) + ".state";
+        ::setenv(ENV_SNAPSHOT_PATH, ownSnapshotPath.c_str(), 1);
+    }
+
+    int exitCode = 0;
+    try {
+        mySupervisor = std::make_unique<example::Supervisor>(
+            [](example::Supervisor::Role role,
+               const example::Supervisor::TakeoverWait& waitForTakeover) {
+                if (role == example::Supervisor::Role::Active) {
+                    return runApp({});
+                }
+                return runApp([&waitForTakeover]() {
+                    const auto sinceActiveDied = waitForTakeover();
+                    if (sinceActiveDied) {
+                        velocitas::logger().info("Took over {} us after the active process died",
+                                                 sinceActiveDied->count());
+                    }
+                    return sinceActiveDied.has_value();
+                });
+            });
+        exitCode = mySupervisor->run();
+    } catch (const std::system_error& e) {
+        velocitas::logger().error("Supervisor terminated due to: {}", e.what());
+        exitCode = 1;
+    }
+
+    if (!ownSnapshotPath.empty()) {
+        ::unlink(ownSnapshotPath.c_str());
+    }
+    return exitCode;
+}
+
+int main(int argc, char** argv) {
+    signal(SIGINT, signal_handler);
+
+    if (std::getenv(ENV_SUPERVISOR) != nullptr) {
+        return runSupervised();
+    }
+    return runApp({});
+}
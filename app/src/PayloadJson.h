@@ -0,0 +1,382 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_PAYLOADJSON_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_PAYLOADJSON_H
+
+#include "Json.h"
+#include "SignalCondition.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fmt/format.h>
+#include <limits>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/**
+ * @brief Serialization of the field values of the generated payloads.
+ * @details The payload structs in payloads/<Name>.h are generated from the schemas
+ *      in app/schemas by generate_payloads.py. Their JSON text is appended field
+ *      by field with the keys as literals. Incoming payloads are read into the
+ *      structs directly by a SAX parser, without building a JSON document.
+ */
+namespace example::payloads {
+
+inline void appendJson(std::string& out, bool value) { out += value ? "true" : "false"; }
+
+template <typename TInteger>
+std::enable_if_t<std::is_integral_v<TInteger> && !std::is_same_v<TInteger, bool>>
+appendJson(std::string& out, TInteger value) {
+    const fmt::format_int text(value);
+    out.append(text.data(), text.size());
+}
+
+inline void appendJson(std::string& out, double value) {
+    // JSON has no representation of NaN and infinity
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+    fmt::format_to(std::back_inserter(out), "{}", value);
+}
+
+inline void appendJson(std::string& out, const std::string& value) {
+    constexpr const char* HEX_DIGITS = "0123456789abcdef";
+
+    out += '"';
+    for (const auto character : value) {
+        switch (character) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(character) < 0x20) {
+                out += "\\u00";
+                out += HEX_DIGITS[static_cast<unsigned char>(character) >> 4];
+                out += HEX_DIGITS[static_cast<unsigned char>(character) & 0xf];
+            } else {
+                out += character;
+            }
+        }
+    }
+    out += '"';
+}
+
+inline void appendJson(std::string& out, const SignalValue& value) {
+    std::visit([&out](const auto& alternative) { appendJson(out, alternative); }, value);
+}
+
+template <typename TValue>
+void appendJson(std::string& out, const std::vector<TValue>& values) {
+    out += '[';
+    for (std::size_t index = 0; index < values.size(); ++index) {
+        if (index > 0) {
+            out += ',';
+        }
+        appendJson(out, values[index]);
+    }
+    out += ']';
+}
+
+/**
+ * @brief Read a field value, passed by the SaxParser as a scalar JSON value.
+ * @return false if the value has the wrong type or is out of range.
+ */
+inline bool readJson(const nlohmann::json& json, bool& value) {
+    if (!json.is_boolean()) {
+        return false;
+    }
+    value = json.get<bool>();
+    return true;
+}
+
+template <typename TInteger>
+std::enable_if_t<std::is_integral_v<TInteger> && !std::is_same_v<TInteger, bool>, bool>
+readJson(const nlohmann::json& json, TInteger& value) {
+    if (json.is_number_unsigned()) {
+        const auto number = json.get<uint64_t>();
+        if (number > static_cast<uint64_t>(std::numeric_limits<TInteger>::max())) {
+            return false;
+        }
+        value = static_cast<TInteger>(number);
+        return true;
+    }
+    if (json.is_number_integer()) {
+        const auto number = json.get<int64_t>();
+        if constexpr (std::is_unsigned_v<TInteger>) {
+            return false;
+        } else if (number < std::numeric_limits<TInteger>::min() ||
+                   number > std::numeric_limits<TInteger>::max()) {
+            return false;
+        }
+        value = static_cast<TInteger>(number);
+        return true;
+    }
+    return false;
+}
+
+inline bool readJson(const nlohmann::json& json, double& value) {
+    if (!json.is_number()) {
+        return false;
+    }
+    value = json.get<double>();
+    return true;
+}
+
+inline bool readJson(const nlohmann::json& json, std::string& value) {
+    if (!json.is_string()) {
+        return false;
+    }
+    value = json.get_ref<const std::string&>();
+    return true;
+}
+
+inline bool readJson(const nlohmann::json& json, SignalValue& value) {
+    if (json.is_boolean()) {
+        value = json.get<bool>();
+    } else if (json.is_number()) {
+        value = json.get<double>();
+    } else if (json.is_string()) {
+        value = json.get_ref<const std::string&>();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+template <typename TValue>
+bool readJson(const nlohmann::json& json, std::vector<TValue>& values) {
+    if (!json.is_array()) {
+        return false;
+    }
+    values.clear();
+    values.reserve(json.size());
+    for (const auto& element : json) {
+        if (!readJson(element, values.emplace_back())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the fields of one payload object, generated as <Name>Reader.
+ */
+class ObjectReader {
+public:
+    virtual ~ObjectReader() = default;
+
+    /**
+     * @brief Start reading an object into the bound payload.
+     */
+    virtual void begin() = 0;
+
+    /**
+     * @brief Select the field the next value belongs to.
+     * @return false if the key is unknown, its value is skipped then.
+     */
+    virtual bool selectField(const std::string& key) = 0;
+
+    /**
+     * @brief Read a scalar value (or null) into the selected field.
+     * @return The error if the field has another type.
+     */
+    virtual std::optional<std::string> readValue(const nlohmann::json& value) = 0;
+
+    /**
+     * @brief Return the reader of the payload in the selected field, bound to it, or
+     *      nullptr if the field has a scalar type.
+     */
+    virtual ObjectReader* readObject() = 0;
+
+    /**
+     * @brief Finish the object.
+     * @return The error if a required field is missing.
+     */
+    virtual std::optional<std::string> end() = 0;
+};
+
+/**
+ * @brief SAX handler feeding the events of nlohmann::json::sax_parse() to the readers
+ *      of a payload and its nested payloads.
+ * @details Scalars are passed to the readers as single JSON values, and so are arrays,
+ *      which are only collected into a JSON value of their own. Values of unknown keys
+ *      are skipped. Parsing stops at the first error, which is prefixed with the
+ *      keys of the nested payloads it occurred in.
+ */
+class SaxParser final : public nlohmann::json_sax<nlohmann::json> {
+public:
+    SaxParser(ObjectReader& reader, std::string typeError)
+        : m_rootReader(reader)
+        , m_typeError(std::move(typeError)) {}
+
+    /**
+     * @brief Return the error which stopped the parsing, "Malformed JSON" for syntax errors.
+     */
+    const std::optional<std::string>& getError() const { return m_error; }
+
+    bool null() override { return readValue(nullptr); }
+    bool boolean(bool value) override { return readValue(value); }
+    bool number_integer(number_integer_t value) override { return readValue(value); }
+    bool number_unsigned(number_unsigned_t value) override { return readValue(value); }
+    bool number_float(number_float_t value, const string_t& /*text*/) override {
+        return readValue(value);
+    }
+    bool string(string_t& value) override { return readValue(std::move(value)); }
+    bool binary(binary_t& /*value*/) override { return readValue(nlohmann::json::value_t::binary); }
+
+    bool start_object(std::size_t /*elements*/) override {
+        if (m_isSkipping) {
+            ++m_skipDepth;
+            return true;
+        }
+        if (!m_arrays.empty()) {
+            // Arrays only hold scalars, let the reader report the type of the field
+            m_arrays.clear();
+            return readValue(nlohmann::json::value_t::object);
+        }
+        if (m_frames.empty()) {
+            m_rootReader.begin();
+            m_frames.push_back({&m_rootReader, {}});
+            return true;
+        }
+        if (auto* reader = m_frames.back().reader->readObject()) {
+            reader->begin();
+            m_frames.push_back({reader, std::move(m_key)});
+            return true;
+        }
+        return readValue(nlohmann::json::value_t::object);
+    }
+
+    bool key(string_t& key) override {
+        if (m_isSkipping) {
+            return true;
+        }
+        // The value of an unknown key is skipped
+        m_isSkipping = !m_frames.back().reader->selectField(key);
+        m_key        = std::move(key);
+        return true;
+    }
+
+    bool end_object() override {
+        if (m_isSkipping) {
+            leaveSkippedContainer();
+            return true;
+        }
+        if (auto error = m_frames.back().reader->end()) {
+            return fail(std::move(*error));
+        }
+        m_frames.pop_back();
+        return true;
+    }
+
+    bool start_array(std::size_t /*elements*/) override {
+        if (m_isSkipping) {
+            ++m_skipDepth;
+            return true;
+        }
+        if (m_frames.empty()) {
+            return fail(m_typeError);
+        }
+        m_arrays.emplace_back(nlohmann::json::value_t::array);
+        return true;
+    }
+
+    bool end_array() override {
+        if (m_isSkipping) {
+            leaveSkippedContainer();
+            return true;
+        }
+        auto array = std::move(m_arrays.back());
+        m_arrays.pop_back();
+        return readValue(std::move(array));
+    }
+
+    bool parse_error(std::size_t /*position*/, const std::string& /*token*/,
+                     const nlohmann::detail::exception& /*exception*/) override {
+        m_error = "Malformed JSON";
+        return false;
+    }
+
+private:
+    struct Frame {
+        ObjectReader* reader;
+        std::string   key; // of the payload in its parent, empty for the root
+    };
+
+    bool readValue(nlohmann::json value) {
+        if (m_isSkipping) {
+            m_isSkipping = m_skipDepth > 0;
+            return true;
+        }
+        if (!m_arrays.empty()) {
+            m_arrays.back().push_back(std::move(value));
+            return true;
+        }
+        if (m_frames.empty()) {
+            return fail(m_typeError);
+        }
+        if (auto error = m_frames.back().reader->readValue(value)) {
+            return fail(std::move(*error));
+        }
+        return true;
+    }
+
+    void leaveSkippedContainer() {
+        --m_skipDepth;
+        m_isSkipping = m_skipDepth > 0;
+    }
+
+    bool fail(std::string error) {
+        std::string path;
+        for (std::size_t index = 1; index < m_frames.size(); ++index) {
+            path += m_frames[index].key + ": ";
+        }
+        m_error = path + error;
+        return false;
+    }
+
+    ObjectReader&               m_rootReader;
+    const std::string           m_typeError;
+    std::vector<Frame>          m_frames;
+    std::string                 m_key;
+    std::vector<nlohmann::json> m_arrays; // being collected, the innermost one last
+    bool                        m_isSkipping{false};
+    std::size_t                 m_skipDepth{0}; // of the skipped arrays and objects
+    std::optional<std::string>  m_error;
+};
+
+} // namespace example::payloads
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_PAYLOADJSON_H
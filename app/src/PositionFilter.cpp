@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "PositionFilter.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace example {
+
+namespace {
+
+constexpr auto MEDIAN_PREFIX   = "median:";
+constexpr auto DEADBAND_PREFIX = "deadband:";
+
+bool startsWith(const std::string& text, const std::string& prefix) {
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+int parsePositive(const std::string& text, const std::string& specification) {
+    char*      end   = nullptr;
+    const auto value = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value <= 0 || value > SEAT_POSITION_MAX) {
+        throw std::invalid_argument("Invalid position filter \"" + specification + "\"");
+    }
+    return static_cast<int>(value);
+}
+
+} // namespace
+
+PositionFilter::Config PositionFilter::parseConfig(const std::string& specification) {
+    Config config;
+    if (startsWith(specification, MEDIAN_PREFIX)) {
+        const auto arguments = specification.substr(std::string(MEDIAN_PREFIX).size());
+        const auto separator = arguments.find(':');
+        config.mode          = Mode::Median;
+        config.windowSize    = static_cast<std::size_t>(
+            parsePositive(arguments.substr(0, separator), specification));
+        if (separator != std::string::npos) {
+            config.settleTime = std::chrono::milliseconds(
+                parsePositive(arguments.substr(separator + 1), specification));
+        }
+    } else if (startsWith(specification, DEADBAND_PREFIX)) {
+        config.mode     = Mode::Deadband;
+        config.deadband = parsePositive(specification.substr(std::string(DEADBAND_PREFIX).size()),
+                                        specification);
+    } else {
+        throw std::invalid_argument("Unknown position filter \"" + specification +
+                                    "\", expected median:<size>[:<ms>] or deadband:<width>");
+    }
+    return config;
+}
+
+PositionFilter::PositionFilter(const Config& config)
+    : m_config(config) {
+    if (config.mode == Mode::Median &&
+        (config.windowSize < 3 || config.windowSize > MAX_WINDOW_SIZE ||
+         config.windowSize % 2 == 0)) {
+        throw std::invalid_argument("Median window has to be an odd size between 3 and " +
+                                    std::to_string(MAX_WINDOW_SIZE));
+    }
+    if (config.mode == Mode::Deadband && config.deadband <= 0) {
+        throw std::invalid_argument("Deadband has to be positive");
+    }
+}
+
+std::optional<int> PositionFilter::update(SeatId seat, int position) {
+    auto& state = m_seats[toIndex(seat)];
+
+    int filtered = position;
+    if (m_config.mode == Mode::Median) {
+        state.lastReport          = position;
+        state.samples[state.next] = position;
+        state.next                = static_cast<uint8_t>((state.next + 1) % m_config.windowSize);
+        state.sampleCount =
+            static_cast<uint8_t>(std::min<std::size_t>(state.sampleCount + 1, m_config.windowSize));
+        filtered = median(state);
+    } else if (state.hasOutput && isNoise(state, position)) {
+        return std::nullopt;
+    }
+
+    if (state.hasOutput && filtered == state.output) {
+        return std::nullopt;
+    }
+    state.hasOutput = true;
+    state.output    = filtered;
+    return filtered;
+}
+
+std::optional<int> PositionFilter::settle(SeatId seat) {
+    auto& state = m_seats[toIndex(seat)];
+    if (m_config.mode != Mode::Median || state.sampleCount == 0) {
+        return std::nullopt;
+    }
+
+    // The seat is at rest, so its last report is its position; the window restarts from it
+    state.samples.fill(state.lastReport);
+    if (state.hasOutput && state.output == state.lastReport) {
+        return std::nullopt;
+    }
+    state.hasOutput = true;
+    state.output    = state.lastReport;
+    return state.output;
+}
+
+void PositionFilter::reset(SeatId seat) { m_seats[toIndex(seat)] = SeatState{}; }
+
+int PositionFilter::median(const SeatState& state) const {
+    // At most MAX_WINDOW_SIZE values, partially sorting a copy is cheaper than keeping order.
+    // While the window fills up, the lower middle is taken, so a first outlier is dropped.
+    std::array<int, MAX_WINDOW_SIZE> window;
+    std::copy_n(state.samples.begin(), state.sampleCount, window.begin());
+    const auto middle = window.begin() + (state.sampleCount - 1) / 2;
+    std::nth_element(window.begin(), middle, window.begin() + state.sampleCount);
+    return *middle;
+}
+
+bool PositionFilter::isNoise(SeatState& state, int position) const {
+    const auto delta = position - state.output;
+    if (delta == 0) {
+        return true;
+    }
+    const int8_t direction = delta > 0 ? 1 : -1;
+    if (direction == state.direction) {
+        return false;
+    }
+    if (std::abs(delta) > m_config.deadband) {
+        state.direction = direction;
+        return false;
+    }
+    // A small step back ends the movement, the seat is at rest again
+    state.direction = 0;
+    return true;
+}
+
+} // namespace example
@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_POSITIONFILTER_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_POSITIONFILTER_H
+
+#include "Seat.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace example {
+
+/**
+ * @brief Removes sensor jitter from the reported seat positions before they are published.
+ * @details Two modes are supported:
+ *      - Median: the output is the median of the last windowSize reports, so single
+ *        outliers never get through. Movements are delayed by half the window. As the
+ *        seat only reports changes, the output would stop short of the end of a
+ *        movement: once a seat has not reported for the settle time, settle() makes
+ *        its last report the output.
+ *      - Deadband: at rest, a report has to differ from the output by more than the
+ *        deadband to get through. Once moving, every report in the same direction
+ *        gets through until the direction reverses, so a movement ends at its exact
+ *        position while jitter around a resting seat is suppressed (hysteresis).
+ *
+ *      Only changes of the filtered position are returned. The state of a seat is a
+ *      fixed-size ring of its last reports, no allocation happens per report.
+ *      Reports of the same seat must not be passed concurrently.
+ */
+class PositionFilter {
+public:
+    enum class Mode { Median, Deadband };
+
+    static constexpr std::size_t MAX_WINDOW_SIZE = 15;
+
+    struct Config {
+        Mode                      mode{Mode::Deadband};
+        std::size_t               windowSize{5};
+        std::chrono::milliseconds settleTime{500}; // median only
+        int                       deadband{1};
+    };
+
+    /**
+     * @brief Parse a filter specification, "median:<window size>[:<settle time in ms>]" or
+     *      "deadband:<width>".
+     * @throws std::invalid_argument if the specification is malformed.
+     */
+    static Config parseConfig(const std::string& specification);
+
+    /**
+     * @throws std::invalid_argument if the median window is not an odd number between 3
+     *      and MAX_WINDOW_SIZE, or the deadband is not positive.
+     */
+    explicit PositionFilter(const Config& config);
+
+    /**
+     * @brief Feed a reported position into the filter of the seat.
+     * @return The filtered position if it changed, nothing if the report was noise.
+     */
+    std::optional<int> update(SeatId seat, int position);
+
+    /**
+     * @brief Make the last report of a seat which stopped reporting its output (median
+     *      mode only, the caller tracks the settle time).
+     * @return The filtered position if it changed.
+     */
+    std::optional<int> settle(SeatId seat);
+
+    /**
+     * @brief Forget the history of a seat, its next report gets through unfiltered.
+     */
+    void reset(SeatId seat);
+
+    const Config& getConfig() const { return m_config; }
+
+private:
+    struct SeatState {
+        std::array<int, MAX_WINDOW_SIZE> samples{};
+        uint8_t                          sampleCount{0};
+        uint8_t                          next{0};
+        int                              lastReport{0};
+        int8_t                           direction{0};
+        bool                             hasOutput{false};
+        int                              output{0};
+    };
+
+    int  median(const SeatState& state) const;
+    bool isNoise(SeatState& state, int position) const;
+
+    const Config                      m_config;
+    std::array<SeatState, SEAT_COUNT> m_seats;
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_POSITIONFILTER_H
@@ -0,0 +1,592 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "PositionHistory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace example {
+
+namespace {
+
+constexpr uint32_t HISTORY_MAGIC   = 0x53414853; // "SAHS"
+constexpr uint32_t HISTORY_VERSION = 1;
+
+constexpr std::array<int64_t, HISTORY_RESOLUTION_COUNT> BUCKET_WIDTHS{0, 60'000, 3'600'000};
+
+// Prefix codes of the zigzag encoded deltas: class n is announced by n one bits and a zero
+// bit (the last class by one bits only) and holds values below 2^bits. Regular reports of a
+// resting seat need a single bit for the timestamp and for each value.
+using CodeClasses = std::array<unsigned, 5>;
+
+constexpr CodeClasses TIMESTAMP_CLASSES{0, 7, 12, 20, 64};
+constexpr CodeClasses VALUE_CLASSES{0, 4, 8, 12, 32};
+
+// Raw points store the position only, buckets their minimum, maximum, last position and count
+constexpr std::size_t MAX_VALUE_COUNT = 4;
+
+std::size_t getValueCount(HistoryResolution resolution) {
+    return resolution == HistoryResolution::Raw ? 1 : MAX_VALUE_COUNT;
+}
+
+uint64_t toZigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t fromZigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+std::size_t getCodeClass(uint64_t value, const CodeClasses& classes) {
+    for (std::size_t index = 0; index + 1 < classes.size(); ++index) {
+        if (value < (uint64_t{1} << classes[index])) {
+            return index;
+        }
+    }
+    return classes.size() - 1;
+}
+
+std::size_t getCodeLength(uint64_t value, const CodeClasses& classes) {
+    const auto index = getCodeClass(value, classes);
+    return index + (index + 1 < classes.size() ? 1 : 0) + classes[index];
+}
+
+class BitWriter {
+public:
+    BitWriter(uint8_t* data, std::size_t bitPosition)
+        : m_data(data)
+        , m_bitPosition(bitPosition) {}
+
+    void write(uint64_t value, unsigned bitCount) {
+        for (auto bit = bitCount; bit-- > 0;) {
+            if ((value >> bit) & 1) {
+                m_data[m_bitPosition / 8] |= static_cast<uint8_t>(0x80 >> (m_bitPosition % 8));
+            }
+            ++m_bitPosition;
+        }
+    }
+
+    void writeCode(uint64_t value, const CodeClasses& classes) {
+        const auto index = getCodeClass(value, classes);
+        write((uint64_t{1} << index) - 1, static_cast<unsigned>(index));
+        if (index + 1 < classes.size()) {
+            write(0, 1);
+        }
+        write(value, classes[index]);
+    }
+
+    std::size_t getBitPosition() const { return m_bitPosition; }
+
+private:
+    uint8_t*    m_data;
+    std::size_t m_bitPosition;
+};
+
+class BitReader {
+public:
+    explicit BitReader(const uint8_t* data)
+        : m_data(data) {}
+
+    uint64_t read(unsigned bitCount) {
+        uint64_t value = 0;
+        for (unsigned bit = 0; bit < bitCount; ++bit) {
+            value = (value << 1) | ((m_data[m_bitPosition / 8] >> (7 - m_bitPosition % 8)) & 1);
+            ++m_bitPosition;
+        }
+        return value;
+    }
+
+    uint64_t readCode(const CodeClasses& classes) {
+        std::size_t index = 0;
+        while (index + 1 < classes.size() && read(1) == 1) {
+            ++index;
+        }
+        return read(classes[index]);
+    }
+
+    std::size_t getBitPosition() const { return m_bitPosition; }
+
+private:
+    const uint8_t* m_data;
+    std::size_t    m_bitPosition{0};
+};
+
+// Values are 32 bit, so their deltas wrap around in 32 bits to fit the largest code class
+int64_t getValueDelta(int64_t value, int64_t last) {
+    return static_cast<int32_t>(static_cast<uint32_t>(value) - static_cast<uint32_t>(last));
+}
+
+int64_t addValueDelta(int64_t last, int64_t delta) {
+    return static_cast<int32_t>(static_cast<uint32_t>(last) + static_cast<uint32_t>(delta));
+}
+
+int64_t getBucketStart(int64_t timestamp, int64_t width) {
+    return timestamp - ((timestamp % width) + width) % width;
+}
+
+// Whether the points from first to last, each covering width, overlap [from, to]
+bool overlaps(int64_t first, int64_t last, int64_t width, int64_t from, int64_t to) {
+    return first <= to && last + std::max<int64_t>(width, 1) > from;
+}
+
+void merge(PositionHistory::Point& bucket, const PositionHistory::Point& point) {
+    bucket.min = std::min(bucket.min, point.min);
+    bucket.max = std::max(bucket.max, point.max);
+    bucket.last = point.last;
+    bucket.count += point.count;
+}
+
+[[noreturn]] void throwSystemError(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace
+
+struct PositionHistory::FileHeader {
+    uint32_t                                       magic;
+    uint32_t                                       version;
+    uint32_t                                       blockSize;
+    std::array<uint32_t, HISTORY_RESOLUTION_COUNT> blockCounts;
+};
+
+struct PositionHistory::BlockHeader {
+    static constexpr std::size_t PAYLOAD_SIZE = BLOCK_SIZE - 32;
+
+    // Updated last, so a point is only visible once it has been written completely
+    std::atomic<uint32_t> pointCount;
+    uint8_t               seat;
+    uint8_t               resolution;
+    uint16_t              reserved;
+    // Order of the blocks of all resolutions, 0 if the block is unused
+    uint64_t                           sequence;
+    int64_t                            firstTimestamp;
+    int64_t                            lastTimestamp;
+    std::array<uint8_t, PAYLOAD_SIZE> payload;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+const char* toString(HistoryResolution resolution) {
+    switch (resolution) {
+    case HistoryResolution::Raw:
+        return "raw";
+    case HistoryResolution::Minute:
+        return "minute";
+    case HistoryResolution::Hour:
+        return "hour";
+    }
+    return "unknown";
+}
+
+std::optional<HistoryResolution> parseHistoryResolution(const std::string& name) {
+    for (std::size_t index = 0; index < HISTORY_RESOLUTION_COUNT; ++index) {
+        const auto resolution = static_cast<HistoryResolution>(index);
+        if (name == toString(resolution)) {
+            return resolution;
+        }
+    }
+    return std::nullopt;
+}
+
+PositionHistory::PositionHistory(const Config& config)
+    : m_config(config) {
+    static_assert(sizeof(BlockHeader) == BLOCK_SIZE);
+    static_assert(sizeof(FileHeader) <= BLOCK_SIZE);
+
+    uint32_t blockCount = 1;
+    for (std::size_t index = 0; index < HISTORY_RESOLUTION_COUNT; ++index) {
+        // With a single block, each seat would overwrite the block of the other one
+        if (config.blockCounts[index] < SEAT_COUNT) {
+            throw std::invalid_argument("Position history needs at least " +
+                                        std::to_string(SEAT_COUNT) + " blocks per resolution");
+        }
+        m_firstBlocks[index] = blockCount;
+        blockCount += config.blockCounts[index];
+    }
+    m_fileSize = std::size_t{blockCount} * BLOCK_SIZE;
+
+    const auto fd = ::open(config.path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0640);
+    if (fd < 0) {
+        throwSystemError(config.path);
+    }
+
+    struct stat fileStat {};
+    if (::fstat(fd, &fileStat) < 0 ||
+        (static_cast<std::size_t>(fileStat.st_size) != m_fileSize &&
+         ::ftruncate(fd, static_cast<off_t>(m_fileSize)) < 0)) {
+        const auto error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), config.path);
+    }
+
+    auto* mapping = ::mmap(nullptr, m_fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // The mapping stays valid without the file descriptor
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throwSystemError(config.path);
+    }
+    m_mapping = static_cast<uint8_t*>(mapping);
+
+    auto* header = reinterpret_cast<FileHeader*>(m_mapping);
+    if (header->magic != HISTORY_MAGIC || header->version != HISTORY_VERSION ||
+        header->blockSize != BLOCK_SIZE || header->blockCounts != config.blockCounts) {
+        std::memset(m_mapping, 0, m_fileSize);
+        header->magic       = HISTORY_MAGIC;
+        header->version     = HISTORY_VERSION;
+        header->blockSize   = BLOCK_SIZE;
+        header->blockCounts = config.blockCounts;
+    }
+    recover();
+}
+
+PositionHistory::~PositionHistory() {
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        for (std::size_t seatIndex = 0; seatIndex < SEAT_COUNT; ++seatIndex) {
+            // Minute buckets first, they are folded into the hour buckets
+            for (std::size_t index = 1; index < HISTORY_RESOLUTION_COUNT; ++index) {
+                flushBucket(static_cast<SeatId>(seatIndex), static_cast<HistoryResolution>(index));
+            }
+        }
+    }
+    ::munmap(m_mapping, m_fileSize);
+}
+
+void PositionHistory::append(SeatId seat, int64_t timestamp, int position) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    auto& lastTimestamp = m_lastTimestamps[toIndex(seat)];
+    lastTimestamp       = std::max(lastTimestamp, timestamp);
+
+    const Point point{lastTimestamp, position, position, position, 1};
+    writePoint(seat, HistoryResolution::Raw, point);
+    addToBucket(seat, HistoryResolution::Minute, point);
+}
+
+std::vector<PositionHistory::Point> PositionHistory::query(SeatId seat, int64_t from, int64_t to,
+                                                           HistoryResolution resolution) const {
+    const auto         width = getBucketWidth(resolution);
+    std::vector<Point> points;
+
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    for (const auto* block : getBlocks(seat, resolution)) {
+        if (!overlaps(block->firstTimestamp, block->lastTimestamp, width, from, to)) {
+            continue;
+        }
+        decodeBlock(*block, &points);
+    }
+    for (const auto& point : getPendingPoints(seat, resolution)) {
+        points.push_back(point);
+    }
+
+    points.erase(std::remove_if(points.begin(), points.end(),
+                                [width, from, to](const Point& point) {
+                                    return !overlaps(point.timestamp, point.timestamp, width,
+                                                     from, to);
+                                }),
+                 points.end());
+    return points;
+}
+
+HistoryResolution PositionHistory::selectResolution(SeatId seat, int64_t from, int64_t to,
+                                                    std::size_t maxPoints) const {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    for (std::size_t index = 0; index + 1 < HISTORY_RESOLUTION_COUNT; ++index) {
+        const auto resolution = static_cast<HistoryResolution>(index);
+        const auto blocks     = getBlocks(seat, resolution);
+        // Once the ring has wrapped, older points are only left at coarser resolutions
+        if (isFull(resolution) && (blocks.empty() || blocks.front()->firstTimestamp > from)) {
+            continue;
+        }
+
+        const auto  width      = getBucketWidth(resolution);
+        std::size_t pointCount = getPendingPoints(seat, resolution).size();
+        for (const auto* block : blocks) {
+            if (overlaps(block->firstTimestamp, block->lastTimestamp, width, from, to)) {
+                pointCount += block->pointCount.load(std::memory_order_relaxed);
+            }
+        }
+        if (pointCount <= maxPoints) {
+            return resolution;
+        }
+    }
+    return HistoryResolution::Hour;
+}
+
+std::optional<PositionHistory::Aggregate>
+PositionHistory::aggregate(const std::vector<Point>& points) {
+    if (points.empty()) {
+        return std::nullopt;
+    }
+    Aggregate result{points.front().min, points.front().max, points.back().last, 0};
+    for (const auto& point : points) {
+        result.min = std::min(result.min, point.min);
+        result.max = std::max(result.max, point.max);
+        result.count += point.count;
+    }
+    return result;
+}
+
+std::size_t PositionHistory::getUsedBlockCount(HistoryResolution resolution) const {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    std::size_t                    usedCount = 0;
+    for (uint32_t index = 0; index < m_config.blockCounts[static_cast<std::size_t>(resolution)];
+         ++index) {
+        usedCount += getBlock(resolution, index)->sequence != 0 ? 1 : 0;
+    }
+    return usedCount;
+}
+
+int64_t PositionHistory::getBucketWidth(HistoryResolution resolution) {
+    return BUCKET_WIDTHS[static_cast<std::size_t>(resolution)];
+}
+
+PositionHistory::BlockHeader* PositionHistory::getBlock(HistoryResolution resolution,
+                                                        uint32_t          index) const {
+    const auto blockIndex = m_firstBlocks[static_cast<std::size_t>(resolution)] + index;
+    return reinterpret_cast<BlockHeader*>(m_mapping + std::size_t{blockIndex} * BLOCK_SIZE);
+}
+
+void PositionHistory::recover() {
+    for (std::size_t index = 0; index < HISTORY_RESOLUTION_COUNT; ++index) {
+        const auto resolution = static_cast<HistoryResolution>(index);
+        uint64_t   newest     = 0;
+        for (uint32_t blockIndex = 0; blockIndex < m_config.blockCounts[index]; ++blockIndex) {
+            const auto* block = getBlock(resolution, blockIndex);
+            if (block->sequence == 0 || block->seat >= SEAT_COUNT ||
+                block->resolution != index) {
+                continue;
+            }
+            if (block->sequence > newest) {
+                newest              = block->sequence;
+                m_nextBlocks[index] = (blockIndex + 1) % m_config.blockCounts[index];
+            }
+            m_sequence = std::max(m_sequence, block->sequence);
+
+            // Points are appended to the newest block of each seat
+            auto& cursor = m_cursors[block->seat][index];
+            if (!cursor.block || getBlock(resolution, *cursor.block)->sequence < block->sequence) {
+                cursor.block = blockIndex;
+            }
+        }
+    }
+
+    for (std::size_t seatIndex = 0; seatIndex < SEAT_COUNT; ++seatIndex) {
+        for (std::size_t index = 0; index < HISTORY_RESOLUTION_COUNT; ++index) {
+            auto& cursor = m_cursors[seatIndex][index];
+            if (!cursor.block) {
+                continue;
+            }
+            const auto blockIndex = *cursor.block;
+            cursor                = decodeBlock(
+                *getBlock(static_cast<HistoryResolution>(index), blockIndex), nullptr);
+            cursor.block = blockIndex;
+        }
+        const auto& rawCursor = m_cursors[seatIndex][0];
+        if (rawCursor.block) {
+            m_lastTimestamps[seatIndex] = rawCursor.lastTimestamp;
+        }
+    }
+}
+
+PositionHistory::Cursor PositionHistory::decodeBlock(const BlockHeader&  block,
+                                                     std::vector<Point>* points) {
+    const auto resolution = static_cast<HistoryResolution>(block.resolution);
+    const auto valueCount = getValueCount(resolution);
+    const auto pointCount = block.pointCount.load(std::memory_order_acquire);
+
+    Cursor    cursor;
+    BitReader reader(block.payload.data());
+    cursor.lastTimestamp = block.firstTimestamp;
+    for (uint32_t pointIndex = 0; pointIndex < pointCount; ++pointIndex) {
+        if (pointIndex > 0) {
+            cursor.lastDelta += fromZigzag(reader.readCode(TIMESTAMP_CLASSES));
+            cursor.lastTimestamp += cursor.lastDelta;
+        }
+        for (std::size_t valueIndex = 0; valueIndex < valueCount; ++valueIndex) {
+            auto& value = cursor.lastValues[valueIndex];
+            value       = addValueDelta(value, fromZigzag(reader.readCode(VALUE_CLASSES)));
+        }
+
+        if (points != nullptr) {
+            const auto& values = cursor.lastValues;
+            if (valueCount == 1) {
+                const auto position = static_cast<int32_t>(values[0]);
+                points->push_back({cursor.lastTimestamp, position, position, position, 1});
+            } else {
+                points->push_back({cursor.lastTimestamp, static_cast<int32_t>(values[0]),
+                                   static_cast<int32_t>(values[1]),
+                                   static_cast<int32_t>(values[2]),
+                                   static_cast<uint32_t>(values[3])});
+            }
+        }
+    }
+    cursor.bitPosition = reader.getBitPosition();
+    return cursor;
+}
+
+void PositionHistory::writePoint(SeatId seat, HistoryResolution resolution, const Point& point) {
+    const auto                              valueCount = getValueCount(resolution);
+    const std::array<int64_t, MAX_VALUE_COUNT> values{
+        valueCount == 1 ? point.last : point.min, point.max, point.last, point.count};
+
+    auto&       cursor = m_cursors[toIndex(seat)][static_cast<std::size_t>(resolution)];
+    const auto  delta  = point.timestamp - cursor.lastTimestamp;
+    std::size_t bitCount =
+        cursor.block ? getCodeLength(toZigzag(delta - cursor.lastDelta), TIMESTAMP_CLASSES) : 0;
+    for (std::size_t valueIndex = 0; valueIndex < valueCount; ++valueIndex) {
+        const auto valueDelta = getValueDelta(values[valueIndex], cursor.lastValues[valueIndex]);
+        bitCount += getCodeLength(toZigzag(valueDelta), VALUE_CLASSES);
+    }
+
+    if (!cursor.block || cursor.bitPosition + bitCount > BlockHeader::PAYLOAD_SIZE * 8) {
+        const auto blockIndex = allocateBlock(seat, resolution, point.timestamp);
+        cursor                = Cursor{};
+        cursor.block          = blockIndex;
+    }
+
+    auto*     block = getBlock(resolution, *cursor.block);
+    BitWriter writer(block->payload.data(), cursor.bitPosition);
+    if (block->pointCount.load(std::memory_order_relaxed) > 0) {
+        writer.writeCode(toZigzag(delta - cursor.lastDelta), TIMESTAMP_CLASSES);
+        cursor.lastDelta = delta;
+    } else {
+        // The first point of a block is stored in its header
+        block->firstTimestamp = point.timestamp;
+    }
+    cursor.lastTimestamp = point.timestamp;
+    for (std::size_t valueIndex = 0; valueIndex < valueCount; ++valueIndex) {
+        writer.writeCode(
+            toZigzag(getValueDelta(values[valueIndex], cursor.lastValues[valueIndex])),
+            VALUE_CLASSES);
+        cursor.lastValues[valueIndex] = values[valueIndex];
+    }
+    cursor.bitPosition   = writer.getBitPosition();
+    block->lastTimestamp = point.timestamp;
+    block->pointCount.fetch_add(1, std::memory_order_release);
+}
+
+uint32_t PositionHistory::allocateBlock(SeatId seat, HistoryResolution resolution,
+                                        int64_t timestamp) {
+    const auto index      = static_cast<std::size_t>(resolution);
+    const auto blockIndex = m_nextBlocks[index];
+    m_nextBlocks[index]   = (blockIndex + 1) % m_config.blockCounts[index];
+
+    // The oldest block is overwritten, possibly the one the other seat is appending to
+    for (auto& cursors : m_cursors) {
+        if (cursors[index].block == blockIndex) {
+            cursors[index].block.reset();
+        }
+    }
+
+    auto* block     = getBlock(resolution, blockIndex);
+    block->sequence = 0;
+    block->pointCount.store(0, std::memory_order_release);
+    block->payload.fill(0);
+    block->seat           = static_cast<uint8_t>(toIndex(seat));
+    block->resolution     = static_cast<uint8_t>(index);
+    block->firstTimestamp = timestamp;
+    block->lastTimestamp  = timestamp;
+    std::atomic_thread_fence(std::memory_order_release);
+    block->sequence = ++m_sequence;
+    return blockIndex;
+}
+
+void PositionHistory::addToBucket(SeatId seat, HistoryResolution resolution, const Point& point) {
+    const auto start  = getBucketStart(point.timestamp, getBucketWidth(resolution));
+    auto&      bucket = m_buckets[toIndex(seat)][static_cast<std::size_t>(resolution)];
+    if (bucket.active && bucket.point.timestamp != start) {
+        flushBucket(seat, resolution);
+    }
+    if (!bucket.active) {
+        bucket.active          = true;
+        bucket.point           = point;
+        bucket.point.timestamp = start;
+        return;
+    }
+    merge(bucket.point, point);
+}
+
+void PositionHistory::flushBucket(SeatId seat, HistoryResolution resolution) {
+    const auto index  = static_cast<std::size_t>(resolution);
+    auto&      bucket = m_buckets[toIndex(seat)][index];
+    if (!bucket.active) {
+        return;
+    }
+    bucket.active = false;
+    writePoint(seat, resolution, bucket.point);
+    if (index + 1 < HISTORY_RESOLUTION_COUNT) {
+        addToBucket(seat, static_cast<HistoryResolution>(index + 1), bucket.point);
+    }
+}
+
+std::vector<PositionHistory::Point> PositionHistory::getPendingPoints(
+    SeatId seat, HistoryResolution resolution) const {
+    // The open bucket of each resolution has not been folded into the coarser ones yet
+    std::vector<Point> points;
+    for (std::size_t index = 1; index <= static_cast<std::size_t>(resolution); ++index) {
+        const auto&        bucket = m_buckets[toIndex(seat)][index];
+        const auto         width  = BUCKET_WIDTHS[index];
+        std::vector<Point> coarser;
+        if (bucket.active) {
+            coarser.push_back(bucket.point);
+        }
+        for (const auto& point : points) {
+            const auto start = getBucketStart(point.timestamp, width);
+            if (!coarser.empty() && coarser.back().timestamp == start) {
+                merge(coarser.back(), point);
+            } else {
+                coarser.push_back(point);
+                coarser.back().timestamp = start;
+            }
+        }
+        points = std::move(coarser);
+    }
+    return points;
+}
+
+std::vector<const PositionHistory::BlockHeader*>
+PositionHistory::getBlocks(SeatId seat, HistoryResolution resolution) const {
+    const auto                      index = static_cast<std::size_t>(resolution);
+    std::vector<const BlockHeader*> blocks;
+    for (uint32_t blockIndex = 0; blockIndex < m_config.blockCounts[index]; ++blockIndex) {
+        const auto* block = getBlock(resolution, blockIndex);
+        if (block->sequence != 0 && block->seat == toIndex(seat) && block->resolution == index) {
+            blocks.push_back(block);
+        }
+    }
+    std::sort(blocks.begin(), blocks.end(), [](const BlockHeader* lhs, const BlockHeader* rhs) {
+        return lhs->sequence < rhs->sequence;
+    });
+    return blocks;
+}
+
+bool PositionHistory::isFull(HistoryResolution resolution) const {
+    // Blocks are taken in order, so the ring has wrapped once the next one is in use
+    const auto index = static_cast<std::size_t>(resolution);
+    return getBlock(resolution, m_nextBlocks[index])->sequence != 0;
+}
+
+} // namespace example
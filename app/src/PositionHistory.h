@@ -0,0 +1,184 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_POSITIONHISTORY_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_POSITIONHISTORY_H
+
+#include "ProfiledMutex.h"
+#include "Seat.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace example {
+
+/**
+ * @brief Time resolutions kept by the PositionHistory, finest first.
+ */
+enum class HistoryResolution : uint8_t { Raw = 0, Minute = 1, Hour = 2 };
+
+constexpr std::size_t HISTORY_RESOLUTION_COUNT = 3;
+
+const char* toString(HistoryResolution resolution);
+
+std::optional<HistoryResolution> parseHistoryResolution(const std::string& name);
+
+/**
+ * @brief Compressed history of the seat positions in a memory-mapped ring file.
+ * @details Every reported position is stored at the raw resolution and folded
+ *      into per-minute buckets, which in turn are folded into per-hour buckets.
+ *      A bucket keeps the minimum, maximum and last position and the number of
+ *      reports. Each resolution has its own ring of fixed-size blocks in the file,
+ *      so the coarser resolutions outlive the raw reports by far: with the default
+ *      sizes the file has 2.6 MiB and holds weeks of raw reports of a normally
+ *      used seat, and years of hourly buckets.
+ *
+ *      Within a block, timestamps are stored as delta of deltas and positions as
+ *      deltas to the previous point, both with short prefix codes (as in
+ *      Facebook's Gorilla), so regular reports of a resting seat take a few bits.
+ *      Points are written in place and the block's point count is updated last,
+ *      so the file is consistent whenever the process dies. The bucket still
+ *      being filled per resolution is kept in memory and written on destruction.
+ *
+ *      Timestamps are milliseconds since the epoch. A timestamp before the
+ *      previous one of the seat (wall clock set back) is stored as the previous one.
+ *      All methods are thread-safe.
+ */
+class PositionHistory {
+public:
+    static constexpr std::size_t BLOCK_SIZE = 1024;
+
+    struct Config {
+        std::string path;
+        // Number of blocks per resolution, indexed by HistoryResolution
+        std::array<uint32_t, HISTORY_RESOLUTION_COUNT> blockCounts{2048, 512, 128};
+    };
+
+    /**
+     * @brief A raw report (min = max = last, count 1) or a bucket of reports.
+     */
+    struct Point {
+        int64_t  timestamp; // start of the bucket for Minute and Hour
+        int32_t  min;
+        int32_t  max;
+        int32_t  last;
+        uint32_t count;
+    };
+
+    struct Aggregate {
+        int32_t  min;
+        int32_t  max;
+        int32_t  last;
+        uint64_t count;
+    };
+
+    /**
+     * @brief Open or create the history file. Files of another layout are reset.
+     *
+     * @throws std::invalid_argument  If a resolution has less than two blocks.
+     * @throws std::system_error      If the file cannot be opened or mapped.
+     */
+    explicit PositionHistory(const Config& config);
+    ~PositionHistory();
+
+    PositionHistory(const PositionHistory&)            = delete;
+    PositionHistory& operator=(const PositionHistory&) = delete;
+
+    void append(SeatId seat, int64_t timestamp, int position);
+
+    /**
+     * @brief Return the points of the seat in [from, to] at the given resolution, oldest
+     *      first. Buckets are included if they overlap the range.
+     */
+    std::vector<Point> query(SeatId seat, int64_t from, int64_t to,
+                             HistoryResolution resolution) const;
+
+    /**
+     * @brief Return the finest resolution which still covers the start of the range and
+     *      has at most maxPoints points in it, or the coarsest one.
+     */
+    HistoryResolution selectResolution(SeatId seat, int64_t from, int64_t to,
+                                       std::size_t maxPoints) const;
+
+    /**
+     * @brief Combine points into their minimum, maximum, last position and report count.
+     */
+    static std::optional<Aggregate> aggregate(const std::vector<Point>& points);
+
+    /**
+     * @brief Return the number of blocks in use at a resolution.
+     */
+    std::size_t getUsedBlockCount(HistoryResolution resolution) const;
+
+    static int64_t getBucketWidth(HistoryResolution resolution);
+
+private:
+    struct FileHeader;
+    struct BlockHeader;
+
+    // Position of the block written next for a seat and resolution, and the codec state
+    struct Cursor {
+        std::optional<uint32_t> block;
+        std::size_t             bitPosition{0};
+        int64_t                 lastTimestamp{0};
+        int64_t                 lastDelta{0};
+        std::array<int64_t, 4>  lastValues{};
+    };
+
+    struct Bucket {
+        bool  active{false};
+        Point point{};
+    };
+
+    using Cursors = std::array<Cursor, HISTORY_RESOLUTION_COUNT>;
+    using Buckets = std::array<Bucket, HISTORY_RESOLUTION_COUNT>;
+
+    /**
+     * @brief Decode the points of a block, and return the codec state after its last point.
+     */
+    static Cursor decodeBlock(const BlockHeader& block, std::vector<Point>* points);
+
+    BlockHeader* getBlock(HistoryResolution resolution, uint32_t index) const;
+    bool         isFull(HistoryResolution resolution) const;
+    void         recover();
+    void         writePoint(SeatId seat, HistoryResolution resolution, const Point& point);
+    uint32_t     allocateBlock(SeatId seat, HistoryResolution resolution, int64_t timestamp);
+    void         addToBucket(SeatId seat, HistoryResolution resolution, const Point& point);
+    void         flushBucket(SeatId seat, HistoryResolution resolution);
+
+    std::vector<const BlockHeader*> getBlocks(SeatId seat, HistoryResolution resolution) const;
+    std::vector<Point>              getPendingPoints(SeatId            seat,
+                                                     HistoryResolution resolution) const;
+
+    const Config                                   m_config;
+    std::array<uint32_t, HISTORY_RESOLUTION_COUNT> m_firstBlocks{};
+    std::size_t                                    m_fileSize{0};
+    uint8_t*                                       m_mapping{nullptr};
+    mutable ProfiledMutex                          m_mutex{"PositionHistory"};
+    uint64_t                                       m_sequence{0};
+    std::array<uint32_t, HISTORY_RESOLUTION_COUNT> m_nextBlocks{};
+    std::array<Cursors, SEAT_COUNT>                m_cursors;
+    std::array<Buckets, SEAT_COUNT>                m_buckets;
+    std::array<int64_t, SEAT_COUNT>                m_lastTimestamps{};
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_POSITIONHISTORY_H
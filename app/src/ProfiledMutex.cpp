@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "ProfiledMutex.h"
+#include "Json.h"
+
+#ifdef APP_ENABLE_LOCK_PROFILING
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace example {
+
+namespace {
+
+// Plain std::mutex, the registry itself is not profiled
+std::mutex                                             registryMutex;
+std::map<std::string, std::unique_ptr<LockStatistics>> registry;
+
+std::size_t toBucket(uint64_t durationNs) {
+    std::size_t bucket = 0;
+    while (durationNs > 1 && bucket + 1 < DurationHistogram::BUCKET_COUNT) {
+        durationNs >>= 1U;
+        ++bucket;
+    }
+    return bucket;
+}
+
+} // namespace
+
+void DurationHistogram::record(std::chrono::nanoseconds duration) {
+    const auto durationNs = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+    m_buckets[toBucket(durationNs)].fetch_add(1, std::memory_order_relaxed);
+    m_totalNs.fetch_add(durationNs, std::memory_order_relaxed);
+
+    auto maxNs = m_maxNs.load(std::memory_order_relaxed);
+    while (durationNs > maxNs &&
+           !m_maxNs.compare_exchange_weak(maxNs, durationNs, std::memory_order_relaxed)) {
+    }
+}
+
+nlohmann::json DurationHistogram::toJson() const {
+    // Trailing empty buckets are omitted to keep the profile compact
+    std::vector<uint64_t> histogram;
+    for (std::size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+        const auto count = m_buckets[bucket].load(std::memory_order_relaxed);
+        if (count > 0) {
+            histogram.resize(bucket + 1);
+            histogram[bucket] = count;
+        }
+    }
+
+    return {{"totalNs", m_totalNs.load(std::memory_order_relaxed)},
+            {"maxNs", m_maxNs.load(std::memory_order_relaxed)},
+            {"log2NsHistogram", histogram}};
+}
+
+LockStatistics& getLockStatistics(const char* name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto&                       statistics = registry[name];
+    if (!statistics) {
+        statistics = std::make_unique<LockStatistics>();
+    }
+    return *statistics;
+}
+
+nlohmann::json getLockProfile() {
+    auto                        profile = nlohmann::json::object();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& [name, statistics] : registry) {
+        profile[name] = {
+            {"acquisitions", statistics->acquisitions.load(std::memory_order_relaxed)},
+            {"contentions", statistics->contentions.load(std::memory_order_relaxed)},
+            {"waitTime", statistics->waitTime.toJson()},
+            {"holdTime", statistics->holdTime.toJson()}};
+    }
+    return profile;
+}
+
+void ProfiledMutex::lockContended() {
+    const auto waitStart = Clock::now();
+    m_mutex.lock();
+    m_statistics.contentions.fetch_add(1, std::memory_order_relaxed);
+    m_statistics.waitTime.record(Clock::now() - waitStart);
+}
+
+} // namespace example
+
+#endif
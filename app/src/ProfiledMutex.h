@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_PROFILEDMUTEX_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_PROFILEDMUTEX_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#ifdef APP_ENABLE_LOCK_PROFILING
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <nlohmann/json_fwd.hpp>
+#endif
+
+namespace example {
+
+#ifdef APP_ENABLE_LOCK_PROFILING
+
+/**
+ * @brief Histogram of durations with power of two buckets.
+ * @details Bucket i counts durations within [2^i, 2^(i+1)) ns, the last bucket
+ *      everything above. Recording is lock-free.
+ */
+class DurationHistogram {
+public:
+    static constexpr std::size_t BUCKET_COUNT = 32;
+
+    void record(std::chrono::nanoseconds duration);
+
+    nlohmann::json toJson() const;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets{};
+    std::atomic<uint64_t>                           m_totalNs{0};
+    std::atomic<uint64_t>                           m_maxNs{0};
+};
+
+/**
+ * @brief Profile of all locks sharing a name.
+ */
+struct LockStatistics {
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> contentions{0};
+    DurationHistogram     waitTime;
+    DurationHistogram     holdTime;
+};
+
+/**
+ * @brief Return the statistics of the locks with the given name.
+ *      The returned reference stays valid for the lifetime of the process.
+ */
+LockStatistics& getLockStatistics(const char* name);
+
+/**
+ * @brief Return the profile of all locks created so far, by lock name.
+ */
+nlohmann::json getLockProfile();
+
+#endif
+
+/**
+ * @brief Mutex recording wait time, hold time and contention per lock name.
+ * @details Only built with APP_ENABLE_LOCK_PROFILING, otherwise this is a
+ *      plain std::mutex and the name is ignored. Instances of a class should
+ *      share the name, e.g. the class name, so they are profiled together.
+ *
+ *      Acquiring a lock which is free is not counted as waiting, so
+ *      uncontended locks only pay for taking the time stamps.
+ */
+class ProfiledMutex {
+public:
+#ifdef APP_ENABLE_LOCK_PROFILING
+    explicit ProfiledMutex(const char* name)
+        : m_statistics(getLockStatistics(name)) {}
+#else
+    explicit ProfiledMutex(const char* /*name*/) {}
+#endif
+
+    ProfiledMutex(const ProfiledMutex&)            = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock() {
+#ifdef APP_ENABLE_LOCK_PROFILING
+        if (!m_mutex.try_lock()) {
+            lockContended();
+        }
+        onAcquired();
+#else
+        m_mutex.lock();
+#endif
+    }
+
+    bool try_lock() {
+#ifdef APP_ENABLE_LOCK_PROFILING
+        if (!m_mutex.try_lock()) {
+            return false;
+        }
+        onAcquired();
+        return true;
+#else
+        return m_mutex.try_lock();
+#endif
+    }
+
+    void unlock() {
+#ifdef APP_ENABLE_LOCK_PROFILING
+        onReleasing();
+#endif
+        m_mutex.unlock();
+    }
+
+private:
+    friend class ProfiledConditionVariable;
+
+#ifdef APP_ENABLE_LOCK_PROFILING
+    using Clock = std::chrono::steady_clock;
+
+    void lockContended();
+
+    void onAcquired() {
+        m_statistics.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        m_acquiredAt = Clock::now();
+    }
+
+    void onReleasing() { m_statistics.holdTime.record(Clock::now() - m_acquiredAt); }
+
+    LockStatistics&   m_statistics;
+    Clock::time_point m_acquiredAt; // only accessed by the owner of the lock
+#endif
+    std::mutex m_mutex;
+};
+
+/**
+ * @brief Condition variable to be used with ProfiledMutex.
+ * @details Waiting on the condition is not counted as lock wait time, the hold
+ *      time is interrupted while waiting.
+ */
+class ProfiledConditionVariable {
+public:
+    void notify_one() noexcept { m_condition.notify_one(); }
+    void notify_all() noexcept { m_condition.notify_all(); }
+
+    void wait(std::unique_lock<ProfiledMutex>& lock) {
+        waitNative(lock, [this](auto& nativeLock) {
+            m_condition.wait(nativeLock);
+            return std::cv_status::no_timeout;
+        });
+    }
+
+    template <typename TClock, typename TDuration>
+    std::cv_status wait_until(std::unique_lock<ProfiledMutex>&                 lock,
+                              const std::chrono::time_point<TClock, TDuration>& deadline) {
+        return waitNative(lock, [this, &deadline](auto& nativeLock) {
+            return m_condition.wait_until(nativeLock, deadline);
+        });
+    }
+
+    template <typename TRep, typename TPeriod>
+    std::cv_status wait_for(std::unique_lock<ProfiledMutex>&           lock,
+                            const std::chrono::duration<TRep, TPeriod>& timeout) {
+        return waitNative(lock, [this, &timeout](auto& nativeLock) {
+            return m_condition.wait_for(nativeLock, timeout);
+        });
+    }
+
+private:
+    // Wait on the std::mutex wrapped by the locked ProfiledMutex
+    template <typename TWait>
+    std::cv_status waitNative(std::unique_lock<ProfiledMutex>& lock, TWait wait) {
+        auto& mutex = *lock.mutex();
+#ifdef APP_ENABLE_LOCK_PROFILING
+        mutex.onReleasing();
+#endif
+        std::unique_lock<std::mutex> nativeLock(mutex.m_mutex, std::adopt_lock);
+        const auto                   status = wait(nativeLock);
+        nativeLock.release();
+#ifdef APP_ENABLE_LOCK_PROFILING
+        mutex.onAcquired();
+#endif
+        return status;
+    }
+
+    std::condition_variable m_condition;
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_PROFILEDMUTEX_H
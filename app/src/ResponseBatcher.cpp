@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "ResponseBatcher.h"
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace example {
+
+ResponseBatcher::ResponseBatcher(const Config& config, TimerService& timerService,
+                                 PublishCallback publish)
+    : m_config(config)
+    , m_timerService(timerService)
+    , m_publish(std::move(publish)) {
+    if (config.window <= std::chrono::milliseconds::zero()) {
+        throw std::invalid_argument("Response batch window has to be positive");
+    }
+    if (config.maxEntries == 0) {
+        throw std::invalid_argument("Response batches need room for at least one entry");
+    }
+}
+
+ResponseBatcher::~ResponseBatcher() {
+    // Pending batches are dropped like the requests still queued at shutdown. The timers are
+    // cancelled outside the lock, as cancel() waits for a running onWindowElapsed().
+    std::vector<TimerService::TimerId> timerIds;
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        for (const auto& [topic, batch] : m_batches) {
+            timerIds.push_back(batch.timerId);
+        }
+        m_batches.clear();
+    }
+    for (const auto timerId : timerIds) {
+        m_timerService.cancel(timerId);
+    }
+}
+
+void ResponseBatcher::add(const std::string& topic, const std::string& response) {
+    std::string           payload;
+    TimerService::TimerId timerId;
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        auto [iterator, isNew] = m_batches.try_emplace(topic);
+        auto& batch            = iterator->second;
+        if (isNew) {
+            batch.payload.reserve(m_config.maxEntries * (response.size() + 1) + 1);
+            batch.payload += '[';
+            batch.deadline = m_timerService.now() + m_config.window;
+            batch.timerId  = m_timerService.scheduleAt(
+                batch.deadline, [this, topic]() { onWindowElapsed(topic); });
+        } else {
+            batch.payload += ',';
+        }
+        batch.payload += response;
+        if (++batch.entryCount < m_config.maxEntries) {
+            return;
+        }
+
+        timerId = batch.timerId;
+        payload = std::move(batch.payload);
+        m_batches.erase(iterator);
+    }
+    // Outside the lock, as cancel() waits for a running onWindowElapsed()
+    m_timerService.cancel(timerId);
+    payload += ']';
+    m_publish(topic, payload);
+}
+
+void ResponseBatcher::onWindowElapsed(const std::string& topic) {
+    std::string payload;
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        const auto                     iterator = m_batches.find(topic);
+        // The batch may have been published full meanwhile, and a younger one started
+        if (iterator == m_batches.end() || iterator->second.deadline > m_timerService.now()) {
+            return;
+        }
+        payload = std::move(iterator->second.payload);
+        m_batches.erase(iterator);
+    }
+    payload += ']';
+    m_publish(topic, payload);
+}
+
+} // namespace example
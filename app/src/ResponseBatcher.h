@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_RESPONSEBATCHER_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_RESPONSEBATCHER_H
+
+#include "ProfiledMutex.h"
+#include "TimerService.h"
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace example {
+
+/**
+ * @brief Accumulates response payloads per topic and publishes them as one JSON array.
+ * @details A batch is published once it holds maxEntries responses or the window
+ *      after its first response has passed, whichever comes first. The window timer
+ *      runs on the TimerService, so batches are published from its thread as well as
+ *      from the thread adding the last entry of a full batch. Consecutive batches of
+ *      a topic may therefore overtake each other; the entries carry their own
+ *      correlation ids.
+ *
+ *      A topic only has state while a batch is pending, so the memory is bounded by
+ *      the number of clients with responses in flight.
+ */
+class ResponseBatcher {
+public:
+    using PublishCallback =
+        std::function<void(const std::string& topic, const std::string& payload)>;
+
+    struct Config {
+        std::chrono::milliseconds window{20};
+        std::size_t               maxEntries{100};
+    };
+
+    /**
+     * @throws std::invalid_argument if the window is not positive or maxEntries is zero.
+     */
+    ResponseBatcher(const Config& config, TimerService& timerService, PublishCallback publish);
+    ~ResponseBatcher();
+
+    ResponseBatcher(const ResponseBatcher&)            = delete;
+    ResponseBatcher& operator=(const ResponseBatcher&) = delete;
+
+    /**
+     * @brief Add a serialized response (a JSON object) to the pending batch of the topic.
+     */
+    void add(const std::string& topic, const std::string& response);
+
+    const Config& getConfig() const { return m_config; }
+
+private:
+    struct Batch {
+        std::string                     payload;
+        std::size_t                     entryCount{0};
+        TimerService::Clock::time_point deadline;
+        TimerService::TimerId           timerId{0};
+    };
+
+    void onWindowElapsed(const std::string& topic);
+
+    const Config                           m_config;
+    TimerService&                          m_timerService;
+    PublishCallback                        m_publish;
+    ProfiledMutex                          m_mutex{"ResponseBatcher"};
+    std::unordered_map<std::string, Batch> m_batches;
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_RESPONSEBATCHER_H
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_SEAT_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_SEAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace example {
+
+/**
+ * @brief Seats which can be controlled by the SeatAdjuster.
+ */
+enum class SeatId : uint8_t { Driver = 0, CoDriver = 1 };
+
+constexpr std::size_t SEAT_COUNT = 2;
+
+/**
+ * @brief Frontmost and rearmost seat positions as defined by
+ *      Vehicle.Cabin.Seat.*.Position (0 = frontmost).
+ */
+constexpr int SEAT_POSITION_MIN = 0;
+constexpr int SEAT_POSITION_MAX = 1000;
+
+constexpr std::size_t toIndex(SeatId seat) { return static_cast<std::size_t>(seat); }
+
+constexpr const char* toString(SeatId seat) {
+    return seat == SeatId::Driver ? "Driver" : "CoDriver";
+}
+
+/**
+ * @brief Where a seat command originates from, e.g. for auditing.
+ */
+enum class CommandSource : uint8_t {
+    Mqtt        = 1,
+    HoldToMove  = 2,
+    Grpc        = 3,
+    Uds         = 4,
+    Automation  = 5,
+    LeaseExpiry = 6,
+};
+
+constexpr const char* toString(CommandSource source) {
+    switch (source) {
+    case CommandSource::Mqtt:
+        return "mqtt";
+    case CommandSource::HoldToMove:
+        return "holdToMove";
+    case CommandSource::Grpc:
+        return "grpc";
+    case CommandSource::Uds:
+        return "uds";
+    case CommandSource::Automation:
+        return "automation";
+    case CommandSource::LeaseExpiry:
+        return "leaseExpiry";
+    }
+    return "unknown";
+}
+
+constexpr int STATUS_OK   = 0;
+constexpr int STATUS_FAIL = 1;
+
+/**
+ * @brief Outcome of a seat request, independent of the interface it was received on.
+ */
+struct SeatRequestResult {
+    int         status;
+    std::string message;
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_SEAT_H
@@ -0,0 +1,988 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "SeatAdjuster.h"
+#include "Json.h"
+#include "ProfiledMutex.h"
+#include "ThreadStatistics.h"
+#include "payloads/ActuatorCurrentValue.h"
+#include "payloads/ActuatorRequest.h"
+#include "payloads/ActuatorResponse.h"
+#include "payloads/CurrentPosition.h"
+#include "payloads/MoveSeatRequest.h"
+#include "payloads/MoveSeatResponse.h"
+#include "payloads/PositionHistoryRequest.h"
+#include "payloads/PositionHistoryResponse.h"
+#include "payloads/PositionResyncRequest.h"
+#include "payloads/PositionResyncResponse.h"
+#include "payloads/PositionUnavailable.h"
+#include "payloads/PowerMetrics.h"
+#include "payloads/RequestError.h"
+#include "payloads/SetPositionRequest.h"
+#include "payloads/SetPositionResponse.h"
+#include "sdk/Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <fmt/core.h>
+#include <limits>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+namespace example {
+
+const auto MOVE_ACTION_START     = "start";
+const auto MOVE_ACTION_HEARTBEAT = "heartbeat";
+const auto MOVE_ACTION_STOP      = "stop";
+
+const auto MOVE_DIRECTION_FORWARD  = "forward";
+const auto MOVE_DIRECTION_BACKWARD = "backward";
+
+// Clients are expected to send heartbeats at least twice per lease duration
+constexpr auto MOVE_LEASE_DURATION = std::chrono::milliseconds(500);
+
+constexpr auto STATISTICS_PUBLISH_INTERVAL      = std::chrono::minutes(15);
+constexpr auto IDLE_STATISTICS_PUBLISH_INTERVAL = std::chrono::hours(1);
+
+constexpr auto THREAD_STATISTICS_PUBLISH_INTERVAL = std::chrono::minutes(1);
+
+// Without any seat activity for this long, the SeatAdjuster goes idle
+constexpr auto IDLE_TIMEOUT = std::chrono::minutes(5);
+
+// Retries of a set position request within this time are not executed again
+constexpr auto IDEMPOTENCY_RETENTION = std::chrono::minutes(1);
+
+// A snapshot older than this is not restored, the seats may have been moved meanwhile
+constexpr auto SNAPSHOT_MAX_AGE          = std::chrono::minutes(1);
+constexpr auto SNAPSHOT_PERSIST_INTERVAL = std::chrono::seconds(1);
+
+// Nothing changes while idle, the snapshot only has to stay fresh for a standby to take over
+constexpr auto IDLE_SNAPSHOT_PERSIST_INTERVAL = std::chrono::seconds(SNAPSHOT_MAX_AGE) / 2;
+
+// Larger history query results are thinned out to a coarser resolution or truncated
+constexpr std::size_t MAX_HISTORY_QUERY_POINTS = 5000;
+
+// Metrics jobs may run this fraction of their period late, so their wakeups can be coalesced
+constexpr int PERIODIC_JOB_SLACK_DIVISOR = 10;
+
+#ifdef APP_ENABLE_LOCK_PROFILING
+constexpr auto LOCK_PROFILE_PUBLISH_INTERVAL = std::chrono::minutes(1);
+#endif
+
+namespace {
+
+const char* getResponseTopic(SeatId seat) {
+    return seat == SeatId::Driver ? TOPIC_Driver_RESPONSE : TOPIC_CoDriver_RESPONSE;
+}
+
+const char* getMoveResponseTopic(SeatId seat) {
+    return seat == SeatId::Driver ? TOPIC_Driver_MOVE_RESPONSE : TOPIC_CoDriver_MOVE_RESPONSE;
+}
+
+const char* getResyncResponseTopic(SeatId seat) {
+    return seat == SeatId::Driver ? TOPIC_Driver_RESYNC_RESPONSE : TOPIC_CoDriver_RESYNC_RESPONSE;
+}
+
+const char* getHistoryResponseTopic(SeatId seat) {
+    return seat == SeatId::Driver ? TOPIC_Driver_HISTORY_RESPONSE
+                                  : TOPIC_CoDriver_HISTORY_RESPONSE;
+}
+
+const char* getCurrentPositionTopic(SeatId seat) {
+    return seat == SeatId::Driver ? TOPIC_CURRENT_Driver_POSITION
+                                  : TOPIC_CURRENT_CoDriver_POSITION;
+}
+
+// MQTT wildcards and level separators would make the topic match other clients
+bool isTopicLevel(const std::string& name) {
+    return !name.empty() && name.find_first_of("+#/") == std::string::npos;
+}
+
+// The request id is optional in move requests
+uint32_t toAuditRequestId(std::optional<int32_t> requestId) {
+    return static_cast<uint32_t>(requestId.value_or(0));
+}
+
+// The history is meant for diagnostics, so it is recorded in wall clock time
+int64_t getWallClockMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// Tells the position sequences of this instance from those of earlier ones
+uint32_t generatePositionEpoch() {
+    std::random_device randomDevice;
+    return randomDevice();
+}
+
+TimerService::Clock::time_point fromTicks(int64_t ticks) {
+    return TimerService::Clock::time_point(TimerService::Clock::duration(ticks));
+}
+
+uint8_t toSnapshotDirection(std::optional<MoveDirection> direction) {
+    if (!direction) {
+        return StateSnapshot::MOVE_NONE;
+    }
+    return *direction == MoveDirection::Forward ? StateSnapshot::MOVE_FORWARD
+                                                : StateSnapshot::MOVE_BACKWARD;
+}
+
+std::pair<AuditRecordKind, int32_t> encodeAuditValue(const ActuatorEngine::Actuator& actuator,
+                                                     const SignalValue&              value) {
+    if (const auto* text = std::get_if<std::string>(&value)) {
+        const auto& allowed = actuator.allowedValues;
+        const auto  found   = std::find(allowed.begin(), allowed.end(), *text);
+        return {AuditRecordKind::ActuatorText,
+                found == allowed.end() ? -1 : static_cast<int32_t>(found - allowed.begin())};
+    }
+    const auto number = static_cast<float>(
+        std::holds_alternative<bool>(value) ? (std::get<bool>(value) ? 1.0 : 0.0)
+                                            : std::get<double>(value));
+    int32_t bits = 0;
+    std::memcpy(&bits, &number, sizeof(bits));
+    return {AuditRecordKind::ActuatorNumber, bits};
+}
+
+} // namespace
+
+SeatAdjuster::SeatAdjuster(ISeatAdjusterBackend& backend, TimerService& timerService)
+    : m_backend(backend)
+    , m_timerService(timerService)
+    , m_usageStatistics(timerService.now())
+    , m_holdToMoveController(m_timerService, MOVE_LEASE_DURATION,
+                             [this](SeatId seat, HoldToMoveController::SessionId sessionId) {
+                                 onMoveLeaseExpired(seat, sessionId);
+                             })
+    , m_idempotencyCache(IDEMPOTENCY_RETENTION)
+    , m_idleMonitor(m_timerService, IDLE_TIMEOUT,
+                    [this](PowerMode mode) { onPowerModeChanged(mode); })
+    , m_powerMetricsSince(timerService.now())
+    , m_positionEpoch(generatePositionEpoch()) {
+    for (auto& position : m_currentPositions) {
+        position = POSITION_UNKNOWN;
+    }
+}
+
+SeatAdjuster::~SeatAdjuster() {
+    for (const auto timerId : m_periodicJobs) {
+        m_timerService.cancel(timerId);
+    }
+
+    std::vector<TimerService::TimerId> settleTimers;
+    {
+        std::lock_guard<ProfiledMutex> lock(m_positionFilterMutex);
+        for (auto& settling : m_positionSettling) {
+            if (settling.timerId) {
+                settleTimers.push_back(*settling.timerId);
+                settling.timerId.reset();
+            }
+        }
+    }
+    for (const auto timerId : settleTimers) {
+        m_timerService.cancel(timerId);
+    }
+}
+
+void SeatAdjuster::start() {
+    schedulePeriodicJobs(PowerMode::Active);
+    m_idleMonitor.start();
+}
+
+void SeatAdjuster::schedulePeriodicJobs(PowerMode mode) {
+    // No locking needed: called by start() and afterwards only by the serialized mode changes.
+    // cancel() waits for a running job, none of which takes the IdleMonitor lock held here.
+    for (const auto timerId : m_periodicJobs) {
+        m_timerService.cancel(timerId);
+    }
+    m_periodicJobs.clear();
+
+    const auto schedule = [this](TimerService::Clock::duration period, auto&& callback) {
+        m_periodicJobs.push_back(
+            m_timerService.schedulePeriodic(period, std::forward<decltype(callback)>(callback),
+                                            period / PERIODIC_JOB_SLACK_DIVISOR));
+    };
+
+    if (m_snapshotFile) {
+        schedule(mode == PowerMode::Idle ? IDLE_SNAPSHOT_PERSIST_INTERVAL
+                                         : SNAPSHOT_PERSIST_INTERVAL,
+                 [this]() { persistSnapshot(); });
+    }
+
+    if (mode == PowerMode::Idle) {
+        schedule(IDLE_STATISTICS_PUBLISH_INTERVAL, [this]() {
+            publishStatistics();
+            publishPowerMetrics(PowerMode::Idle);
+        });
+        return;
+    }
+
+    schedule(STATISTICS_PUBLISH_INTERVAL, [this]() {
+        publishStatistics();
+        publishPowerMetrics(PowerMode::Active);
+    });
+    schedule(THREAD_STATISTICS_PUBLISH_INTERVAL, [this]() {
+        m_backend.publish(TOPIC_THREAD_STATISTICS, sampleThreadStatistics().dump());
+    });
+#ifdef APP_ENABLE_LOCK_PROFILING
+    schedule(LOCK_PROFILE_PUBLISH_INTERVAL, [this]() {
+        m_backend.publish(TOPIC_LOCK_PROFILE, getLockProfile().dump());
+    });
+#endif
+}
+
+void SeatAdjuster::onPowerModeChanged(PowerMode mode) {
+    velocitas::logger().info("Entering {} mode", toString(mode));
+    // Idle mode is only entered on the timer thread, so this is the single snapshot writer still
+    if (m_snapshotFile && mode == PowerMode::Idle) {
+        persistSnapshot();
+    }
+    publishPowerMetrics(mode);
+    schedulePeriodicJobs(mode);
+}
+
+void SeatAdjuster::publishPowerMetrics(PowerMode mode) {
+    payloads::PowerMetrics metrics;
+    {
+        std::lock_guard<ProfiledMutex> lock(m_powerMetricsMutex);
+        const auto                  now     = m_timerService.now();
+        const auto                  wakeups = m_timerService.getWakeupCount();
+        const auto                  elapsed =
+            std::chrono::duration_cast<std::chrono::duration<double>>(now - m_powerMetricsSince);
+
+        metrics.mode         = toString(mode);
+        metrics.timerWakeups = wakeups - m_powerMetricsSinceWakeups;
+        metrics.wakeupsPerSecond =
+            elapsed.count() > 0 ? metrics.timerWakeups / elapsed.count() : 0.0;
+
+        m_powerMetricsSince        = now;
+        m_powerMetricsSinceWakeups = wakeups;
+    }
+    m_backend.publish(TOPIC_POWER_METRICS, payloads::serialize(metrics));
+}
+
+void SeatAdjuster::onSetPositionRequestReceived(SeatId seat, const std::string& data) {
+    // Use the logger with the preferred log level (e.g. debug, info, error, etc)
+    velocitas::logger().debug("position request: \"{}\"", data);
+
+    // Parse the received JSON data
+    payloads::SetPositionRequest request;
+    if (auto error = payloads::parse(data, request)) {
+        velocitas::logger().error("Invalid position request: {}", *error);
+        m_backend.publish(getResponseTopic(seat),
+                          payloads::serialize(payloads::RequestError{
+                              std::nullopt, STATUS_FAIL,
+                              fmt::format("Invalid request: {}", *error)}));
+        return;
+    }
+
+    // Check if the received JSON data contains the required fields
+    if (!request.position) {
+        const auto errorMsg = fmt::format("No position specified");
+        velocitas::logger().error(errorMsg);
+
+        publishSetPositionResponse(seat, request,
+                                   payloads::serialize(payloads::RequestError{
+                                       request.requestId, STATUS_FAIL, errorMsg,
+                                       request.correlationId}));
+        return;
+    }
+
+    if (auto rejection =
+            dispatchRequest(seat, request.clientId, data.size(),
+                            [this, seat, request]() { handleSetPositionRequest(seat, request); })) {
+        publishSetPositionResponse(seat, request,
+                                   payloads::serialize(payloads::RequestError{
+                                       request.requestId, STATUS_FAIL, *rejection,
+                                       request.correlationId}));
+    }
+}
+
+void SeatAdjuster::handleSetPositionRequest(SeatId                              seat,
+                                            const payloads::SetPositionRequest& request) {
+    const auto desiredSeatPosition = *request.position;
+    const auto requestId           = request.requestId;
+
+    payloads::SetPositionResponse response{requestId, {}, request.correlationId};
+
+    const auto now = m_timerService.now();
+    if (const auto status = m_idempotencyCache.find(seat, requestId, desiredSeatPosition, now)) {
+        velocitas::logger().info("Request {} has already been handled, not repeating it",
+                                 requestId);
+        response.result = {*status, fmt::format("Request {} has already been handled", requestId)};
+        publishSetPositionResponse(seat, request, payloads::serialize(response));
+        return;
+    }
+
+    const auto result = requestSeatPosition(seat, desiredSeatPosition, CommandSource::Mqtt,
+                                            static_cast<uint32_t>(requestId));
+    // A refused request (e.g. while driving) is evaluated again when it is retried
+    if (result.status == STATUS_OK) {
+        m_idempotencyCache.insert({seat, requestId, desiredSeatPosition, result.status, now});
+    }
+
+    response.result = {result.status, result.message};
+
+    // Publish the response to the MQTT topic
+    publishSetPositionResponse(seat, request, payloads::serialize(response));
+}
+
+void SeatAdjuster::publishSetPositionResponse(SeatId                              seat,
+                                              const payloads::SetPositionRequest& request,
+                                              const std::string&                  payload) {
+    if (m_responseBatcher && request.batchResponse.value_or(false) && request.clientId &&
+        isTopicLevel(*request.clientId)) {
+        m_responseBatcher->add(TOPIC_BATCHED_RESPONSES_PREFIX + *request.clientId, payload);
+        return;
+    }
+    m_backend.publish(getResponseTopic(seat), payload);
+}
+
+std::optional<std::string> SeatAdjuster::dispatchRequest(std::optional<SeatId>             seat,
+                                                         const std::optional<std::string>& clientId,
+                                                         std::size_t                       cost,
+                                                         FairRequestQueue::Task handler) {
+    const auto runOnExecutor = [this, seat](FairRequestQueue::Task task) {
+        if (seat) {
+            m_backend.runForSeat(*seat, std::move(task));
+        } else {
+            m_backend.runForActuators(std::move(task));
+        }
+    };
+
+    auto* requestQueue = m_requestQueues[seat ? toIndex(*seat) : SEAT_COUNT].get();
+    if (requestQueue == nullptr) {
+        runOnExecutor(std::move(handler));
+        return std::nullopt;
+    }
+
+    // The queue only decides the order, each admitted request makes the executor run
+    // the next one in turn
+    const auto client = clientId ? std::string_view(*clientId) : std::string_view();
+    switch (requestQueue->submit(client, cost, std::move(handler))) {
+    case FairRequestQueue::Admission::Queued:
+        runOnExecutor([requestQueue]() { requestQueue->runNext(); });
+        return std::nullopt;
+    case FairRequestQueue::Admission::RateLimited:
+        // Debug level only, an abusive client would flood the log otherwise
+        velocitas::logger().debug("Request of client \"{}\" exceeds its rate", client);
+        return fmt::format("Rate limit of {} requests per second exceeded",
+                           client.empty() ? requestQueue->getConfig().anonymousRate
+                                          : requestQueue->getConfig().rate);
+    case FairRequestQueue::Admission::QueueFull:
+        velocitas::logger().debug("Too many pending requests of client \"{}\"", client);
+        return std::string("Too many pending requests");
+    }
+    return std::nullopt;
+}
+
+bool SeatAdjuster::onSeatPositionChanged(SeatId seat, int position) {
+    if (!m_positionFilter) {
+        publishPosition(seat, position);
+        return true;
+    }
+
+    // Filtering and publishing are serialized with the settle timers of the seats
+    std::lock_guard<ProfiledMutex> lock(m_positionFilterMutex);
+    const auto                     filtered = m_positionFilter->update(seat, position);
+    const auto&                    config   = m_positionFilter->getConfig();
+    if (config.mode == PositionFilter::Mode::Median) {
+        // Postponing a pending timer on every report would cost more than checking on expiry
+        auto& settling      = m_positionSettling[toIndex(seat)];
+        settling.lastReport = m_timerService.now();
+        if (!settling.timerId) {
+            settling.timerId =
+                m_timerService.scheduleAt(settling.lastReport + config.settleTime,
+                                          [this, seat]() { onPositionSettleTimer(seat); });
+        }
+    }
+    if (!filtered) {
+        return false;
+    }
+    publishPosition(seat, *filtered);
+    return true;
+}
+
+void SeatAdjuster::onPositionSettleTimer(SeatId seat) {
+    std::lock_guard<ProfiledMutex> lock(m_positionFilterMutex);
+    auto&                          settling = m_positionSettling[toIndex(seat)];
+    if (!settling.timerId) {
+        return; // cancelled on destruction
+    }
+    const auto deadline = settling.lastReport + m_positionFilter->getConfig().settleTime;
+    if (m_timerService.now() < deadline) {
+        settling.timerId = m_timerService.scheduleAt(
+            deadline, [this, seat]() { onPositionSettleTimer(seat); });
+        return;
+    }
+
+    settling.timerId.reset();
+    if (const auto settled = m_positionFilter->settle(seat)) {
+        publishPosition(seat, *settled);
+    }
+}
+
+void SeatAdjuster::publishPosition(SeatId seat, int position) {
+    m_idleMonitor.onActivity();
+    m_currentPositions[toIndex(seat)] = position;
+    m_usageStatistics.onPositionChanged(seat, position, m_timerService.now());
+
+    // Publish the current seat position to the MQTT topic
+    {
+        std::lock_guard<ProfiledMutex> lock(m_positionStreamMutex);
+        auto&                          published = m_publishedPositions[toIndex(seat)];
+        published.position                       = position;
+        ++published.sequence;
+        m_backend.publish(getCurrentPositionTopic(seat),
+                          payloads::serialize(payloads::CurrentPosition{
+                              position, published.sequence, m_positionEpoch}));
+    }
+    if (m_positionHistory) {
+        m_positionHistory->append(seat, getWallClockMillis(), position);
+    }
+    m_backend.onPositionPublished(seat, position);
+}
+
+void SeatAdjuster::onSeatPositionUnavailable(SeatId seat, const std::string& reason) {
+    velocitas::logger().warn("Unable to get Current Seat Position, Exception: {}", reason);
+    if (m_positionFilter) {
+        // The history is stale by the time the position can be read again
+        std::lock_guard<ProfiledMutex> lock(m_positionFilterMutex);
+        m_positionFilter->reset(seat);
+    }
+
+    std::lock_guard<ProfiledMutex> lock(m_positionStreamMutex);
+    auto&                          published = m_publishedPositions[toIndex(seat)];
+    published.position.reset();
+    ++published.sequence;
+    m_backend.publish(getCurrentPositionTopic(seat),
+                      payloads::serialize(payloads::PositionUnavailable{
+                          STATUS_FAIL, reason, published.sequence, m_positionEpoch}));
+}
+
+void SeatAdjuster::onPositionResyncRequestReceived(SeatId seat, const std::string& data) {
+    // The request carries nothing but its id, so even a malformed one is answered
+    payloads::PositionResyncRequest request;
+    if (auto error = payloads::parse(data, request)) {
+        velocitas::logger().error("Invalid position resync request: {}", *error);
+        request.requestId.reset();
+    }
+
+    std::lock_guard<ProfiledMutex> lock(m_positionStreamMutex);
+    const auto&                    published = m_publishedPositions[toIndex(seat)];
+    m_backend.publish(getResyncResponseTopic(seat),
+                      payloads::serialize(payloads::PositionResyncResponse{
+                          request.requestId, published.sequence, m_positionEpoch,
+                          published.position}));
+}
+
+void SeatAdjuster::onPositionHistoryRequestReceived(SeatId seat, const std::string& data) {
+    payloads::PositionHistoryResponse response;
+    const auto                        publishError = [&](const std::string& message) {
+        velocitas::logger().error("Position history query failed: {}", message);
+        response.status  = STATUS_FAIL;
+        response.message = message;
+        m_backend.publish(getHistoryResponseTopic(seat), payloads::serialize(response));
+    };
+
+    payloads::PositionHistoryRequest request;
+    if (auto error = payloads::parse(data, request)) {
+        publishError(fmt::format("Invalid request: {}", *error));
+        return;
+    }
+    response.requestId = request.requestId;
+    if (!m_positionHistory) {
+        publishError("Position history is disabled");
+        return;
+    }
+
+    const auto from = request.from.value_or(std::numeric_limits<int64_t>::min());
+    const auto to   = request.to.value_or(getWallClockMillis());
+    auto       resolution =
+        m_positionHistory->selectResolution(seat, from, to, MAX_HISTORY_QUERY_POINTS);
+    if (request.resolution) {
+        const auto requested = parseHistoryResolution(*request.resolution);
+        if (!requested) {
+            publishError(fmt::format("Unknown resolution \"{}\"", *request.resolution));
+            return;
+        }
+        resolution = *requested;
+    }
+
+    auto points         = m_positionHistory->query(seat, from, to, resolution);
+    response.status     = STATUS_OK;
+    response.resolution = toString(resolution);
+    if (request.aggregate.value_or(false)) {
+        const auto aggregate = PositionHistory::aggregate(points);
+        response.count       = aggregate ? aggregate->count : 0;
+        if (aggregate) {
+            response.min  = aggregate->min;
+            response.max  = aggregate->max;
+            response.last = aggregate->last;
+        }
+    } else {
+        if (points.size() > MAX_HISTORY_QUERY_POINTS) {
+            // The most recent points are the most interesting ones for diagnostics
+            points.erase(points.begin(), points.end() - MAX_HISTORY_QUERY_POINTS);
+            response.truncated = true;
+        }
+        auto& responsePoints = response.points.emplace();
+        responsePoints.reserve(points.size());
+        for (const auto& point : points) {
+            if (resolution == HistoryResolution::Raw) {
+                responsePoints.push_back({point.timestamp, point.last});
+            } else {
+                responsePoints.push_back(
+                    {point.timestamp, point.min, point.max, point.last, point.count});
+            }
+        }
+    }
+    m_backend.publish(getHistoryResponseTopic(seat), payloads::serialize(response));
+}
+
+void SeatAdjuster::onMoveSeatRequestReceived(SeatId seat, const std::string& data) {
+    // Payload format: {"requestId": 1, "action": "start", "direction": "forward"}
+    //                 {"action": "heartbeat"}
+    //                 {"requestId": 2, "action": "stop"}
+    velocitas::logger().debug("move request: \"{}\"", data);
+    m_idleMonitor.onActivity();
+
+    payloads::MoveSeatRequest request;
+    if (auto error = payloads::parse(data, request)) {
+        const auto errorMsg = fmt::format("Invalid request: {}", *error);
+        velocitas::logger().error(errorMsg);
+
+        m_backend.publish(getMoveResponseTopic(seat),
+                          payloads::serialize(payloads::MoveSeatResponse{
+                              request.requestId, {STATUS_FAIL, errorMsg}}));
+        return;
+    }
+
+    if (auto rejection =
+            dispatchRequest(seat, request.clientId, data.size(),
+                            [this, seat, request]() { handleMoveSeatRequest(seat, request); })) {
+        m_backend.publish(getMoveResponseTopic(seat),
+                          payloads::serialize(payloads::MoveSeatResponse{
+                              request.requestId, {STATUS_FAIL, *rejection}}));
+    }
+}
+
+void SeatAdjuster::handleMoveSeatRequest(SeatId seat, const payloads::MoveSeatRequest& request) {
+    const auto                 responseTopic = getMoveResponseTopic(seat);
+    const auto&                action        = request.action;
+    payloads::MoveSeatResponse response{request.requestId, {}};
+
+    // Heartbeats are the bulk of the traffic, so a renewed lease is not acknowledged
+    if (action == MOVE_ACTION_HEARTBEAT) {
+        if (!m_holdToMoveController.renew(seat)) {
+            response.result = {STATUS_FAIL, "No seat movement in progress"};
+            m_backend.publish(responseTopic, payloads::serialize(response));
+        }
+        return;
+    }
+
+    if (action == MOVE_ACTION_START) {
+        const auto directionName = request.direction.value_or(std::string());
+        if (directionName != MOVE_DIRECTION_FORWARD && directionName != MOVE_DIRECTION_BACKWARD) {
+            const auto errorMsg = fmt::format("Invalid direction \"{}\"", directionName);
+            velocitas::logger().error(errorMsg);
+
+            response.result = {STATUS_FAIL, errorMsg};
+            m_backend.publish(responseTopic, payloads::serialize(response));
+            return;
+        }
+
+        const auto direction = directionName == MOVE_DIRECTION_FORWARD ? MoveDirection::Forward
+                                                                       : MoveDirection::Backward;
+        // The lease is started first so heartbeats arriving meanwhile are not rejected
+        m_holdToMoveController.start(seat, direction);
+
+        // Position 0 is the frontmost position, so forward means moving to the minimum
+        auto result = requestSeatPosition(
+            seat, direction == MoveDirection::Forward ? SEAT_POSITION_MIN : SEAT_POSITION_MAX,
+            CommandSource::HoldToMove, toAuditRequestId(request.requestId));
+        if (result.status == STATUS_OK) {
+            result.message = fmt::format("Moving seat {}, lease duration {} ms", directionName,
+                                         m_holdToMoveController.getLeaseDuration().count());
+        } else {
+            m_holdToMoveController.stop(seat);
+        }
+
+        response.result = {result.status, result.message};
+    } else if (action == MOVE_ACTION_STOP) {
+        if (m_holdToMoveController.stop(seat)) {
+            stopSeat(seat, CommandSource::HoldToMove);
+            response.result = {STATUS_OK, "Seat movement stopped"};
+        } else {
+            response.result = {STATUS_FAIL, "No seat movement in progress"};
+        }
+    } else {
+        const auto errorMsg = fmt::format("Unknown action \"{}\"", action);
+        velocitas::logger().error(errorMsg);
+
+        response.result = {STATUS_FAIL, errorMsg};
+    }
+
+    m_backend.publish(responseTopic, payloads::serialize(response));
+}
+
+void SeatAdjuster::onMoveLeaseExpired(SeatId seat, HoldToMoveController::SessionId sessionId) {
+    // Executed on the timer thread once a client stopped sending heartbeats, the stop waits
+    // for the databroker and therefore runs on the seat's executor
+    m_backend.runForSeat(seat, [this, seat, sessionId]() {
+        // A move started after the expiry must not be stopped by it
+        if (!m_holdToMoveController.isCurrentSession(seat, sessionId)) {
+            return;
+        }
+        velocitas::logger().info("Move lease of {} seat expired, stopping seat", toString(seat));
+        stopSeat(seat, CommandSource::LeaseExpiry);
+
+        m_backend.publish(getMoveResponseTopic(seat),
+                          payloads::serialize(payloads::MoveSeatResponse{
+                              std::nullopt, {STATUS_OK, "Move lease expired, seat stopped"}}));
+    });
+}
+
+SeatRequestResult SeatAdjuster::requestSeatPosition(SeatId seat, int position,
+                                                    CommandSource source, uint32_t requestId) {
+    m_idleMonitor.onActivity();
+
+    // A command which cannot be audited is not executed
+    if (m_auditLog && m_auditLog->isFailing()) {
+        const auto errorMsg = std::string("Not allowed to move seat while the audit log fails");
+        velocitas::logger().warn(errorMsg);
+        m_usageStatistics.onRequest(seat, false);
+        m_auditLog->append(source, seat, position, STATUS_FAIL, requestId);
+        return {STATUS_FAIL, errorMsg};
+    }
+
+    const auto vehicleSpeed = m_backend.getVehicleSpeed();
+
+    // Check if the vehicle is not moving
+    if (vehicleSpeed != 0) {
+        const auto errorMsg = fmt::format(
+            "Not allowed to move seat because vehicle speed is {} and not 0", vehicleSpeed);
+        velocitas::logger().info(errorMsg);
+        m_usageStatistics.onRequest(seat, false);
+        if (m_auditLog) {
+            m_auditLog->append(source, seat, position, STATUS_FAIL, requestId);
+        }
+        return {STATUS_FAIL, errorMsg};
+    }
+
+    // Move the seat to the desired position
+    m_backend.setSeatPosition(seat, position);
+    m_usageStatistics.onRequest(seat, true);
+    if (m_auditLog) {
+        m_auditLog->append(source, seat, position, STATUS_OK, requestId);
+    }
+    return {STATUS_OK, fmt::format("Set Seat position to: {}", position)};
+}
+
+void SeatAdjuster::enableAutomation(std::unique_ptr<AutomationEngine> automationEngine) {
+    m_automationEngine = std::move(automationEngine);
+}
+
+void SeatAdjuster::onAutomationSignalChanged(const std::string& signal, const SignalValue& value) {
+    // Signals like open doors announce that someone is about to use the seats
+    m_idleMonitor.onActivity();
+    for (auto& action : m_automationEngine->onSignalChanged(signal, value)) {
+        // Moved in order with the seat's requests, not on the subscription's thread
+        const auto seat = action.seat;
+        m_backend.runForSeat(seat, [this, action = std::move(action)]() {
+            const auto result =
+                requestSeatPosition(action.seat, action.position, CommandSource::Automation);
+            velocitas::logger().info("Automation rule \"{}\" moved {} seat: {}",
+                                     action.ruleName, toString(action.seat), result.message);
+        });
+    }
+}
+
+void SeatAdjuster::enableActuators(std::unique_ptr<ActuatorEngine> actuatorEngine) {
+    m_actuatorEngine = std::move(actuatorEngine);
+}
+
+void SeatAdjuster::onActuatorRequestReceived(std::size_t actuatorIndex, const std::string& data) {
+    velocitas::logger().debug("actuator request: \"{}\"", data);
+    m_idleMonitor.onActivity();
+
+    const auto&               actuator = m_actuatorEngine->getActuators()[actuatorIndex];
+    payloads::ActuatorRequest request;
+    if (auto error = payloads::parse(data, request)) {
+        const auto errorMsg = fmt::format("Invalid request: {}", *error);
+        velocitas::logger().info(errorMsg);
+        publishActuatorResponse(actuator, request.requestId, STATUS_FAIL, errorMsg);
+        return;
+    }
+    if (!request.value) {
+        publishActuatorResponse(actuator, request.requestId, STATUS_FAIL, "No value specified");
+        return;
+    }
+
+    if (auto rejection =
+            dispatchRequest(std::nullopt, request.clientId, data.size(),
+                            [this, actuatorIndex, request]() {
+                                handleActuatorRequest(actuatorIndex, request);
+                            })) {
+        publishActuatorResponse(actuator, request.requestId, STATUS_FAIL, *rejection);
+    }
+}
+
+void SeatAdjuster::handleActuatorRequest(std::size_t                      actuatorIndex,
+                                         const payloads::ActuatorRequest& request) {
+    const auto& actuator  = m_actuatorEngine->getActuators()[actuatorIndex];
+    const auto  requestId = request.requestId;
+
+    // A command which cannot be audited is not executed
+    if (m_auditLog && m_auditLog->isFailing()) {
+        const auto errorMsg =
+            fmt::format("Not allowed to set {} while the audit log fails", actuator.name);
+        velocitas::logger().warn(errorMsg);
+        auditActuator(actuatorIndex, {requestId, *request.value}, STATUS_FAIL);
+        publishActuatorResponse(actuator, requestId, STATUS_FAIL, errorMsg);
+        return;
+    }
+
+    auto submission = m_actuatorEngine->submit(actuatorIndex, requestId, *request.value);
+    if (submission.error) {
+        velocitas::logger().info(*submission.error);
+        auditActuator(actuatorIndex, {requestId, *request.value}, STATUS_FAIL);
+        publishActuatorResponse(actuator, requestId, STATUS_FAIL, *submission.error);
+        return;
+    }
+    if (submission.superseded) {
+        // The superseded value is never written
+        auditActuator(actuatorIndex, *submission.superseded, STATUS_FAIL);
+        publishActuatorResponse(actuator, submission.superseded->requestId, STATUS_FAIL,
+                                fmt::format("Superseded by request {}", requestId));
+    }
+    // Otherwise the request is queued and written by the thread of the write in flight
+    if (submission.write) {
+        writeActuator(actuatorIndex, std::move(*submission.write));
+    }
+}
+
+void SeatAdjuster::writeActuator(std::size_t actuatorIndex, ActuatorEngine::Write write) {
+    const auto&                          actuator = m_actuatorEngine->getActuators()[actuatorIndex];
+    std::optional<ActuatorEngine::Write> next     = std::move(write);
+    while (next) {
+        std::string valueText;
+        payloads::appendJson(valueText, next->value);
+        try {
+            m_backend.setActuatorValue(actuator.signal, next->value);
+            auditActuator(actuatorIndex, *next, STATUS_OK);
+            publishActuatorResponse(actuator, next->requestId, STATUS_OK,
+                                    fmt::format("Set {} to {}", actuator.name, valueText));
+        } catch (const std::exception& exception) {
+            const auto errorMsg = fmt::format("Unable to set {} to {}: {}", actuator.name,
+                                              valueText, exception.what());
+            velocitas::logger().error(errorMsg);
+            auditActuator(actuatorIndex, *next, STATUS_FAIL);
+            publishActuatorResponse(actuator, next->requestId, STATUS_FAIL, errorMsg);
+        }
+        next = m_actuatorEngine->completeWrite(actuatorIndex);
+    }
+}
+
+void SeatAdjuster::auditActuator(std::size_t actuatorIndex, const ActuatorEngine::Write& write,
+                                 int status) {
+    if (!m_auditLog) {
+        return;
+    }
+    const auto& actuator = m_actuatorEngine->getActuators()[actuatorIndex];
+    const auto  encoded  = encodeAuditValue(actuator, write.value);
+    m_auditLog->appendActuator(CommandSource::Mqtt, actuatorIndex, encoded.first,
+                               encoded.second, status, static_cast<uint32_t>(write.requestId));
+}
+
+void SeatAdjuster::publishActuatorResponse(const ActuatorEngine::Actuator& actuator,
+                                           int requestId, int status, const std::string& message) {
+    m_backend.publish(actuator.responseTopic, payloads::serialize(payloads::ActuatorResponse{
+                                                  requestId, {status, message}}));
+}
+
+void SeatAdjuster::onActuatorSignalChanged(const std::string& signal, const SignalValue& value) {
+    const auto& actuators = m_actuatorEngine->getActuators();
+    for (const auto actuatorIndex : m_actuatorEngine->onSignalChanged(signal, value)) {
+        m_backend.publish(actuators[actuatorIndex].currentTopic,
+                          payloads::serialize(payloads::ActuatorCurrentValue{value}));
+    }
+}
+
+SeatCommandResponseFrame
+SeatAdjuster::onSeatCommandReceived(const SeatCommandRequestFrame& request) {
+    m_idleMonitor.onActivity();
+
+    SeatCommandResponseFrame response{};
+    response.command   = request.command;
+    response.requestId = request.requestId;
+    response.position  = request.position;
+
+    if (request.seat >= SEAT_COUNT) {
+        response.status = static_cast<uint8_t>(SeatCommandStatus::InvalidFrame);
+        return response;
+    }
+    const auto seat = static_cast<SeatId>(request.seat);
+
+    switch (static_cast<SeatCommand>(request.command)) {
+    case SeatCommand::SetPosition: {
+        if (request.position < SEAT_POSITION_MIN || request.position > SEAT_POSITION_MAX) {
+            response.status = static_cast<uint8_t>(SeatCommandStatus::InvalidFrame);
+            break;
+        }
+        const auto result =
+            requestSeatPosition(seat, request.position, CommandSource::Uds, request.requestId);
+        response.status   = static_cast<uint8_t>(result.status == STATUS_OK
+                                                     ? SeatCommandStatus::Ok
+                                                     : SeatCommandStatus::Failed);
+        break;
+    }
+    case SeatCommand::GetPosition:
+        response.position = getCurrentPosition(seat);
+        response.status   = static_cast<uint8_t>(response.position == POSITION_UNKNOWN
+                                                     ? SeatCommandStatus::Unknown
+                                                     : SeatCommandStatus::Ok);
+        break;
+    default:
+        response.status = static_cast<uint8_t>(SeatCommandStatus::InvalidFrame);
+        break;
+    }
+    return response;
+}
+
+void SeatAdjuster::publishStatistics() {
+    m_backend.publish(TOPIC_STATISTICS, m_usageStatistics.takeSummary(m_timerService.now()).dump());
+}
+
+void SeatAdjuster::enableAuditLog(std::unique_ptr<AuditLog> auditLog) {
+    m_auditLog = std::move(auditLog);
+}
+
+void SeatAdjuster::enableClientFairness(const FairRequestQueue::Config& config) {
+    for (auto& requestQueue : m_requestQueues) {
+        requestQueue = std::make_unique<FairRequestQueue>(config, m_timerService,
+                                                          FairRequestQueue::ManualDispatch{});
+    }
+}
+
+void SeatAdjuster::enableResponseBatching(const ResponseBatcher::Config& config) {
+    m_responseBatcher = std::make_unique<ResponseBatcher>(
+        config, m_timerService,
+        [this](const std::string& topic, const std::string& payload) {
+            m_backend.publish(topic, payload);
+        });
+}
+
+void SeatAdjuster::enablePositionFilter(std::unique_ptr<PositionFilter> positionFilter) {
+    m_positionFilter = std::move(positionFilter);
+}
+
+void SeatAdjuster::enablePositionHistory(std::unique_ptr<PositionHistory> positionHistory) {
+    m_positionHistory = std::move(positionHistory);
+}
+
+bool SeatAdjuster::enableSnapshots(std::unique_ptr<StateSnapshotFile> snapshotFile) {
+    m_snapshotFile      = std::move(snapshotFile);
+    const auto snapshot = m_snapshotFile->load();
+    return snapshot && restoreSnapshot(*snapshot);
+}
+
+bool SeatAdjuster::restoreSnapshot(const StateSnapshot& snapshot) {
+    const auto now     = m_timerService.now();
+    const auto takenAt = fromTicks(snapshot.takenAt);
+    if (takenAt > now || now - takenAt > SNAPSHOT_MAX_AGE) {
+        velocitas::logger().info("Ignoring stale state snapshot");
+        return false;
+    }
+
+    for (std::size_t seatIndex = 0; seatIndex < SEAT_COUNT; ++seatIndex) {
+        const auto  seat      = static_cast<SeatId>(seatIndex);
+        const auto& seatState = snapshot.seats[seatIndex];
+
+        // Positions reported meanwhile are more recent than the snapshot
+        auto expected = POSITION_UNKNOWN;
+        m_currentPositions[seatIndex].compare_exchange_strong(expected, seatState.position);
+
+        // The lease starts anew: if the client is gone, the seat is stopped once it expires
+        if (seatState.moveDirection == StateSnapshot::MOVE_FORWARD) {
+            m_holdToMoveController.start(seat, MoveDirection::Forward);
+        } else if (seatState.moveDirection == StateSnapshot::MOVE_BACKWARD) {
+            m_holdToMoveController.start(seat, MoveDirection::Backward);
+        }
+    }
+
+    const auto requestCount =
+        std::min<std::size_t>(snapshot.requestCount, snapshot.requests.size());
+    for (std::size_t i = 0; i < requestCount; ++i) {
+        const auto& request = snapshot.requests[i];
+        if (request.seat < SEAT_COUNT) {
+            m_idempotencyCache.insert({static_cast<SeatId>(request.seat), request.requestId,
+                                       request.position, request.status,
+                                       fromTicks(request.receivedAt)});
+        }
+    }
+
+    const auto age = std::chrono::duration_cast<std::chrono::milliseconds>(now - takenAt);
+    velocitas::logger().info("Restored state snapshot taken {} ms ago", age.count());
+    return true;
+}
+
+void SeatAdjuster::persistSnapshot() {
+    const auto    now = m_timerService.now();
+    StateSnapshot snapshot{};
+    snapshot.takenAt = now.time_since_epoch().count();
+
+    for (std::size_t seatIndex = 0; seatIndex < SEAT_COUNT; ++seatIndex) {
+        const auto seat      = static_cast<SeatId>(seatIndex);
+        const auto direction = m_holdToMoveController.getActiveDirection(seat);
+        auto&      seatState = snapshot.seats[seatIndex];
+
+        seatState.position      = getCurrentPosition(seat);
+        seatState.moveDirection = toSnapshotDirection(direction);
+    }
+
+    for (const auto& entry : m_idempotencyCache.getEntries(now)) {
+        auto& request      = snapshot.requests[snapshot.requestCount++];
+        request.receivedAt = entry.receivedAt.time_since_epoch().count();
+        request.requestId  = entry.requestId;
+        request.position   = entry.position;
+        request.seat       = static_cast<uint8_t>(entry.seat);
+        request.status     = static_cast<uint8_t>(entry.status);
+    }
+
+    m_snapshotFile->store(snapshot);
+}
+
+void SeatAdjuster::stopSeat(SeatId seat, CommandSource source) {
+    // Stopping is done by re-targeting the seat to the last reported position
+    const auto currentPosition = getCurrentPosition(seat);
+    if (currentPosition == POSITION_UNKNOWN) {
+        velocitas::logger().warn("Unable to stop {} seat, current position is unknown",
+                                 toString(seat));
+        return;
+    }
+    m_backend.setSeatPosition(seat, currentPosition);
+    if (m_auditLog) {
+        m_auditLog->append(source, seat, currentPosition, STATUS_OK, 0);
+    }
+}
+
+} // namespace example
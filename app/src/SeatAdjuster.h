@@ -0,0 +1,396 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_SEATADJUSTER_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_SEATADJUSTER_H
+
+#include "ActuatorEngine.h"
+#include "AuditLog.h"
+#include "AutomationEngine.h"
+#include "FairRequestQueue.h"
+#include "HoldToMoveController.h"
+#include "IdempotencyCache.h"
+#include "IdleMonitor.h"
+#include "PositionFilter.h"
+#include "PositionHistory.h"
+#include "ProfiledMutex.h"
+#include "ResponseBatcher.h"
+#include "Seat.h"
+#include "SeatCommandProtocol.h"
+#include "SeatUsageStatistics.h"
+#include "StateSnapshot.h"
+#include "TimerService.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace example {
+
+namespace payloads {
+struct ActuatorRequest;
+struct MoveSeatRequest;
+struct SetPositionRequest;
+} // namespace payloads
+
+constexpr auto TOPIC_Driver_REQUEST          = "seatadjuster/setDriverPosition/request";
+constexpr auto TOPIC_Driver_RESPONSE         = "seatadjuster/setDriverPosition/response";
+constexpr auto TOPIC_CURRENT_Driver_POSITION = "seatadjuster/currentDriverPosition";
+
+constexpr auto TOPIC_CoDriver_REQUEST          = "seatadjuster/setCoDriverPosition/request";
+constexpr auto TOPIC_CoDriver_RESPONSE         = "seatadjuster/setCoDriverPosition/response";
+constexpr auto TOPIC_CURRENT_CoDriver_POSITION = "seatadjuster/currentCoDriverPosition";
+
+constexpr auto TOPIC_Driver_MOVE_REQUEST  = "seatadjuster/moveDriverSeat/request";
+constexpr auto TOPIC_Driver_MOVE_RESPONSE = "seatadjuster/moveDriverSeat/response";
+
+constexpr auto TOPIC_CoDriver_MOVE_REQUEST  = "seatadjuster/moveCoDriverSeat/request";
+constexpr auto TOPIC_CoDriver_MOVE_RESPONSE = "seatadjuster/moveCoDriverSeat/response";
+
+constexpr auto TOPIC_Driver_RESYNC_REQUEST  = "seatadjuster/resyncDriverPosition/request";
+constexpr auto TOPIC_Driver_RESYNC_RESPONSE = "seatadjuster/resyncDriverPosition/response";
+
+constexpr auto TOPIC_CoDriver_RESYNC_REQUEST  = "seatadjuster/resyncCoDriverPosition/request";
+constexpr auto TOPIC_CoDriver_RESYNC_RESPONSE = "seatadjuster/resyncCoDriverPosition/response";
+
+constexpr auto TOPIC_Driver_HISTORY_REQUEST  = "seatadjuster/queryDriverPositionHistory/request";
+constexpr auto TOPIC_Driver_HISTORY_RESPONSE = "seatadjuster/queryDriverPositionHistory/response";
+
+constexpr auto TOPIC_CoDriver_HISTORY_REQUEST =
+    "seatadjuster/queryCoDriverPositionHistory/request";
+constexpr auto TOPIC_CoDriver_HISTORY_RESPONSE =
+    "seatadjuster/queryCoDriverPositionHistory/response";
+
+// Followed by the clientId of the set position requests asking for batched responses
+constexpr auto TOPIC_BATCHED_RESPONSES_PREFIX = "seatadjuster/batchedResponses/";
+
+constexpr auto TOPIC_STATISTICS = "seatadjuster/statistics";
+
+constexpr auto TOPIC_THREAD_STATISTICS = "seatadjuster/metrics/threads";
+
+constexpr auto TOPIC_POWER_METRICS = "seatadjuster/metrics/power";
+
+// Only published if built with APP_ENABLE_LOCK_PROFILING
+constexpr auto TOPIC_LOCK_PROFILE = "seatadjuster/metrics/locks";
+
+/**
+ * @brief The vehicle and broker as seen by the SeatAdjuster.
+ * @details Implemented by the vehicle app on top of the SDK, and by fakes in
+ *      tests and benchmarks.
+ */
+class ISeatAdjusterBackend {
+public:
+    virtual ~ISeatAdjusterBackend() = default;
+
+    virtual double getVehicleSpeed()                                                     = 0;
+    virtual void   setSeatPosition(SeatId seat, int position)                            = 0;
+    virtual void   setActuatorValue(const std::string& signal, const SignalValue& value) = 0;
+    virtual void   publish(const std::string& topic, const std::string& payload)         = 0;
+
+    /**
+     * @brief Called after a seat position was published, also for positions settled
+     *      by the position filter later on.
+     */
+    virtual void onPositionPublished(SeatId /*seat*/, int /*position*/) {}
+
+    /**
+     * @brief Run a task after all tasks submitted before for the same seat. Runs it
+     *      right away by default. Submitted tasks have to run before the SeatAdjuster
+     *      is destroyed.
+     */
+    virtual void runForSeat(SeatId /*seat*/, std::function<void()> task) { task(); }
+
+    /**
+     * @brief Run a task after all actuator tasks submitted before, see runForSeat.
+     */
+    virtual void runForActuators(std::function<void()> task) { task(); }
+};
+
+/**
+ * @brief Seat control logic of the SeatAdjuster, independent of the SDK.
+ * @details Handles the request payloads of all interfaces, tracks the reported
+ *      seat positions and owns the hold to move sessions, comfort automation
+ *      and usage statistics. Requests for other actuators (e.g. wipers or the
+ *      defroster) run through the generic ActuatorEngine. All time based
+ *      behaviour is driven by the given TimerService, so the logic can run on
+ *      a virtual clock.
+ *
+ *      Without any seat activity for a while the SeatAdjuster goes idle: the
+ *      statistics are published less often and the per-minute metrics are
+ *      suspended until the seats are used again.
+ *
+ *      Retries of set position requests are answered from an idempotency
+ *      cache instead of moving the seat again. Together with the last known
+ *      positions and running hold to move sessions, the cache can be persisted
+ *      in a snapshot file to survive restarts (see enableSnapshots).
+ *
+ *      The MQTT requests are parsed on the receiving thread and handled on
+ *      the backend's executor of their seat (or of the actuators). With client
+ *      fairness enabled, they are rate limited per client and the executor
+ *      runs them in fair order (see enableClientFairness).
+ *
+ *      High-volume clients can ask for their set position responses to be
+ *      published in batches instead of one message each (see
+ *      enableResponseBatching).
+ *
+ *      Jitter of the position sensors can be removed before the positions are
+ *      published (see enablePositionFilter).
+ *
+ *      Every publish on a current position topic carries a per-seat sequence
+ *      number, so clients can detect lost updates and ask for the last published
+ *      position on the resync topic instead of polling. The sequences restart
+ *      with every instance of the app (e.g. a standby taking over), which is told
+ *      apart by a random epoch published along with them.
+ *
+ *      The published positions can be recorded in a compact on-disk history for
+ *      diagnostics, which is queried via MQTT (see enablePositionHistory).
+ */
+class SeatAdjuster {
+public:
+    static constexpr int POSITION_UNKNOWN = -1;
+
+    SeatAdjuster(ISeatAdjusterBackend& backend, TimerService& timerService);
+    ~SeatAdjuster();
+
+    SeatAdjuster(const SeatAdjuster&)            = delete;
+    SeatAdjuster& operator=(const SeatAdjuster&) = delete;
+
+    /**
+     * @brief Start the periodic jobs (statistics and metrics publishing) and idle detection.
+     */
+    void start();
+
+    /**
+     * @brief Handle a set position request.
+     *
+     * @param seat  The seat the request is addressed to.
+     * @param data  The JSON payload, format: {"requestId": 1, "position": 1}
+     */
+    void onSetPositionRequestReceived(SeatId seat, const std::string& data);
+
+    /**
+     * @brief Handle hold to move requests (start, heartbeat, stop).
+     *
+     * @param seat  The seat the request is addressed to.
+     * @param data  The JSON payload.
+     */
+    void onMoveSeatRequestReceived(SeatId seat, const std::string& data);
+
+    /**
+     * @brief Handle a seat position reported by the vehicle and publish it.
+     * @return false if the position filter dropped the report as noise.
+     */
+    bool onSeatPositionChanged(SeatId seat, int position);
+
+    /**
+     * @brief Publish that the position of a seat could not be read.
+     */
+    void onSeatPositionUnavailable(SeatId seat, const std::string& reason);
+
+    /**
+     * @brief Answer with the last published position of the seat and its sequence number.
+     *
+     * @param seat  The seat the request is addressed to.
+     * @param data  The JSON payload, format: {"requestId": 1}
+     */
+    void onPositionResyncRequestReceived(SeatId seat, const std::string& data);
+
+    /**
+     * @brief Answer a query of the position history of the seat.
+     *
+     * @param seat  The seat the request is addressed to.
+     * @param data  The JSON payload, format: {"requestId": 1, "from": 0, "resolution": "hour"}
+     */
+    void onPositionHistoryRequestReceived(SeatId seat, const std::string& data);
+
+    /**
+     * @brief Enable comfort automation with the given rules.
+     *      The caller is responsible to feed the referenced signals.
+     */
+    void enableAutomation(std::unique_ptr<AutomationEngine> automationEngine);
+
+    AutomationEngine* getAutomationEngine() const { return m_automationEngine.get(); }
+
+    void onAutomationSignalChanged(const std::string& signal, const SignalValue& value);
+
+    /**
+     * @brief Enable requests for the configured actuators.
+     *      The caller is responsible to subscribe their request topics and to feed
+     *      the referenced signals.
+     */
+    void enableActuators(std::unique_ptr<ActuatorEngine> actuatorEngine);
+
+    ActuatorEngine* getActuatorEngine() const { return m_actuatorEngine.get(); }
+
+    /**
+     * @brief Handle a request for an actuator.
+     *
+     * @param actuatorIndex  Index of the actuator in ActuatorEngine::getActuators().
+     * @param data           The JSON payload, format: {"requestId": 1, "value": "WIPE"}
+     */
+    void onActuatorRequestReceived(std::size_t actuatorIndex, const std::string& data);
+
+    void onActuatorSignalChanged(const std::string& signal, const SignalValue& value);
+
+    /**
+     * @brief Restore the state of a previous run from the snapshot file unless it is
+     *      stale, and persist the state into it regularly. Has to be called before start().
+     *
+     * @return true   A snapshot has been restored.
+     * @return false  There was no snapshot, or it was too old.
+     */
+    bool enableSnapshots(std::unique_ptr<StateSnapshotFile> snapshotFile);
+
+    /**
+     * @brief Handle a request of the binary command interface.
+     */
+    SeatCommandResponseFrame onSeatCommandReceived(const SeatCommandRequestFrame& request);
+
+    /**
+     * @brief Record all seat commands (including rejected ones) in the given audit log.
+     */
+    void enableAuditLog(std::unique_ptr<AuditLog> auditLog);
+
+    /**
+     * @brief Rate limit the set position, move and actuator requests per client (their
+     *      clientId field) and handle them in fair order. Each seat and the actuators
+     *      have a request queue of their own, drained by their executor, so the limits
+     *      apply per seat. Requests exceeding the client's rate are answered with
+     *      STATUS_FAIL. Has to be called before any request is received.
+     *
+     * @throws std::invalid_argument  If a rate or burst is not positive.
+     */
+    void enableClientFairness(const FairRequestQueue::Config& config);
+
+    /**
+     * @brief Publish the responses to set position requests with "batchResponse" set as
+     *      JSON arrays on TOPIC_BATCHED_RESPONSES_PREFIX + clientId. Without batching,
+     *      or if the request has no clientId usable as topic level, the flag is ignored.
+     *      Has to be called before any request is received.
+     */
+    void enableResponseBatching(const ResponseBatcher::Config& config);
+
+    /**
+     * @brief Filter the reported seat positions, so only changes of the filtered position
+     *      are published and count as seat activity. Has to be called before any position
+     *      is reported.
+     */
+    void enablePositionFilter(std::unique_ptr<PositionFilter> positionFilter);
+
+    /**
+     * @brief Record every published seat position in the given history, which can then
+     *      be queried via MQTT.
+     */
+    void enablePositionHistory(std::unique_ptr<PositionHistory> positionHistory);
+
+    /**
+     * @brief Move a seat if the vehicle is not moving. Shared by all request sources.
+     *
+     * @param seat       The seat to move.
+     * @param position   The target position.
+     * @param source     The interface the request was received on, for auditing.
+     * @param requestId  The id of the request if the interface has one, for auditing.
+     */
+    SeatRequestResult requestSeatPosition(SeatId seat, int position, CommandSource source,
+                                          uint32_t requestId = 0);
+
+    int getCurrentPosition(SeatId seat) const { return m_currentPositions[toIndex(seat)]; }
+
+    PowerMode getPowerMode() const { return m_idleMonitor.getMode(); }
+
+    void publishStatistics();
+
+private:
+    // Last-value cache of a current position topic
+    struct PublishedPosition {
+        uint64_t           sequence{0};
+        std::optional<int> position;
+    };
+
+    // Timer publishing the last report once a seat stopped reporting, see PositionFilter
+    struct PositionSettling {
+        std::optional<TimerService::TimerId> timerId;
+        TimerService::Clock::time_point      lastReport;
+    };
+
+    /**
+     * @brief Run the handler of a parsed request on the executor of its seat, queued
+     *      fairly if enabled.
+     *
+     * @param seat  The seat of the request, none for actuator requests.
+     * @return The reason if the request was rejected.
+     */
+    std::optional<std::string> dispatchRequest(std::optional<SeatId>             seat,
+                                               const std::optional<std::string>& clientId,
+                                               std::size_t cost, FairRequestQueue::Task handler);
+
+    void handleSetPositionRequest(SeatId seat, const payloads::SetPositionRequest& request);
+    void publishSetPositionResponse(SeatId seat, const payloads::SetPositionRequest& request,
+                                    const std::string& payload);
+    void handleMoveSeatRequest(SeatId seat, const payloads::MoveSeatRequest& request);
+    void handleActuatorRequest(std::size_t actuatorIndex, const payloads::ActuatorRequest& request);
+    void publishPosition(SeatId seat, int position);
+    void onPositionSettleTimer(SeatId seat);
+    void stopSeat(SeatId seat, CommandSource source);
+    void writeActuator(std::size_t actuatorIndex, ActuatorEngine::Write write);
+    void auditActuator(std::size_t actuatorIndex, const ActuatorEngine::Write& write, int status);
+    void publishActuatorResponse(const ActuatorEngine::Actuator& actuator, int requestId,
+                                 int status, const std::string& message);
+    void onMoveLeaseExpired(SeatId seat, HoldToMoveController::SessionId sessionId);
+    void onPowerModeChanged(PowerMode mode);
+    void schedulePeriodicJobs(PowerMode mode);
+    void publishPowerMetrics(PowerMode mode);
+    bool restoreSnapshot(const StateSnapshot& snapshot);
+    void persistSnapshot();
+
+    ISeatAdjusterBackend&                     m_backend;
+    TimerService&                             m_timerService;
+    std::array<std::atomic<int>, SEAT_COUNT>  m_currentPositions;
+    SeatUsageStatistics                       m_usageStatistics;
+    HoldToMoveController                      m_holdToMoveController;
+    std::unique_ptr<AutomationEngine>         m_automationEngine;
+    std::unique_ptr<ActuatorEngine>           m_actuatorEngine;
+    IdempotencyCache                          m_idempotencyCache;
+    std::unique_ptr<StateSnapshotFile>        m_snapshotFile;
+    std::unique_ptr<AuditLog>                 m_auditLog;
+    std::unique_ptr<PositionFilter>           m_positionFilter;
+    ProfiledMutex                             m_positionFilterMutex{"PositionFilter"};
+    std::array<PositionSettling, SEAT_COUNT>  m_positionSettling;
+    std::unique_ptr<PositionHistory>          m_positionHistory;
+    IdleMonitor                               m_idleMonitor;
+    std::vector<TimerService::TimerId>        m_periodicJobs;
+    ProfiledMutex                             m_powerMetricsMutex{"SeatAdjuster"};
+    TimerService::Clock::time_point           m_powerMetricsSince;
+    uint64_t                                  m_powerMetricsSinceWakeups{0};
+    ProfiledMutex                             m_positionStreamMutex{"PositionStream"};
+    const uint32_t                            m_positionEpoch;
+    std::array<PublishedPosition, SEAT_COUNT> m_publishedPositions;
+    std::unique_ptr<ResponseBatcher>          m_responseBatcher;
+
+    // One per seat, followed by the one of the actuators
+    std::array<std::unique_ptr<FairRequestQueue>, SEAT_COUNT + 1> m_requestQueues;
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_SEATADJUSTER_H
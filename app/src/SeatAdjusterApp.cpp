@@ -20,36 +20,136 @@
 #include "sdk/QueryBuilder.h"
 #include "sdk/vdb/IVehicleDataBrokerClient.h"
 
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <fmt/core.h>
-#include <nlohmann/json.hpp>
+#include <future>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
 #include <utility>
 
 namespace example {
 
-const auto TOPIC_Driver_REQUEST          = "seatadjuster/setDriverPosition/request";
-const auto TOPIC_Driver_RESPONSE         = "seatadjuster/setDriverPosition/response";
-const auto TOPIC_CURRENT_Driver_POSITION = "seatadjuster/currentDriverPosition";
+// Path of the JSON file with the comfort automation rules, automation is disabled if unset
+const auto ENV_AUTOMATION_CONFIG = "SEATADJUSTER_AUTOMATION_CONFIG";
 
-const auto TOPIC_CoDriver_REQUEST          = "seatadjuster/setCoDriverPosition/request";
-const auto TOPIC_CoDriver_RESPONSE         = "seatadjuster/setCoDriverPosition/response";
-const auto TOPIC_CURRENT_CoDriver_POSITION = "seatadjuster/currentCoDriverPosition";
+// Path of the JSON file with the allowlisted actuators, only seats can be moved if unset
+const auto ENV_ACTUATOR_CONFIG = "SEATADJUSTER_ACTUATOR_CONFIG";
 
-const auto JSON_FIELD_REQUEST_ID = "requestId";
-const auto JSON_FIELD_POSITION   = "position";
-const auto JSON_FIELD_STATUS     = "status";
-const auto JSON_FIELD_MESSAGE    = "message";
-const auto JSON_FIELD_RESULT     = "result";
+// Listen address of the gRPC seat control service (e.g. "0.0.0.0:50051"), disabled if unset
+const auto ENV_GRPC_ADDRESS = "SEATADJUSTER_GRPC_ADDRESS";
 
-const auto STATUS_OK   = 0;
-const auto STATUS_FAIL = 1;
+// Path of the Unix domain socket for the binary command interface, disabled if unset
+const auto ENV_UDS_PATH = "SEATADJUSTER_UDS_PATH";
 
-SeatAdjusterApp::SeatAdjusterApp()
+// Path of the state snapshot file, preferably on tmpfs (e.g. "/dev/shm/seatadjuster.state"),
+// warm restarts are disabled if unset
+const auto ENV_SNAPSHOT_PATH = "SEATADJUSTER_SNAPSHOT_PATH";
+
+// MQTT shared subscription group for the request topics, plain subscriptions if unset
+const auto ENV_SHARED_GROUP = "SEATADJUSTER_SHARED_GROUP";
+
+// Path of the audit log of all seat commands, auditing is disabled if unset
+const auto ENV_AUDIT_LOG_PATH = "SEATADJUSTER_AUDIT_LOG";
+
+// Maximum time in milliseconds until an audited seat command is on disk
+const auto ENV_AUDIT_FLUSH_INTERVAL_MS = "SEATADJUSTER_AUDIT_FLUSH_INTERVAL_MS";
+
+// Sustained MQTT requests per second and client, per-client rate limiting is disabled if unset
+const auto ENV_CLIENT_RATE = "SEATADJUSTER_CLIENT_RATE";
+
+// Number of MQTT requests a client may send at once, twice the rate if unset
+const auto ENV_CLIENT_BURST = "SEATADJUSTER_CLIENT_BURST";
+
+// Sustained MQTT requests per second of all clients without clientId, unlimited if unset
+const auto ENV_ANONYMOUS_RATE = "SEATADJUSTER_ANONYMOUS_RATE";
+
+// Time in milliseconds batched set position responses are collected, batching is disabled if unset
+const auto ENV_RESPONSE_BATCH_WINDOW_MS = "SEATADJUSTER_RESPONSE_BATCH_WINDOW_MS";
+
+// Maximum number of responses in one batch
+const auto ENV_RESPONSE_BATCH_SIZE = "SEATADJUSTER_RESPONSE_BATCH_SIZE";
+
+// Filter for the reported seat positions, "median:<window size>" or "deadband:<width>",
+// every reported position is published if unset
+const auto ENV_POSITION_FILTER = "SEATADJUSTER_POSITION_FILTER";
+
+// Path of the position history file (2.6 MiB), the history is not recorded if unset
+const auto ENV_HISTORY_PATH = "SEATADJUSTER_HISTORY_PATH";
+
+// Directory the published messages are spooled to for upload, telemetry is disabled if unset
+const auto ENV_TELEMETRY_DIR = "SEATADJUSTER_TELEMETRY_DIR";
+
+// Path of the zstd dictionary the telemetry files are compressed with, none if unset
+const auto ENV_TELEMETRY_DICTIONARY = "SEATADJUSTER_TELEMETRY_DICTIONARY";
+
+// Compressed size in bytes at which a telemetry file is sealed
+const auto ENV_TELEMETRY_MAX_FILE_BYTES = "SEATADJUSTER_TELEMETRY_MAX_FILE_BYTES";
+
+// Time in seconds after which a telemetry file is sealed
+const auto ENV_TELEMETRY_MAX_FILE_AGE_S = "SEATADJUSTER_TELEMETRY_MAX_FILE_AGE_S";
+
+template <typename T> SignalValue toSignalValue(const T& value) {
+    if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, std::string>) {
+        return value;
+    } else {
+        return static_cast<double>(value);
+    }
+}
+
+template <typename T> T fromSignalValue(const SignalValue& value) {
+    if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, std::string>) {
+        return std::get<T>(value);
+    } else {
+        return static_cast<T>(std::get<double>(value));
+    }
+}
+
+SeatAdjusterApp::SeatAdjusterApp(TakeoverGate waitForTakeover)
     : VehicleApp(velocitas::IVehicleDataBrokerClient::createInstance("vehicledatabroker"),
-                 velocitas::IPubSubClient::createInstance("SeatAdjusterApp")) {}
+                 velocitas::IPubSubClient::createInstance("SeatAdjusterApp"))
+    , m_waitForTakeover(std::move(waitForTakeover))
+    , m_vehicleSpeed(std::numeric_limits<double>::quiet_NaN())
+    , m_seatAdjuster(*this, m_timerService) {
+    if (const auto* sharedGroup = std::getenv(ENV_SHARED_GROUP)) {
+        m_sharedGroupPrefix = std::string("$share/") + sharedGroup + "/";
+    }
+    for (auto& executor : m_seatExecutors) {
+        executor = std::make_unique<SerialExecutor>(m_scheduler);
+    }
+    m_actuatorExecutor = std::make_unique<SerialExecutor>(m_scheduler);
+}
 
 void SeatAdjusterApp::onStart() {
     // This method will be called by the SDK when the connection to the
     // Vehicle DataBroker is ready.
+
+    // A standby warms up with everything which neither receives requests nor touches the
+    // files of the active instance, so taking over is left with little more than subscribing
+    startClientFairness();
+    startResponseBatching();
+    startPositionFilter();
+    startAutomation();
+    startActuators();
+
+    if (m_waitForTakeover) {
+        velocitas::logger().info("Running as standby, waiting to take over");
+        if (!m_waitForTakeover()) {
+            return;
+        }
+    }
+
+    // Started first, so the telemetry holds everything published
+    startTelemetry();
+    startAuditLog();
+    // The snapshot is restored first, so its positions do not replace newer reported ones
+    startSnapshots();
+    startPositionHistory();
+
     velocitas::logger().info("Subscribe for data points!");
 
     // Here you can subscribe for the Vehicle Signals update and provide callbacks.
@@ -70,159 +170,527 @@ void SeatAdjusterApp::onStart() {
             [this](auto&& status) { onErrorDatapoint(std::forward<decltype(status)>(status)); });
 
     // ... and, unlike Python, you have to manually subscribe to pub/sub topics
-    subscribeToTopic(TOPIC_Driver_REQUEST)
+    subscribeToTopic(getSubscriptionTopic(TOPIC_Driver_REQUEST))
         ->onItem([this](auto&& item) {
             onSetDriverPositionRequestReceived(std::forward<decltype(item)>(item));
         })
         ->onError([this](auto&& status) { onErrorTopic(std::forward<decltype(status)>(status)); });
 
-    subscribeToTopic(TOPIC_CoDriver_REQUEST)
+    subscribeToTopic(getSubscriptionTopic(TOPIC_CoDriver_REQUEST))
         ->onItem([this](auto&& item) {
             onSetCoDriverPositionRequestReceived(std::forward<decltype(item)>(item));
         })
         ->onError([this](auto&& status) { onErrorTopic(std::forward<decltype(status)>(status)); });
+
+    subscribeToTopic(getSubscriptionTopic(TOPIC_Driver_MOVE_REQUEST))
+        ->onItem([this](auto&& item) {
+            onMoveSeatRequestReceived(SeatId::Driver, std::forward<decltype(item)>(item));
+        })
+        ->onError([this](auto&& status) { onErrorTopic(std::forward<decltype(status)>(status)); });
+
+    subscribeToTopic(getSubscriptionTopic(TOPIC_CoDriver_MOVE_REQUEST))
+        ->onItem([this](auto&& item) {
+            onMoveSeatRequestReceived(SeatId::CoDriver, std::forward<decltype(item)>(item));
+        })
+        ->onError([this](auto&& status) { onErrorTopic(std::forward<decltype(status)>(status)); });
+
+    subscribeToTopic(getSubscriptionTopic(TOPIC_Driver_RESYNC_REQUEST))
+        ->onItem([this](auto&& item) {
+            m_seatAdjuster.onPositionResyncRequestReceived(SeatId::Driver,
+                                                           std::forward<decltype(item)>(item));
+        })
+        ->onError([this](auto&& status) { onErrorTopic(std::forward<decltype(status)>(status)); });
+
+    subscribeToTopic(getSubscriptionTopic(TOPIC_CoDriver_RESYNC_REQUEST))
+        ->onItem([this](auto&& item) {
+            m_seatAdjuster.onPositionResyncRequestReceived(SeatId::CoDriver,
+                                                           std::forward<decltype(item)>(item));
+        })
+        ->onError([this](auto&& status) { onErrorTopic(std::forward<decltype(status)>(status)); });
+
+    subscribeToTopic(getSubscriptionTopic(TOPIC_Driver_HISTORY_REQUEST))
+        ->onItem([this](auto&& item) {
+            m_seatAdjuster.onPositionHistoryRequestReceived(SeatId::Driver,
+                                                            std::forward<decltype(item)>(item));
+        })
+        ->onError([this](auto&& status) { onErrorTopic(std::forward<decltype(status)>(status)); });
+
+    subscribeToTopic(getSubscriptionTopic(TOPIC_CoDriver_HISTORY_REQUEST))
+        ->onItem([this](auto&& item) {
+            m_seatAdjuster.onPositionHistoryRequestReceived(SeatId::CoDriver,
+                                                            std::forward<decltype(item)>(item));
+        })
+        ->onError([this](auto&& status) { onErrorTopic(std::forward<decltype(status)>(status)); });
+
+    subscribeActuators();
+    subscribeSignals();
+    startSeatControlServer();
+    startUdsCommandServer();
+
+    m_seatAdjuster.start();
 }
 
 void SeatAdjusterApp::onSetDriverPositionRequestReceived(const std::string& data) {
     // Callback is executed whenever a message is received on the subscribed topic
     // The data parameter contains the message payload
-    // Payload format: {"requestId": 1, "position": 1}
+    m_seatAdjuster.onSetPositionRequestReceived(SeatId::Driver, data);
+}
+
+void SeatAdjusterApp::onDriverSeatPositionChanged(const velocitas::DataPointReply& dataPoints) {
+    // Callback is executed whenever the subscribed datapoints are updated
+    // The dataPoints parameter contains the updated datapoints
+    try {
+        // Get the current seat position
+        const auto seatPositionValue =
+            dataPoints.get(Vehicle.Cabin.Seat.Row1.DriverSide.Position)->value();
+        updateSeatPosition(SeatId::Driver, seatPositionValue);
+    } catch (std::exception& exception) {
+        m_seatAdjuster.onSeatPositionUnavailable(SeatId::Driver, exception.what());
+    }
+}
+
+void SeatAdjusterApp::onSetCoDriverPositionRequestReceived(const std::string& data) {
+    // Callback is executed whenever a message is received on the subscribed topic
+    // The data parameter contains the message payload
+    m_seatAdjuster.onSetPositionRequestReceived(SeatId::CoDriver, data);
+}
+
+void SeatAdjusterApp::onCoDriverSeatPositionChanged(const velocitas::DataPointReply& dataPoints) {
+    // Callback is executed whenever the subscribed datapoints are updated
+    // The dataPoints parameter contains the updated datapoints
+    try {
+        // Get the current seat position
+        const auto seatPositionValue =
+            dataPoints.get(Vehicle.Cabin.Seat.Row1.PassengerSide.Position)->value();
+        updateSeatPosition(SeatId::CoDriver, seatPositionValue);
+    } catch (std::exception& exception) {
+        m_seatAdjuster.onSeatPositionUnavailable(SeatId::CoDriver, exception.what());
+    }
+}
+
+void SeatAdjusterApp::onMoveSeatRequestReceived(SeatId seat, const std::string& data) {
+    m_seatAdjuster.onMoveSeatRequestReceived(seat, data);
+}
+
+double SeatAdjusterApp::getVehicleSpeed() {
+    // The subscribed speed saves a round trip to the databroker per request
+    const auto speed = m_vehicleSpeed.load();
+    if (!std::isnan(speed)) {
+        return speed;
+    }
+    return Vehicle.Speed.get()->await().value();
+}
+
+void SeatAdjusterApp::setSeatPosition(SeatId seat, int position) {
+    if (seat == SeatId::Driver) {
+        Vehicle.Cabin.Seat.Row1.DriverSide.Position.set(position)->await();
+    } else {
+        Vehicle.Cabin.Seat.Row1.PassengerSide.Position.set(position)->await();
+    }
+}
 
-    // Use the logger with the preferred log level (e.g. debug, info, error, etc)
-    velocitas::logger().debug("position request: \"{}\"", data);
+void SeatAdjusterApp::setActuatorValue(const std::string& signal, const SignalValue& value) {
+    const auto isSupported = visitDataPoint(signal, [&value](auto& dataPoint) {
+        using TValue = std::decay_t<decltype(dataPoint.get()->await().value())>;
+        dataPoint.set(fromSignalValue<TValue>(value))->await();
+    });
+    if (!isSupported) {
+        throw std::invalid_argument(fmt::format("Signal {} is not supported", signal));
+    }
+}
 
-    // Parse the received JSON data
-    const auto jsonData = nlohmann::json::parse(data);
+void SeatAdjusterApp::publish(const std::string& topic, const std::string& payload) {
+    publishToTopic(topic, payload);
+    if (m_telemetrySpooler) {
+        m_telemetrySpooler->append(topic, payload);
+    }
+}
 
-    // Check if the received JSON data contains the required fields
-    if (!jsonData.contains(JSON_FIELD_POSITION)) {
-        const auto errorMsg = fmt::format("No position specified");
-        velocitas::logger().error(errorMsg);
+std::string SeatAdjusterApp::getSubscriptionTopic(const std::string& topic) const {
+    return m_sharedGroupPrefix + topic;
+}
 
-        nlohmann::json respData({{JSON_FIELD_REQUEST_ID, jsonData[JSON_FIELD_REQUEST_ID]},
-                                 {JSON_FIELD_STATUS, STATUS_FAIL},
-                                 {JSON_FIELD_MESSAGE, errorMsg}});
-        publishToTopic(TOPIC_Driver_RESPONSE, respData.dump());
+void SeatAdjusterApp::startTelemetry() {
+    const auto* directory = std::getenv(ENV_TELEMETRY_DIR);
+    if (directory == nullptr) {
         return;
     }
 
-    const auto desiredSeatPosition = jsonData[JSON_FIELD_POSITION].get<int>();
-    const auto requestId           = jsonData[JSON_FIELD_REQUEST_ID].get<int>();
+    TelemetrySpooler::Config config;
+    config.directory = directory;
+    if (const auto* dictionaryPath = std::getenv(ENV_TELEMETRY_DICTIONARY)) {
+        config.dictionaryPath = dictionaryPath;
+    }
+    if (const auto* maxFileBytes = std::getenv(ENV_TELEMETRY_MAX_FILE_BYTES)) {
+        config.maxFileBytes = static_cast<std::size_t>(std::atoll(maxFileBytes));
+    }
+    if (const auto* maxFileAge = std::getenv(ENV_TELEMETRY_MAX_FILE_AGE_S)) {
+        config.maxFileAge = std::chrono::seconds(std::atoi(maxFileAge));
+    }
 
-    nlohmann::json respData({{JSON_FIELD_REQUEST_ID, requestId}, {JSON_FIELD_RESULT, {}}});
+    try {
+        m_telemetrySpooler = std::make_unique<TelemetrySpooler>(config);
+    } catch (const std::system_error& exception) {
+        velocitas::logger().error("Telemetry disabled: {}", exception.what());
+        return;
+    } catch (const std::invalid_argument& exception) {
+        velocitas::logger().error("Telemetry disabled: {}", exception.what());
+        return;
+    }
+    velocitas::logger().info("Spooling telemetry to \"{}\", sealing files at {} bytes or {} ms",
+                             directory, config.maxFileBytes, config.maxFileAge.count());
+}
 
-    const auto vehicleSpeed = Vehicle.Speed.get()->await().value();
+void SeatAdjusterApp::startAuditLog() {
+    const auto* auditLogPath = std::getenv(ENV_AUDIT_LOG_PATH);
+    if (auditLogPath == nullptr) {
+        return;
+    }
 
-    // Check if the vehicle is not moving
-    if (vehicleSpeed == 0) {
-        // Move the seat to the desired position
-        Vehicle.Cabin.Seat.Row1.DriverSide.Position.set(desiredSeatPosition)->await();
+    AuditLog::Config config;
+    config.path = auditLogPath;
+    if (const auto* flushInterval = std::getenv(ENV_AUDIT_FLUSH_INTERVAL_MS)) {
+        config.flushInterval = std::chrono::milliseconds(std::atoi(flushInterval));
+    }
 
-        respData[JSON_FIELD_RESULT][JSON_FIELD_STATUS] = STATUS_OK;
-        respData[JSON_FIELD_RESULT][JSON_FIELD_MESSAGE] =
-            fmt::format("Set Seat position to: {}", desiredSeatPosition);
-    } else {
-        const auto errorMsg = fmt::format(
-            "Not allowed to move seat because vehicle speed is {} and not 0", vehicleSpeed);
-        velocitas::logger().info(errorMsg);
+    try {
+        m_seatAdjuster.enableAuditLog(std::make_unique<AuditLog>(config));
+    } catch (const std::system_error& exception) {
+        velocitas::logger().error("Audit log disabled: {}", exception.what());
+        return;
+    }
+    velocitas::logger().info("Auditing seat commands to \"{}\", flush interval {} ms",
+                             auditLogPath, config.flushInterval.count());
+}
 
-        respData[JSON_FIELD_RESULT][JSON_FIELD_STATUS]  = STATUS_FAIL;
-        respData[JSON_FIELD_RESULT][JSON_FIELD_MESSAGE] = errorMsg;
+void SeatAdjusterApp::startSnapshots() {
+    const auto* snapshotPath = std::getenv(ENV_SNAPSHOT_PATH);
+    if (snapshotPath == nullptr) {
+        return;
     }
 
-    // Publish the response to the MQTT topic
-    publishToTopic(TOPIC_Driver_RESPONSE, respData.dump());
+    try {
+        if (!m_seatAdjuster.enableSnapshots(std::make_unique<StateSnapshotFile>(snapshotPath))) {
+            velocitas::logger().info("No recent state snapshot in \"{}\"", snapshotPath);
+        }
+    } catch (const std::system_error& exception) {
+        velocitas::logger().error("State snapshots disabled: {}", exception.what());
+    }
 }
 
-void SeatAdjusterApp::onDriverSeatPositionChanged(const velocitas::DataPointReply& dataPoints) {
-    // Callback is executed whenever the subscribed datapoints are updated
-    // The dataPoints parameter contains the updated datapoints
-    nlohmann::json jsonResponse;
+void SeatAdjusterApp::startClientFairness() {
+    const auto* rate = std::getenv(ENV_CLIENT_RATE);
+    if (rate == nullptr) {
+        return;
+    }
+
+    FairRequestQueue::Config config;
+    config.rate  = std::atof(rate);
+    config.burst = 2 * config.rate;
+    if (const auto* burst = std::getenv(ENV_CLIENT_BURST)) {
+        config.burst = std::atof(burst);
+    }
+    if (const auto* anonymousRate = std::getenv(ENV_ANONYMOUS_RATE)) {
+        config.anonymousRate  = std::atof(anonymousRate);
+        config.anonymousBurst = 2 * config.anonymousRate;
+    }
+
     try {
-        // Get the current seat position
-        const auto seatPositionValue =
-            dataPoints.get(Vehicle.Cabin.Seat.Row1.DriverSide.Position)->value();
-        jsonResponse[JSON_FIELD_POSITION] = seatPositionValue;
-    } catch (std::exception& exception) {
-        velocitas::logger().warn("Unable to get Current Seat Position, Exception: {}",
-                                 exception.what());
-        jsonResponse[JSON_FIELD_STATUS]  = STATUS_FAIL;
-        jsonResponse[JSON_FIELD_MESSAGE] = exception.what();
+        m_seatAdjuster.enableClientFairness(config);
+    } catch (const std::invalid_argument& exception) {
+        velocitas::logger().error("Per-client rate limiting disabled: {}", exception.what());
+        return;
+    }
+    velocitas::logger().info("Limiting MQTT requests to {} per second, client and seat, burst {}",
+                             config.rate, config.burst);
+    if (config.anonymousRate > 0.0) {
+        velocitas::logger().info("Limiting MQTT requests without clientId to {} per second",
+                                 config.anonymousRate);
+    }
+}
+
+void SeatAdjusterApp::startResponseBatching() {
+    const auto* window = std::getenv(ENV_RESPONSE_BATCH_WINDOW_MS);
+    if (window == nullptr) {
+        return;
+    }
+
+    ResponseBatcher::Config config;
+    config.window = std::chrono::milliseconds(std::atoi(window));
+    if (const auto* batchSize = std::getenv(ENV_RESPONSE_BATCH_SIZE)) {
+        config.maxEntries = static_cast<std::size_t>(std::atoi(batchSize));
     }
 
-    // Publish the current seat position to the MQTT topic
-    publishToTopic(TOPIC_CURRENT_Driver_POSITION, jsonResponse.dump());
+    try {
+        m_seatAdjuster.enableResponseBatching(config);
+    } catch (const std::invalid_argument& exception) {
+        velocitas::logger().error("Response batching disabled: {}", exception.what());
+        return;
+    }
+    velocitas::logger().info("Batching responses for {} ms or up to {} entries",
+                             config.window.count(), config.maxEntries);
 }
 
-void SeatAdjusterApp::onSetCoDriverPositionRequestReceived(const std::string& data) {
-    // Callback is executed whenever a message is received on the subscribed topic
-    // The data parameter contains the message payload
-    // Payload format: {"requestId": 1, "position": 1}
+void SeatAdjusterApp::startPositionFilter() {
+    const auto* specification = std::getenv(ENV_POSITION_FILTER);
+    if (specification == nullptr) {
+        return;
+    }
+
+    try {
+        m_seatAdjuster.enablePositionFilter(
+            std::make_unique<PositionFilter>(PositionFilter::parseConfig(specification)));
+    } catch (const std::invalid_argument& exception) {
+        velocitas::logger().error("Position filter disabled: {}", exception.what());
+        return;
+    }
+    velocitas::logger().info("Filtering seat positions with \"{}\"", specification);
+}
+
+void SeatAdjusterApp::startPositionHistory() {
+    const auto* historyPath = std::getenv(ENV_HISTORY_PATH);
+    if (historyPath == nullptr) {
+        return;
+    }
+
+    PositionHistory::Config config;
+    config.path = historyPath;
+    try {
+        m_seatAdjuster.enablePositionHistory(std::make_unique<PositionHistory>(config));
+    } catch (const std::system_error& exception) {
+        velocitas::logger().error("Position history disabled: {}", exception.what());
+        return;
+    }
+    velocitas::logger().info("Recording the position history in \"{}\"", historyPath);
+}
 
-    // Use the logger with the preferred log level (e.g. debug, info, error, etc)
-    velocitas::logger().debug("position request: \"{}\"", data);
+void SeatAdjusterApp::startAutomation() {
+    const auto* configPath = std::getenv(ENV_AUTOMATION_CONFIG);
+    if (configPath == nullptr) {
+        return;
+    }
 
-    // Parse the received JSON data
-    const auto jsonData = nlohmann::json::parse(data);
+    try {
+        m_seatAdjuster.enableAutomation(AutomationEngine::fromFile(configPath));
+    } catch (const std::invalid_argument& exception) {
+        velocitas::logger().error("Automation disabled: {}", exception.what());
+        return;
+    }
+    velocitas::logger().info("Loaded {} automation rule(s) from \"{}\"",
+                             m_seatAdjuster.getAutomationEngine()->getRuleCount(), configPath);
+}
 
-    // Check if the received JSON data contains the required fields
-    if (!jsonData.contains(JSON_FIELD_POSITION)) {
-        const auto errorMsg = fmt::format("No position specified");
-        velocitas::logger().error(errorMsg);
+void SeatAdjusterApp::startActuators() {
+    const auto* configPath = std::getenv(ENV_ACTUATOR_CONFIG);
+    if (configPath == nullptr) {
+        return;
+    }
 
-        nlohmann::json respData({{JSON_FIELD_REQUEST_ID, jsonData[JSON_FIELD_REQUEST_ID]},
-                                 {JSON_FIELD_STATUS, STATUS_FAIL},
-                                 {JSON_FIELD_MESSAGE, errorMsg}});
-        publishToTopic(TOPIC_CoDriver_RESPONSE, respData.dump());
+    try {
+        m_seatAdjuster.enableActuators(ActuatorEngine::fromFile(configPath));
+    } catch (const std::invalid_argument& exception) {
+        velocitas::logger().error("Actuators disabled: {}", exception.what());
         return;
     }
+    velocitas::logger().info("Loaded {} actuator(s) from \"{}\"",
+                             m_seatAdjuster.getActuatorEngine()->getActuators().size(), configPath);
+}
 
-    const auto desiredSeatPosition = jsonData[JSON_FIELD_POSITION].get<int>();
-    const auto requestId           = jsonData[JSON_FIELD_REQUEST_ID].get<int>();
+void SeatAdjusterApp::subscribeActuators() {
+    const auto* actuatorEngine = m_seatAdjuster.getActuatorEngine();
+    if (actuatorEngine == nullptr) {
+        return;
+    }
 
-    nlohmann::json respData({{JSON_FIELD_REQUEST_ID, requestId}, {JSON_FIELD_RESULT, {}}});
+    const auto& actuators = actuatorEngine->getActuators();
+    for (std::size_t actuatorIndex = 0; actuatorIndex < actuators.size(); ++actuatorIndex) {
+        subscribeToTopic(getSubscriptionTopic(actuators[actuatorIndex].requestTopic))
+            ->onItem([this, actuatorIndex](auto&& item) {
+                m_seatAdjuster.onActuatorRequestReceived(actuatorIndex,
+                                                         std::forward<decltype(item)>(item));
+            })
+            ->onError(
+                [this](auto&& status) { onErrorTopic(std::forward<decltype(status)>(status)); });
+    }
+}
 
-    const auto vehicleSpeed = Vehicle.Speed.get()->await().value();
+void SeatAdjusterApp::subscribeSignals() {
+    subscribeDataPoints(velocitas::QueryBuilder::select(Vehicle.Speed).build())
+        ->onItem([this](const velocitas::DataPointReply& dataPoints) {
+            try {
+                m_vehicleSpeed = dataPoints.get(Vehicle.Speed)->value();
+            } catch (std::exception&) {
+                m_vehicleSpeed = std::numeric_limits<double>::quiet_NaN();
+            }
+        })
+        ->onError([this](auto&& status) {
+            m_vehicleSpeed = std::numeric_limits<double>::quiet_NaN();
+            onErrorDatapoint(std::forward<decltype(status)>(status));
+        });
+
+    std::set<std::string> automationSignals;
+    if (const auto* automationEngine = m_seatAdjuster.getAutomationEngine()) {
+        automationSignals = automationEngine->getReferencedSignals();
+    }
+    std::set<std::string> actuatorSignals;
+    if (const auto* actuatorEngine = m_seatAdjuster.getActuatorEngine()) {
+        actuatorSignals = actuatorEngine->getReferencedSignals();
+    }
 
-    // Check if the vehicle is not moving
-    if (vehicleSpeed == 0) {
-        // Move the seat to the desired position
-        Vehicle.Cabin.Seat.Row1.PassengerSide.Position.set(desiredSeatPosition)->await();
+    // Signals used by both engines are subscribed once
+    auto signals = automationSignals;
+    signals.insert(actuatorSignals.begin(), actuatorSignals.end());
+    for (const auto& signal : signals) {
+        const auto isAutomationSignal = automationSignals.count(signal) > 0;
+        const auto isActuatorSignal   = actuatorSignals.count(signal) > 0;
+
+        const auto onValue = [this, signal, isAutomationSignal, isActuatorSignal](
+                                 const SignalValue& value) {
+            if (isAutomationSignal) {
+                m_seatAdjuster.onAutomationSignalChanged(signal, value);
+            }
+            if (isActuatorSignal) {
+                m_seatAdjuster.onActuatorSignalChanged(signal, value);
+            }
+        };
+
+        const auto isSupported = visitDataPoint(signal, [this, &onValue](const auto& dataPoint) {
+            subscribeSignal(dataPoint, onValue);
+        });
+        if (!isSupported) {
+            velocitas::logger().error("Signal {} is not supported", signal);
+        }
+    }
+}
 
-        respData[JSON_FIELD_RESULT][JSON_FIELD_STATUS] = STATUS_OK;
-        respData[JSON_FIELD_RESULT][JSON_FIELD_MESSAGE] =
-            fmt::format("Set Seat position to: {}", desiredSeatPosition);
+template <typename TVisitor>
+bool SeatAdjusterApp::visitDataPoint(const std::string& path, TVisitor&& visitor) {
+    // The vehicle model is typed, so every signal usable by automation rules and
+    // actuators has to be listed here once
+    if (path == Vehicle.Speed.getPath()) {
+        visitor(Vehicle.Speed);
+    } else if (path == Vehicle.Cabin.Seat.Row1.DriverSide.Position.getPath()) {
+        visitor(Vehicle.Cabin.Seat.Row1.DriverSide.Position);
+    } else if (path == Vehicle.Cabin.Seat.Row1.PassengerSide.Position.getPath()) {
+        visitor(Vehicle.Cabin.Seat.Row1.PassengerSide.Position);
+    } else if (path == Vehicle.Cabin.Door.Row1.DriverSide.IsOpen.getPath()) {
+        visitor(Vehicle.Cabin.Door.Row1.DriverSide.IsOpen);
+    } else if (path == Vehicle.Cabin.Door.Row1.PassengerSide.IsOpen.getPath()) {
+        visitor(Vehicle.Cabin.Door.Row1.PassengerSide.IsOpen);
+    } else if (path == Vehicle.Cabin.HVAC.IsFrontDefrosterActive.getPath()) {
+        visitor(Vehicle.Cabin.HVAC.IsFrontDefrosterActive);
+    } else if (path == Vehicle.Body.Windshield.Front.Wiping.System.Mode.getPath()) {
+        visitor(Vehicle.Body.Windshield.Front.Wiping.System.Mode);
+    } else if (path == Vehicle.Body.Windshield.Front.Wiping.System.TargetPosition.getPath()) {
+        visitor(Vehicle.Body.Windshield.Front.Wiping.System.TargetPosition);
+    } else if (path == Vehicle.Body.Windshield.Front.Wiping.System.ActualPosition.getPath()) {
+        visitor(Vehicle.Body.Windshield.Front.Wiping.System.ActualPosition);
     } else {
-        const auto errorMsg = fmt::format(
-            "Not allowed to move seat because vehicle speed is {} and not 0", vehicleSpeed);
-        velocitas::logger().info(errorMsg);
+        return false;
+    }
+    return true;
+}
+
+template <typename TDataPoint>
+void SeatAdjusterApp::subscribeSignal(const TDataPoint& dataPoint, const SignalHandler& onValue) {
+    subscribeDataPoints(velocitas::QueryBuilder::select(dataPoint).build())
+        ->onItem([&dataPoint, onValue](const velocitas::DataPointReply& dataPoints) {
+            try {
+                onValue(toSignalValue(dataPoints.get(dataPoint)->value()));
+            } catch (std::exception& exception) {
+                velocitas::logger().warn("Unable to get value of {}, Exception: {}",
+                                         dataPoint.getPath(), exception.what());
+            }
+        })
+        ->onError(
+            [this](auto&& status) { onErrorDatapoint(std::forward<decltype(status)>(status)); });
+}
 
-        respData[JSON_FIELD_RESULT][JSON_FIELD_STATUS]  = STATUS_FAIL;
-        respData[JSON_FIELD_RESULT][JSON_FIELD_MESSAGE] = errorMsg;
+void SeatAdjusterApp::startSeatControlServer() {
+#ifdef APP_ENABLE_GRPC_SERVICE
+    const auto* address = std::getenv(ENV_GRPC_ADDRESS);
+    if (address == nullptr) {
+        return;
     }
 
-    // Publish the response to the MQTT topic
-    publishToTopic(TOPIC_CoDriver_RESPONSE, respData.dump());
+    try {
+        m_seatControlServer = std::make_unique<SeatControlServer>(
+            address, [this](SeatId seat, int position) {
+                // The handler thread waits for the request to run in order on the seat's executor
+                auto request = std::make_shared<std::packaged_task<SeatRequestResult()>>(
+                    [this, seat, position]() {
+                        return m_seatAdjuster.requestSeatPosition(seat, position,
+                                                                  CommandSource::Grpc);
+                    });
+                auto result = request->get_future();
+                runForSeat(seat, [request]() { (*request)(); });
+                return result.get();
+            });
+    } catch (const std::runtime_error& exception) {
+        velocitas::logger().error("gRPC seat control service disabled: {}", exception.what());
+        return;
+    }
+    velocitas::logger().info("gRPC seat control service listening on {}", address);
+
+    // Positions restored from a snapshot can be queried right away
+    for (const auto seat : {SeatId::Driver, SeatId::CoDriver}) {
+        const auto position = m_seatAdjuster.getCurrentPosition(seat);
+        if (position != SeatAdjuster::POSITION_UNKNOWN) {
+            m_seatControlServer->notifyPositionChanged(seat, position);
+        }
+    }
+#endif
 }
 
-void SeatAdjusterApp::onCoDriverSeatPositionChanged(const velocitas::DataPointReply& dataPoints) {
-    // Callback is executed whenever the subscribed datapoints are updated
-    // The dataPoints parameter contains the updated datapoints
-    nlohmann::json jsonResponse;
+void SeatAdjusterApp::startUdsCommandServer() {
+    const auto* socketPath = std::getenv(ENV_UDS_PATH);
+    if (socketPath == nullptr) {
+        return;
+    }
+
     try {
-        // Get the current seat position
-        const auto seatPositionValue =
-            dataPoints.get(Vehicle.Cabin.Seat.Row1.PassengerSide.Position)->value();
-        jsonResponse[JSON_FIELD_POSITION] = seatPositionValue;
-    } catch (std::exception& exception) {
-        velocitas::logger().warn("Unable to get Current Seat Position, Exception: {}",
-                                 exception.what());
-        jsonResponse[JSON_FIELD_STATUS]  = STATUS_FAIL;
-        jsonResponse[JSON_FIELD_MESSAGE] = exception.what();
+        m_udsCommandServer = std::make_unique<UdsCommandServer>(
+            socketPath,
+            [this](const SeatCommandRequestFrame& request, UdsCommandServer::Responder respond) {
+                // Only moving a seat waits for the databroker, everything else is answered
+                // right away
+                if (request.command != static_cast<uint8_t>(SeatCommand::SetPosition) ||
+                    request.seat >= SEAT_COUNT) {
+                    respond(m_seatAdjuster.onSeatCommandReceived(request));
+                    return;
+                }
+                runForSeat(static_cast<SeatId>(request.seat),
+                           [this, request, respond = std::move(respond)]() {
+                               respond(m_seatAdjuster.onSeatCommandReceived(request));
+                           });
+            });
+    } catch (const std::system_error& exception) {
+        velocitas::logger().error("Unix domain socket command interface disabled: {}",
+                                  exception.what());
+        return;
     }
+    velocitas::logger().info("Unix domain socket command interface listening on {}", socketPath);
+}
+
+void SeatAdjusterApp::updateSeatPosition(SeatId seat, int position) {
+    m_seatAdjuster.onSeatPositionChanged(seat, position);
+}
+
+void SeatAdjusterApp::onPositionPublished([[maybe_unused]] SeatId seat,
+                                          [[maybe_unused]] int    position) {
+#ifdef APP_ENABLE_GRPC_SERVICE
+    if (m_seatControlServer) {
+        m_seatControlServer->notifyPositionChanged(seat, position);
+    }
+#endif
+}
+
+void SeatAdjusterApp::runForSeat(SeatId seat, WorkStealingScheduler::Task task) {
+    m_seatExecutors[toIndex(seat)]->submit(std::move(task));
+}
 
-    // Publish the current seat position to the MQTT topic
-    publishToTopic(TOPIC_CURRENT_CoDriver_POSITION, jsonResponse.dump());
+void SeatAdjusterApp::runForActuators(WorkStealingScheduler::Task task) {
+    m_actuatorExecutor->submit(std::move(task));
 }
 
 // Error handling methods
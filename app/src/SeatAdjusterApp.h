@@ -17,10 +17,23 @@
 #ifndef VEHICLE_APP_SDK_SEATADJUSTER_EXAMPLE_H
 #define VEHICLE_APP_SDK_SEATADJUSTER_EXAMPLE_H
 
+#include "Seat.h"
+#include "SeatAdjuster.h"
+#include "TelemetrySpooler.h"
+#include "TimerService.h"
+#include "UdsCommandServer.h"
+#include "WorkStealingScheduler.h"
 #include "sdk/Status.h"
 #include "sdk/VehicleApp.h"
 #include "vehicle/Vehicle.hpp"
 
+#ifdef APP_ENABLE_GRPC_SERVICE
+#include "SeatControlService.h"
+#endif
+
+#include <array>
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -35,11 +48,82 @@ namespace example {
  *      It also subcribes to the VehicleDataBroker
  *      directly for updates of the
  *      driverseat position signal and publishes this
- *      information via another specific MQTT topic
+ *      information via another specific MQTT topic. Clients which detect a
+ *      gap in its sequence numbers get the last position on the resync topic.
+ *
+ *      Additionally it offers a "hold to move" mode: A client starts
+ *      moving a seat into a direction and keeps the movement alive by
+ *      sending heartbeats. As soon as the heartbeats stop, the seat is
+ *      stopped at its current position.
+ *
+ *      If SEATADJUSTER_AUTOMATION_CONFIG points to a rule file (see
+ *      AutomationEngine), comfort automations triggered by signal changes
+ *      are executed locally through the same seat request pipeline.
+ *
+ *      Other actuators like the wipers or the defroster can be controlled via
+ *      MQTT if they are allowlisted in the file SEATADJUSTER_ACTUATOR_CONFIG
+ *      points to (see ActuatorEngine).
+ *
+ *      Seat usage statistics are computed incrementally and published as
+ *      compact summaries in a fixed interval.
+ *
+ *      If built with APP_ENABLE_GRPC_SERVICE and SEATADJUSTER_GRPC_ADDRESS
+ *      is set, local clients can control the seats via gRPC as well.
+ *      On-host daemons can use the binary protocol (see SeatCommandProtocol.h)
+ *      on the Unix domain socket given by SEATADJUSTER_UDS_PATH. Their set
+ *      position commands run on the seat's executor like the MQTT requests,
+ *      with the vehicle speed read from a subscription instead of the
+ *      databroker, so the socket thread only parses and dispatches frames.
+ *
+ *      If SEATADJUSTER_SNAPSHOT_PATH is set, the app state is persisted in
+ *      that file and restored on restart, see StateSnapshot.
+ *
+ *      If SEATADJUSTER_AUDIT_LOG is set, every seat and actuator command is
+ *      recorded in that durable audit log (see AuditLog).
+ *
+ *      If SEATADJUSTER_CLIENT_RATE is set, the MQTT requests of each client
+ *      are rate limited per seat and served fairly (see FairRequestQueue), so
+ *      one flooding client cannot delay the others.
+ *
+ *      If SEATADJUSTER_RESPONSE_BATCH_WINDOW_MS is set, clients can ask for
+ *      their set position responses to be batched (see ResponseBatcher).
+ *
+ *      SEATADJUSTER_POSITION_FILTER selects a filter for the jitter of the
+ *      reported seat positions (see PositionFilter).
+ *
+ *      If SEATADJUSTER_HISTORY_PATH is set, the seat positions are recorded in
+ *      that file and can be queried via MQTT (see PositionHistory).
+ *
+ *      If SEATADJUSTER_TELEMETRY_DIR is set, all published messages are also
+ *      spooled into compressed files in that directory, which an external
+ *      uploader picks up (see TelemetrySpooler).
+ *
+ *      When run as hot standby (see Supervisor), the app connects to the
+ *      middleware and loads its configuration, but only opens the files shared
+ *      with the active instance, subscribes and starts serving once it takes over.
+ *      If SEATADJUSTER_SHARED_GROUP is set, the request topics are subscribed
+ *      as MQTT shared subscriptions of that group, so a request is handled by
+ *      one instance only even while two of them are subscribed.
+ *
+ *      The seat control logic itself lives in SeatAdjuster, this class
+ *      connects it to the Vehicle DataBroker and the PubSub middleware.
+ *      Seat requests of all interfaces, automation actions and the stop of an
+ *      expired hold to move session run on a WorkStealingScheduler with one
+ *      SerialExecutor per seat, and one for the actuator requests: the
+ *      requests of a seat stay ordered, the seats are served in parallel, and
+ *      a slow Vehicle DataBroker call never blocks the threads receiving the
+ *      requests or the timer thread. gRPC handlers wait for their request to
+ *      run on the executor.
  */
-class SeatAdjusterApp : public velocitas::VehicleApp {
+class SeatAdjusterApp : public velocitas::VehicleApp, private ISeatAdjusterBackend {
 public:
-    SeatAdjusterApp();
+    /**
+     * @brief Blocks a standby instance until it has to take over.
+     * @return false if the instance shall terminate instead.
+     */
+    using TakeoverGate = std::function<bool()>;
+
+    explicit SeatAdjusterApp(TakeoverGate waitForTakeover = {});
 
     /**
      * @brief Run when the vehicle app starts
@@ -65,6 +149,14 @@ public:
 
     void onCoDriverSeatPositionChanged(const velocitas::DataPointReply& dataPoints);
 
+    /**
+     * @brief Handle hold to move requests (start, heartbeat, stop) from PubSub topic
+     *
+     * @param seat  The seat the request is addressed to.
+     * @param data  The JSON string received from PubSub topic.
+     */
+    void onMoveSeatRequestReceived(SeatId seat, const std::string& data);
+
     /**
      * @brief Handle errors which occurred during async invocation.
      *
@@ -75,7 +167,63 @@ public:
     void onErrorTopic(const velocitas::Status& status);
 
 private:
-    vehicle::Vehicle Vehicle;
+    using SignalHandler = std::function<void(const SignalValue&)>;
+
+    double getVehicleSpeed() override;
+    void   setSeatPosition(SeatId seat, int position) override;
+    void   setActuatorValue(const std::string& signal, const SignalValue& value) override;
+    void   publish(const std::string& topic, const std::string& payload) override;
+    void   onPositionPublished(SeatId seat, int position) override;
+    void   runForSeat(SeatId seat, WorkStealingScheduler::Task task) override;
+    void   runForActuators(WorkStealingScheduler::Task task) override;
+
+    std::string getSubscriptionTopic(const std::string& topic) const;
+
+    void startTelemetry();
+    void startAuditLog();
+    void startSnapshots();
+    void startClientFairness();
+    void startResponseBatching();
+    void startPositionFilter();
+    void startPositionHistory();
+    void startAutomation();
+    void startActuators();
+    void subscribeActuators();
+    void subscribeSignals();
+
+    /**
+     * @brief Invoke the visitor with the typed data point of the given VSS path.
+     * @return false if the data point is not supported.
+     */
+    template <typename TVisitor> bool visitDataPoint(const std::string& path, TVisitor&& visitor);
+
+    template <typename TDataPoint>
+    void subscribeSignal(const TDataPoint& dataPoint, const SignalHandler& onValue);
+
+    void startSeatControlServer();
+    void startUdsCommandServer();
+
+    /**
+     * @brief Distribute a reported seat position to all position consumers.
+     */
+    void updateSeatPosition(SeatId seat, int position);
+
+    vehicle::Vehicle                  Vehicle;
+    TakeoverGate                      m_waitForTakeover;
+    std::string                       m_sharedGroupPrefix;
+    std::unique_ptr<TelemetrySpooler> m_telemetrySpooler; // outlives everything publishing
+    std::atomic<double>               m_vehicleSpeed; // of the subscription, NaN until known
+    TimerService                      m_timerService;
+    SeatAdjuster                      m_seatAdjuster;
+    // The scheduler runs all queued requests on destruction, so it is destroyed after
+    // the servers and before the SeatAdjuster and the executors
+    std::array<std::unique_ptr<SerialExecutor>, SEAT_COUNT> m_seatExecutors;
+    std::unique_ptr<SerialExecutor>                         m_actuatorExecutor;
+    WorkStealingScheduler                                   m_scheduler{SEAT_COUNT + 1};
+    std::unique_ptr<UdsCommandServer> m_udsCommandServer;
+#ifdef APP_ENABLE_GRPC_SERVICE
+    std::unique_ptr<SeatControlServer> m_seatControlServer;
+#endif
 };
 
 } // namespace example
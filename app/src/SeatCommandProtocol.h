@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_SEATCOMMANDPROTOCOL_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_SEATCOMMANDPROTOCOL_H
+
+#include <cstdint>
+#include <type_traits>
+
+namespace example {
+
+/**
+ * @brief Binary seat command protocol used on the Unix domain socket interface.
+ * @details Every SOCK_SEQPACKET message carries exactly one frame. Frames are
+ *      exchanged between processes on the same host and therefore use host
+ *      byte order. Frames of unexpected size are answered with
+ *      SeatCommandStatus::InvalidFrame.
+ */
+constexpr uint16_t SEAT_COMMAND_PROTOCOL_VERSION = 1;
+
+enum class SeatCommand : uint8_t {
+    SetPosition = 1,
+    GetPosition = 2,
+};
+
+enum class SeatCommandStatus : uint8_t {
+    Ok           = 0,
+    Failed       = 1, // e.g. rejected because the vehicle is moving
+    InvalidFrame = 2,
+    Unknown      = 3, // e.g. position not reported yet
+};
+
+struct SeatCommandRequestFrame {
+    uint16_t version;
+    uint8_t  command;  // SeatCommand
+    uint8_t  seat;     // SeatId
+    uint32_t requestId;
+    int32_t  position; // target position for SetPosition, ignored otherwise
+    uint32_t reserved;
+};
+
+struct SeatCommandResponseFrame {
+    uint16_t version;
+    uint8_t  command;  // SeatCommand of the request
+    uint8_t  status;   // SeatCommandStatus
+    uint32_t requestId;
+    int32_t  position; // current position for GetPosition, requested one otherwise
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SeatCommandRequestFrame) == 16, "Request frame layout changed");
+static_assert(sizeof(SeatCommandResponseFrame) == 16, "Response frame layout changed");
+static_assert(std::is_trivially_copyable_v<SeatCommandRequestFrame>);
+static_assert(std::is_trivially_copyable_v<SeatCommandResponseFrame>);
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_SEATCOMMANDPROTOCOL_H
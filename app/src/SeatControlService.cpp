@@ -0,0 +1,219 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "SeatControlService.h"
+
+#include <fmt/core.h>
+#include <grpcpp/security/server_credentials.h>
+#include <grpcpp/server_builder.h>
+#include <stdexcept>
+#include <utility>
+
+namespace example {
+
+namespace {
+
+seatadjuster::v1::Seat toProtoSeat(SeatId seat) {
+    return seat == SeatId::Driver ? seatadjuster::v1::SEAT_DRIVER : seatadjuster::v1::SEAT_CODRIVER;
+}
+
+std::optional<SeatId> fromProtoSeat(seatadjuster::v1::Seat seat) {
+    switch (seat) {
+    case seatadjuster::v1::SEAT_DRIVER:
+        return SeatId::Driver;
+    case seatadjuster::v1::SEAT_CODRIVER:
+        return SeatId::CoDriver;
+    default:
+        return std::nullopt;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief A WatchPositions stream, sending the latest position of each seat it has not sent yet.
+ * @details All state is guarded by the service's lock. At most one write is in flight, so
+ *      intermediate positions of a slow client are coalesced.
+ */
+class SeatControlService::PositionWatcher
+    : public grpc::ServerWriteReactor<seatadjuster::v1::SeatPosition> {
+public:
+    explicit PositionWatcher(SeatControlService& service)
+        : m_service(service) {}
+
+    /**
+     * @brief Start writing the next update, unless a write is in flight. Locked by the caller.
+     */
+    void writeNext() {
+        if (m_isWriting || m_isFinished) {
+            return;
+        }
+        if (m_service.m_shuttingDown) {
+            finish(grpc::Status::OK);
+            return;
+        }
+        // Round-robin, so a seat reporting all the time doesn't hold back the other one
+        for (std::size_t i = 0; i < SEAT_COUNT; ++i) {
+            const auto  seatIndex = (m_nextSeatIndex + i) % SEAT_COUNT;
+            const auto& state     = m_service.m_seats[seatIndex];
+            if (state.position && state.version > m_sentVersions[seatIndex]) {
+                m_update.set_seat(toProtoSeat(static_cast<SeatId>(seatIndex)));
+                m_update.set_position(*state.position);
+                m_sentVersions[seatIndex] = state.version;
+                m_nextSeatIndex           = seatIndex + 1;
+                m_isWriting               = true;
+                StartWrite(&m_update);
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Finish the stream once the write in flight is done. Locked by the caller.
+     */
+    void finish(const grpc::Status& status) {
+        if (!m_finishStatus) {
+            m_finishStatus = status;
+        }
+        if (!m_isWriting && !m_isFinished) {
+            m_isFinished = true;
+            Finish(*m_finishStatus);
+        }
+    }
+
+    void OnWriteDone(bool isOk) override {
+        std::lock_guard<ProfiledMutex> lock(m_service.m_mutex);
+        m_isWriting = false;
+        if (!isOk) {
+            finish(grpc::Status::CANCELLED);
+        } else if (m_finishStatus) {
+            finish(*m_finishStatus);
+        } else {
+            writeNext();
+        }
+    }
+
+    void OnCancel() override {
+        std::lock_guard<ProfiledMutex> lock(m_service.m_mutex);
+        finish(grpc::Status::CANCELLED);
+    }
+
+    void OnDone() override {
+        {
+            std::lock_guard<ProfiledMutex> lock(m_service.m_mutex);
+            m_service.m_watchers.erase(this);
+        }
+        delete this;
+    }
+
+private:
+    SeatControlService&              m_service;
+    seatadjuster::v1::SeatPosition   m_update; // of the write in flight
+    std::array<uint64_t, SEAT_COUNT> m_sentVersions{};
+    std::size_t                      m_nextSeatIndex{0};
+    bool                             m_isWriting{false};
+    bool                             m_isFinished{false};
+    std::optional<grpc::Status>      m_finishStatus;
+};
+
+SeatControlService::SeatControlService(SetPositionHandler setPositionHandler)
+    : m_setPositionHandler(std::move(setPositionHandler)) {}
+
+void SeatControlService::notifyPositionChanged(SeatId seat, int position) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    auto&                          state = m_seats[toIndex(seat)];
+    state.position                       = position;
+    state.version                        = ++m_version;
+    for (auto* watcher : m_watchers) {
+        watcher->writeNext();
+    }
+}
+
+void SeatControlService::shutdown() {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_shuttingDown = true;
+    for (auto* watcher : m_watchers) {
+        watcher->finish(grpc::Status::OK);
+    }
+}
+
+grpc::Status SeatControlService::SetPosition(grpc::ServerContext* /*context*/,
+                                             const seatadjuster::v1::SetPositionRequest* request,
+                                             seatadjuster::v1::SetPositionResponse* response) {
+    const auto seat = fromProtoSeat(request->seat());
+    if (!seat) {
+        return {grpc::StatusCode::INVALID_ARGUMENT, "Unknown seat"};
+    }
+    if (request->position() > static_cast<uint32_t>(SEAT_POSITION_MAX)) {
+        return {grpc::StatusCode::INVALID_ARGUMENT,
+                fmt::format("Position {} exceeds maximum of {}", request->position(),
+                            SEAT_POSITION_MAX)};
+    }
+
+    const auto result = m_setPositionHandler(*seat, static_cast<int>(request->position()));
+
+    response->set_request_id(request->request_id());
+    response->set_status(result.status);
+    response->set_message(result.message);
+    return grpc::Status::OK;
+}
+
+grpc::Status SeatControlService::GetPositions(grpc::ServerContext* /*context*/,
+                                              const seatadjuster::v1::GetPositionsRequest* /*request*/,
+                                              seatadjuster::v1::GetPositionsResponse* response) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    for (std::size_t seatIndex = 0; seatIndex < SEAT_COUNT; ++seatIndex) {
+        const auto& state = m_seats[seatIndex];
+        if (state.position) {
+            auto* seatPosition = response->add_positions();
+            seatPosition->set_seat(toProtoSeat(static_cast<SeatId>(seatIndex)));
+            seatPosition->set_position(*state.position);
+        }
+    }
+    return grpc::Status::OK;
+}
+
+grpc::ServerWriteReactor<seatadjuster::v1::SeatPosition>* SeatControlService::WatchPositions(
+    grpc::CallbackServerContext* /*context*/,
+    const seatadjuster::v1::WatchPositionsRequest* /*request*/) {
+    // Writes started before returning the reactor are queued by gRPC
+    auto*                          watcher = new PositionWatcher(*this);
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_watchers.insert(watcher);
+    watcher->writeNext();
+    return watcher;
+}
+
+SeatControlServer::SeatControlServer(const std::string&                     address,
+                                     SeatControlService::SetPositionHandler setPositionHandler)
+    : m_service(std::move(setPositionHandler)) {
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(address, grpc::InsecureServerCredentials());
+    builder.RegisterService(&m_service);
+    m_server = builder.BuildAndStart();
+    if (!m_server) {
+        throw std::runtime_error(fmt::format("Unable to start gRPC server on {}", address));
+    }
+}
+
+SeatControlServer::~SeatControlServer() {
+    // Streams have to end first, otherwise Shutdown() waits for them forever
+    m_service.shutdown();
+    m_server->Shutdown();
+}
+
+} // namespace example
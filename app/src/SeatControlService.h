@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_SEATCONTROLSERVICE_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_SEATCONTROLSERVICE_H
+
+#include "ProfiledMutex.h"
+#include "Seat.h"
+#include "seat_control.grpc.pb.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <grpcpp/server.h>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+
+namespace example {
+
+/**
+ * @brief gRPC seat control service for local clients (e.g. an HMI).
+ * @details Seat requests are delegated to the handler given on construction,
+ *      so they run through the same pipeline as the MQTT requests. Position
+ *      changes have to be fed in via notifyPositionChanged.
+ *
+ *      WatchPositions uses the callback API: a stream holds no server thread,
+ *      its next write is started by a position change or the completion of
+ *      the previous write, and cancellation is delivered as a callback.
+ */
+class SeatControlService final
+    : public seatadjuster::v1::SeatControl::WithCallbackMethod_WatchPositions<
+          seatadjuster::v1::SeatControl::Service> {
+public:
+    using SetPositionHandler = std::function<SeatRequestResult(SeatId, int)>;
+
+    explicit SeatControlService(SetPositionHandler setPositionHandler);
+
+    /**
+     * @brief Update the last known position of a seat and wake all watchers.
+     */
+    void notifyPositionChanged(SeatId seat, int position);
+
+    /**
+     * @brief Terminate all running WatchPositions streams.
+     */
+    void shutdown();
+
+    grpc::Status SetPosition(grpc::ServerContext*                        context,
+                             const seatadjuster::v1::SetPositionRequest* request,
+                             seatadjuster::v1::SetPositionResponse*      response) override;
+
+    grpc::Status GetPositions(grpc::ServerContext*                         context,
+                              const seatadjuster::v1::GetPositionsRequest* request,
+                              seatadjuster::v1::GetPositionsResponse*      response) override;
+
+    grpc::ServerWriteReactor<seatadjuster::v1::SeatPosition>*
+    WatchPositions(grpc::CallbackServerContext*                   context,
+                   const seatadjuster::v1::WatchPositionsRequest* request) override;
+
+private:
+    class PositionWatcher;
+
+    struct SeatState {
+        std::optional<int> position;
+        uint64_t           version{0};
+    };
+
+    SetPositionHandler                m_setPositionHandler;
+    ProfiledMutex                     m_mutex{"SeatControlService"};
+    std::array<SeatState, SEAT_COUNT> m_seats;
+    uint64_t                          m_version{0};
+    std::set<PositionWatcher*>        m_watchers; // deleted by gRPC once done
+    bool                              m_shuttingDown{false};
+};
+
+/**
+ * @brief Hosts the SeatControlService on a gRPC server.
+ */
+class SeatControlServer {
+public:
+    /**
+     * @brief Start serving on the given address, e.g. "0.0.0.0:50051".
+     *
+     * @throws std::runtime_error  If the server cannot be started.
+     */
+    SeatControlServer(const std::string&                     address,
+                      SeatControlService::SetPositionHandler setPositionHandler);
+    ~SeatControlServer();
+
+    void notifyPositionChanged(SeatId seat, int position) {
+        m_service.notifyPositionChanged(seat, position);
+    }
+
+private:
+    SeatControlService            m_service;
+    std::unique_ptr<grpc::Server> m_server;
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_SEATCONTROLSERVICE_H
@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "SeatUsageStatistics.h"
+#include "Json.h"
+
+#include <algorithm>
+
+namespace example {
+
+SeatUsageStatistics::SeatUsageStatistics(Clock::time_point now)
+    : m_intervalStart(now) {}
+
+void SeatUsageStatistics::onPositionChanged(SeatId seat, int position, Clock::time_point now) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    auto&                       statistics = m_seats[toIndex(seat)];
+
+    if (statistics.lastPosition) {
+        if (*statistics.lastPosition == position) {
+            return;
+        }
+        if (!statistics.lastChange || now - *statistics.lastChange > MOVE_PAUSE) {
+            ++statistics.moves;
+        }
+        statistics.lastChange = now;
+        accumulateTimeAtPosition(statistics, now);
+    }
+
+    ++statistics.positionHistogram[toBucket(position)];
+    ++statistics.positionUpdates;
+    statistics.lastPosition       = position;
+    statistics.timeAccountedUntil = now;
+}
+
+void SeatUsageStatistics::onRequest(SeatId seat, bool accepted) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    auto&                       statistics = m_seats[toIndex(seat)];
+    if (accepted) {
+        ++statistics.acceptedRequests;
+    } else {
+        ++statistics.rejectedRequests;
+    }
+}
+
+nlohmann::json SeatUsageStatistics::takeSummary(Clock::time_point now) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+
+    nlohmann::json summary;
+    summary["intervalSeconds"] =
+        std::chrono::duration_cast<std::chrono::seconds>(now - m_intervalStart).count();
+    summary["bucketWidth"] = BUCKET_WIDTH;
+
+    for (std::size_t seatIndex = 0; seatIndex < SEAT_COUNT; ++seatIndex) {
+        auto& statistics = m_seats[seatIndex];
+        accumulateTimeAtPosition(statistics, now);
+
+        std::array<int64_t, BUCKET_COUNT> secondsAtPosition{};
+        std::transform(statistics.secondsAtPosition.begin(), statistics.secondsAtPosition.end(),
+                       secondsAtPosition.begin(),
+                       [](double seconds) { return static_cast<int64_t>(seconds + 0.5); });
+
+        auto& seatSummary                = summary["seats"][toString(static_cast<SeatId>(seatIndex))];
+        seatSummary["positionHistogram"] = statistics.positionHistogram;
+        seatSummary["secondsAtPosition"] = secondsAtPosition;
+        seatSummary["positionUpdates"]   = statistics.positionUpdates;
+        seatSummary["moves"]             = statistics.moves;
+        seatSummary["requests"]          = {{"accepted", statistics.acceptedRequests},
+                                            {"rejected", statistics.rejectedRequests}};
+        if (statistics.lastPosition) {
+            seatSummary["lastPosition"] = *statistics.lastPosition;
+        }
+
+        auto carriedOver               = SeatStatistics();
+        carriedOver.lastPosition       = statistics.lastPosition;
+        carriedOver.lastChange         = statistics.lastChange;
+        carriedOver.timeAccountedUntil = statistics.timeAccountedUntil;
+        statistics                     = carriedOver;
+    }
+
+    m_intervalStart = now;
+    return summary;
+}
+
+std::size_t SeatUsageStatistics::toBucket(int position) {
+    const auto clamped = std::clamp(position, SEAT_POSITION_MIN, SEAT_POSITION_MAX);
+    return static_cast<std::size_t>((clamped - SEAT_POSITION_MIN) / BUCKET_WIDTH);
+}
+
+void SeatUsageStatistics::accumulateTimeAtPosition(SeatStatistics&   statistics,
+                                                   Clock::time_point now) {
+    if (!statistics.lastPosition) {
+        return;
+    }
+    statistics.secondsAtPosition[toBucket(*statistics.lastPosition)] +=
+        std::chrono::duration<double>(now - statistics.timeAccountedUntil).count();
+    statistics.timeAccountedUntil = now;
+}
+
+} // namespace example
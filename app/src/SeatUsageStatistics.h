@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_SEATUSAGESTATISTICS_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_SEATUSAGESTATISTICS_H
+
+#include "ProfiledMutex.h"
+#include "Seat.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json_fwd.hpp>
+#include <optional>
+
+namespace example {
+
+/**
+ * @brief Incrementally computed usage statistics of the seats.
+ * @details Per seat and per reporting interval the following is tracked:
+ *      - histogram of the reported positions (fixed buckets),
+ *      - time spent within each position bucket,
+ *      - number of position updates and of moves, where a move is a series
+ *        of updates without a pause longer than MOVE_PAUSE,
+ *      - number of accepted and rejected seat requests.
+ *
+ *      Memory usage is constant, independent of the number of updates.
+ */
+class SeatUsageStatistics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t BUCKET_COUNT = 10;
+    static constexpr int         BUCKET_WIDTH =
+        (SEAT_POSITION_MAX - SEAT_POSITION_MIN + BUCKET_COUNT) / BUCKET_COUNT;
+    static constexpr auto MOVE_PAUSE = std::chrono::seconds(2);
+
+    explicit SeatUsageStatistics(Clock::time_point now = Clock::now());
+
+    void onPositionChanged(SeatId seat, int position, Clock::time_point now = Clock::now());
+
+    void onRequest(SeatId seat, bool accepted);
+
+    /**
+     * @brief Create a compact summary of the current interval and start a new one.
+     *      The last known position of each seat is carried over.
+     */
+    nlohmann::json takeSummary(Clock::time_point now = Clock::now());
+
+private:
+    struct SeatStatistics {
+        std::array<uint32_t, BUCKET_COUNT> positionHistogram{};
+        std::array<double, BUCKET_COUNT>   secondsAtPosition{};
+        uint32_t                           positionUpdates{0};
+        uint32_t                           moves{0};
+        uint32_t                           acceptedRequests{0};
+        uint32_t                           rejectedRequests{0};
+        std::optional<int>                 lastPosition;
+        std::optional<Clock::time_point>   lastChange;
+        Clock::time_point                  timeAccountedUntil;
+    };
+
+    static std::size_t toBucket(int position);
+    static void        accumulateTimeAtPosition(SeatStatistics& statistics, Clock::time_point now);
+
+    ProfiledMutex                          m_mutex{"SeatUsageStatistics"};
+    Clock::time_point                      m_intervalStart;
+    std::array<SeatStatistics, SEAT_COUNT> m_seats;
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_SEATUSAGESTATISTICS_H
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "SignalCondition.h"
+#include "Json.h"
+
+#include <fmt/core.h>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace example {
+
+SignalValue parseSignalValue(const nlohmann::json& value) {
+    if (value.is_boolean()) {
+        return value.get<bool>();
+    }
+    if (value.is_number()) {
+        return value.get<double>();
+    }
+    if (value.is_string()) {
+        return value.get<std::string>();
+    }
+    throw std::invalid_argument(fmt::format("Unsupported signal value: {}", value.dump()));
+}
+
+nlohmann::json toJson(const SignalValue& value) {
+    return std::visit([](const auto& alternative) { return nlohmann::json(alternative); }, value);
+}
+
+SignalCondition SignalCondition::fromJson(const nlohmann::json& config) {
+    static const std::unordered_map<std::string, CompareOp> OPERATORS{
+        {"==", CompareOp::Equal},   {"!=", CompareOp::NotEqual},
+        {"<", CompareOp::Less},     {"<=", CompareOp::LessEqual},
+        {">", CompareOp::Greater},  {">=", CompareOp::GreaterEqual}};
+
+    const auto opName     = config.at("op").get<std::string>();
+    const auto opIterator = OPERATORS.find(opName);
+    if (opIterator == OPERATORS.end()) {
+        throw std::invalid_argument(fmt::format("Unknown operator \"{}\"", opName));
+    }
+    return {config.at("signal").get<std::string>(), opIterator->second,
+            parseSignalValue(config.at("value"))};
+}
+
+bool SignalCondition::isMetBy(const SignalValue& signalValue) const {
+    if (signalValue.index() != value.index()) {
+        return false;
+    }
+    switch (op) {
+    case CompareOp::Equal:
+        return signalValue == value;
+    case CompareOp::NotEqual:
+        return signalValue != value;
+    default:
+        break;
+    }
+
+    const auto* lhsNumber = std::get_if<double>(&signalValue);
+    const auto* rhsNumber = std::get_if<double>(&value);
+    if (lhsNumber == nullptr || rhsNumber == nullptr) {
+        return false;
+    }
+    switch (op) {
+    case CompareOp::Less:
+        return *lhsNumber < *rhsNumber;
+    case CompareOp::LessEqual:
+        return *lhsNumber <= *rhsNumber;
+    case CompareOp::Greater:
+        return *lhsNumber > *rhsNumber;
+    case CompareOp::GreaterEqual:
+        return *lhsNumber >= *rhsNumber;
+    default:
+        return false;
+    }
+}
+
+} // namespace example
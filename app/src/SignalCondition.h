@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_SIGNALCONDITION_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_SIGNALCONDITION_H
+
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <variant>
+
+namespace example {
+
+/**
+ * @brief Value of a vehicle signal, all numeric types are represented as double.
+ */
+using SignalValue = std::variant<bool, double, std::string>;
+
+/**
+ * @brief Convert a JSON value into a signal value.
+ *
+ * @throws std::invalid_argument  If the value is neither a boolean, a number nor a string.
+ */
+SignalValue parseSignalValue(const nlohmann::json& value);
+
+nlohmann::json toJson(const SignalValue& value);
+
+/**
+ * @brief Comparison of a signal against a constant, configured as
+ *      {"signal": "Vehicle.Speed", "op": "<=", "value": 5}.
+ */
+struct SignalCondition {
+    enum class CompareOp { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+    /**
+     * @throws std::invalid_argument    If the operator or value is not supported.
+     * @throws nlohmann::json::exception  If a field is missing or has the wrong type.
+     */
+    static SignalCondition fromJson(const nlohmann::json& config);
+
+    /**
+     * @brief Check the condition against the current value of its signal.
+     *      Values of different types never match, strings and booleans only
+     *      support (in)equality.
+     */
+    bool isMetBy(const SignalValue& signalValue) const;
+
+    std::string signal;
+    CompareOp   op;
+    SignalValue value;
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_SIGNALCONDITION_H
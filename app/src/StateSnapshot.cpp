@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "StateSnapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace example {
+
+namespace {
+
+constexpr uint32_t SNAPSHOT_MAGIC   = 0x53415353; // "SASS"
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+constexpr std::size_t SLOT_COUNT = 2;
+
+[[noreturn]] void throwSystemError(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace
+
+struct StateSnapshotFile::Layout {
+    struct Slot {
+        // Odd while the slot is written, 2 * generation once complete, 0 if never written
+        std::atomic<uint64_t> sequence;
+        StateSnapshot         snapshot;
+    };
+
+    uint32_t                     magic;
+    uint32_t                     version;
+    uint32_t                     size;
+    std::array<Slot, SLOT_COUNT> slots;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+StateSnapshotFile::StateSnapshotFile(const std::string& path) {
+    const auto fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        throwSystemError(path);
+    }
+
+    struct stat fileStat {};
+    if (::fstat(fd, &fileStat) < 0 ||
+        (fileStat.st_size != sizeof(Layout) && ::ftruncate(fd, sizeof(Layout)) < 0)) {
+        const auto error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), path);
+    }
+
+    auto* mapping = ::mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // The mapping stays valid without the file descriptor
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throwSystemError(path);
+    }
+    m_layout = static_cast<Layout*>(mapping);
+
+    if (m_layout->magic != SNAPSHOT_MAGIC || m_layout->version != SNAPSHOT_VERSION ||
+        m_layout->size != sizeof(Layout)) {
+        std::memset(static_cast<void*>(m_layout), 0, sizeof(Layout));
+        m_layout->magic   = SNAPSHOT_MAGIC;
+        m_layout->version = SNAPSHOT_VERSION;
+        m_layout->size    = sizeof(Layout);
+    }
+
+    for (const auto& slot : m_layout->slots) {
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence % 2 == 0) {
+            m_generation = std::max(m_generation, sequence / 2);
+        }
+    }
+}
+
+StateSnapshotFile::~StateSnapshotFile() { ::munmap(m_layout, sizeof(Layout)); }
+
+std::optional<StateSnapshot> StateSnapshotFile::load() const {
+    std::optional<StateSnapshot> newest;
+    uint64_t                     newestSequence = 0;
+    for (const auto& slot : m_layout->slots) {
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence == 0 || sequence % 2 != 0 || sequence < newestSequence) {
+            continue;
+        }
+        StateSnapshot snapshot;
+        std::memcpy(&snapshot, &slot.snapshot, sizeof(snapshot));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+            newest         = snapshot;
+            newestSequence = sequence;
+        }
+    }
+    return newest;
+}
+
+void StateSnapshotFile::store(const StateSnapshot& snapshot) {
+    ++m_generation;
+    auto& slot = m_layout->slots[m_generation % SLOT_COUNT];
+    slot.sequence.store(2 * m_generation - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slot.snapshot, &snapshot, sizeof(snapshot));
+    slot.sequence.store(2 * m_generation, std::memory_order_release);
+}
+
+} // namespace example
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_STATESNAPSHOT_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_STATESNAPSHOT_H
+
+#include "IdempotencyCache.h"
+#include "Seat.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+namespace example {
+
+/**
+ * @brief Compact copy of the SeatAdjuster state which survives a restart.
+ * @details Plain data only, it is copied byte-wise into the snapshot file.
+ *      Points in time are ticks of TimerService::Clock, which keeps running
+ *      across process restarts (but not reboots, which clear tmpfs anyway).
+ */
+struct StateSnapshot {
+    enum MoveDirectionValue : uint8_t { MOVE_NONE = 0, MOVE_FORWARD = 1, MOVE_BACKWARD = 2 };
+
+    struct Seat {
+        int32_t position;
+        uint8_t moveDirection;
+    };
+
+    struct Request {
+        int64_t receivedAt;
+        int32_t requestId;
+        int32_t position;
+        uint8_t seat;
+        uint8_t status;
+    };
+
+    int64_t                                         takenAt;
+    std::array<Seat, SEAT_COUNT>                    seats;
+    uint32_t                                        requestCount;
+    std::array<Request, IdempotencyCache::CAPACITY> requests;
+};
+
+static_assert(std::is_trivially_copyable_v<StateSnapshot>);
+
+/**
+ * @brief Memory-mapped file holding the latest StateSnapshot, meant to be placed on tmpfs.
+ * @details Storing a snapshot is a plain memory copy without any system call.
+ *      The file has two slots which are written alternately, each guarded by
+ *      a sequence number which is odd while the slot is written. If the app
+ *      dies while storing, the other slot still holds a complete snapshot.
+ */
+class StateSnapshotFile {
+public:
+    /**
+     * @brief Open or create the snapshot file. Files of another layout are reset.
+     *
+     * @throws std::system_error  If the file cannot be opened or mapped.
+     */
+    explicit StateSnapshotFile(const std::string& path);
+    ~StateSnapshotFile();
+
+    StateSnapshotFile(const StateSnapshotFile&)            = delete;
+    StateSnapshotFile& operator=(const StateSnapshotFile&) = delete;
+
+    /**
+     * @brief Return the most recently stored complete snapshot, if any.
+     */
+    std::optional<StateSnapshot> load() const;
+
+    /**
+     * @brief Store a snapshot. Not thread-safe, there must be a single writer.
+     */
+    void store(const StateSnapshot& snapshot);
+
+private:
+    struct Layout;
+
+    Layout*  m_layout{nullptr};
+    uint64_t m_generation{0};
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_STATESNAPSHOT_H
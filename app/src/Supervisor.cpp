@@ -0,0 +1,190 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "Supervisor.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+
+namespace example {
+
+namespace {
+
+// Children dying faster than this are considered crash looping and respawned with a delay
+constexpr auto MIN_CHILD_LIFETIME = std::chrono::seconds(1);
+constexpr auto RESPAWN_DELAY      = std::chrono::seconds(1);
+
+[[noreturn]] void throwSystemError(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+int64_t toNanoseconds(std::chrono::steady_clock::time_point timePoint) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(timePoint.time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+struct Supervisor::SharedState {
+    sem_t                takeover;
+    std::atomic<int64_t> activeDiedAt; // steady clock, which is system-wide
+};
+
+static_assert(std::atomic<int64_t>::is_always_lock_free);
+
+Supervisor::Supervisor(ChildMain childMain)
+    : m_childMain(std::move(childMain))
+    , m_supervisorPid(::getpid()) {
+    // Anonymous shared mappings are inherited by all forked children
+    auto* mapping = ::mmap(nullptr, sizeof(SharedState), PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        throwSystemError("mmap");
+    }
+    m_sharedState = new (mapping) SharedState{};
+    if (::sem_init(&m_sharedState->takeover, 1, 0) < 0) {
+        const auto error = errno;
+        ::munmap(mapping, sizeof(SharedState));
+        throw std::system_error(error, std::generic_category(), "sem_init");
+    }
+}
+
+Supervisor::~Supervisor() {
+    ::sem_destroy(&m_sharedState->takeover);
+    ::munmap(m_sharedState, sizeof(SharedState));
+}
+
+int Supervisor::run() {
+    m_activePid  = spawn(Role::Active);
+    m_standbyPid = spawn(Role::Standby);
+    auto activeStartedAt  = std::chrono::steady_clock::now();
+    auto standbyStartedAt = activeStartedAt;
+
+    for (;;) {
+        int        status = 0;
+        const auto pid    = ::waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // ECHILD: all children have terminated
+            return 0;
+        }
+        if (m_stopping) {
+            continue;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (pid == m_activePid) {
+            m_sharedState->activeDiedAt.store(toNanoseconds(now));
+            const auto lifetime = now - activeStartedAt;
+            if (m_standbyPid != 0) {
+                promoteStandby();
+                activeStartedAt = standbyStartedAt;
+            } else {
+                m_activePid     = spawn(Role::Active);
+                activeStartedAt = now;
+            }
+            if (lifetime < MIN_CHILD_LIFETIME) {
+                std::this_thread::sleep_for(RESPAWN_DELAY);
+            }
+        } else if (pid == m_standbyPid) {
+            m_standbyPid = 0;
+            if (now - standbyStartedAt < MIN_CHILD_LIFETIME) {
+                std::this_thread::sleep_for(RESPAWN_DELAY);
+            }
+        } else {
+            continue;
+        }
+
+        if (m_standbyPid == 0 && !m_stopping) {
+            m_standbyPid     = spawn(Role::Standby);
+            standbyStartedAt = std::chrono::steady_clock::now();
+        }
+    }
+}
+
+void Supervisor::stop() {
+    // Children inherit the signal handlers of the supervisor, this must not act there
+    if (::getpid() != m_supervisorPid) {
+        return;
+    }
+    m_stopping = true;
+    for (const auto pid : {m_activePid.load(), m_standbyPid.load()}) {
+        if (pid > 0) {
+            ::kill(pid, SIGINT);
+        }
+    }
+}
+
+pid_t Supervisor::spawn(Role role) {
+    if (role == Role::Standby) {
+        // A takeover left over from a standby which died meanwhile must not promote the new one
+        while (::sem_trywait(&m_sharedState->takeover) == 0) {
+        }
+    }
+
+    const auto pid = ::fork();
+    if (pid < 0) {
+        throwSystemError("fork");
+    }
+    if (pid > 0) {
+        // stop() may have been called before the pid was known
+        if (m_stopping) {
+            ::kill(pid, SIGINT);
+        }
+        return pid;
+    }
+
+    ::prctl(PR_SET_PDEATHSIG, SIGINT);
+    if (::getppid() != m_supervisorPid) {
+        ::_exit(EXIT_FAILURE);
+    }
+
+    const TakeoverWait waitForTakeover = [this]() -> std::optional<std::chrono::microseconds> {
+        if (::sem_wait(&m_sharedState->takeover) < 0) {
+            return std::nullopt;
+        }
+        const auto diedAt = std::chrono::steady_clock::time_point(
+            std::chrono::nanoseconds(m_sharedState->activeDiedAt.load()));
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - diedAt);
+    };
+    const auto exitCode = m_childMain(role, waitForTakeover);
+    // Skip the exit handlers of the supervisor's copy of the process image
+    std::fflush(nullptr);
+    ::_exit(exitCode);
+}
+
+void Supervisor::promoteStandby() {
+    m_activePid  = m_standbyPid.load();
+    m_standbyPid = 0;
+    ::sem_post(&m_sharedState->takeover);
+}
+
+} // namespace example
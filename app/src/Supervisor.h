@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_SUPERVISOR_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_SUPERVISOR_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <sys/types.h>
+
+namespace example {
+
+/**
+ * @brief Keeps an active app process and a hot standby process running.
+ * @details Both processes are forked from the supervisor and run the given
+ *      child main function. The standby initializes as far as possible and then
+ *      blocks in waitForTakeover(). Once the active process dies, the supervisor
+ *      promotes the standby via a process-shared semaphore, which wakes it up
+ *      immediately, and forks a new standby.
+ *
+ *      State is handed over by the app itself, e.g. via a StateSnapshotFile on
+ *      tmpfs which both processes open.
+ */
+class Supervisor {
+public:
+    enum class Role { Active, Standby };
+
+    /**
+     * @brief Block a standby until it has to take over.
+     * @return The time since the active process died, or nullopt if the wait was
+     *      interrupted by a signal and the standby shall terminate.
+     */
+    using TakeoverWait = std::function<std::optional<std::chrono::microseconds>()>;
+    using ChildMain    = std::function<int(Role role, const TakeoverWait& waitForTakeover)>;
+
+    /**
+     * @brief Set up the shared memory segment used to signal a takeover.
+     *
+     * @throws std::system_error  If the segment cannot be set up.
+     */
+    explicit Supervisor(ChildMain childMain);
+    ~Supervisor();
+
+    Supervisor(const Supervisor&)            = delete;
+    Supervisor& operator=(const Supervisor&) = delete;
+
+    /**
+     * @brief Fork the processes and supervise them until stop() is called.
+     * @return The exit code for the supervisor process.
+     */
+    int run();
+
+    /**
+     * @brief Terminate the children (via SIGINT) and make run() return.
+     *      Async-signal-safe, may be called from a signal handler.
+     */
+    void stop();
+
+private:
+    struct SharedState;
+
+    pid_t spawn(Role role);
+    void  promoteStandby();
+
+    ChildMain          m_childMain;
+    SharedState*       m_sharedState{nullptr};
+    const pid_t        m_supervisorPid;
+    std::atomic<pid_t> m_activePid{0};
+    std::atomic<pid_t> m_standbyPid{0};
+    std::atomic<bool>  m_stopping{false};
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_SUPERVISOR_H
@@ -0,0 +1,361 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "TelemetrySpooler.h"
+#include "Json.h"
+#include "ThreadStatistics.h"
+#include "sdk/Logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fmt/core.h>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+#include <zdict.h>
+#include <zstd.h>
+
+namespace example {
+
+namespace {
+
+constexpr auto FILE_PREFIX   = "telemetry-";
+constexpr auto FILE_SUFFIX   = ".jsonl.zst";
+constexpr auto UNSEALED_MARK = ".part";
+
+// The flusher is woken up early once this much is buffered, records are dropped beyond the limit
+constexpr std::size_t FLUSH_BYTES        = 64 * 1024;
+constexpr std::size_t MAX_BUFFERED_BYTES = 16 * FLUSH_BYTES;
+
+// 128 KiB window: keeps the compressor state small, records far apart share little anyway
+constexpr int WINDOW_LOG = 17;
+
+int64_t getUnixTimeMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool writeAll(int fd, const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        const auto written = ::write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+std::string getSealedPath(const std::string& path) {
+    return path.substr(0, path.size() - std::strlen(UNSEALED_MARK));
+}
+
+} // namespace
+
+TelemetrySpooler::TelemetrySpooler(Config config)
+    : m_config(std::move(config))
+    , m_output(ZSTD_CStreamOutSize()) {
+    std::string dictionary;
+    if (!m_config.dictionaryPath.empty()) {
+        dictionary = readTelemetryFile(m_config.dictionaryPath);
+        // Also checks the entropy tables, so a broken dictionary does not fail every file later
+        if (ZDICT_isError(ZDICT_getDictHeaderSize(dictionary.data(), dictionary.size()))) {
+            throw std::invalid_argument("Not a zstd dictionary: " + m_config.dictionaryPath);
+        }
+    }
+    sealLeftoverFiles();
+
+    m_context = ZSTD_createCCtx();
+    ZSTD_CCtx_setParameter(m_context, ZSTD_c_compressionLevel, m_config.compressionLevel);
+    ZSTD_CCtx_setParameter(m_context, ZSTD_c_windowLog, WINDOW_LOG);
+    ZSTD_CCtx_setParameter(m_context, ZSTD_c_checksumFlag, 1);
+    if (!dictionary.empty()) {
+        // Loaded rather than a prepared CDict, whose parameters would override the window size.
+        // The dictionary is only digested once per file.
+        ZSTD_CCtx_loadDictionary(m_context, dictionary.data(), dictionary.size());
+        velocitas::logger().info("Compressing telemetry with dictionary {}",
+                                 ZDICT_getDictID(dictionary.data(), dictionary.size()));
+    }
+    m_buffer.reserve(FLUSH_BYTES);
+    m_thread = std::thread([this]() { run(); });
+}
+
+TelemetrySpooler::~TelemetrySpooler() {
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_flushNeeded.notify_one();
+    m_thread.join();
+    ZSTD_freeCCtx(m_context);
+}
+
+void TelemetrySpooler::append(const std::string& topic, const std::string& payload) {
+    const auto line = fmt::format(R"({{"timestamp":{},"topic":{},"payload":{}}})",
+                                  getUnixTimeMs(), nlohmann::json(topic).dump(), payload);
+
+    bool isFirstOrBatchFull;
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        if (m_buffer.size() + line.size() + 1 > MAX_BUFFERED_BYTES) {
+            ++m_droppedRecords;
+            return;
+        }
+        if (m_buffer.empty()) {
+            m_oldestBuffered = std::chrono::steady_clock::now();
+        }
+        const auto previousSize = m_buffer.size();
+        m_buffer += line;
+        m_buffer += '\n';
+        isFirstOrBatchFull =
+            previousSize == 0 || (previousSize < FLUSH_BYTES && m_buffer.size() >= FLUSH_BYTES);
+    }
+    // The flusher only needs to know when to start its flush interval, and when a batch is full
+    if (isFirstOrBatchFull) {
+        m_flushNeeded.notify_one();
+    }
+}
+
+void TelemetrySpooler::sealLeftoverFiles() {
+    DIR* directory = opendir(m_config.directory.c_str());
+    if (directory == nullptr) {
+        throw std::system_error(errno, std::generic_category(), m_config.directory);
+    }
+    const auto               unsealedSuffix = std::string(FILE_SUFFIX) + UNSEALED_MARK;
+    std::vector<std::string> leftovers;
+    while (const auto* entry = readdir(directory)) {
+        const std::string name = entry->d_name;
+        if (name.rfind(FILE_PREFIX, 0) == 0 && endsWith(name, unsealedSuffix)) {
+            leftovers.push_back(m_config.directory + "/" + name);
+        }
+    }
+    closedir(directory);
+
+    for (const auto& path : leftovers) {
+        velocitas::logger().warn("Sealing unfinished telemetry file {}", path);
+        ::rename(path.c_str(), getSealedPath(path).c_str());
+    }
+}
+
+void TelemetrySpooler::run() {
+    setCurrentThreadName("sa-telemetry");
+
+    std::unique_lock<ProfiledMutex> lock(m_mutex);
+    for (;;) {
+        const auto now        = std::chrono::steady_clock::now();
+        const auto flushAt    = m_oldestBuffered + m_config.flushInterval;
+        const auto sealAt     = m_fileOpenedAt + m_config.maxFileAge;
+        const bool isFlushDue = !m_buffer.empty() &&
+                                (m_stopping || m_buffer.size() >= FLUSH_BYTES || now >= flushAt);
+        const bool isSealDue  = m_fd >= 0 && (m_stopping || now >= sealAt);
+        if (!isFlushDue && !isSealDue) {
+            if (m_stopping) {
+                return;
+            }
+            if (m_buffer.empty() && m_fd < 0) {
+                m_flushNeeded.wait(lock);
+            } else if (m_buffer.empty()) {
+                m_flushNeeded.wait_until(lock, sealAt);
+            } else {
+                m_flushNeeded.wait_until(lock, m_fd >= 0 ? std::min(flushAt, sealAt) : flushAt);
+            }
+            continue;
+        }
+
+        const auto isStopping = m_stopping;
+        m_flushing.swap(m_buffer);
+        lock.unlock();
+
+        if (!m_flushing.empty()) {
+            writeBatch(m_flushing);
+            m_flushing.clear();
+        }
+        // The file may have just been opened, so its age is taken again
+        const auto fileAge = std::chrono::steady_clock::now() - m_fileOpenedAt;
+        if (m_fd >= 0 && (isStopping || fileAge >= m_config.maxFileAge)) {
+            sealFile();
+        }
+
+        lock.lock();
+    }
+}
+
+bool TelemetrySpooler::openFile() {
+    // Another instance may have created a file in the same millisecond, which is not replaced
+    const auto timestamp = getUnixTimeMs();
+    for (;;) {
+        m_filePath = fmt::format("{}/{}{}-{}{}{}", m_config.directory, FILE_PREFIX, timestamp,
+                                 m_fileCount++, FILE_SUFFIX, UNSEALED_MARK);
+        if (::access(getSealedPath(m_filePath).c_str(), F_OK) == 0) {
+            continue;
+        }
+        m_fd = ::open(m_filePath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0640);
+        if (m_fd >= 0 || errno != EEXIST) {
+            break;
+        }
+    }
+    if (m_fd < 0) {
+        velocitas::logger().error("Unable to create telemetry file {}: {}", m_filePath,
+                                  std::strerror(errno));
+        return false;
+    }
+    ZSTD_CCtx_reset(m_context, ZSTD_reset_session_only);
+    m_fileSize     = 0;
+    m_fileOpenedAt = std::chrono::steady_clock::now();
+    return true;
+}
+
+void TelemetrySpooler::writeBatch(const std::string& batch) {
+    if (m_fd < 0 && !openFile()) {
+        return;
+    }
+    // Flushing ends the batch on a block boundary, so it can be decompressed even without the
+    // end of the frame
+    if (!compress(batch, ZSTD_e_flush)) {
+        abandonFile();
+        return;
+    }
+    if (m_fileSize >= m_config.maxFileBytes) {
+        sealFile();
+    }
+}
+
+bool TelemetrySpooler::compress(const std::string& data, int mode) {
+    ZSTD_inBuffer input{data.data(), data.size(), 0};
+    for (;;) {
+        ZSTD_outBuffer output{m_output.data(), m_output.size(), 0};
+        const auto     remaining = ZSTD_compressStream2(m_context, &output, &input,
+                                                        static_cast<ZSTD_EndDirective>(mode));
+        if (ZSTD_isError(remaining)) {
+            velocitas::logger().error("Unable to compress telemetry: {}",
+                                      ZSTD_getErrorName(remaining));
+            return false;
+        }
+        if (!writeAll(m_fd, m_output.data(), output.pos)) {
+            velocitas::logger().error("Unable to write telemetry file {}: {}", m_filePath,
+                                      std::strerror(errno));
+            return false;
+        }
+        m_fileSize += output.pos;
+        if (remaining == 0) {
+            return true;
+        }
+    }
+}
+
+void TelemetrySpooler::sealFile() {
+    if (!compress({}, ZSTD_e_end) || ::fdatasync(m_fd) < 0) {
+        abandonFile();
+        return;
+    }
+    ::close(m_fd);
+    m_fd = -1;
+    if (::rename(m_filePath.c_str(), getSealedPath(m_filePath).c_str()) < 0) {
+        velocitas::logger().error("Unable to seal telemetry file {}: {}", m_filePath,
+                                  std::strerror(errno));
+    }
+}
+
+void TelemetrySpooler::abandonFile() {
+    velocitas::logger().error("Dropping telemetry file {}", m_filePath);
+    ::close(m_fd);
+    m_fd = -1;
+    ::unlink(m_filePath.c_str());
+}
+
+std::string readTelemetryFile(const std::string& path) {
+    const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), path);
+    }
+    std::string content;
+    char        chunk[64 * 1024];
+    for (;;) {
+        const auto bytesRead = ::read(fd, chunk, sizeof(chunk));
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead < 0) {
+            const auto error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), path);
+        }
+        if (bytesRead == 0) {
+            break;
+        }
+        content.append(chunk, static_cast<std::size_t>(bytesRead));
+    }
+    ::close(fd);
+    return content;
+}
+
+TelemetryReadResult readTelemetryRecords(const std::string& path, const std::string& dictionary,
+                                         const std::function<void(const std::string&)>& onRecord) {
+    const auto compressed = readTelemetryFile(path);
+
+    auto* context = ZSTD_createDCtx();
+    if (!dictionary.empty()) {
+        ZSTD_DCtx_loadDictionary(context, dictionary.data(), dictionary.size());
+    }
+
+    TelemetryReadResult result;
+    std::vector<char>   output(ZSTD_DStreamOutSize());
+    std::string         line;
+    ZSTD_inBuffer       input{compressed.data(), compressed.size(), 0};
+    std::size_t         remaining = 1;
+    for (;;) {
+        ZSTD_outBuffer decompressed{output.data(), output.size(), 0};
+        remaining = ZSTD_decompressStream(context, &decompressed, &input);
+        if (ZSTD_isError(remaining)) {
+            break;
+        }
+        for (std::size_t index = 0; index < decompressed.pos; ++index) {
+            if (output[index] != '\n') {
+                line += output[index];
+                continue;
+            }
+            ++result.records;
+            onRecord(line);
+            line.clear();
+        }
+        // A partly filled output buffer means the decoder has nothing more to flush
+        if (input.pos == input.size && decompressed.pos < decompressed.size) {
+            break;
+        }
+    }
+    ZSTD_freeDCtx(context);
+    result.isComplete = remaining == 0 && line.empty();
+    return result;
+}
+
+} // namespace example
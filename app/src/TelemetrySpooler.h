@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_TELEMETRYSPOOLER_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_TELEMETRYSPOOLER_H
+
+#include "ProfiledMutex.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ZSTD_CCtx_s;
+
+namespace example {
+
+/**
+ * @brief Spools telemetry records into zstd compressed files for an external uploader.
+ * @details Every record is one JSON line with the time, topic and payload of a
+ *      message. Writers only append the line to an in-memory buffer; a single
+ *      flusher thread compresses the buffered lines as one stream step into the
+ *      file being written, once the flush interval has passed since the oldest
+ *      buffered line or enough lines are buffered. Compression is streaming with
+ *      a small window, so neither a file nor a batch is ever held in memory as a
+ *      whole. If the disk cannot keep up, records beyond a fixed buffer size are
+ *      dropped (and counted) instead of blocking the writers.
+ *
+ *      Small records share most of their bytes (topic names, field names) with
+ *      the other records, but not within the few hundred bytes zstd has seen of a
+ *      fresh file. A dictionary trained on sample records (see the
+ *      telemetry_dict_trainer tool) provides that context up front and improves
+ *      the compression ratio several times.
+ *
+ *      The file being written is named "telemetry-<ms>-<n>.jsonl.zst.part". It is
+ *      sealed by ending its zstd frame and renaming it without the ".part" suffix
+ *      once it holds the maximum number of compressed bytes or has been open for
+ *      the maximum age, so an uploader only picks up "*.jsonl.zst" files and may
+ *      delete them once uploaded. A ".part" file left by a crash is sealed as it
+ *      is when the spooler starts again; its frame has no end, but every flushed
+ *      batch in it can still be decompressed.
+ */
+class TelemetrySpooler {
+public:
+    struct Config {
+        std::string               directory;
+        std::string               dictionaryPath; // no dictionary if empty
+        int                       compressionLevel{3};
+        std::chrono::milliseconds flushInterval{1000};
+        std::size_t               maxFileBytes{1024 * 1024};
+        std::chrono::milliseconds maxFileAge{5 * 60 * 1000};
+    };
+
+    /**
+     * @brief Load the dictionary, seal files left by a previous run and start the flusher thread.
+     *
+     * @throws std::system_error      If the directory or the dictionary cannot be read.
+     * @throws std::invalid_argument  If the dictionary is invalid.
+     */
+    explicit TelemetrySpooler(Config config);
+
+    /**
+     * @brief Write all buffered records, seal the current file and stop the flusher thread.
+     */
+    ~TelemetrySpooler();
+
+    TelemetrySpooler(const TelemetrySpooler&)            = delete;
+    TelemetrySpooler& operator=(const TelemetrySpooler&) = delete;
+
+    /**
+     * @brief Spool a message. The payload must be a JSON value.
+     */
+    void append(const std::string& topic, const std::string& payload);
+
+    uint64_t getDroppedRecordCount() const { return m_droppedRecords.load(); }
+
+private:
+    void sealLeftoverFiles();
+    void run();
+    bool openFile();
+    void writeBatch(const std::string& batch);
+    bool compress(const std::string& data, int mode);
+    void sealFile();
+    void abandonFile();
+
+    const Config                          m_config;
+    ZSTD_CCtx_s*                          m_context{nullptr};
+    ProfiledMutex                         m_mutex{"TelemetrySpooler"};
+    ProfiledConditionVariable             m_flushNeeded;
+    std::string                           m_buffer;
+    std::chrono::steady_clock::time_point m_oldestBuffered;
+    bool                                  m_stopping{false};
+    std::atomic<uint64_t>                 m_droppedRecords{0};
+    // Only accessed by the flusher thread once started
+    std::string                           m_flushing;
+    std::vector<char>                     m_output;
+    uint64_t                              m_fileCount{0};
+    std::string                           m_filePath;
+    int                                   m_fd{-1};
+    std::size_t                           m_fileSize{0};
+    std::chrono::steady_clock::time_point m_fileOpenedAt;
+    std::thread                           m_thread;
+};
+
+/**
+ * @brief Result of reading a telemetry file.
+ */
+struct TelemetryReadResult {
+    std::size_t records{0};
+    bool        isComplete{false}; // false if the frame has no end or is corrupt
+};
+
+/**
+ * @brief Read a whole file, e.g. a dictionary.
+ *
+ * @throws std::system_error  If the file cannot be read.
+ */
+std::string readTelemetryFile(const std::string& path);
+
+/**
+ * @brief Decompress a telemetry file and pass each record (without line break) in order.
+ *
+ * @param dictionary  The dictionary the file was compressed with, or empty.
+ * @throws std::system_error  If the file cannot be read.
+ */
+TelemetryReadResult readTelemetryRecords(const std::string& path, const std::string& dictionary,
+                                         const std::function<void(const std::string&)>& onRecord);
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_TELEMETRYSPOOLER_H
@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "ThreadStatistics.h"
+#include "Json.h"
+
+#include <cstdint>
+#include <dirent.h>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <pthread.h>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace example {
+
+namespace {
+
+const auto TASK_DIRECTORY = "/proc/self/task";
+
+// Longest name accepted by pthread_setname_np, without the terminating null
+constexpr std::size_t THREAD_NAME_MAX_LENGTH = 15;
+
+std::optional<std::string> readFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return std::nullopt;
+    }
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+std::vector<std::string> listTaskIds() {
+    std::vector<std::string> taskIds;
+    DIR*                     directory = opendir(TASK_DIRECTORY);
+    if (directory == nullptr) {
+        return taskIds;
+    }
+    while (const auto* entry = readdir(directory)) {
+        if (entry->d_name[0] != '.') {
+            taskIds.emplace_back(entry->d_name);
+        }
+    }
+    closedir(directory);
+    return taskIds;
+}
+
+uint64_t getStatusValue(const std::string& status, const std::string& key) {
+    const auto keyPos = status.find(key + ":");
+    if (keyPos == std::string::npos) {
+        return 0;
+    }
+    return std::stoull(status.substr(keyPos + key.size() + 1));
+}
+
+bool addCpuTimes(const std::string& stat, nlohmann::json& thread) {
+    // The name in parentheses may contain spaces, fields are counted after it
+    const auto nameEnd = stat.rfind(')');
+    if (nameEnd == std::string::npos) {
+        return false;
+    }
+    std::istringstream       fields(stat.substr(nameEnd + 1));
+    std::vector<std::string> values{std::istream_iterator<std::string>(fields),
+                                    std::istream_iterator<std::string>()};
+    // utime and stime are fields 14 and 15 of stat, the first field after the name is 3
+    constexpr std::size_t UTIME_INDEX = 14 - 3;
+    constexpr std::size_t STIME_INDEX = 15 - 3;
+    if (values.size() <= STIME_INDEX) {
+        return false;
+    }
+
+    const auto msPerTick = 1000.0 / static_cast<double>(sysconf(_SC_CLK_TCK));
+
+    thread["cpuUserMs"]   = static_cast<double>(std::stoull(values[UTIME_INDEX])) * msPerTick;
+    thread["cpuSystemMs"] = static_cast<double>(std::stoull(values[STIME_INDEX])) * msPerTick;
+    return true;
+}
+
+} // namespace
+
+void setCurrentThreadName(const char* name) {
+    const std::string truncatedName = std::string(name).substr(0, THREAD_NAME_MAX_LENGTH);
+    pthread_setname_np(pthread_self(), truncatedName.c_str());
+}
+
+nlohmann::json sampleThreadStatistics() {
+    auto threads = nlohmann::json::array();
+    for (const auto& taskId : listTaskIds()) {
+        const auto taskPath = std::string(TASK_DIRECTORY) + "/" + taskId;
+        const auto comm     = readFile(taskPath + "/comm");
+        const auto stat     = readFile(taskPath + "/stat");
+        const auto status   = readFile(taskPath + "/status");
+        if (!comm || !stat || !status) {
+            continue;
+        }
+
+        nlohmann::json thread;
+        thread["tid"]  = std::stoi(taskId);
+        thread["name"] = comm->substr(0, comm->find('\n'));
+        if (!addCpuTimes(*stat, thread)) {
+            continue;
+        }
+        thread["voluntaryContextSwitches"] = getStatusValue(*status, "voluntary_ctxt_switches");
+        thread["involuntaryContextSwitches"] =
+            getStatusValue(*status, "nonvoluntary_ctxt_switches");
+
+        // schedstat: time on cpu [ns], time waiting on a run queue [ns], number of time slices
+        if (const auto schedstat = readFile(taskPath + "/schedstat")) {
+            std::istringstream fields(*schedstat);
+            uint64_t           runNs      = 0;
+            uint64_t           runQueueNs = 0;
+            uint64_t           timeslices = 0;
+            if (fields >> runNs >> runQueueNs >> timeslices) {
+                thread["runNs"]           = runNs;
+                thread["runQueueDelayNs"] = runQueueNs;
+                thread["timeslices"]      = timeslices;
+            }
+        }
+        threads.push_back(std::move(thread));
+    }
+    return {{"threads", threads}};
+}
+
+} // namespace example
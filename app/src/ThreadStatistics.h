@@ -0,0 +1,46 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_THREADSTATISTICS_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_THREADSTATISTICS_H
+
+#include <nlohmann/json_fwd.hpp>
+
+namespace example {
+
+/**
+ * @brief Name the calling thread, as shown by top, ps and in /proc.
+ *      Names are truncated to 15 characters by the kernel.
+ */
+void setCurrentThreadName(const char* name);
+
+/**
+ * @brief Sample CPU and scheduling statistics of all threads of the process.
+ * @details Read from /proc/self/task/<tid>/{comm,stat,status,schedstat}.
+ *      Per thread the following cumulative values are reported:
+ *      - user and system CPU time,
+ *      - voluntary and involuntary context switches,
+ *      - time spent running and waiting on a run queue (run-queue delay),
+ *        and the number of time slices; only if the kernel provides schedstat.
+ *
+ *      Threads exiting while being sampled are skipped.
+ */
+nlohmann::json sampleThreadStatistics();
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_THREADSTATISTICS_H
@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "TimerService.h"
+#include "ThreadStatistics.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace example {
+
+TimerService::TimerService()
+    : m_thread([this]() { run(); }) {}
+
+TimerService::TimerService(ManualClock)
+    : m_isManualClock(true)
+    , m_manualNow(Clock::now()) {}
+
+TimerService::~TimerService() {
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+TimerService::TimerId TimerService::scheduleAt(Clock::time_point deadline, Callback callback) {
+    return addTimer(deadline, Clock::duration::zero(), {std::move(callback)});
+}
+
+TimerService::TimerId TimerService::scheduleAfter(Clock::duration delay, Callback callback) {
+    return scheduleAt(now() + delay, std::move(callback));
+}
+
+TimerService::TimerId TimerService::schedulePeriodic(Clock::duration period, Callback callback,
+                                                     Clock::duration slack) {
+    return addTimer(now() + period, slack, {std::move(callback), period});
+}
+
+TimerService::TimerId TimerService::addTimer(Clock::time_point deadline, Clock::duration slack,
+                                             Timer timer) {
+    TimerId timerId;
+    bool    isNewEarliest;
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        timerId       = m_nextId++;
+        isNewEarliest = m_queue.empty() || deadline + slack < m_queue.front().latest();
+        m_timers.emplace(timerId, std::move(timer));
+        pushEntry({deadline, slack, timerId});
+    }
+    // Only wake the timer thread if it has to wait for a shorter time now
+    if (isNewEarliest) {
+        m_cv.notify_one();
+    }
+    return timerId;
+}
+
+void TimerService::pushEntry(const Entry& entry) {
+    m_queue.push_back(entry);
+    std::push_heap(m_queue.begin(), m_queue.end(), std::greater<>());
+}
+
+bool TimerService::cancel(TimerId timerId) {
+    // The queue entry is left in place and skipped once it becomes due
+    std::unique_lock<ProfiledMutex> lock(m_mutex);
+    const bool                      wasPending = m_timers.erase(timerId) > 0;
+    // A callback cancelling its own timer would wait for itself
+    if (m_callbackThread != std::this_thread::get_id()) {
+        while (m_runningTimerId == timerId) {
+            m_callbackDone.wait(lock);
+        }
+    }
+    return wasPending;
+}
+
+TimerService::Clock::time_point TimerService::now() const {
+    if (!m_isManualClock) {
+        return Clock::now();
+    }
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    return m_manualNow;
+}
+
+void TimerService::advance(Clock::duration duration) {
+    assert(m_isManualClock);
+
+    std::unique_lock<ProfiledMutex> lock(m_mutex);
+    const auto                   target = m_manualNow + duration;
+    // The virtual timer thread wakes up as late as the earliest timer allows
+    while (!m_queue.empty() && m_queue.front().latest() <= target) {
+        m_manualNow = std::max(m_manualNow, m_queue.front().latest());
+        m_wakeupCount.fetch_add(1, std::memory_order_relaxed);
+        runDueTimers(lock, m_manualNow);
+    }
+    m_manualNow = target;
+}
+
+void TimerService::run() {
+    setCurrentThreadName("sa-timer");
+
+    std::unique_lock<ProfiledMutex> lock(m_mutex);
+    while (!m_stopping) {
+        if (m_queue.empty()) {
+            m_cv.wait(lock);
+            m_wakeupCount.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        const auto wakeupTime = m_queue.front().latest();
+        if (Clock::now() < wakeupTime) {
+            m_cv.wait_until(lock, wakeupTime);
+            m_wakeupCount.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        runDueTimers(lock, Clock::now());
+    }
+}
+
+void TimerService::runDueTimers(std::unique_lock<ProfiledMutex>& lock, Clock::time_point now) {
+    // Besides the timer which woke us up, all timers past their deadline run in this batch.
+    // The queue only holds a handful of timers, so a linear scan is cheap.
+    const auto dueBegin = std::partition(m_queue.begin(), m_queue.end(), [now](const Entry& entry) {
+        return entry.deadline > now;
+    });
+    std::vector<Entry> dueEntries(dueBegin, m_queue.end());
+    m_queue.erase(dueBegin, m_queue.end());
+    std::make_heap(m_queue.begin(), m_queue.end(), std::greater<>());
+    std::sort(dueEntries.begin(), dueEntries.end(),
+              [](const Entry& lhs, const Entry& rhs) { return lhs.deadline < rhs.deadline; });
+
+    for (const auto& entry : dueEntries) {
+        auto timerIter = m_timers.find(entry.timerId);
+        if (timerIter == m_timers.end()) {
+            continue;
+        }
+
+        const auto period = timerIter->second.period;
+        Callback   callback;
+        if (period == Clock::duration::zero()) {
+            callback = std::move(timerIter->second.callback);
+            m_timers.erase(timerIter);
+        } else {
+            callback = timerIter->second.callback;
+        }
+
+        m_runningTimerId = entry.timerId;
+        m_callbackThread = std::this_thread::get_id();
+        lock.unlock();
+        callback();
+        lock.lock();
+        m_runningTimerId = 0;
+        m_callbackThread = std::thread::id();
+        m_callbackDone.notify_all();
+
+        // Periodic timers are re-armed unless cancelled by or during the callback
+        if (period != Clock::duration::zero() && m_timers.count(entry.timerId) > 0) {
+            pushEntry({entry.deadline + period, entry.slack, entry.timerId});
+        }
+    }
+}
+
+} // namespace example
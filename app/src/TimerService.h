@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_TIMERSERVICE_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_TIMERSERVICE_H
+
+#include "ProfiledMutex.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace example {
+
+/**
+ * @brief One-shot and periodic timers executed on a single dedicated thread.
+ * @details Callbacks are invoked outside of the internal lock, so they may
+ *      schedule or cancel timers themselves. Long running callbacks delay
+ *      all subsequent timers. Cancelling waits for a running callback of the
+ *      timer, so callers must not hold a lock which the callback takes.
+ *
+ *      Timers may be given a slack: they can be run up to that much later than
+ *      their deadline, and run early together with any other timer which is
+ *      due. This coalesces wakeups of the timer thread, e.g. while the vehicle
+ *      is parked.
+ *
+ *      A service created with ManualClock runs on a virtual clock instead:
+ *      no thread is started and due timers are run on the thread calling
+ *      advance(). This allows simulating long periods in tests and benchmarks.
+ */
+class TimerService {
+public:
+    using Clock    = std::chrono::steady_clock;
+    using TimerId  = uint64_t;
+    using Callback = std::function<void()>;
+
+    /**
+     * @brief Tag selecting the virtual clock mode.
+     */
+    struct ManualClock {};
+
+    TimerService();
+    explicit TimerService(ManualClock);
+    ~TimerService();
+
+    TimerService(const TimerService&)            = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    /**
+     * @brief Schedule a callback to be run at the given point in time.
+     *
+     * @param deadline  The point in time the callback shall be run at.
+     * @param callback  The callback to run.
+     * @return TimerId  Identifier which can be used to cancel the timer.
+     */
+    TimerId scheduleAt(Clock::time_point deadline, Callback callback);
+
+    /**
+     * @brief Schedule a callback to be run after the given delay.
+     */
+    TimerId scheduleAfter(Clock::duration delay, Callback callback);
+
+    /**
+     * @brief Schedule a callback to be run repeatedly, first after one period.
+     *      The returned id stays valid until the timer is cancelled.
+     *
+     * @param period    The nominal interval between two runs.
+     * @param callback  The callback to run.
+     * @param slack     How much later than nominal each run may happen (see class details).
+     */
+    TimerId schedulePeriodic(Clock::duration period, Callback callback,
+                             Clock::duration slack = Clock::duration::zero());
+
+    /**
+     * @brief Cancel a pending timer.
+     * @details If the callback of the timer is running on another thread, wait for it
+     *      to return, so the objects it uses may be destroyed afterwards. A callback
+     *      may cancel its own timer without waiting.
+     *
+     * @return true   The timer was pending and will not fire.
+     * @return false  The (one-shot) timer already fired or is unknown.
+     */
+    bool cancel(TimerId timerId);
+
+    /**
+     * @brief Return the current time of the clock driving this service.
+     *      All users of the service shall use it instead of Clock::now().
+     */
+    Clock::time_point now() const;
+
+    /**
+     * @brief Advance the virtual clock, running all timers becoming due meanwhile
+     *      on the calling thread. Only allowed in ManualClock mode.
+     */
+    void advance(Clock::duration duration);
+
+    /**
+     * @brief Return how often the timer thread woke up so far.
+     * @details Every return from waiting counts, no matter whether a timer was
+     *      due. In ManualClock mode every batch of timers run by advance() counts.
+     */
+    uint64_t getWakeupCount() const { return m_wakeupCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        Clock::time_point deadline;
+        Clock::duration   slack;
+        TimerId           timerId;
+
+        Clock::time_point latest() const { return deadline + slack; }
+        bool operator>(const Entry& other) const { return latest() > other.latest(); }
+    };
+
+    struct Timer {
+        Callback        callback;
+        Clock::duration period{Clock::duration::zero()};
+    };
+
+    TimerId addTimer(Clock::time_point deadline, Clock::duration slack, Timer timer);
+    void    pushEntry(const Entry& entry);
+    void    run();
+    void    runDueTimers(std::unique_lock<ProfiledMutex>& lock, Clock::time_point now);
+
+    mutable ProfiledMutex              m_mutex{"TimerService"};
+    ProfiledConditionVariable          m_cv;
+    ProfiledConditionVariable          m_callbackDone;
+    std::vector<Entry>                 m_queue; // min-heap on the latest point in time to run
+    std::unordered_map<TimerId, Timer> m_timers;
+    TimerId                            m_nextId{1};
+    TimerId                            m_runningTimerId{0}; // 0 while no callback runs
+    std::thread::id                    m_callbackThread;
+    bool                               m_stopping{false};
+    const bool                         m_isManualClock{false};
+    Clock::time_point                  m_manualNow;
+    std::atomic<uint64_t>              m_wakeupCount{0};
+    std::thread                        m_thread;
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_TIMERSERVICE_H
@@ -0,0 +1,302 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "UdsCommandServer.h"
+#include "ProfiledMutex.h"
+#include "ThreadStatistics.h"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace example {
+
+namespace {
+
+constexpr int MAX_EPOLL_EVENTS = 64;
+constexpr int LISTEN_BACKLOG   = 64;
+
+// Frames handled per connection and wakeup, so a busy client cannot starve the others
+constexpr int MAX_FRAMES_PER_WAKEUP = 32;
+
+[[noreturn]] void throwSystemError(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+void closeFd(int& fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+} // namespace
+
+struct UdsCommandServer::CompletionQueue {
+    struct Completion {
+        int                      connectionFd;
+        uint64_t                 connectionId;
+        SeatCommandResponseFrame response;
+    };
+
+    ~CompletionQueue() { closeFd(eventFd); }
+
+    void push(const Completion& completion) {
+        bool wasEmpty = false;
+        {
+            std::lock_guard<ProfiledMutex> lock(mutex);
+            wasEmpty = completions.empty();
+            completions.push_back(completion);
+        }
+        // The server thread takes all queued completions per wakeup
+        if (wasEmpty) {
+            const uint64_t                 wakeup  = 1;
+            [[maybe_unused]] const ssize_t written = ::write(eventFd, &wakeup, sizeof(wakeup));
+        }
+    }
+
+    std::vector<Completion> take() {
+        uint64_t                       wakeups = 0;
+        [[maybe_unused]] const ssize_t read    = ::read(eventFd, &wakeups, sizeof(wakeups));
+        std::vector<Completion>        taken;
+        std::lock_guard<ProfiledMutex> lock(mutex);
+        taken.swap(completions);
+        return taken;
+    }
+
+    int                     eventFd{-1};
+    ProfiledMutex           mutex{"UdsCompletionQueue"};
+    std::vector<Completion> completions;
+};
+
+UdsCommandServer::UdsCommandServer(std::string socketPath, RequestHandler handler)
+    : m_socketPath(std::move(socketPath))
+    , m_handler(std::move(handler))
+    , m_completions(std::make_shared<CompletionQueue>()) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (m_socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::system_error(ENAMETOOLONG, std::generic_category(), m_socketPath);
+    }
+    std::strncpy(address.sun_path, m_socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    try {
+        m_listenFd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (m_listenFd < 0) {
+            throwSystemError("socket");
+        }
+        ::unlink(m_socketPath.c_str());
+        if (::bind(m_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+            throwSystemError("bind");
+        }
+        if (::listen(m_listenFd, LISTEN_BACKLOG) < 0) {
+            throwSystemError("listen");
+        }
+
+        m_stopEventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        m_completions->eventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_stopEventFd < 0 || m_completions->eventFd < 0) {
+            throwSystemError("eventfd");
+        }
+
+        m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (m_epollFd < 0) {
+            throwSystemError("epoll_create1");
+        }
+        for (const auto fd : {m_listenFd, m_stopEventFd, m_completions->eventFd}) {
+            epoll_event event{};
+            event.events  = EPOLLIN;
+            event.data.fd = fd;
+            if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+                throwSystemError("epoll_ctl");
+            }
+        }
+    } catch (...) {
+        closeFd(m_epollFd);
+        closeFd(m_stopEventFd);
+        closeFd(m_listenFd);
+        throw;
+    }
+
+    m_thread = std::thread([this]() { run(); });
+}
+
+UdsCommandServer::~UdsCommandServer() {
+    const uint64_t                 stop    = 1;
+    [[maybe_unused]] const ssize_t written = ::write(m_stopEventFd, &stop, sizeof(stop));
+    m_thread.join();
+
+    for (const auto& [connectionFd, connection] : m_connections) {
+        ::close(connectionFd);
+    }
+    closeFd(m_epollFd);
+    closeFd(m_stopEventFd);
+    closeFd(m_listenFd);
+    ::unlink(m_socketPath.c_str());
+}
+
+void UdsCommandServer::run() {
+    setCurrentThreadName("sa-uds");
+
+    std::array<epoll_event, MAX_EPOLL_EVENTS> events{};
+    for (;;) {
+        const auto eventCount = ::epoll_wait(m_epollFd, events.data(), MAX_EPOLL_EVENTS, -1);
+        if (eventCount < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        for (int i = 0; i < eventCount; ++i) {
+            const auto fd = events[i].data.fd;
+            if (fd == m_stopEventFd) {
+                return;
+            }
+            if (fd == m_listenFd) {
+                acceptConnections();
+            } else if (fd == m_completions->eventFd) {
+                sendCompletions();
+            } else if ((events[i].events & EPOLLIN) != 0) {
+                handleConnection(fd);
+            } else {
+                closeConnection(fd);
+            }
+        }
+    }
+}
+
+void UdsCommandServer::acceptConnections() {
+    for (;;) {
+        const auto connectionFd =
+            ::accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (connectionFd < 0) {
+            // EAGAIN: all pending connections accepted, anything else: retry on next wakeup
+            return;
+        }
+
+        epoll_event event{};
+        event.events  = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = connectionFd;
+        if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, connectionFd, &event) < 0) {
+            ::close(connectionFd);
+            continue;
+        }
+        m_connections[connectionFd] = Connection{m_nextConnectionId++};
+    }
+}
+
+void UdsCommandServer::handleConnection(int connectionFd) {
+    const auto found = m_connections.find(connectionFd);
+    if (found == m_connections.end()) {
+        return;
+    }
+    auto& connection = found->second;
+
+    // One byte larger than a request frame to detect oversized frames
+    std::array<uint8_t, sizeof(SeatCommandRequestFrame) + 1> buffer{};
+
+    for (int frameCount = 0; frameCount < MAX_FRAMES_PER_WAKEUP && !connection.paused;
+         ++frameCount) {
+        const auto received = ::recv(connectionFd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        }
+        if (received <= 0) {
+            closeConnection(connectionFd);
+            return;
+        }
+
+        SeatCommandRequestFrame request{};
+        if (received == sizeof(request)) {
+            std::memcpy(&request, buffer.data(), sizeof(request));
+        }
+        if (received != sizeof(request) || request.version != SEAT_COMMAND_PROTOCOL_VERSION) {
+            SeatCommandResponseFrame response{};
+            response.command   = request.command;
+            response.status    = static_cast<uint8_t>(SeatCommandStatus::InvalidFrame);
+            response.requestId = request.requestId;
+            if (!sendResponse(connectionFd, response)) {
+                closeConnection(connectionFd);
+                return;
+            }
+            continue;
+        }
+
+        if (++connection.pendingCount == MAX_PENDING_REQUESTS) {
+            setReading(connectionFd, connection, false);
+        }
+        auto respond = [completions = m_completions, connectionFd, connectionId = connection.id](
+                           const SeatCommandResponseFrame& response) {
+            completions->push({connectionFd, connectionId, response});
+        };
+        m_handler(request, std::move(respond));
+    }
+}
+
+void UdsCommandServer::sendCompletions() {
+    for (const auto& completion : m_completions->take()) {
+        const auto found = m_connections.find(completion.connectionFd);
+        if (found == m_connections.end() || found->second.id != completion.connectionId) {
+            continue;
+        }
+        auto& connection = found->second;
+        --connection.pendingCount;
+        if (!sendResponse(completion.connectionFd, completion.response)) {
+            closeConnection(completion.connectionFd);
+            continue;
+        }
+        if (connection.paused) {
+            setReading(completion.connectionFd, connection, true);
+        }
+    }
+}
+
+bool UdsCommandServer::sendResponse(int connectionFd, SeatCommandResponseFrame response) {
+    response.version = SEAT_COMMAND_PROTOCOL_VERSION;
+    return ::send(connectionFd, &response, sizeof(response), MSG_DONTWAIT | MSG_NOSIGNAL) ==
+           static_cast<ssize_t>(sizeof(response));
+}
+
+void UdsCommandServer::setReading(int connectionFd, Connection& connection, bool reading) {
+    // A hangup is still reported while the connection is not read
+    epoll_event event{};
+    event.events  = reading ? (EPOLLIN | EPOLLRDHUP) : EPOLLRDHUP;
+    event.data.fd = connectionFd;
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_MOD, connectionFd, &event);
+    connection.paused = !reading;
+}
+
+void UdsCommandServer::closeConnection(int connectionFd) {
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, connectionFd, nullptr);
+    ::close(connectionFd);
+    m_connections.erase(connectionFd);
+}
+
+} // namespace example
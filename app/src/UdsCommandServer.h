@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_UDSCOMMANDSERVER_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_UDSCOMMANDSERVER_H
+
+#include "SeatCommandProtocol.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace example {
+
+/**
+ * @brief Serves the binary seat command protocol on a Unix domain socket.
+ * @details A single thread multiplexes the listening socket and all client
+ *      connections (SOCK_SEQPACKET) via epoll. That thread only parses the
+ *      frames and passes each valid request to the handler, which must not
+ *      block: it answers via the responder once the request is done, usually
+ *      from another thread. The responses are sent by the server thread, in the
+ *      order the requests complete, so clients match them by requestId.
+ *
+ *      A connection with MAX_PENDING_REQUESTS unanswered requests is not read
+ *      until some of them are answered. Clients which do not read their
+ *      responses are disconnected instead of blocking the other connections.
+ */
+class UdsCommandServer {
+public:
+    static constexpr std::size_t MAX_PENDING_REQUESTS = 64;
+
+    /**
+     * @brief Send the response to a request. May be called from any thread, once per
+     *      request. Responses to closed connections (or after the server is destroyed)
+     *      are dropped.
+     */
+    using Responder      = std::function<void(const SeatCommandResponseFrame&)>;
+    using RequestHandler = std::function<void(const SeatCommandRequestFrame&, Responder)>;
+
+    /**
+     * @brief Bind the socket (replacing a stale one) and start serving.
+     *
+     * @throws std::system_error  If the socket cannot be set up.
+     */
+    UdsCommandServer(std::string socketPath, RequestHandler handler);
+    ~UdsCommandServer();
+
+    UdsCommandServer(const UdsCommandServer&)            = delete;
+    UdsCommandServer& operator=(const UdsCommandServer&) = delete;
+
+private:
+    struct Connection {
+        uint64_t    id; // tells a connection apart from a later one with the same fd
+        std::size_t pendingCount{0};
+        bool        paused{false};
+    };
+
+    // Responses handed over by the responders, which may outlive the server
+    struct CompletionQueue;
+
+    void run();
+    void acceptConnections();
+    void handleConnection(int connectionFd);
+    void sendCompletions();
+    bool sendResponse(int connectionFd, SeatCommandResponseFrame response);
+    void setReading(int connectionFd, Connection& connection, bool reading);
+    void closeConnection(int connectionFd);
+
+    const std::string                   m_socketPath;
+    RequestHandler                      m_handler;
+    int                                 m_listenFd{-1};
+    int                                 m_epollFd{-1};
+    int                                 m_stopEventFd{-1};
+    std::shared_ptr<CompletionQueue>    m_completions;
+    std::unordered_map<int, Connection> m_connections; // only accessed by the server thread
+    uint64_t                            m_nextConnectionId{0};
+    std::thread                         m_thread;
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_UDSCOMMANDSERVER_H
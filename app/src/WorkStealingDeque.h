@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_WORKSTEALINGDEQUE_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_WORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace example {
+
+/**
+ * @brief Chase-Lev work-stealing deque of pointers.
+ * @details The owning thread pushes and pops items at the bottom (LIFO), any other
+ *      thread may steal items from the top (FIFO). Only taking the last item and
+ *      stealing need a compare-and-swap, push and pop are plain loads and stores
+ *      otherwise. The ring buffer doubles when full; replaced buffers are kept until
+ *      destruction since thieves may still read from them.
+ *
+ *      The memory orderings follow Lê et al., "Correct and Efficient Work-Stealing
+ *      for Weak Memory Models" (PPoPP 2013).
+ */
+template <typename T> class WorkStealingDeque {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 256;
+
+    /**
+     * @param capacity  Initial capacity, a power of two.
+     */
+    explicit WorkStealingDeque(std::size_t capacity = DEFAULT_CAPACITY) {
+        assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+        m_buffers.push_back(std::make_unique<Buffer>(capacity));
+        m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&)            = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /**
+     * @brief Add an item at the bottom. Owner thread only.
+     */
+    void push(T* item) {
+        const auto bottom = m_bottom.load(std::memory_order_relaxed);
+        const auto top    = m_top.load(std::memory_order_acquire);
+        auto*      buffer = m_buffer.load(std::memory_order_relaxed);
+        if (bottom - top >= static_cast<int64_t>(buffer->capacity())) {
+            buffer = grow(buffer, top, bottom);
+        }
+        buffer->put(bottom, item);
+        // A release store instead of the paper's release fence, which ThreadSanitizer can't
+        // follow; it is just as cheap on x86 and ARMv8
+        m_bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Take the most recently pushed item. Owner thread only.
+     * @return nullptr if the deque is empty.
+     */
+    T* pop() {
+        const auto bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        auto*      buffer = m_buffer.load(std::memory_order_relaxed);
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T* item = buffer->get(bottom);
+        if (top == bottom) {
+            // Last item, a thief may take it concurrently
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                               std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /**
+     * @brief Take the least recently pushed item. Any thread.
+     * @return nullptr if the deque is empty or another thread took the item first.
+     */
+    T* steal() {
+        auto top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+        // Read before claiming the slot, the owner may overwrite it right after
+        T* item = m_buffer.load(std::memory_order_acquire)->get(top);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    /**
+     * @brief Return the number of items, exact only on the owner thread while no thief
+     *      is active.
+     */
+    std::size_t size() const {
+        const auto bottom = m_bottom.load(std::memory_order_relaxed);
+        const auto top    = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+    }
+
+    std::size_t capacity() const { return m_buffer.load(std::memory_order_relaxed)->capacity(); }
+
+private:
+    class Buffer {
+    public:
+        explicit Buffer(std::size_t capacity)
+            : m_mask(capacity - 1)
+            , m_items(new std::atomic<T*>[capacity]) {}
+
+        std::size_t capacity() const { return m_mask + 1; }
+
+        T* get(int64_t index) const {
+            return m_items[static_cast<std::size_t>(index) & m_mask].load(
+                std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T* item) {
+            m_items[static_cast<std::size_t>(index) & m_mask].store(item,
+                                                                     std::memory_order_relaxed);
+        }
+
+    private:
+        const std::size_t                  m_mask;
+        std::unique_ptr<std::atomic<T*>[]> m_items;
+    };
+
+    Buffer* grow(Buffer* buffer, int64_t top, int64_t bottom) {
+        auto grown = std::make_unique<Buffer>(buffer->capacity() * 2);
+        for (auto index = top; index < bottom; ++index) {
+            grown->put(index, buffer->get(index));
+        }
+        m_buffers.push_back(std::move(grown));
+        m_buffer.store(m_buffers.back().get(), std::memory_order_release);
+        return m_buffers.back().get();
+    }
+
+    // Top and bottom are written by different threads, keep them on separate cache lines
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_top{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_bottom{0};
+    std::atomic<Buffer*>                 m_buffer{nullptr};
+    std::vector<std::unique_ptr<Buffer>> m_buffers; // all buffers ever used, owner only
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_WORKSTEALINGDEQUE_H
@@ -0,0 +1,218 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "WorkStealingScheduler.h"
+#include "ThreadStatistics.h"
+
+#include <string>
+#include <utility>
+
+namespace example {
+
+namespace {
+
+// Workers check the shared queue first every that many tasks, so tasks submitted from
+// outside are not starved by workers busy with their own tasks
+constexpr uint64_t SHARED_QUEUE_INTERVAL = 61;
+
+struct CurrentWorker {
+    const WorkStealingScheduler* scheduler{nullptr};
+    std::size_t                  index{0};
+};
+
+thread_local CurrentWorker currentWorker;
+
+uint64_t nextRandom(uint64_t& state) {
+    // xorshift64
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+} // namespace
+
+WorkStealingScheduler::WorkStealingScheduler(std::size_t          workerCount,
+                                             WorkerStartedHandler onWorkerStarted)
+    : m_onWorkerStarted(std::move(onWorkerStarted)) {
+    for (std::size_t index = 0; index < workerCount; ++index) {
+        m_workers.push_back(std::make_unique<Worker>());
+        m_workers.back()->randomState = 0x9E3779B97F4A7C15ULL * (index + 1);
+    }
+    // All deques exist before the first worker may steal from them
+    for (std::size_t index = 0; index < workerCount; ++index) {
+        m_workers[index]->thread = std::thread([this, index]() { run(index); });
+    }
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+    {
+        std::lock_guard<ProfiledMutex> lock(m_parkMutex);
+        m_stopping = true;
+    }
+    m_parkCondition.notify_all();
+    for (auto& worker : m_workers) {
+        worker->thread.join();
+    }
+}
+
+void WorkStealingScheduler::submit(Task task) {
+    if (currentWorker.scheduler != this) {
+        submitShared(std::move(task));
+        return;
+    }
+    m_workers[currentWorker.index]->deque.push(new Task(std::move(task)));
+    onTaskQueued();
+}
+
+void WorkStealingScheduler::submitShared(Task task) {
+    {
+        std::lock_guard<ProfiledMutex> lock(m_sharedMutex);
+        m_sharedQueue.push_back(std::make_unique<Task>(std::move(task)));
+    }
+    onTaskQueued();
+}
+
+void WorkStealingScheduler::onTaskQueued() {
+    m_queuedTasks.fetch_add(1);
+    // A searching worker will find the task, it wakes another one if it finds more
+    if (m_searchingWorkers.load() == 0 && m_sleepingWorkers.load() > 0) {
+        wakeWorker();
+    }
+}
+
+void WorkStealingScheduler::wakeWorker() {
+    std::lock_guard<ProfiledMutex> lock(m_parkMutex);
+    m_parkCondition.notify_one();
+}
+
+void WorkStealingScheduler::run(std::size_t workerIndex) {
+    setCurrentThreadName(("sa-worker-" + std::to_string(workerIndex)).c_str());
+    currentWorker = {this, workerIndex};
+    if (m_onWorkerStarted) {
+        m_onWorkerStarted(workerIndex);
+    }
+
+    for (uint64_t tick = 1;; ++tick) {
+        auto task = findTask(workerIndex, tick);
+        if (!task) {
+            if (!park()) {
+                break;
+            }
+            continue;
+        }
+        m_queuedTasks.fetch_sub(1);
+        (*task)();
+    }
+    currentWorker = {};
+}
+
+std::unique_ptr<WorkStealingScheduler::Task>
+WorkStealingScheduler::findTask(std::size_t workerIndex, uint64_t tick) {
+    if (tick % SHARED_QUEUE_INTERVAL == 0) {
+        if (auto task = popShared()) {
+            return task;
+        }
+    }
+    if (auto* task = m_workers[workerIndex]->deque.pop()) {
+        return std::unique_ptr<Task>(task);
+    }
+    if (auto task = popShared()) {
+        return task;
+    }
+
+    m_searchingWorkers.fetch_add(1);
+    auto       task            = steal(workerIndex);
+    const bool wasLastSearcher = m_searchingWorkers.fetch_sub(1) == 1;
+    // Tasks queued meanwhile didn't wake anybody, as this worker was searching
+    if (task && wasLastSearcher && m_queuedTasks.load() > 1 && m_sleepingWorkers.load() > 0) {
+        wakeWorker();
+    }
+    return task;
+}
+
+std::unique_ptr<WorkStealingScheduler::Task> WorkStealingScheduler::popShared() {
+    std::lock_guard<ProfiledMutex> lock(m_sharedMutex);
+    if (m_sharedQueue.empty()) {
+        return nullptr;
+    }
+    auto task = std::move(m_sharedQueue.front());
+    m_sharedQueue.pop_front();
+    return task;
+}
+
+std::unique_ptr<WorkStealingScheduler::Task> WorkStealingScheduler::steal(std::size_t workerIndex) {
+    const auto workerCount = m_workers.size();
+    const auto first       = nextRandom(m_workers[workerIndex]->randomState) % workerCount;
+    for (std::size_t offset = 0; offset < workerCount; ++offset) {
+        const auto victim = (first + offset) % workerCount;
+        if (victim == workerIndex) {
+            continue;
+        }
+        if (auto* task = m_workers[victim]->deque.steal()) {
+            m_stealCount.fetch_add(1, std::memory_order_relaxed);
+            return std::unique_ptr<Task>(task);
+        }
+    }
+    return nullptr;
+}
+
+bool WorkStealingScheduler::park() {
+    std::unique_lock<ProfiledMutex> lock(m_parkMutex);
+    // Pairs with onTaskQueued(): either the submitter sees this worker sleeping and
+    // wakes it, or this worker sees the queued task and doesn't sleep
+    m_sleepingWorkers.fetch_add(1);
+    while (m_queuedTasks.load() <= 0 && !m_stopping) {
+        m_parkCondition.wait(lock);
+    }
+    m_sleepingWorkers.fetch_sub(1);
+    return m_queuedTasks.load() > 0 || !m_stopping;
+}
+
+SerialExecutor::SerialExecutor(WorkStealingScheduler& scheduler)
+    : m_scheduler(scheduler) {}
+
+void SerialExecutor::submit(Task task) {
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+        if (m_isScheduled) {
+            return;
+        }
+        m_isScheduled = true;
+    }
+    m_scheduler.submit([this]() { drain(); });
+}
+
+void SerialExecutor::drain() {
+    for (std::size_t count = 0; count < BATCH_SIZE; ++count) {
+        Task task;
+        {
+            std::lock_guard<ProfiledMutex> lock(m_mutex);
+            if (m_tasks.empty()) {
+                m_isScheduled = false;
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+    m_scheduler.submitShared([this]() { drain(); });
+}
+
+} // namespace example
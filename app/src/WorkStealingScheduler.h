@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_WORKSTEALINGSCHEDULER_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_WORKSTEALINGSCHEDULER_H
+
+#include "ProfiledMutex.h"
+#include "WorkStealingDeque.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace example {
+
+/**
+ * @brief Task pool with one work-stealing deque per worker thread.
+ * @details Tasks submitted by a worker are pushed onto its own deque and run in LIFO
+ *      order, which keeps their data in that core's caches. Tasks submitted by other
+ *      threads go to a shared FIFO queue. A worker running out of tasks first looks at
+ *      the shared queue and then steals the oldest task of a randomly chosen other
+ *      worker, so a burst of work produced on one core spreads across all idle cores.
+ *      Workers without tasks sleep until new tasks are submitted.
+ *
+ *      Tasks must not throw. No ordering is guaranteed between tasks; use a
+ *      SerialExecutor per tenant for that.
+ */
+class WorkStealingScheduler {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Called on each worker thread before it runs any task, e.g. to pin it to a CPU.
+     */
+    using WorkerStartedHandler = std::function<void(std::size_t workerIndex)>;
+
+    explicit WorkStealingScheduler(std::size_t          workerCount,
+                                   WorkerStartedHandler onWorkerStarted = {});
+
+    /**
+     * @brief Run all tasks submitted so far, including the ones they submit, then stop
+     *      the workers.
+     */
+    ~WorkStealingScheduler();
+
+    WorkStealingScheduler(const WorkStealingScheduler&)            = delete;
+    WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+    /**
+     * @brief Queue a task, on the calling worker's deque if called from a task.
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Queue a task behind all tasks submitted from outside of the workers.
+     * @details Meant for long running work which yields to waiting tasks, as the
+     *      task is not run next on the calling worker.
+     */
+    void submitShared(Task task);
+
+    std::size_t getWorkerCount() const { return m_workers.size(); }
+
+    /**
+     * @brief Return how many tasks were taken from another worker's deque so far.
+     */
+    uint64_t getStealCount() const { return m_stealCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Worker {
+        WorkStealingDeque<Task> deque;
+        std::thread             thread;
+        uint64_t                randomState{0}; // victim selection, worker thread only
+    };
+
+    void                  run(std::size_t workerIndex);
+    std::unique_ptr<Task> findTask(std::size_t workerIndex, uint64_t tick);
+    std::unique_ptr<Task> popShared();
+    std::unique_ptr<Task> steal(std::size_t workerIndex);
+    void                  onTaskQueued();
+    void                  wakeWorker();
+    bool                  park();
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    WorkerStartedHandler                 m_onWorkerStarted;
+
+    ProfiledMutex                     m_sharedMutex{"WorkStealingScheduler"};
+    std::deque<std::unique_ptr<Task>> m_sharedQueue;
+
+    ProfiledMutex             m_parkMutex{"WorkStealingScheduler.park"};
+    ProfiledConditionVariable m_parkCondition;
+    bool                      m_stopping{false};
+
+    // Queued but not yet taken tasks; may briefly be negative while a task is taken
+    // before its submitter counted it
+    std::atomic<int64_t>  m_queuedTasks{0};
+    std::atomic<int>      m_searchingWorkers{0};
+    std::atomic<int>      m_sleepingWorkers{0};
+    std::atomic<uint64_t> m_stealCount{0};
+};
+
+/**
+ * @brief Runs tasks one after another in submission order on a WorkStealingScheduler.
+ * @details One executor per tenant (e.g. per simulated vehicle) keeps the tenant's
+ *      requests ordered while different tenants run in parallel, on whichever workers
+ *      are idle. At most one drain task of an executor is queued at a time. After
+ *      BATCH_SIZE tasks it requeues itself behind the other waiting work, so a busy
+ *      tenant can't starve the others.
+ *
+ *      The executor must outlive all tasks submitted to it.
+ */
+class SerialExecutor {
+public:
+    using Task = WorkStealingScheduler::Task;
+
+    static constexpr std::size_t BATCH_SIZE = 32;
+
+    explicit SerialExecutor(WorkStealingScheduler& scheduler);
+
+    SerialExecutor(const SerialExecutor&)            = delete;
+    SerialExecutor& operator=(const SerialExecutor&) = delete;
+
+    void submit(Task task);
+
+private:
+    void drain();
+
+    WorkStealingScheduler& m_scheduler;
+    ProfiledMutex          m_mutex{"SerialExecutor"};
+    std::deque<Task>       m_tasks;
+    bool                   m_isScheduled{false};
+};
+
+} // namespace example
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_WORKSTEALINGSCHEDULER_H
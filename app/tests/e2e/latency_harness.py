@@ -0,0 +1,321 @@
+# Copyright (c) 2024 Contributors to the Eclipse Foundation
+#
+# This program and the accompanying materials are made available under the
+# terms of the Apache License, Version 2.0 which is available at
+# https://www.apache.org/licenses/LICENSE-2.0.
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+
+"""End-to-end latency harness for the SeatAdjuster app.
+
+Starts a local Mosquitto broker, a local Kuksa databroker loaded with a
+minimal VSS subset and the built app binary, then publishes seat position
+requests via MQTT at several fixed rates and reports the latency from
+request publish to response receive.
+
+Everything runs on localhost, no network access is required:
+
+    python3 app/tests/e2e/latency_harness.py --rates 10 50 100 --duration 10
+
+Binaries are looked up in PATH unless given via MOSQUITTO_BIN,
+DATABROKER_BIN or --app.
+"""
+
+import json
+import os
+import shutil
+import socket
+import statistics
+import subprocess  # nosec
+import sys
+import tempfile
+import threading
+import time
+from argparse import ArgumentParser
+from pathlib import Path
+from typing import Dict, List, Optional
+
+import paho.mqtt.client as mqtt
+from kuksa_client.grpc import Datapoint, VSSClient
+
+SCRIPT_DIR = Path(__file__).absolute().parent
+WORKSPACE_DIR = SCRIPT_DIR.parents[2]
+
+REQUEST_TOPIC = "seatadjuster/setDriverPosition/request"
+RESPONSE_TOPIC = "seatadjuster/setDriverPosition/response"
+
+STARTUP_TIMEOUT_S = 30.0
+DRAIN_TIMEOUT_S = 5.0
+
+
+def find_binary(env_var: str, name: str) -> str:
+    path = os.environ.get(env_var) or shutil.which(name)
+    if path is None:
+        sys.exit(f"'{name}' not found, add it to PATH or set {env_var}")
+    return path
+
+
+def get_free_port() -> int:
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as sock:
+        sock.bind(("127.0.0.1", 0))
+        return sock.getsockname()[1]
+
+
+def wait_for_port(port: int, timeout: float = STARTUP_TIMEOUT_S) -> None:
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        try:
+            with socket.create_connection(("127.0.0.1", port), timeout=0.5):
+                return
+        except OSError:
+            time.sleep(0.1)
+    raise TimeoutError(f"Nothing listening on port {port} after {timeout}s")
+
+
+def percentile(sorted_values: List[float], fraction: float) -> float:
+    last = len(sorted_values) - 1
+    index = min(last, int(round(fraction * last)))
+    return sorted_values[index]
+
+
+class LatencyProbe:
+    """Publishes requests and correlates responses by requestId."""
+
+    def __init__(self, mqtt_port: int):
+        self._lock = threading.Lock()
+        self._sent: Dict[int, float] = {}
+        self._latencies: List[float] = []
+        self._next_request_id = 0
+        self._client = mqtt.Client(client_id="latency-harness")
+        self._client.on_message = self._on_message
+        self._client.connect("127.0.0.1", mqtt_port)
+        self._client.subscribe(RESPONSE_TOPIC, qos=0)
+        self._client.loop_start()
+
+    def close(self) -> None:
+        self._client.loop_stop()
+        self._client.disconnect()
+
+    def _on_message(self, _client, _userdata, message) -> None:
+        received = time.perf_counter()
+        request_id = json.loads(message.payload).get("requestId")
+        with self._lock:
+            sent = self._sent.pop(request_id, None)
+            if sent is not None:
+                self._latencies.append(received - sent)
+
+    def send(self, position: int) -> None:
+        with self._lock:
+            request_id = self._next_request_id
+            self._next_request_id += 1
+            self._sent[request_id] = time.perf_counter()
+        payload = json.dumps({"requestId": request_id, "position": position})
+        self._client.publish(REQUEST_TOPIC, payload, qos=0)
+
+    def reset(self) -> None:
+        with self._lock:
+            self._sent.clear()
+            self._latencies = []
+
+    def wait_until_drained(self, timeout: float) -> None:
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            with self._lock:
+                if not self._sent:
+                    return
+            time.sleep(0.01)
+
+    def results(self) -> Dict[str, float]:
+        with self._lock:
+            latencies = sorted(self._latencies)
+            lost = len(self._sent)
+        if not latencies:
+            return {"received": 0, "lost": lost}
+        to_ms = 1000.0
+        return {
+            "received": len(latencies),
+            "lost": lost,
+            "mean_ms": statistics.fmean(latencies) * to_ms,
+            "p50_ms": percentile(latencies, 0.50) * to_ms,
+            "p90_ms": percentile(latencies, 0.90) * to_ms,
+            "p99_ms": percentile(latencies, 0.99) * to_ms,
+            "max_ms": latencies[-1] * to_ms,
+        }
+
+
+class Environment:
+    """Local broker, databroker and app processes."""
+
+    def __init__(self, app_binary: str, work_dir: Path):
+        self._processes: List[subprocess.Popen] = []
+        self._work_dir = work_dir
+        self.mqtt_port = get_free_port()
+        self.vdb_port = get_free_port()
+        self._app_binary = app_binary
+
+    def __enter__(self) -> "Environment":
+        try:
+            self._start_broker()
+            self._start_databroker()
+            self._start_app()
+        except BaseException:
+            self.__exit__(None, None, None)
+            raise
+        return self
+
+    def __exit__(self, *_args) -> None:
+        for process in reversed(self._processes):
+            process.terminate()
+            try:
+                process.wait(timeout=5)
+            except subprocess.TimeoutExpired:
+                process.kill()
+
+    def _spawn(self, name: str, args: List[str], env: Optional[dict] = None) -> None:
+        log_file = open(self._work_dir / f"{name}.log", "w", encoding="utf-8")
+        self._processes.append(
+            subprocess.Popen(  # nosec
+                args, stdout=log_file, stderr=subprocess.STDOUT, env=env
+            )
+        )
+
+    def _start_broker(self) -> None:
+        config_path = self._work_dir / "mosquitto.conf"
+        config_path.write_text(
+            f"listener {self.mqtt_port} 127.0.0.1\nallow_anonymous true\n",
+            encoding="utf-8",
+        )
+        mosquitto = find_binary("MOSQUITTO_BIN", "mosquitto")
+        self._spawn("mosquitto", [mosquitto, "-c", str(config_path)])
+        wait_for_port(self.mqtt_port)
+
+    def _start_databroker(self) -> None:
+        databroker = find_binary("DATABROKER_BIN", "databroker")
+        self._spawn(
+            "databroker",
+            [
+                databroker,
+                "--address",
+                "127.0.0.1",
+                "--port",
+                str(self.vdb_port),
+                "--insecure",
+                "--vss",
+                str(SCRIPT_DIR / "vss_subset.json"),
+            ],
+        )
+        wait_for_port(self.vdb_port)
+
+        # Seat requests are only accepted while the vehicle is not moving
+        with VSSClient("127.0.0.1", self.vdb_port) as client:
+            client.set_current_values({"Vehicle.Speed": Datapoint(0.0)})
+
+    def _start_app(self) -> None:
+        env = dict(os.environ)
+        env.update(
+            {
+                "SDV_MIDDLEWARE_TYPE": "native",
+                "SDV_MQTT_ADDRESS": f"127.0.0.1:{self.mqtt_port}",
+                "SDV_VEHICLEDATABROKER_ADDRESS": f"127.0.0.1:{self.vdb_port}",
+            }
+        )
+        self._spawn("app", [self._app_binary], env)
+
+
+def wait_for_app(probe: LatencyProbe) -> None:
+    """Send probe requests until the app answers, i.e. it has subscribed."""
+    deadline = time.monotonic() + STARTUP_TIMEOUT_S
+    while time.monotonic() < deadline:
+        probe.reset()
+        probe.send(0)
+        probe.wait_until_drained(0.5)
+        if probe.results()["received"] > 0:
+            return
+    raise TimeoutError("App did not answer within the startup timeout")
+
+
+def run_rate(probe: LatencyProbe, rate: float, duration: float) -> Dict[str, float]:
+    """Send requests on a fixed schedule, independent of the responses."""
+    probe.reset()
+    interval = 1.0 / rate
+    count = int(rate * duration)
+    start = time.perf_counter()
+    for index in range(count):
+        send_at = start + index * interval
+        delay = send_at - time.perf_counter()
+        if delay > 0:
+            time.sleep(delay)
+        probe.send(index % 1000)
+    probe.wait_until_drained(DRAIN_TIMEOUT_S)
+    return {"rate": rate, "sent": count, **probe.results()}
+
+
+def print_report(results: List[Dict[str, float]]) -> None:
+    columns = [
+        "rate",
+        "sent",
+        "received",
+        "lost",
+        "mean_ms",
+        "p50_ms",
+        "p90_ms",
+        "p99_ms",
+        "max_ms",
+    ]
+    print(" ".join(f"{column:>9}" for column in columns))
+    for result in results:
+        print(
+            " ".join(
+                f"{result[column]:>9.2f}"
+                if isinstance(result.get(column), float)
+                else f"{result.get(column, '-'):>9}"
+                for column in columns
+            )
+        )
+
+
+def main() -> None:
+    parser = ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        "--app",
+        default=str(WORKSPACE_DIR / "build" / "bin" / "app"),
+        help="Path of the app binary.",
+    )
+    parser.add_argument(
+        "--rates",
+        type=float,
+        nargs="+",
+        default=[10, 50, 100, 200],
+        help="Request rates in requests per second.",
+    )
+    parser.add_argument(
+        "--duration", type=float, default=10.0, help="Seconds per rate."
+    )
+    parser.add_argument("--json", help="Additionally write the results to this file.")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory(prefix="latency-harness-") as work_dir:
+        with Environment(args.app, Path(work_dir)) as environment:
+            probe = LatencyProbe(environment.mqtt_port)
+            try:
+                wait_for_app(probe)
+                results = [
+                    run_rate(probe, rate, args.duration) for rate in args.rates
+                ]
+            finally:
+                probe.close()
+
+    print_report(results)
+    if args.json:
+        Path(args.json).write_text(json.dumps(results, indent=2), encoding="utf-8")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "ArrivalSchedule.h"
+
+#include <random>
+#include <stdexcept>
+
+namespace example::load {
+
+std::optional<ArrivalProcess> parseArrivalProcess(const std::string& name) {
+    if (name == "constant") {
+        return ArrivalProcess::Constant;
+    }
+    if (name == "poisson") {
+        return ArrivalProcess::Poisson;
+    }
+    if (name == "burst") {
+        return ArrivalProcess::Burst;
+    }
+    return std::nullopt;
+}
+
+const char* toString(ArrivalProcess process) {
+    switch (process) {
+    case ArrivalProcess::Constant:
+        return "constant";
+    case ArrivalProcess::Poisson:
+        return "poisson";
+    case ArrivalProcess::Burst:
+        return "burst";
+    }
+    return "unknown";
+}
+
+std::vector<std::chrono::nanoseconds> createSchedule(const LoadProfile&       profile,
+                                                     std::chrono::nanoseconds duration,
+                                                     uint64_t                 seed) {
+    if (!(profile.rate > 0.0) || profile.burstSize == 0) {
+        throw std::invalid_argument("Rate and burst size have to be positive");
+    }
+
+    const auto meanInterval = std::chrono::duration<double, std::nano>(1e9 / profile.rate);
+
+    std::vector<std::chrono::nanoseconds> schedule;
+    schedule.reserve(static_cast<std::size_t>(profile.rate * (duration.count() / 1e9)) + 1);
+
+    std::mt19937_64                          random(seed);
+    std::exponential_distribution<>          gap(1.0);
+    std::chrono::duration<double, std::nano> sendTime{0.0};
+    while (sendTime < duration) {
+        const auto intended = std::chrono::duration_cast<std::chrono::nanoseconds>(sendTime);
+        switch (profile.process) {
+        case ArrivalProcess::Constant:
+            schedule.push_back(intended);
+            sendTime += meanInterval;
+            break;
+        case ArrivalProcess::Poisson:
+            schedule.push_back(intended);
+            sendTime += meanInterval * gap(random);
+            break;
+        case ArrivalProcess::Burst:
+            schedule.insert(schedule.end(), profile.burstSize, intended);
+            sendTime += meanInterval * static_cast<double>(profile.burstSize);
+            break;
+        }
+    }
+    return schedule;
+}
+
+} // namespace example::load
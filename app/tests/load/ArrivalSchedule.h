@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_ARRIVALSCHEDULE_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_ARRIVALSCHEDULE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace example::load {
+
+/**
+ * @brief How the send times of the requests are distributed.
+ */
+enum class ArrivalProcess {
+    // Evenly spaced requests
+    Constant,
+    // Exponentially distributed gaps, i.e. independent clients
+    Poisson,
+    // Groups of requests sent at once, the groups evenly spaced
+    Burst,
+};
+
+std::optional<ArrivalProcess> parseArrivalProcess(const std::string& name);
+
+const char* toString(ArrivalProcess process);
+
+struct LoadProfile {
+    ArrivalProcess process{ArrivalProcess::Constant};
+    // Average requests per second
+    double rate{100.0};
+    // Requests per group of the burst profile
+    std::size_t burstSize{10};
+};
+
+/**
+ * @brief Compute the intended send times of all requests of a run, relative
+ *      to its start.
+ * @details The schedule is fixed upfront and does not depend on when responses
+ *      arrive, so a slow response delays neither the following requests nor
+ *      their latency measurement (no coordinated omission).
+ *
+ * @throws std::invalid_argument  If the rate or burst size is not positive.
+ */
+std::vector<std::chrono::nanoseconds> createSchedule(const LoadProfile&       profile,
+                                                     std::chrono::nanoseconds duration,
+                                                     uint64_t                 seed);
+
+} // namespace example::load
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_ARRIVALSCHEDULE_H
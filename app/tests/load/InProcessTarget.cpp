@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "InProcessTarget.h"
+#include "ThreadStatistics.h"
+#include "payloads/SetPositionRequest.h"
+#include "payloads/SetPositionResponse.h"
+
+#include <utility>
+
+namespace example::load {
+
+InProcessTarget::InProcessTarget(std::chrono::microseconds serviceTime)
+    : m_serviceTime(serviceTime)
+    , m_seatAdjuster(*this, m_timerService) {}
+
+InProcessTarget::~InProcessTarget() { stop(); }
+
+void InProcessTarget::start(ResponseHandler onResponse) {
+    m_onResponse = std::move(onResponse);
+    m_dispatcher = std::thread([this]() { dispatch(); });
+}
+
+void InProcessTarget::send(int requestId, int position) {
+    auto payload = payloads::serialize(payloads::SetPositionRequest{requestId, position});
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(payload));
+    }
+    m_queueChanged.notify_one();
+}
+
+void InProcessTarget::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_queueChanged.notify_one();
+    if (m_dispatcher.joinable()) {
+        m_dispatcher.join();
+    }
+}
+
+void InProcessTarget::setSeatPosition(SeatId /*seat*/, int /*position*/) {
+    // Busy waiting, sleeping would add the scheduler latency of the host
+    const auto done = Clock::now() + m_serviceTime;
+    while (Clock::now() < done) {
+    }
+}
+
+void InProcessTarget::publish(const std::string& topic, const std::string& payload) {
+    if (topic != TOPIC_Driver_RESPONSE) {
+        return;
+    }
+    const auto                    received = Clock::now();
+    payloads::SetPositionResponse response;
+    if (!payloads::parse(payload, response)) {
+        m_onResponse(response.requestId, received);
+    }
+}
+
+void InProcessTarget::dispatch() {
+    setCurrentThreadName("load-dispatch");
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_queueChanged.wait(lock, [this]() { return m_isStopping || !m_queue.empty(); });
+        if (m_queue.empty()) {
+            return;
+        }
+        const auto payload = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+        m_seatAdjuster.onSetPositionRequestReceived(SeatId::Driver, payload);
+        lock.lock();
+    }
+}
+
+} // namespace example::load
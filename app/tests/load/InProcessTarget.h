@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_INPROCESSTARGET_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_INPROCESSTARGET_H
+
+#include "LoadTarget.h"
+#include "SeatAdjuster.h"
+#include "TimerService.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace example::load {
+
+/**
+ * @brief Runs the SeatAdjuster in-process against a fake vehicle.
+ * @details Requests are queued and handled one by one on a dispatcher thread,
+ *      like the callbacks of the MQTT client. Setting a seat position takes
+ *      the given service time, standing in for the databroker round trip.
+ */
+class InProcessTarget : public ILoadTarget, private ISeatAdjusterBackend {
+public:
+    explicit InProcessTarget(std::chrono::microseconds serviceTime);
+    ~InProcessTarget() override;
+
+    void start(ResponseHandler onResponse) override;
+    void send(int requestId, int position) override;
+    void stop() override;
+
+private:
+    double getVehicleSpeed() override { return 0.0; }
+    void   setSeatPosition(SeatId seat, int position) override;
+    void   setActuatorValue(const std::string& /*signal*/, const SignalValue& /*value*/) override {}
+    void   publish(const std::string& topic, const std::string& payload) override;
+
+    void dispatch();
+
+    std::chrono::microseconds m_serviceTime;
+    ResponseHandler           m_onResponse;
+    TimerService              m_timerService;
+    SeatAdjuster              m_seatAdjuster;
+    std::mutex                m_mutex;
+    std::condition_variable   m_queueChanged;
+    std::deque<std::string>   m_queue;
+    bool                      m_isStopping{false};
+    std::thread               m_dispatcher;
+};
+
+} // namespace example::load
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_INPROCESSTARGET_H
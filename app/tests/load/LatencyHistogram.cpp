@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fmt/core.h>
+#include <limits>
+#include <stdexcept>
+
+namespace example::load {
+
+namespace {
+
+int getLeadingZeros(uint64_t value) { return value == 0 ? 64 : __builtin_clzll(value); }
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram(int64_t highestTrackableValue, int significantDigits)
+    : m_highestTrackableValue(highestTrackableValue)
+    , m_significantDigits(significantDigits) {
+    if (highestTrackableValue < 2) {
+        throw std::invalid_argument("Highest trackable value has to be at least 2");
+    }
+    if (significantDigits < 1 || significantDigits > 5) {
+        throw std::invalid_argument("Significant digits have to be between 1 and 5");
+    }
+
+    // Enough sub-buckets to tell apart values differing in the last significant digit
+    const auto largestValueWithSingleUnitResolution =
+        2 * static_cast<int64_t>(std::pow(10, significantDigits));
+    const auto subBucketCountMagnitude =
+        static_cast<int>(std::ceil(std::log2(largestValueWithSingleUnitResolution)));
+    m_subBucketHalfCountMagnitude = std::max(subBucketCountMagnitude, 1) - 1;
+    m_subBucketCount              = int64_t{1} << (m_subBucketHalfCountMagnitude + 1);
+    m_subBucketHalfCount          = m_subBucketCount / 2;
+    m_subBucketMask               = m_subBucketCount - 1;
+
+    auto smallestUntrackableValue = m_subBucketCount;
+    m_bucketCount                 = 1;
+    while (smallestUntrackableValue <= highestTrackableValue) {
+        if (smallestUntrackableValue > std::numeric_limits<int64_t>::max() / 2) {
+            ++m_bucketCount;
+            break;
+        }
+        smallestUntrackableValue <<= 1;
+        ++m_bucketCount;
+    }
+    m_counts.resize(static_cast<std::size_t>((m_bucketCount + 1) * m_subBucketHalfCount));
+}
+
+void LatencyHistogram::record(int64_t value) {
+    if (value > m_highestTrackableValue) {
+        value = m_highestTrackableValue;
+        ++m_clampedCount;
+    }
+    ++m_counts[getCountsIndex(std::max<int64_t>(value, 0))];
+    ++m_totalCount;
+}
+
+void LatencyHistogram::add(const LatencyHistogram& other) {
+    if (other.m_highestTrackableValue != m_highestTrackableValue ||
+        other.m_significantDigits != m_significantDigits) {
+        throw std::invalid_argument("Histograms with different parameters cannot be added");
+    }
+    for (std::size_t index = 0; index < m_counts.size(); ++index) {
+        m_counts[index] += other.m_counts[index];
+    }
+    m_totalCount += other.m_totalCount;
+    m_clampedCount += other.m_clampedCount;
+}
+
+void LatencyHistogram::reset() {
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_totalCount   = 0;
+    m_clampedCount = 0;
+}
+
+int64_t LatencyHistogram::getMin() const {
+    for (std::size_t index = 0; index < m_counts.size(); ++index) {
+        if (m_counts[index] != 0) {
+            return getValueFromIndex(index);
+        }
+    }
+    return 0;
+}
+
+int64_t LatencyHistogram::getMax() const {
+    for (auto index = m_counts.size(); index > 0; --index) {
+        if (m_counts[index - 1] != 0) {
+            return getHighestEquivalentValue(getValueFromIndex(index - 1));
+        }
+    }
+    return 0;
+}
+
+double LatencyHistogram::getMean() const {
+    if (m_totalCount == 0) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (std::size_t index = 0; index < m_counts.size(); ++index) {
+        if (m_counts[index] != 0) {
+            const auto value = getValueFromIndex(index);
+            // The middle of the range of equivalent values
+            const auto median = (value + getHighestEquivalentValue(value) + 1) / 2;
+            sum += static_cast<double>(median) * static_cast<double>(m_counts[index]);
+        }
+    }
+    return sum / static_cast<double>(m_totalCount);
+}
+
+double LatencyHistogram::getStdDeviation() const {
+    if (m_totalCount == 0) {
+        return 0.0;
+    }
+    const auto mean              = getMean();
+    double     squaredDeviations = 0.0;
+    for (std::size_t index = 0; index < m_counts.size(); ++index) {
+        if (m_counts[index] != 0) {
+            const auto value     = getValueFromIndex(index);
+            const auto median    = (value + getHighestEquivalentValue(value) + 1) / 2;
+            const auto deviation = static_cast<double>(median) - mean;
+            squaredDeviations += deviation * deviation * static_cast<double>(m_counts[index]);
+        }
+    }
+    return std::sqrt(squaredDeviations / static_cast<double>(m_totalCount));
+}
+
+int64_t LatencyHistogram::getValueAtPercentile(double percentile) const {
+    const auto requested   = std::clamp(percentile, 0.0, 100.0);
+    const auto countAtRank = std::max<uint64_t>(
+        static_cast<uint64_t>(std::ceil(requested / 100.0 * static_cast<double>(m_totalCount))),
+        1);
+
+    uint64_t count = 0;
+    for (std::size_t index = 0; index < m_counts.size(); ++index) {
+        count += m_counts[index];
+        if (count >= countAtRank) {
+            return getHighestEquivalentValue(getValueFromIndex(index));
+        }
+    }
+    return 0;
+}
+
+std::string LatencyHistogram::formatPercentileDistribution(int    ticksPerHalfDistance,
+                                                           double valueUnitScale) const {
+    std::string out = fmt::format("{:>12} {:>14} {:>10} {:>14}\n\n", "Value", "Percentile",
+                                  "TotalCount", "1/(1-Percentile)");
+
+    const auto total   = static_cast<double>(m_totalCount);
+    const auto addLine = [&](int64_t value, double percentile, uint64_t count) {
+        const auto scaled = static_cast<double>(value) / valueUnitScale;
+        if (percentile < 100.0) {
+            out += fmt::format("{:12.3f} {:2.12f} {:10} {:14.2f}\n", scaled, percentile / 100.0,
+                               count, 1.0 / (1.0 - percentile / 100.0));
+        } else {
+            out += fmt::format("{:12.3f} {:2.12f} {:10}\n", scaled, 1.0, count);
+        }
+    };
+
+    if (m_totalCount != 0) {
+        // Percentile ticks get denser towards the tail: ticksPerHalfDistance per halving to 100%
+        double   percentileToReport = 0.0;
+        uint64_t count              = 0;
+        for (std::size_t index = 0; index < m_counts.size(); ++index) {
+            if (m_counts[index] == 0) {
+                continue;
+            }
+            count += m_counts[index];
+            const auto value = getHighestEquivalentValue(getValueFromIndex(index));
+            while (count >= percentileToReport / 100.0 * total && count < m_totalCount) {
+                addLine(value, percentileToReport, count);
+                const auto halvings = std::floor(std::log2(100.0 / (100.0 - percentileToReport)));
+                percentileToReport +=
+                    100.0 / (ticksPerHalfDistance * std::pow(2.0, halvings + 1.0));
+            }
+            if (count == m_totalCount) {
+                addLine(value, 100.0, count);
+                break;
+            }
+        }
+    }
+
+    out += fmt::format("#[Mean    = {:12.3f}, StdDeviation   = {:12.3f}]\n",
+                       getMean() / valueUnitScale, getStdDeviation() / valueUnitScale);
+    out += fmt::format("#[Max     = {:12.3f}, Total count    = {:12}]\n",
+                       static_cast<double>(getMax()) / valueUnitScale, m_totalCount);
+    out += fmt::format("#[Buckets = {:12}, SubBuckets     = {:12}]\n", m_bucketCount,
+                       m_subBucketCount);
+    return out;
+}
+
+std::size_t LatencyHistogram::getCountsIndex(int64_t value) const {
+    const auto unsignedValue = static_cast<uint64_t>(value);
+    const auto bucketIndex =
+        (63 - m_subBucketHalfCountMagnitude) -
+        getLeadingZeros(unsignedValue | static_cast<uint64_t>(m_subBucketMask));
+    const auto subBucketIndex = static_cast<int64_t>(unsignedValue >> bucketIndex);
+    return static_cast<std::size_t>(((int64_t{bucketIndex} + 1) << m_subBucketHalfCountMagnitude) +
+                                    (subBucketIndex - m_subBucketHalfCount));
+}
+
+int64_t LatencyHistogram::getValueFromIndex(std::size_t index) const {
+    auto bucketIndex    = static_cast<int>(index >> m_subBucketHalfCountMagnitude) - 1;
+    auto subBucketIndex = static_cast<int64_t>(index & (m_subBucketHalfCount - 1)) +
+                          m_subBucketHalfCount;
+    if (bucketIndex < 0) {
+        subBucketIndex -= m_subBucketHalfCount;
+        bucketIndex = 0;
+    }
+    return subBucketIndex << bucketIndex;
+}
+
+int64_t LatencyHistogram::getHighestEquivalentValue(int64_t value) const {
+    const auto unsignedValue = static_cast<uint64_t>(value);
+    const auto bucketIndex =
+        (63 - m_subBucketHalfCountMagnitude) -
+        getLeadingZeros(unsignedValue | static_cast<uint64_t>(m_subBucketMask));
+    const auto lowestEquivalentValue = static_cast<int64_t>(unsignedValue >> bucketIndex)
+                                       << bucketIndex;
+    return lowestEquivalentValue + (int64_t{1} << bucketIndex) - 1;
+}
+
+} // namespace example::load
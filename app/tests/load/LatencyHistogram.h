@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_LATENCYHISTOGRAM_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_LATENCYHISTOGRAM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace example::load {
+
+/**
+ * @brief High dynamic range histogram of latencies in nanoseconds.
+ * @details Same layout as HdrHistogram: values are counted in buckets whose
+ *      width doubles with each power of two, each split into enough sub-buckets
+ *      to keep the given number of significant decimal digits. Recording is
+ *      a constant time array increment, so it does not distort the tail.
+ *
+ *      Values above the highest trackable value are counted as that value.
+ *      Not thread safe.
+ */
+class LatencyHistogram {
+public:
+    /**
+     * @param highestTrackableValue  Largest value to be distinguished, at least 2.
+     * @param significantDigits      Precision of the recorded values, 1 to 5.
+     * @throws std::invalid_argument  If a parameter is out of range.
+     */
+    LatencyHistogram(int64_t highestTrackableValue, int significantDigits);
+
+    void record(int64_t value);
+
+    /**
+     * @brief Add the counts of another histogram with the same parameters.
+     *
+     * @throws std::invalid_argument  If the parameters differ.
+     */
+    void add(const LatencyHistogram& other);
+
+    void reset();
+
+    uint64_t getTotalCount() const { return m_totalCount; }
+    uint64_t getClampedCount() const { return m_clampedCount; }
+    int64_t  getMin() const;
+    int64_t  getMax() const;
+    double   getMean() const;
+    double   getStdDeviation() const;
+
+    /**
+     * @brief Return the value below or at which the given percentage of the
+     *      recorded values lie, as the highest value equivalent to it.
+     */
+    int64_t getValueAtPercentile(double percentile) const;
+
+    /**
+     * @brief Format the percentile distribution like HdrHistogram's
+     *      outputPercentileDistribution(), so it can be plotted with its tools.
+     *
+     * @param ticksPerHalfDistance  Reported percentiles per halving of the distance to 100%.
+     * @param valueUnitScale        Divisor of the reported values, e.g. 1e6 for milliseconds.
+     */
+    std::string formatPercentileDistribution(int ticksPerHalfDistance, double valueUnitScale) const;
+
+private:
+    std::size_t getCountsIndex(int64_t value) const;
+    int64_t     getValueFromIndex(std::size_t index) const;
+    int64_t     getHighestEquivalentValue(int64_t value) const;
+
+    int64_t               m_highestTrackableValue;
+    int                   m_significantDigits;
+    int                   m_subBucketHalfCountMagnitude;
+    int64_t               m_subBucketCount;
+    int64_t               m_subBucketHalfCount;
+    int64_t               m_subBucketMask;
+    int                   m_bucketCount;
+    std::vector<uint64_t> m_counts;
+    uint64_t              m_totalCount{0};
+    uint64_t              m_clampedCount{0};
+};
+
+} // namespace example::load
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_LATENCYHISTOGRAM_H
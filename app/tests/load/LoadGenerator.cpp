@@ -0,0 +1,301 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/**
+ * Open-loop load generator for the SeatAdjuster.
+ *
+ * Sends set position requests on a schedule computed upfront (constant rate,
+ * Poisson arrivals or bursts), no matter how fast responses arrive. Latencies
+ * are measured from the intended send time of each request, so a stalled app
+ * shows up with the full delay of every request queued behind the stall
+ * instead of a single slow sample (coordinated omission). For comparison, the
+ * latency from the actual send time is reported as well.
+ *
+ * Targets:
+ *   - inprocess: the SeatAdjuster against a fake vehicle in this process,
+ *   - mqtt:      a running app, via the MQTT broker configured for the SDK.
+ *
+ * Latencies are recorded in HDR histograms, the percentile distribution can
+ * be written in HdrHistogram's text format for plotting.
+ */
+
+#include "ArrivalSchedule.h"
+#include "InProcessTarget.h"
+#include "LatencyHistogram.h"
+#include "MqttTarget.h"
+#include "Seat.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fmt/core.h>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace example::load {
+
+using Clock = ILoadTarget::Clock;
+using namespace std::chrono_literals;
+
+// Latencies up to a minute are told apart with three significant digits
+constexpr int64_t HISTOGRAM_HIGHEST_VALUE_NS = 60'000'000'000;
+constexpr int     HISTOGRAM_SIGNIFICANT_DIGITS = 3;
+
+// The generator sleeps until shortly before a send time and spins for the rest
+constexpr auto SPIN_THRESHOLD = 100us;
+
+constexpr double NS_PER_MS = 1e6;
+
+struct Options {
+    std::string               target{"inprocess"};
+    LoadProfile               profile;
+    double                    durationSeconds{10.0};
+    double                    warmupSeconds{1.0};
+    double                    drainTimeoutSeconds{5.0};
+    std::chrono::microseconds serviceTime{50};
+    uint64_t                  seed{1};
+    std::string               histogramFile;
+    bool                      verbose{false};
+};
+
+/**
+ * @brief Send times and outcome of one request.
+ */
+struct RequestRecord {
+    std::chrono::nanoseconds intended{0};
+    std::atomic<int64_t>     sentNs{0};
+    std::atomic<bool>        isAnswered{false};
+};
+
+struct RunResult {
+    std::size_t      sent{0};
+    std::size_t      received{0};
+    Clock::duration  maxSendLag{0};
+    LatencyHistogram fromIntended{HISTOGRAM_HIGHEST_VALUE_NS, HISTOGRAM_SIGNIFICANT_DIGITS};
+    LatencyHistogram fromSent{HISTOGRAM_HIGHEST_VALUE_NS, HISTOGRAM_SIGNIFICANT_DIGITS};
+};
+
+/**
+ * @brief Sends the scheduled requests and collects the latencies of their responses.
+ */
+class LoadRun {
+public:
+    LoadRun(const Options& options, ILoadTarget& target)
+        : m_options(options)
+        , m_target(target)
+        , m_warmup(std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::duration<double>(options.warmupSeconds))) {
+        const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::duration<double>(options.warmupSeconds + options.durationSeconds));
+        const auto schedule = createSchedule(options.profile, duration, options.seed);
+
+        m_records = std::vector<RequestRecord>(schedule.size());
+        for (std::size_t index = 0; index < schedule.size(); ++index) {
+            m_records[index].intended = schedule[index];
+        }
+    }
+
+    RunResult& run() {
+        m_target.start([this](int requestId, Clock::time_point received) {
+            onResponse(requestId, received);
+        });
+
+        m_start = Clock::now();
+        for (std::size_t index = 0; index < m_records.size(); ++index) {
+            auto&      record   = m_records[index];
+            const auto sendTime = m_start + record.intended;
+            if (Clock::now() + SPIN_THRESHOLD < sendTime) {
+                std::this_thread::sleep_until(sendTime - SPIN_THRESHOLD);
+            }
+            while (Clock::now() < sendTime) {
+            }
+
+            const auto now = Clock::now();
+            record.sentNs.store((now - m_start).count(), std::memory_order_relaxed);
+            m_result.maxSendLag = std::max(m_result.maxSendLag, now - sendTime);
+            m_target.send(static_cast<int>(index), static_cast<int>(index % SEAT_POSITION_MAX));
+        }
+
+        const auto drainDeadline =
+            Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                               std::chrono::duration<double>(m_options.drainTimeoutSeconds));
+        while (m_answered.load() < m_records.size() && Clock::now() < drainDeadline) {
+            std::this_thread::sleep_for(10ms);
+        }
+        m_target.stop();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& record : m_records) {
+            if (record.intended >= m_warmup) {
+                ++m_result.sent;
+            }
+        }
+        return m_result;
+    }
+
+private:
+    void onResponse(int requestId, Clock::time_point received) {
+        if (requestId < 0 || static_cast<std::size_t>(requestId) >= m_records.size()) {
+            return;
+        }
+        auto& record = m_records[static_cast<std::size_t>(requestId)];
+        if (record.isAnswered.exchange(true)) {
+            return;
+        }
+        ++m_answered;
+        if (record.intended < m_warmup) {
+            return;
+        }
+
+        const auto elapsed = received - m_start;
+        const auto sent    = Clock::duration(record.sentNs.load(std::memory_order_relaxed));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_result.received;
+        m_result.fromIntended.record(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed - record.intended)
+                .count());
+        m_result.fromSent.record(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed - sent).count());
+    }
+
+    const Options&             m_options;
+    ILoadTarget&               m_target;
+    std::chrono::nanoseconds   m_warmup;
+    std::vector<RequestRecord> m_records;
+    Clock::time_point          m_start;
+    std::atomic<std::size_t>   m_answered{0};
+    std::mutex                 m_mutex;
+    RunResult                  m_result;
+};
+
+void printLatencies(const char* name, const LatencyHistogram& histogram) {
+    const auto toMs = [](int64_t valueNs) { return static_cast<double>(valueNs) / NS_PER_MS; };
+    fmt::print(stderr, "{:<14} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f}\n",
+               name, toMs(histogram.getValueAtPercentile(50.0)),
+               toMs(histogram.getValueAtPercentile(90.0)),
+               toMs(histogram.getValueAtPercentile(99.0)),
+               toMs(histogram.getValueAtPercentile(99.9)),
+               toMs(histogram.getValueAtPercentile(99.99)), toMs(histogram.getMax()),
+               histogram.getMean() / NS_PER_MS);
+}
+
+void printReport(const Options& options, const RunResult& result) {
+    fmt::print(stderr, "{} profile, {} requests/s for {} s (warm-up {} s) against {}\n",
+               toString(options.profile.process), options.profile.rate, options.durationSeconds,
+               options.warmupSeconds, options.target);
+    fmt::print(stderr, "sent {}, received {}, lost {}, max send lag {:.3f} ms\n", result.sent,
+               result.received, result.sent - result.received,
+               std::chrono::duration<double, std::milli>(result.maxSendLag).count());
+    fmt::print(stderr, "{:<14} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9}\n", "latency [ms]", "p50",
+               "p90", "p99", "p99.9", "p99.99", "max", "mean");
+    printLatencies("from intended", result.fromIntended);
+    printLatencies("from sent", result.fromSent);
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int index = 1; index < argc; ++index) {
+        const std::string_view argument = argv[index];
+        if (argument == "--verbose") {
+            options.verbose = true;
+            continue;
+        }
+        if (index + 1 >= argc) {
+            throw std::invalid_argument(
+                fmt::format("Unknown option or missing value: {}", argument));
+        }
+        const std::string value = argv[++index];
+        if (argument == "--target") {
+            if (value != "inprocess" && value != "mqtt") {
+                throw std::invalid_argument(fmt::format("Unknown target: {}", value));
+            }
+            options.target = value;
+        } else if (argument == "--profile") {
+            const auto process = parseArrivalProcess(value);
+            if (!process) {
+                throw std::invalid_argument(fmt::format("Unknown profile: {}", value));
+            }
+            options.profile.process = *process;
+        } else if (argument == "--rate") {
+            options.profile.rate = std::stod(value);
+        } else if (argument == "--burst-size") {
+            options.profile.burstSize = std::stoul(value);
+        } else if (argument == "--duration") {
+            options.durationSeconds = std::stod(value);
+        } else if (argument == "--warmup") {
+            options.warmupSeconds = std::stod(value);
+        } else if (argument == "--drain-timeout") {
+            options.drainTimeoutSeconds = std::stod(value);
+        } else if (argument == "--service-time-us") {
+            options.serviceTime = std::chrono::microseconds(std::stoll(value));
+        } else if (argument == "--seed") {
+            options.seed = std::stoull(value);
+        } else if (argument == "--histogram-file") {
+            options.histogramFile = value;
+        } else {
+            throw std::invalid_argument(fmt::format("Unknown option: {}", argument));
+        }
+    }
+    return options;
+}
+
+std::unique_ptr<ILoadTarget> createTarget(const Options& options) {
+    if (options.target == "mqtt") {
+        return std::make_unique<MqttTarget>();
+    }
+    return std::make_unique<InProcessTarget>(options.serviceTime);
+}
+
+} // namespace example::load
+
+int main(int argc, char** argv) {
+    using namespace example::load;
+
+    try {
+        const auto options = parseOptions(argc, argv);
+        // The app logs every request, which would dominate the output
+        if (!options.verbose && std::freopen("/dev/null", "w", stdout) == nullptr) {
+            throw std::runtime_error("Unable to discard app log output");
+        }
+
+        auto        target = createTarget(options);
+        LoadRun     loadRun(options, *target);
+        const auto& result = loadRun.run();
+
+        printReport(options, result);
+        if (!options.histogramFile.empty()) {
+            std::ofstream file(options.histogramFile);
+            file << result.fromIntended.formatPercentileDistribution(5, NS_PER_MS);
+            if (!file) {
+                throw std::runtime_error(
+                    fmt::format("Unable to write {}", options.histogramFile));
+            }
+        }
+        return 0;
+    } catch (const std::exception& exception) {
+        fmt::print(stderr, "Load generator aborted: {}\n", exception.what());
+        return 2;
+    }
+}
@@ -0,0 +1,50 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_LOADTARGET_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_LOADTARGET_H
+
+#include <chrono>
+#include <functional>
+
+namespace example::load {
+
+/**
+ * @brief Transport the load generator sends seat requests through.
+ */
+class ILoadTarget {
+public:
+    using Clock           = std::chrono::steady_clock;
+    using ResponseHandler = std::function<void(int requestId, Clock::time_point received)>;
+
+    virtual ~ILoadTarget() = default;
+
+    /**
+     * @brief Connect to the app, responses are passed to the handler from any thread.
+     */
+    virtual void start(ResponseHandler onResponse) = 0;
+
+    /**
+     * @brief Hand over a set driver position request without waiting for its response.
+     */
+    virtual void send(int requestId, int position) = 0;
+
+    virtual void stop() = 0;
+};
+
+} // namespace example::load
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_LOADTARGET_H
@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "MqttTarget.h"
+#include "SeatAdjuster.h"
+#include "payloads/SetPositionRequest.h"
+#include "payloads/SetPositionResponse.h"
+
+#include <fmt/core.h>
+#include <stdexcept>
+#include <utility>
+
+namespace example::load {
+
+MqttTarget::MqttTarget()
+    : m_client(velocitas::IPubSubClient::createInstance("SeatAdjusterLoadGenerator")) {
+    if (!m_client) {
+        throw std::runtime_error("Unable to create the MQTT client");
+    }
+}
+
+void MqttTarget::start(ResponseHandler onResponse) {
+    m_client->connect();
+    m_client->subscribeTopic(TOPIC_Driver_RESPONSE)
+        ->onItem([onResponse = std::move(onResponse)](const std::string& payload) {
+            const auto                    received = Clock::now();
+            payloads::SetPositionResponse response;
+            if (!payloads::parse(payload, response)) {
+                onResponse(response.requestId, received);
+            }
+        })
+        ->onError([](const velocitas::Status& status) {
+            fmt::print(stderr, "Response subscription failed: {}\n", status.errorMessage());
+        });
+}
+
+void MqttTarget::send(int requestId, int position) {
+    const auto payload = payloads::serialize(payloads::SetPositionRequest{requestId, position});
+    m_client->publishOnTopic(TOPIC_Driver_REQUEST, payload);
+}
+
+void MqttTarget::stop() { m_client->disconnect(); }
+
+} // namespace example::load
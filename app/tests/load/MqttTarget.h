@@ -0,0 +1,47 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_MQTTTARGET_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_MQTTTARGET_H
+
+#include "LoadTarget.h"
+#include "sdk/IPubSubClient.h"
+
+#include <memory>
+
+namespace example::load {
+
+/**
+ * @brief Sends the requests to a running app via the MQTT broker.
+ * @details The broker is configured like for the app itself, e.g. via
+ *      SDV_MQTT_ADDRESS. The vehicle has to stand still, otherwise the app
+ *      rejects the requests.
+ */
+class MqttTarget : public ILoadTarget {
+public:
+    MqttTarget();
+
+    void start(ResponseHandler onResponse) override;
+    void send(int requestId, int position) override;
+    void stop() override;
+
+private:
+    std::shared_ptr<velocitas::IPubSubClient> m_client;
+};
+
+} // namespace example::load
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_MQTTTARGET_H
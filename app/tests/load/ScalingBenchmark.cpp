@@ -0,0 +1,465 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/**
+ * Core-count scaling benchmark of the SeatAdjuster.
+ *
+ * Runs the set position request workload with an increasing number of worker
+ * threads, each pinned to its own CPU, against one or more independent
+ * SeatAdjuster instances (tenants). Per point the throughput and latency
+ * percentiles are measured, together with the speedup and parallel efficiency
+ * relative to a single thread with the same tenant setup:
+ *   - one shared tenant shows how far the request path scales under contention,
+ *   - one tenant per thread is the contention-free reference.
+ *
+ * With --scheduler stealing the requests are not run on dedicated threads but
+ * as tasks on a WorkStealingScheduler with one pinned worker per thread, each
+ * tenant's requests ordered by its own SerialExecutor. This shows the overhead
+ * of the scheduler and how it copes with busy tenants sharing the workers.
+ *
+ * The workload runs in-process without any middleware, so the benchmark runs
+ * on any Linux machine. The scaling curve can be written as CSV for plotting.
+ */
+
+#include "LatencyHistogram.h"
+#include "SeatAdjuster.h"
+#include "TimerService.h"
+#include "WorkStealingScheduler.h"
+#include "payloads/SetPositionRequest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <fmt/core.h>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace example::load {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int64_t HISTOGRAM_HIGHEST_VALUE_NS   = 10'000'000'000;
+constexpr int     HISTOGRAM_SIGNIFICANT_DIGITS = 3;
+
+// Request ids are unique per thread, so retries are never detected by the idempotency cache
+constexpr int REQUEST_IDS_PER_THREAD = 1'000'000;
+
+// Tenant count meaning one tenant per worker thread
+constexpr int TENANT_PER_THREAD = 0;
+
+constexpr double NS_PER_US = 1e3;
+
+enum class Scheduler {
+    Pinned,  // one dedicated thread per client
+    Stealing // clients' requests as tasks on a WorkStealingScheduler
+};
+
+struct Options {
+    std::vector<int> threadCounts;
+    std::vector<int> tenantCounts{1, TENANT_PER_THREAD};
+    Scheduler        scheduler{Scheduler::Pinned};
+    double           durationSeconds{2.0};
+    double           warmupSeconds{0.2};
+    std::string      csvFile;
+    bool             verbose{false};
+};
+
+struct Point {
+    int              threads{0};
+    int              tenants{0};
+    uint64_t         requests{0};
+    double           throughput{0.0};
+    LatencyHistogram latencies{HISTOGRAM_HIGHEST_VALUE_NS, HISTOGRAM_SIGNIFICANT_DIGITS};
+};
+
+/**
+ * @brief Vehicle which accepts every request immediately.
+ */
+class NullVehicle : public ISeatAdjusterBackend {
+public:
+    double getVehicleSpeed() override { return 0.0; }
+    void   setSeatPosition(SeatId /*seat*/, int /*position*/) override {}
+    void   setActuatorValue(const std::string& /*signal*/, const SignalValue& /*value*/) override {}
+    void   publish(const std::string& /*topic*/, const std::string& /*payload*/) override {}
+};
+
+/**
+ * @brief One independent SeatAdjuster instance.
+ */
+struct Tenant {
+    NullVehicle  vehicle;
+    TimerService timerService{TimerService::ManualClock{}};
+    SeatAdjuster seatAdjuster{vehicle, timerService};
+};
+
+/**
+ * @brief Closed-loop request source, one per thread; sends its next request as soon as the
+ *      previous one was handled.
+ */
+struct Client {
+    int              request{0};
+    uint64_t         requests{0};
+    LatencyHistogram latencies{HISTOGRAM_HIGHEST_VALUE_NS, HISTOGRAM_SIGNIFICANT_DIGITS};
+};
+
+/**
+ * @brief Handle the next request of a client and record its latency while measuring.
+ */
+void handleRequest(SeatAdjuster& seatAdjuster, int clientIndex, Client& client,
+                   bool isMeasuring) {
+    const auto                         request = client.request++;
+    const payloads::SetPositionRequest payload{
+        clientIndex * REQUEST_IDS_PER_THREAD + request % REQUEST_IDS_PER_THREAD,
+        request % SEAT_POSITION_MAX};
+    const auto data = payloads::serialize(payload);
+    const auto seat = request % 2 == 0 ? SeatId::Driver : SeatId::CoDriver;
+
+    const auto start = Clock::now();
+    seatAdjuster.onSetPositionRequestReceived(seat, data);
+    const auto end = Clock::now();
+
+    if (isMeasuring) {
+        ++client.requests;
+        client.latencies.record(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+}
+
+/**
+ * @brief Return the CPUs this process may run on.
+ */
+std::vector<int> getAllowedCpus() {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+        throw std::system_error(errno, std::generic_category(), "sched_getaffinity");
+    }
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &cpuSet)) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+void pinThread(pthread_t thread, int cpu) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    const auto result = pthread_setaffinity_np(thread, sizeof(cpuSet), &cpuSet);
+    if (result != 0) {
+        throw std::system_error(result, std::generic_category(), "pthread_setaffinity_np");
+    }
+}
+
+Point summarize(const std::vector<Client>& clients, int threads, int tenants,
+                Clock::duration measuredTime) {
+    Point point;
+    point.threads = threads;
+    point.tenants = tenants;
+    for (const auto& client : clients) {
+        point.requests += client.requests;
+        point.latencies.add(client.latencies);
+    }
+    point.throughput = static_cast<double>(point.requests) /
+                       std::chrono::duration<double>(measuredTime).count();
+    return point;
+}
+
+/**
+ * @brief Measure one point of the scaling curve with one pinned thread per client.
+ */
+Point runPinnedPoint(const Options& options, const std::vector<int>& cpus, int threads,
+                     int tenants) {
+    std::vector<std::unique_ptr<Tenant>> tenantInstances;
+    for (int index = 0; index < tenants; ++index) {
+        tenantInstances.push_back(std::make_unique<Tenant>());
+    }
+
+    std::vector<Client> clients(static_cast<std::size_t>(threads));
+    std::atomic<bool>   isStarted{false};
+    std::atomic<bool>   isMeasuring{false};
+    std::atomic<bool>   isStopping{false};
+
+    std::vector<std::thread> threadPool;
+    for (int index = 0; index < threads; ++index) {
+        threadPool.emplace_back([&, index]() {
+            auto& client       = clients[static_cast<std::size_t>(index)];
+            auto& seatAdjuster = tenantInstances[static_cast<std::size_t>(index % tenants)]
+                                     ->seatAdjuster;
+
+            // Wait until all threads are pinned
+            while (!isStarted.load()) {
+                std::this_thread::yield();
+            }
+
+            while (!isStopping.load(std::memory_order_relaxed)) {
+                handleRequest(seatAdjuster, index, client,
+                              isMeasuring.load(std::memory_order_relaxed));
+            }
+        });
+    }
+
+    try {
+        for (std::size_t index = 0; index < threadPool.size(); ++index) {
+            pinThread(threadPool[index].native_handle(), cpus[index % cpus.size()]);
+        }
+    } catch (...) {
+        isStopping = true;
+        isStarted  = true;
+        for (auto& thread : threadPool) {
+            thread.join();
+        }
+        throw;
+    }
+    isStarted = true;
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.warmupSeconds));
+    isMeasuring = true;
+    const auto start = Clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.durationSeconds));
+    const auto end = Clock::now();
+    isMeasuring = false;
+    isStopping  = true;
+    for (auto& thread : threadPool) {
+        thread.join();
+    }
+    return summarize(clients, threads, tenants, end - start);
+}
+
+/**
+ * @brief Measure one point of the scaling curve with the clients' requests run as tasks on a
+ *      WorkStealingScheduler with one pinned worker per thread.
+ */
+Point runStealingPoint(const Options& options, const std::vector<int>& cpus, int threads,
+                       int tenants) {
+    std::vector<std::unique_ptr<Tenant>> tenantInstances;
+    for (int index = 0; index < tenants; ++index) {
+        tenantInstances.push_back(std::make_unique<Tenant>());
+    }
+
+    std::vector<Client> clients(static_cast<std::size_t>(threads));
+    std::atomic<bool>   isMeasuring{false};
+    std::atomic<bool>   isStopping{false};
+    std::mutex          errorMutex;
+    std::exception_ptr  pinningError;
+
+    auto scheduler = std::make_unique<WorkStealingScheduler>(
+        static_cast<std::size_t>(threads), [&](std::size_t workerIndex) {
+            try {
+                pinThread(pthread_self(), cpus[workerIndex % cpus.size()]);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                pinningError = std::current_exception();
+            }
+        });
+    // The executors have to outlive the scheduler's tasks, see the reset() below
+    std::vector<std::unique_ptr<SerialExecutor>> executors;
+    for (int index = 0; index < tenants; ++index) {
+        executors.push_back(std::make_unique<SerialExecutor>(*scheduler));
+    }
+
+    std::function<void(int)> sendRequest = [&](int index) {
+        const auto tenant = static_cast<std::size_t>(index % tenants);
+        executors[tenant]->submit([&, index, tenant]() {
+            handleRequest(tenantInstances[tenant]->seatAdjuster, index,
+                          clients[static_cast<std::size_t>(index)],
+                          isMeasuring.load(std::memory_order_relaxed));
+            if (!isStopping.load(std::memory_order_relaxed)) {
+                sendRequest(index);
+            }
+        });
+    };
+    for (int index = 0; index < threads; ++index) {
+        sendRequest(index);
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.warmupSeconds));
+    isMeasuring = true;
+    const auto start = Clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.durationSeconds));
+    const auto end = Clock::now();
+    isMeasuring = false;
+    isStopping  = true;
+    scheduler.reset();
+
+    if (pinningError) {
+        std::rethrow_exception(pinningError);
+    }
+    return summarize(clients, threads, tenants, end - start);
+}
+
+std::vector<int> getDefaultThreadCounts(std::size_t cpuCount) {
+    std::vector<int> threadCounts;
+    for (std::size_t threads = 1; threads < cpuCount; threads *= 2) {
+        threadCounts.push_back(static_cast<int>(threads));
+    }
+    threadCounts.push_back(static_cast<int>(cpuCount));
+    return threadCounts;
+}
+
+std::vector<int> parseCounts(const std::string& value, bool allowPerThread) {
+    std::vector<int>   counts;
+    std::istringstream stream(value);
+    std::string        item;
+    while (std::getline(stream, item, ',')) {
+        if (allowPerThread && item == "threads") {
+            counts.push_back(TENANT_PER_THREAD);
+            continue;
+        }
+        const auto count = std::stoi(item);
+        if (count < 1) {
+            throw std::invalid_argument(fmt::format("Invalid count: {}", item));
+        }
+        counts.push_back(count);
+    }
+    return counts;
+}
+
+Scheduler parseScheduler(const std::string& value) {
+    if (value == "pinned") {
+        return Scheduler::Pinned;
+    }
+    if (value == "stealing") {
+        return Scheduler::Stealing;
+    }
+    throw std::invalid_argument(fmt::format("Unknown scheduler: {}", value));
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int index = 1; index < argc; ++index) {
+        const std::string_view argument = argv[index];
+        if (argument == "--verbose") {
+            options.verbose = true;
+            continue;
+        }
+        if (index + 1 >= argc) {
+            throw std::invalid_argument(
+                fmt::format("Unknown option or missing value: {}", argument));
+        }
+        const std::string value = argv[++index];
+        if (argument == "--threads") {
+            options.threadCounts = parseCounts(value, false);
+        } else if (argument == "--tenants") {
+            options.tenantCounts = parseCounts(value, true);
+        } else if (argument == "--scheduler") {
+            options.scheduler = parseScheduler(value);
+        } else if (argument == "--duration") {
+            options.durationSeconds = std::stod(value);
+        } else if (argument == "--warmup") {
+            options.warmupSeconds = std::stod(value);
+        } else if (argument == "--csv") {
+            options.csvFile = value;
+        } else {
+            throw std::invalid_argument(fmt::format("Unknown option: {}", argument));
+        }
+    }
+    return options;
+}
+
+const char* toString(Scheduler scheduler) {
+    return scheduler == Scheduler::Stealing ? "stealing" : "pinned";
+}
+
+std::string formatTenants(int tenantCount) {
+    return tenantCount == TENANT_PER_THREAD ? "threads" : std::to_string(tenantCount);
+}
+
+} // namespace example::load
+
+int main(int argc, char** argv) {
+    using namespace example::load;
+
+    try {
+        auto options = parseOptions(argc, argv);
+        // The app logs every request, which would dominate the output
+        if (!options.verbose && std::freopen("/dev/null", "w", stdout) == nullptr) {
+            throw std::runtime_error("Unable to discard app log output");
+        }
+
+        const auto cpus = getAllowedCpus();
+        if (options.threadCounts.empty()) {
+            options.threadCounts = getDefaultThreadCounts(cpus.size());
+        }
+        const auto maxThreads =
+            *std::max_element(options.threadCounts.begin(), options.threadCounts.end());
+        if (static_cast<std::size_t>(maxThreads) > cpus.size()) {
+            fmt::print(stderr, "Note: {} threads share {} CPUs, efficiency will drop\n",
+                       maxThreads, cpus.size());
+        }
+
+        std::string csv = "scheduler,threads,tenants,requests,throughput,speedup,efficiency,"
+                          "p50_us,p99_us,p999_us\n";
+        fmt::print(stderr, "{:>7} {:>7} {:>12} {:>8} {:>10} {:>9} {:>9} {:>10}\n", "threads",
+                   "tenants", "requests/s", "speedup", "efficiency", "p50 [us]", "p99 [us]",
+                   "p99.9 [us]");
+        for (const auto tenantCount : options.tenantCounts) {
+            // Efficiency is relative to a single thread with the same tenant setup
+            double baseline = 0.0;
+            for (const auto threads : options.threadCounts) {
+                const auto tenants = tenantCount == TENANT_PER_THREAD ? threads : tenantCount;
+                const auto point   = options.scheduler == Scheduler::Stealing
+                                         ? runStealingPoint(options, cpus, threads, tenants)
+                                         : runPinnedPoint(options, cpus, threads, tenants);
+                if (baseline == 0.0) {
+                    baseline = point.throughput / threads;
+                }
+                const auto speedup    = point.throughput / baseline;
+                const auto efficiency = speedup / threads;
+                const auto p50        = point.latencies.getValueAtPercentile(50.0) / NS_PER_US;
+                const auto p99        = point.latencies.getValueAtPercentile(99.0) / NS_PER_US;
+                const auto p999       = point.latencies.getValueAtPercentile(99.9) / NS_PER_US;
+
+                fmt::print(stderr, "{:>7} {:>7} {:>12.0f} {:>8.2f} {:>9.0f}% {:>9.1f} {:>9.1f} "
+                           "{:>10.1f}\n",
+                           threads, formatTenants(tenantCount), point.throughput, speedup,
+                           efficiency * 100.0, p50, p99, p999);
+                csv += fmt::format("{},{},{},{},{:.0f},{:.3f},{:.3f},{:.1f},{:.1f},{:.1f}\n",
+                                   toString(options.scheduler), threads,
+                                   formatTenants(tenantCount), point.requests, point.throughput,
+                                   speedup, efficiency, p50, p99, p999);
+            }
+        }
+
+        if (!options.csvFile.empty()) {
+            std::ofstream file(options.csvFile);
+            file << csv;
+            if (!file) {
+                throw std::runtime_error(fmt::format("Unable to write {}", options.csvFile));
+            }
+        }
+        return 0;
+    } catch (const std::exception& exception) {
+        fmt::print(stderr, "Scaling benchmark aborted: {}\n", exception.what());
+        return 2;
+    }
+}
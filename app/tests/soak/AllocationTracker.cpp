@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "AllocationTracker.h"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace example::soak {
+
+namespace {
+
+// Prepended to every allocation to attribute its release to the allocating subsystem
+struct alignas(std::max_align_t) AllocationHeader {
+    std::size_t size;
+    Subsystem   subsystem;
+};
+
+struct AtomicCounters {
+    std::atomic<int64_t>  liveBytes{0};
+    std::atomic<int64_t>  liveAllocations{0};
+    std::atomic<uint64_t> totalAllocations{0};
+};
+
+std::array<AtomicCounters, SUBSYSTEM_COUNT> counters;
+
+thread_local Subsystem currentSubsystem = Subsystem::Harness;
+
+void* allocate(std::size_t size) {
+    auto* header = static_cast<AllocationHeader*>(std::malloc(sizeof(AllocationHeader) + size));
+    if (header == nullptr) {
+        throw std::bad_alloc();
+    }
+    header->size      = size;
+    header->subsystem = currentSubsystem;
+
+    auto& subsystemCounters = counters[static_cast<std::size_t>(header->subsystem)];
+    subsystemCounters.liveBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+    subsystemCounters.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    subsystemCounters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    return header + 1;
+}
+
+void deallocate(void* pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    auto* header = static_cast<AllocationHeader*>(pointer) - 1;
+
+    auto& subsystemCounters = counters[static_cast<std::size_t>(header->subsystem)];
+    subsystemCounters.liveBytes.fetch_sub(static_cast<int64_t>(header->size),
+                                          std::memory_order_relaxed);
+    subsystemCounters.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+    std::free(header);
+}
+
+} // namespace
+
+const char* toString(Subsystem subsystem) {
+    switch (subsystem) {
+    case Subsystem::Harness:
+        return "harness";
+    case Subsystem::Requests:
+        return "requests";
+    case Subsystem::HoldToMove:
+        return "holdToMove";
+    case Subsystem::PositionUpdates:
+        return "positionUpdates";
+    case Subsystem::Automation:
+        return "automation";
+    case Subsystem::Commands:
+        return "commands";
+    case Subsystem::Timers:
+        return "timers";
+    case Subsystem::Broker:
+        return "broker";
+    }
+    return "unknown";
+}
+
+AllocationCounters getAllocationCounters(Subsystem subsystem) {
+    const auto& subsystemCounters = counters[static_cast<std::size_t>(subsystem)];
+    return {subsystemCounters.liveBytes.load(std::memory_order_relaxed),
+            subsystemCounters.liveAllocations.load(std::memory_order_relaxed),
+            subsystemCounters.totalAllocations.load(std::memory_order_relaxed)};
+}
+
+AllocationScope::AllocationScope(Subsystem subsystem)
+    : m_previous(currentSubsystem) {
+    currentSubsystem = subsystem;
+}
+
+AllocationScope::~AllocationScope() { currentSubsystem = m_previous; }
+
+} // namespace example::soak
+
+// The nothrow and aligned variants of the standard library forward to these
+// or use their own matching deallocation functions.
+void* operator new(std::size_t size) { return example::soak::allocate(size); }
+void* operator new[](std::size_t size) { return example::soak::allocate(size); }
+void  operator delete(void* pointer) noexcept { example::soak::deallocate(pointer); }
+void  operator delete[](void* pointer) noexcept { example::soak::deallocate(pointer); }
+void  operator delete(void* pointer, std::size_t) noexcept { example::soak::deallocate(pointer); }
+void  operator delete[](void* pointer, std::size_t) noexcept { example::soak::deallocate(pointer); }
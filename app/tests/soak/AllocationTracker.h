@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_ALLOCATIONTRACKER_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_ALLOCATIONTRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace example::soak {
+
+/**
+ * @brief Subsystems allocations are attributed to.
+ * @details The soak driver tags every call into the app with the subsystem
+ *      handling it, so allocations made inside are attributed to it.
+ */
+enum class Subsystem : uint8_t {
+    Harness,
+    Requests,
+    HoldToMove,
+    PositionUpdates,
+    Automation,
+    Commands,
+    Timers,
+    Broker,
+};
+
+constexpr std::size_t SUBSYSTEM_COUNT = static_cast<std::size_t>(Subsystem::Broker) + 1;
+
+const char* toString(Subsystem subsystem);
+
+struct AllocationCounters {
+    int64_t  liveBytes{0};
+    int64_t  liveAllocations{0};
+    uint64_t totalAllocations{0};
+};
+
+/**
+ * @brief Return the allocation counters of a subsystem.
+ * @details Counted are all allocations via the global operator new, which is
+ *      replaced for this purpose in the soak benchmark binary.
+ */
+AllocationCounters getAllocationCounters(Subsystem subsystem);
+
+/**
+ * @brief Attribute all allocations of the current thread to a subsystem
+ *      for the lifetime of the scope.
+ */
+class AllocationScope {
+public:
+    explicit AllocationScope(Subsystem subsystem);
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope&)            = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+    Subsystem m_previous;
+};
+
+} // namespace example::soak
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_ALLOCATIONTRACKER_H
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "MemoryProbe.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <malloc.h>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+namespace example::soak {
+
+namespace {
+
+std::size_t readResidentBytes() {
+    // Second field of statm is the resident set size in pages
+    std::ifstream statm("/proc/self/statm");
+    std::size_t   totalPages    = 0;
+    std::size_t   residentPages = 0;
+    if (!(statm >> totalPages >> residentPages)) {
+        throw std::runtime_error("Unable to read /proc/self/statm");
+    }
+    return residentPages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+std::string readMallocInfo() {
+    char*       buffer = nullptr;
+    std::size_t size   = 0;
+    FILE*       stream = open_memstream(&buffer, &size);
+    if (stream == nullptr) {
+        throw std::runtime_error("Unable to open memory stream");
+    }
+    const auto result = malloc_info(0, stream);
+    std::fclose(stream);
+
+    std::string info(buffer, size);
+    std::free(buffer);
+    if (result != 0) {
+        throw std::runtime_error("malloc_info() failed");
+    }
+    return info;
+}
+
+// Return the value of an attribute of the first element starting with the given prefix
+std::size_t getAttribute(const std::string& info, std::size_t offset, const std::string& element,
+                         const std::string& attribute) {
+    const auto elementPos = info.find(element, offset);
+    if (elementPos == std::string::npos) {
+        throw std::runtime_error("Element " + element + " missing in malloc_info()");
+    }
+    const auto key      = attribute + "=\"";
+    const auto valuePos = info.find(key, elementPos);
+    if (valuePos == std::string::npos) {
+        throw std::runtime_error("Attribute " + attribute + " missing in malloc_info()");
+    }
+    return std::stoull(info.substr(valuePos + key.size()));
+}
+
+} // namespace
+
+MemorySample sampleMemory() {
+    MemorySample sample;
+    sample.residentBytes = readResidentBytes();
+
+    // The totals over all arenas follow the last per-arena <heap> element
+    const auto info        = readMallocInfo();
+    const auto lastHeapEnd = info.rfind("</heap>");
+    const auto offset      = lastHeapEnd == std::string::npos ? 0 : lastHeapEnd;
+
+    sample.heapFreeBytes = getAttribute(info, offset, "<total type=\"fast\"", "size") +
+                           getAttribute(info, offset, "<total type=\"rest\"", "size");
+    sample.heapBytes     = getAttribute(info, offset, "<system type=\"current\"", "size");
+    return sample;
+}
+
+} // namespace example::soak
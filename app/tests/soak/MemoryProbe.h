@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef VEHICLE_APP_SDK_SEATADJUSTER_MEMORYPROBE_H
+#define VEHICLE_APP_SDK_SEATADJUSTER_MEMORYPROBE_H
+
+#include <cstddef>
+
+namespace example::soak {
+
+/**
+ * @brief Process wide memory figures.
+ * @details The heap figures are taken from malloc_info(). Free heap bytes are
+ *      memory retained by the allocator but not in use, i.e. a measure of
+ *      heap fragmentation.
+ */
+struct MemorySample {
+    std::size_t residentBytes{0};
+    std::size_t heapBytes{0};
+    std::size_t heapFreeBytes{0};
+
+    double getFragmentation() const {
+        return heapBytes == 0 ? 0.0
+                              : static_cast<double>(heapFreeBytes) / static_cast<double>(heapBytes);
+    }
+};
+
+/**
+ * @brief Sample the current memory usage of the process.
+ *
+ * @throws std::runtime_error  The figures cannot be read.
+ */
+MemorySample sampleMemory();
+
+} // namespace example::soak
+
+#endif // VEHICLE_APP_SDK_SEATADJUSTER_MEMORYPROBE_H
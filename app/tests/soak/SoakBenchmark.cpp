@@ -0,0 +1,531 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/**
+ * Soak benchmark of the SeatAdjuster.
+ *
+ * Runs the seat control logic against an in-process fake broker and vehicle on
+ * a virtual clock, so weeks of traffic (set position requests, hold to move
+ * sessions, speed changes, door events, binary commands and broker reconnects)
+ * pass within seconds. Memory is sampled periodically:
+ *   - resident set size,
+ *   - heap size and free heap bytes (fragmentation) via malloc_info(),
+ *   - live bytes per subsystem via a replaced global operator new.
+ *
+ * The run fails if any of these grew by more than the given bound between the
+ * end of the warm-up phase and the end of the run.
+ */
+
+#include "AllocationTracker.h"
+#include "MemoryProbe.h"
+#include "SeatAdjuster.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <fmt/core.h>
+#include <functional>
+#include <map>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace example::soak {
+
+using namespace std::chrono_literals;
+using Duration = std::chrono::milliseconds;
+
+constexpr auto TICK                = 100ms;
+constexpr int  SEAT_MOVE_PER_TICK  = 10;
+constexpr auto HEARTBEAT_INTERVAL  = 200ms;
+constexpr auto RECONNECT_INTERVAL  = std::chrono::hours(6);
+constexpr auto SIGNAL_DOOR_IS_OPEN = "Vehicle.Cabin.Door.Row1.DriverSide.IsOpen";
+constexpr auto SIGNAL_SPEED        = "Vehicle.Speed";
+
+constexpr int64_t KIB = 1024;
+
+struct Options {
+    double      days{14.0};
+    double      warmupDays{1.0};
+    double      sampleHours{6.0};
+    int64_t     maxRssGrowthKib{1024};
+    int64_t     maxHeapFreeGrowthKib{1024};
+    int64_t     maxLiveGrowthKib{16};
+    uint64_t    seed{1};
+    std::string automationConfig{SOAK_AUTOMATION_CONFIG};
+    bool        verbose{false};
+};
+
+struct Sample {
+    Duration                                        elapsed;
+    MemorySample                                    memory;
+    std::array<AllocationCounters, SUBSYSTEM_COUNT> allocations;
+};
+
+/**
+ * @brief In-process stand-in for the MQTT broker.
+ * @details Messages on topics without subscriber are counted and dropped.
+ *      A disconnect drops all subscriptions, like a lost clean session.
+ */
+class FakeBroker {
+public:
+    using Handler = std::function<void(const std::string&)>;
+
+    void subscribe(const std::string& topic, Handler handler) {
+        m_subscriptions[topic] = std::move(handler);
+    }
+
+    void disconnect() { m_subscriptions.clear(); }
+
+    void publish(const std::string& topic, const std::string& payload) {
+        const auto subscription = m_subscriptions.find(topic);
+        if (subscription != m_subscriptions.end()) {
+            subscription->second(payload);
+        } else {
+            ++m_unsubscribedMessages[topic];
+        }
+    }
+
+    const std::map<std::string, uint64_t>& getUnsubscribedMessages() const {
+        return m_unsubscribedMessages;
+    }
+
+private:
+    std::unordered_map<std::string, Handler> m_subscriptions;
+    std::map<std::string, uint64_t>          m_unsubscribedMessages;
+};
+
+/**
+ * @brief Seats moving with constant speed towards their target and a settable
+ *      vehicle speed, reporting seat positions like the databroker does.
+ */
+class FakeVehicle : public ISeatAdjusterBackend {
+public:
+    explicit FakeVehicle(FakeBroker& broker)
+        : m_broker(broker) {}
+
+    void setSeatAdjuster(SeatAdjuster& seatAdjuster) { m_seatAdjuster = &seatAdjuster; }
+
+    double getVehicleSpeed() override { return m_speed; }
+
+    void setSeatPosition(SeatId seat, int position) override {
+        m_seats[toIndex(seat)].target = std::clamp(position, SEAT_POSITION_MIN, SEAT_POSITION_MAX);
+    }
+
+    // The soak run only covers the seats
+    void setActuatorValue(const std::string& /*signal*/, const SignalValue& /*value*/) override {}
+
+    void publish(const std::string& topic, const std::string& payload) override {
+        m_broker.publish(topic, payload);
+    }
+
+    void setSpeed(double speed) { m_speed = speed; }
+
+    void tick() {
+        for (std::size_t index = 0; index < SEAT_COUNT; ++index) {
+            auto& seat = m_seats[index];
+            if (seat.position == seat.target) {
+                continue;
+            }
+            const auto step = std::clamp(seat.target - seat.position, -SEAT_MOVE_PER_TICK,
+                                         SEAT_MOVE_PER_TICK);
+            seat.position += step;
+            reportPosition(static_cast<SeatId>(index));
+        }
+    }
+
+    void reportPosition(SeatId seat) {
+        AllocationScope scope(Subsystem::PositionUpdates);
+        m_seatAdjuster->onSeatPositionChanged(seat, m_seats[toIndex(seat)].position);
+    }
+
+private:
+    struct Seat {
+        int position{SEAT_POSITION_MAX / 2};
+        int target{SEAT_POSITION_MAX / 2};
+    };
+
+    FakeBroker&                  m_broker;
+    SeatAdjuster*                m_seatAdjuster{nullptr};
+    double                       m_speed{0.0};
+    std::array<Seat, SEAT_COUNT> m_seats;
+};
+
+/**
+ * @brief Traffic generator and memory sampler of one soak run.
+ */
+class SoakRun {
+public:
+    explicit SoakRun(const Options& options)
+        : m_options(options)
+        , m_random(options.seed)
+        , m_vehicle(m_broker)
+        , m_timerService(TimerService::ManualClock{})
+        , m_seatAdjuster(m_vehicle, m_timerService) {
+        m_vehicle.setSeatAdjuster(m_seatAdjuster);
+        m_seatAdjuster.enableAutomation(AutomationEngine::fromFile(options.automationConfig));
+    }
+
+    std::vector<Sample> run() {
+        const auto duration       = toDuration(std::chrono::hours(24) * m_options.days);
+        const auto sampleInterval = toDuration(std::chrono::hours(1) * m_options.sampleHours);
+
+        m_seatAdjuster.start();
+        connect();
+        scheduleTraffic();
+
+        // Reserved upfront, so the samples do not show up as growth themselves
+        std::vector<Sample> samples;
+        samples.reserve(static_cast<std::size_t>(duration / sampleInterval) + 1);
+        auto nextSample = Duration::zero();
+        for (m_elapsed = Duration::zero(); m_elapsed <= duration; m_elapsed += TICK) {
+            generateTraffic();
+            m_vehicle.tick();
+            {
+                AllocationScope scope(Subsystem::Timers);
+                m_timerService.advance(TICK);
+            }
+            if (m_elapsed >= nextSample) {
+                samples.push_back(takeSample());
+                nextSample += sampleInterval;
+            }
+        }
+        return samples;
+    }
+
+    uint64_t getRequestCount() const { return m_requestCount; }
+
+    const FakeBroker& getBroker() const { return m_broker; }
+
+private:
+    struct MoveSession {
+        SeatId   seat{SeatId::Driver};
+        Duration end;
+        Duration nextHeartbeat;
+        bool     stopExplicitly{true};
+    };
+
+    template <typename TDuration> static Duration toDuration(TDuration duration) {
+        return std::chrono::duration_cast<Duration>(duration);
+    }
+
+    Duration randomDelay(Duration mean) {
+        std::exponential_distribution<double> distribution(1.0 / static_cast<double>(mean.count()));
+        return m_elapsed + Duration(static_cast<Duration::rep>(distribution(m_random)) + 1);
+    }
+
+    int randomInt(int min, int max) {
+        return std::uniform_int_distribution<int>(min, max)(m_random);
+    }
+
+    SeatId randomSeat() { return static_cast<SeatId>(randomInt(0, SEAT_COUNT - 1)); }
+
+    void subscribe(const std::string& topic, Subsystem subsystem,
+                   std::function<void(const std::string&)> handler) {
+        m_broker.subscribe(topic, [subsystem, handler = std::move(handler)](const auto& payload) {
+            AllocationScope scope(subsystem);
+            handler(payload);
+        });
+    }
+
+    void connect() {
+        AllocationScope scope(Subsystem::Broker);
+        for (const auto seat : {SeatId::Driver, SeatId::CoDriver}) {
+            subscribe(seat == SeatId::Driver ? TOPIC_Driver_REQUEST : TOPIC_CoDriver_REQUEST,
+                      Subsystem::Requests, [this, seat](const std::string& payload) {
+                          m_seatAdjuster.onSetPositionRequestReceived(seat, payload);
+                      });
+            subscribe(seat == SeatId::Driver ? TOPIC_Driver_MOVE_REQUEST
+                                             : TOPIC_CoDriver_MOVE_REQUEST,
+                      Subsystem::HoldToMove, [this, seat](const std::string& payload) {
+                          m_seatAdjuster.onMoveSeatRequestReceived(seat, payload);
+                      });
+            // The databroker delivers the current value on (re-)subscription
+            m_vehicle.reportPosition(seat);
+        }
+    }
+
+    void reconnect() {
+        {
+            AllocationScope scope(Subsystem::Broker);
+            m_broker.disconnect();
+        }
+        connect();
+    }
+
+    void scheduleTraffic() {
+        m_nextSetRequest  = randomDelay(1min);
+        m_nextMoveSession = randomDelay(10min);
+        m_nextSpeedChange = randomDelay(20min);
+        m_nextDoorEvent   = randomDelay(15min);
+        m_nextCommand     = randomDelay(30s);
+        m_nextReconnect   = m_elapsed + RECONNECT_INTERVAL;
+    }
+
+    void generateTraffic() {
+        if (m_elapsed >= m_nextSetRequest) {
+            const auto seat = randomSeat();
+            m_broker.publish(seat == SeatId::Driver ? TOPIC_Driver_REQUEST : TOPIC_CoDriver_REQUEST,
+                             fmt::format(R"({{"requestId": {}, "position": {}}})", m_requestCount++,
+                                         randomInt(SEAT_POSITION_MIN, SEAT_POSITION_MAX)));
+            m_nextSetRequest = randomDelay(1min);
+        }
+        if (m_elapsed >= m_nextMoveSession && !m_moveSession) {
+            startMoveSession();
+            m_nextMoveSession = randomDelay(10min);
+        }
+        if (m_moveSession) {
+            continueMoveSession();
+        }
+        if (m_elapsed >= m_nextSpeedChange) {
+            const auto speed = m_vehicle.getVehicleSpeed() == 0.0 ? randomInt(10, 130) : 0.0;
+            m_vehicle.setSpeed(speed);
+            feedAutomation(SIGNAL_SPEED, speed);
+            m_nextSpeedChange = randomDelay(20min);
+        }
+        if (m_elapsed >= m_nextDoorEvent) {
+            m_isDoorOpen = !m_isDoorOpen;
+            feedAutomation(SIGNAL_DOOR_IS_OPEN, m_isDoorOpen);
+            m_nextDoorEvent = randomDelay(15min);
+        }
+        if (m_elapsed >= m_nextCommand) {
+            sendCommand();
+            m_nextCommand = randomDelay(30s);
+        }
+        if (m_elapsed >= m_nextReconnect) {
+            reconnect();
+            m_nextReconnect += RECONNECT_INTERVAL;
+        }
+    }
+
+    void startMoveSession() {
+        MoveSession session;
+        session.seat           = randomSeat();
+        session.end            = m_elapsed + Duration(randomInt(500, 4000));
+        session.nextHeartbeat  = m_elapsed + HEARTBEAT_INTERVAL;
+        session.stopExplicitly = randomInt(0, 9) < 7;
+        m_moveSession          = session;
+
+        const auto direction = randomInt(0, 1) == 0 ? "forward" : "backward";
+        const auto payload   = fmt::format(R"({{"requestId": {}, "action": "start", )"
+                                           R"("direction": "{}"}})",
+                                           m_requestCount++, direction);
+        publishMoveRequest(session.seat, payload);
+    }
+
+    void continueMoveSession() {
+        auto& session = *m_moveSession;
+        if (m_elapsed >= session.end) {
+            // Without explicit stop, the lease expires once the heartbeats cease
+            if (session.stopExplicitly) {
+                publishMoveRequest(session.seat,
+                                   fmt::format(R"({{"requestId": {}, "action": "stop"}})",
+                                               m_requestCount++));
+            }
+            m_moveSession.reset();
+        } else if (m_elapsed >= session.nextHeartbeat) {
+            publishMoveRequest(session.seat, R"({"action": "heartbeat"})");
+            session.nextHeartbeat += HEARTBEAT_INTERVAL;
+        }
+    }
+
+    void publishMoveRequest(SeatId seat, const std::string& payload) {
+        m_broker.publish(seat == SeatId::Driver ? TOPIC_Driver_MOVE_REQUEST
+                                                : TOPIC_CoDriver_MOVE_REQUEST,
+                         payload);
+    }
+
+    void feedAutomation(const std::string& signal, const SignalValue& value) {
+        AllocationScope scope(Subsystem::Automation);
+        m_seatAdjuster.onAutomationSignalChanged(signal, value);
+    }
+
+    void sendCommand() {
+        SeatCommandRequestFrame request{};
+        request.version   = SEAT_COMMAND_PROTOCOL_VERSION;
+        request.seat      = static_cast<uint8_t>(randomSeat());
+        request.requestId = static_cast<uint32_t>(m_requestCount++);
+        if (randomInt(0, 1) == 0) {
+            request.command = static_cast<uint8_t>(SeatCommand::GetPosition);
+        } else {
+            request.command  = static_cast<uint8_t>(SeatCommand::SetPosition);
+            request.position = randomInt(SEAT_POSITION_MIN, SEAT_POSITION_MAX);
+        }
+
+        AllocationScope scope(Subsystem::Commands);
+        m_seatAdjuster.onSeatCommandReceived(request);
+    }
+
+    Sample takeSample() const {
+        Sample sample{m_elapsed, sampleMemory(), {}};
+        for (std::size_t index = 0; index < SUBSYSTEM_COUNT; ++index) {
+            sample.allocations[index] = getAllocationCounters(static_cast<Subsystem>(index));
+        }
+        return sample;
+    }
+
+    const Options&             m_options;
+    std::mt19937_64            m_random;
+    FakeBroker                 m_broker;
+    FakeVehicle                m_vehicle;
+    TimerService               m_timerService;
+    SeatAdjuster               m_seatAdjuster;
+    Duration                   m_elapsed{Duration::zero()};
+    uint64_t                   m_requestCount{0};
+    bool                       m_isDoorOpen{false};
+    std::optional<MoveSession> m_moveSession;
+    Duration                   m_nextSetRequest;
+    Duration                   m_nextMoveSession;
+    Duration                   m_nextSpeedChange;
+    Duration                   m_nextDoorEvent;
+    Duration                   m_nextCommand;
+    Duration                   m_nextReconnect;
+};
+
+double toHours(Duration duration) {
+    return std::chrono::duration<double, std::ratio<3600>>(duration).count();
+}
+
+void printSamples(const std::vector<Sample>& samples) {
+    fmt::print(stderr, "{:>8} {:>9} {:>9} {:>9} {:>6}", "hours", "rssKiB", "heapKiB", "freeKiB",
+               "frag%");
+    for (std::size_t index = 0; index < SUBSYSTEM_COUNT; ++index) {
+        fmt::print(stderr, " {:>15}", toString(static_cast<Subsystem>(index)));
+    }
+    fmt::print(stderr, "\n");
+
+    for (const auto& sample : samples) {
+        fmt::print(stderr, "{:>8.1f} {:>9} {:>9} {:>9} {:>6.1f}", toHours(sample.elapsed),
+                   sample.memory.residentBytes / KIB, sample.memory.heapBytes / KIB,
+                   sample.memory.heapFreeBytes / KIB, sample.memory.getFragmentation() * 100.0);
+        for (const auto& counters : sample.allocations) {
+            fmt::print(stderr, " {:>15}", fmt::format("{}B/{}", counters.liveBytes,
+                                                      counters.liveAllocations));
+        }
+        fmt::print(stderr, "\n");
+    }
+}
+
+bool checkGrowth(const char* name, int64_t baseline, int64_t final, int64_t limitKib) {
+    const auto growth = final - baseline;
+    if (growth <= limitKib * KIB) {
+        return true;
+    }
+    fmt::print(stderr, "FAILED: {} grew by {} bytes (limit {} KiB)\n", name, growth, limitKib);
+    return false;
+}
+
+bool evaluate(const Options& options, const std::vector<Sample>& samples) {
+    const auto warmup   = std::chrono::duration_cast<Duration>(std::chrono::hours(24) *
+                                                             options.warmupDays);
+    const auto baseline = std::find_if(samples.begin(), samples.end(), [&](const auto& sample) {
+        return sample.elapsed >= warmup;
+    });
+    if (baseline == samples.end() || baseline == samples.end() - 1) {
+        fmt::print(stderr, "FAILED: run too short for the warm-up phase\n");
+        return false;
+    }
+    const auto& final = samples.back();
+
+    bool passed = true;
+    passed &= checkGrowth("resident set size", static_cast<int64_t>(baseline->memory.residentBytes),
+                          static_cast<int64_t>(final.memory.residentBytes),
+                          options.maxRssGrowthKib);
+    passed &= checkGrowth("free heap bytes", static_cast<int64_t>(baseline->memory.heapFreeBytes),
+                          static_cast<int64_t>(final.memory.heapFreeBytes),
+                          options.maxHeapFreeGrowthKib);
+    for (std::size_t index = 0; index < SUBSYSTEM_COUNT; ++index) {
+        const auto name = fmt::format("live bytes of {}", toString(static_cast<Subsystem>(index)));
+        passed &= checkGrowth(name.c_str(), baseline->allocations[index].liveBytes,
+                              final.allocations[index].liveBytes, options.maxLiveGrowthKib);
+    }
+    return passed;
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int index = 1; index < argc; ++index) {
+        const std::string_view argument = argv[index];
+        if (argument == "--verbose") {
+            options.verbose = true;
+            continue;
+        }
+        if (index + 1 >= argc) {
+            throw std::invalid_argument(
+                fmt::format("Unknown option or missing value: {}", argument));
+        }
+        const std::string value = argv[++index];
+        if (argument == "--days") {
+            options.days = std::stod(value);
+        } else if (argument == "--warmup-days") {
+            options.warmupDays = std::stod(value);
+        } else if (argument == "--sample-hours") {
+            options.sampleHours = std::stod(value);
+        } else if (argument == "--max-rss-growth-kib") {
+            options.maxRssGrowthKib = std::stoll(value);
+        } else if (argument == "--max-heap-free-growth-kib") {
+            options.maxHeapFreeGrowthKib = std::stoll(value);
+        } else if (argument == "--max-live-growth-kib") {
+            options.maxLiveGrowthKib = std::stoll(value);
+        } else if (argument == "--seed") {
+            options.seed = std::stoull(value);
+        } else if (argument == "--automation-config") {
+            options.automationConfig = value;
+        } else {
+            throw std::invalid_argument(fmt::format("Unknown option: {}", argument));
+        }
+    }
+    return options;
+}
+
+} // namespace example::soak
+
+int main(int argc, char** argv) {
+    using namespace example::soak;
+
+    try {
+        const auto options = parseOptions(argc, argv);
+        // The app logs every rejected request, which would dominate the output
+        if (!options.verbose && std::freopen("/dev/null", "w", stdout) == nullptr) {
+            throw std::runtime_error("Unable to discard app log output");
+        }
+
+        SoakRun    soakRun(options);
+        const auto samples = soakRun.run();
+
+        printSamples(samples);
+        fmt::print(stderr, "{} requests over {} simulated days\n", soakRun.getRequestCount(),
+                   options.days);
+        for (const auto& [topic, count] : soakRun.getBroker().getUnsubscribedMessages()) {
+            fmt::print(stderr, "  {:>8} messages on {}\n", count, topic);
+        }
+
+        if (!evaluate(options, samples)) {
+            return 1;
+        }
+        fmt::print(stderr, "PASSED\n");
+        return 0;
+    } catch (const std::exception& exception) {
+        fmt::print(stderr, "Soak benchmark aborted: {}\n", exception.what());
+        return 2;
+    }
+}
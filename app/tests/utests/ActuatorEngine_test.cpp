@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "ActuatorEngine.h"
+#include "Json.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace example;
+
+namespace {
+
+const auto MODE_SIGNAL     = "Vehicle.Body.Windshield.Front.Wiping.System.Mode";
+const auto POSITION_SIGNAL = "Vehicle.Body.Windshield.Front.Wiping.System.TargetPosition";
+const auto SPEED_SIGNAL    = "Vehicle.Speed";
+
+constexpr std::size_t WIPER_MODE     = 0;
+constexpr std::size_t WIPER_POSITION = 1;
+
+nlohmann::json createWiperConfig() {
+    return nlohmann::json::parse(R"({
+        "actuators": [{
+            "name": "wiperMode",
+            "signal": "Vehicle.Body.Windshield.Front.Wiping.System.Mode",
+            "type": "string",
+            "allowed": ["STOP_HOLD", "WIPE"]
+        }, {
+            "name": "wiperPosition",
+            "signal": "Vehicle.Body.Windshield.Front.Wiping.System.TargetPosition",
+            "type": "uint8",
+            "max": 180,
+            "interlocks": [{"signal": "Vehicle.Speed", "op": "==", "value": 0}]
+        }]
+    })");
+}
+
+} // namespace
+
+TEST(ActuatorEngineTest, constructor_topicsDerivedFromName) {
+    ActuatorEngine engine(createWiperConfig());
+
+    const auto& actuator = engine.getActuators()[WIPER_MODE];
+    EXPECT_EQ("seatadjuster/actuators/wiperMode/request", actuator.requestTopic);
+    EXPECT_EQ("seatadjuster/actuators/wiperMode/response", actuator.responseTopic);
+    EXPECT_EQ("seatadjuster/actuators/wiperMode/current", actuator.currentTopic);
+    EXPECT_EQ((std::set<std::string>{MODE_SIGNAL, POSITION_SIGNAL, SPEED_SIGNAL}),
+              engine.getReferencedSignals());
+}
+
+TEST(ActuatorEngineTest, submit_validValue_writeReturned) {
+    ActuatorEngine engine(createWiperConfig());
+
+    const auto submission = engine.submit(WIPER_MODE, 1, std::string("WIPE"));
+
+    EXPECT_FALSE(submission.error);
+    ASSERT_TRUE(submission.write);
+    EXPECT_EQ(1, submission.write->requestId);
+    EXPECT_EQ(SignalValue(std::string("WIPE")), submission.write->value);
+}
+
+TEST(ActuatorEngineTest, submit_invalidValue_rejected) {
+    ActuatorEngine engine(createWiperConfig());
+    engine.onSignalChanged(SPEED_SIGNAL, 0.0);
+
+    EXPECT_TRUE(engine.submit(WIPER_MODE, 1, std::string("FAST")).error);
+    EXPECT_TRUE(engine.submit(WIPER_MODE, 1, true).error);
+    EXPECT_TRUE(engine.submit(WIPER_POSITION, 1, 181.0).error);
+    EXPECT_TRUE(engine.submit(WIPER_POSITION, 1, 12.5).error);
+    EXPECT_TRUE(engine.submit(WIPER_POSITION, 1, -1.0).error);
+    EXPECT_FALSE(engine.submit(WIPER_POSITION, 1, 180.0).error);
+}
+
+TEST(ActuatorEngineTest, submit_interlockNotMetOrUnknown_rejected) {
+    ActuatorEngine engine(createWiperConfig());
+    EXPECT_TRUE(engine.submit(WIPER_POSITION, 1, 90.0).error);
+
+    engine.onSignalChanged(SPEED_SIGNAL, 30.0);
+    EXPECT_TRUE(engine.submit(WIPER_POSITION, 2, 90.0).error);
+
+    engine.onSignalChanged(SPEED_SIGNAL, 0.0);
+    EXPECT_TRUE(engine.submit(WIPER_POSITION, 3, 90.0).write);
+}
+
+TEST(ActuatorEngineTest, submit_writeInFlight_latestRequestCoalesced) {
+    ActuatorEngine engine(createWiperConfig());
+    ASSERT_TRUE(engine.submit(WIPER_MODE, 1, std::string("WIPE")).write);
+
+    const auto second = engine.submit(WIPER_MODE, 2, std::string("STOP_HOLD"));
+    const auto third  = engine.submit(WIPER_MODE, 3, std::string("WIPE"));
+
+    EXPECT_FALSE(second.write);
+    EXPECT_FALSE(second.superseded);
+    EXPECT_FALSE(third.write);
+    ASSERT_TRUE(third.superseded);
+    EXPECT_EQ(2, third.superseded->requestId);
+    EXPECT_EQ(SignalValue(std::string("STOP_HOLD")), third.superseded->value);
+
+    const auto next = engine.completeWrite(WIPER_MODE);
+    ASSERT_TRUE(next);
+    EXPECT_EQ(3, next->requestId);
+    EXPECT_FALSE(engine.completeWrite(WIPER_MODE));
+    EXPECT_TRUE(engine.submit(WIPER_MODE, 4, std::string("WIPE")).write);
+}
+
+TEST(ActuatorEngineTest, onSignalChanged_onlyChangedActuatorValuesReported) {
+    ActuatorEngine engine(createWiperConfig());
+
+    const SignalValue wipe(std::string("WIPE"));
+
+    EXPECT_EQ(std::vector<std::size_t>{WIPER_MODE}, engine.onSignalChanged(MODE_SIGNAL, wipe));
+    EXPECT_TRUE(engine.onSignalChanged(MODE_SIGNAL, wipe).empty());
+    EXPECT_TRUE(engine.onSignalChanged(SPEED_SIGNAL, 0.0).empty());
+}
+
+TEST(ActuatorEngineTest, constructor_invalidConfig_throws) {
+    EXPECT_THROW(ActuatorEngine(nlohmann::json::parse(R"({"actuators": [{"name": "x"}]})")),
+                 std::invalid_argument);
+    EXPECT_THROW(ActuatorEngine(nlohmann::json::parse(
+                     R"({"actuators": [{"name": "x", "signal": "y", "type": "complex"}]})")),
+                 std::invalid_argument);
+    const auto outOfTypeRange =
+        R"({"actuators": [{"name": "x", "signal": "y", "type": "uint8", "max": 300}]})";
+    EXPECT_THROW(ActuatorEngine(nlohmann::json::parse(outOfTypeRange)), std::invalid_argument);
+}
@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "ArrivalSchedule.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace example::load;
+using namespace std::chrono_literals;
+
+TEST(ArrivalScheduleTest, constant_evenlySpaced) {
+    const auto schedule = createSchedule({ArrivalProcess::Constant, 100.0, 1}, 1s, 1);
+
+    ASSERT_EQ(100U, schedule.size());
+    EXPECT_EQ(0ns, schedule[0]);
+    EXPECT_EQ(10ms, schedule[1]);
+    EXPECT_EQ(990ms, schedule.back());
+}
+
+TEST(ArrivalScheduleTest, poisson_averageRateKept) {
+    const auto schedule = createSchedule({ArrivalProcess::Poisson, 1'000.0, 1}, 10s, 7);
+
+    EXPECT_NEAR(10'000.0, static_cast<double>(schedule.size()), 300.0);
+    EXPECT_TRUE(std::is_sorted(schedule.begin(), schedule.end()));
+    EXPECT_EQ(schedule, createSchedule({ArrivalProcess::Poisson, 1'000.0, 1}, 10s, 7));
+}
+
+TEST(ArrivalScheduleTest, burst_groupsSentAtOnce) {
+    const auto schedule = createSchedule({ArrivalProcess::Burst, 100.0, 10}, 1s, 1);
+
+    ASSERT_EQ(100U, schedule.size());
+    EXPECT_EQ(0ns, schedule[9]);
+    EXPECT_EQ(100ms, schedule[10]);
+    EXPECT_EQ(900ms, schedule.back());
+}
+
+TEST(ArrivalScheduleTest, invalidProfile_throws) {
+    EXPECT_THROW(createSchedule({ArrivalProcess::Constant, 0.0, 1}, 1s, 1), std::invalid_argument);
+    EXPECT_THROW(createSchedule({ArrivalProcess::Burst, 10.0, 0}, 1s, 1), std::invalid_argument);
+    EXPECT_EQ(ArrivalProcess::Burst, parseArrivalProcess("burst"));
+    EXPECT_FALSE(parseArrivalProcess("random"));
+}
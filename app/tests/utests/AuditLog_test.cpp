@@ -0,0 +1,249 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "AuditLog.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <csignal>
+#include <fcntl.h>
+#include <functional>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace example;
+
+namespace {
+
+bool waitUntil(const std::function<bool()>& condition) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+class AuditLogTest : public ::testing::Test {
+protected:
+    AuditLogTest()
+        : m_path("/tmp/seatadjuster_audit_test_" + std::to_string(getpid()) + ".log") {}
+
+    ~AuditLogTest() override {
+        for (const auto& path : {m_path, m_path + ".1", m_path + ".2"}) {
+            ::unlink(path.c_str());
+        }
+    }
+
+    AuditLog::Config makeConfig() const {
+        AuditLog::Config config;
+        config.path          = m_path;
+        config.flushInterval = std::chrono::milliseconds(20);
+        return config;
+    }
+
+    std::vector<AuditRecord> readRecords(const std::string& path) const {
+        std::vector<AuditRecord> records;
+        const auto               result = readAuditLog(
+            path, [&records](const AuditRecord& record) { records.push_back(record); });
+        EXPECT_TRUE(result.validHeader);
+        EXPECT_EQ(0, result.corruptRecords);
+        return records;
+    }
+
+    const std::string m_path;
+};
+
+TEST_F(AuditLogTest, append_durableAfterFlushInterval) {
+    AuditLog log(makeConfig());
+    log.append(CommandSource::Mqtt, SeatId::Driver, 300, STATUS_OK, 7);
+    log.append(CommandSource::Uds, SeatId::CoDriver, 500, STATUS_FAIL, 8);
+    EXPECT_EQ(0, log.getDurableSequence());
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (log.getDurableSequence() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(2, log.getDurableSequence());
+
+    const auto records = readRecords(m_path);
+    ASSERT_EQ(2, records.size());
+    EXPECT_EQ(1, records[0].sequence);
+    EXPECT_EQ(static_cast<uint8_t>(CommandSource::Mqtt), records[0].source);
+    EXPECT_EQ(300, records[0].position);
+    EXPECT_EQ(7, records[0].requestId);
+    EXPECT_EQ(static_cast<uint8_t>(SeatId::CoDriver), records[1].seat);
+    EXPECT_EQ(STATUS_FAIL, records[1].status);
+}
+
+TEST_F(AuditLogTest, appendActuator_indexAndValueRecorded) {
+    {
+        AuditLog log(makeConfig());
+        log.append(CommandSource::Mqtt, SeatId::Driver, 300, STATUS_OK, 1);
+        log.appendActuator(CommandSource::Mqtt, 3, AuditRecordKind::ActuatorText, 2, STATUS_FAIL,
+                           2);
+    }
+
+    const auto records = readRecords(m_path);
+    ASSERT_EQ(2, records.size());
+    EXPECT_EQ(static_cast<uint8_t>(AuditRecordKind::Seat), records[0].kind);
+    EXPECT_EQ(static_cast<uint8_t>(AuditRecordKind::ActuatorText), records[1].kind);
+    EXPECT_EQ(3, records[1].seat);
+    EXPECT_EQ(2, records[1].position);
+    EXPECT_EQ(STATUS_FAIL, records[1].status);
+}
+
+TEST_F(AuditLogTest, reopen_sequenceContinues) {
+    {
+        AuditLog log(makeConfig());
+        log.append(CommandSource::Grpc, SeatId::Driver, 100, STATUS_OK, 0);
+    }
+
+    {
+        AuditLog log(makeConfig());
+        EXPECT_EQ(1, log.getDurableSequence());
+        log.append(CommandSource::Grpc, SeatId::Driver, 200, STATUS_OK, 0);
+    }
+
+    const auto records = readRecords(m_path);
+    ASSERT_EQ(2, records.size());
+    EXPECT_EQ(2, records[1].sequence);
+}
+
+TEST_F(AuditLogTest, tornRecord_cutOffOnReopen) {
+    {
+        AuditLog log(makeConfig());
+        log.append(CommandSource::Automation, SeatId::Driver, 100, STATUS_OK, 0);
+    }
+    {
+        const auto fd = ::open(m_path.c_str(), O_WRONLY | O_APPEND);
+        ASSERT_GE(fd, 0);
+        const char tornRecord[10] = {};
+        EXPECT_EQ(sizeof(tornRecord), ::write(fd, tornRecord, sizeof(tornRecord)));
+        ::close(fd);
+    }
+
+    {
+        AuditLog log(makeConfig());
+        log.append(CommandSource::Automation, SeatId::Driver, 200, STATUS_OK, 0);
+    }
+
+    const auto records = readRecords(m_path);
+    ASSERT_EQ(2, records.size());
+    EXPECT_EQ(200, records[1].position);
+}
+
+TEST_F(AuditLogTest, writeFails_tornBatchCutOffAndRetried) {
+    auto config          = makeConfig();
+    config.retryInterval = std::chrono::milliseconds(20);
+    AuditLog log(config);
+
+    // Writes beyond the file size limit fail with EFBIG, so the batch is written partly
+    const auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit     previousLimit{};
+    ASSERT_EQ(0, ::getrlimit(RLIMIT_FSIZE, &previousLimit));
+    auto limit     = previousLimit;
+    limit.rlim_cur = sizeof(AuditLogHeader) + sizeof(AuditRecord) + sizeof(AuditRecord) / 2;
+    ASSERT_EQ(0, ::setrlimit(RLIMIT_FSIZE, &limit));
+
+    log.append(CommandSource::Mqtt, SeatId::Driver, 100, STATUS_OK, 1);
+    log.append(CommandSource::Mqtt, SeatId::Driver, 200, STATUS_OK, 2);
+    EXPECT_TRUE(waitUntil([&log]() { return log.isFailing(); }));
+    EXPECT_EQ(0, log.getDurableSequence());
+
+    ::setrlimit(RLIMIT_FSIZE, &previousLimit);
+    std::signal(SIGXFSZ, previousHandler);
+    EXPECT_TRUE(waitUntil([&log]() { return log.getDurableSequence() == 2; }));
+    EXPECT_FALSE(log.isFailing());
+
+    const auto records = readRecords(m_path);
+    ASSERT_EQ(2, records.size());
+    EXPECT_EQ(1, records[0].sequence);
+    EXPECT_EQ(200, records[1].position);
+}
+
+TEST_F(AuditLogTest, sizeLimitExceeded_rotated) {
+    auto config         = makeConfig();
+    config.flushRecords = 4;
+    config.maxFileBytes = sizeof(AuditLogHeader) + 4 * sizeof(AuditRecord);
+    config.maxFiles     = 2;
+    {
+        AuditLog log(config);
+        for (int i = 0; i < 12; ++i) {
+            log.append(CommandSource::HoldToMove, SeatId::Driver, i, STATUS_OK, 0);
+            if (i % 4 == 3) {
+                // Wait for every batch, so each file holds exactly one
+                while (log.getDurableSequence() < static_cast<uint64_t>(i + 1)) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        }
+    }
+
+    // Only the newest rotated file is kept, the current file is empty
+    EXPECT_TRUE(readRecords(m_path).empty());
+    const auto rotated = readRecords(m_path + ".1");
+    ASSERT_EQ(4, rotated.size());
+    EXPECT_EQ(9, rotated.front().sequence);
+    EXPECT_EQ(-1, ::access((m_path + ".2").c_str(), F_OK));
+
+    // The sequence continues from the rotated file
+    AuditLog log(config);
+    EXPECT_EQ(12, log.getDurableSequence());
+}
+
+TEST_F(AuditLogTest, corruptRecord_skippedByReader) {
+    {
+        AuditLog log(makeConfig());
+        log.append(CommandSource::Mqtt, SeatId::Driver, 100, STATUS_OK, 1);
+        log.append(CommandSource::Mqtt, SeatId::Driver, 200, STATUS_OK, 2);
+    }
+    {
+        const auto fd = ::open(m_path.c_str(), O_WRONLY);
+        ASSERT_GE(fd, 0);
+        const int32_t position = 999;
+        EXPECT_EQ(sizeof(position),
+                  ::pwrite(fd, &position, sizeof(position),
+                           sizeof(AuditLogHeader) + offsetof(AuditRecord, position)));
+        ::close(fd);
+    }
+
+    std::vector<uint64_t> sequences;
+    const auto            result = readAuditLog(
+        m_path, [&sequences](const AuditRecord& record) { sequences.push_back(record.sequence); });
+    EXPECT_EQ(1, result.corruptRecords);
+    EXPECT_EQ(std::vector<uint64_t>{2}, sequences);
+}
+
+TEST_F(AuditLogTest, otherFile_invalidHeader) {
+    {
+        const auto fd = ::open(m_path.c_str(), O_WRONLY | O_CREAT, 0600);
+        ASSERT_GE(fd, 0);
+        EXPECT_EQ(20, ::write(fd, "not an audit log....", 20));
+        ::close(fd);
+    }
+
+    EXPECT_FALSE(readAuditLog(m_path, [](const AuditRecord&) {}).validHeader);
+}
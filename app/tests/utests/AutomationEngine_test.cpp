@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "AutomationEngine.h"
+#include "Json.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace example;
+
+namespace {
+
+const auto DOOR_SIGNAL  = "Vehicle.Cabin.Door.Row1.DriverSide.IsOpen";
+const auto SPEED_SIGNAL = "Vehicle.Speed";
+
+nlohmann::json createDoorRuleConfig() {
+    return nlohmann::json::parse(R"({
+        "rules": [{
+            "name": "slideBack",
+            "trigger": {"signal": "Vehicle.Cabin.Door.Row1.DriverSide.IsOpen", "equals": true},
+            "conditions": [{"signal": "Vehicle.Speed", "op": "<=", "value": 0}],
+            "action": {"seat": "Driver", "position": 800}
+        }]
+    })");
+}
+
+} // namespace
+
+TEST(AutomationEngineTest, getReferencedSignals_triggerAndConditions) {
+    AutomationEngine engine(createDoorRuleConfig());
+
+    EXPECT_EQ((std::set<std::string>{DOOR_SIGNAL, SPEED_SIGNAL}), engine.getReferencedSignals());
+}
+
+TEST(AutomationEngineTest, onSignalChanged_triggerMatchesAndConditionsMet_actionReturned) {
+    AutomationEngine engine(createDoorRuleConfig());
+    engine.onSignalChanged(SPEED_SIGNAL, 0.0);
+    engine.onSignalChanged(DOOR_SIGNAL, false);
+
+    const auto actions = engine.onSignalChanged(DOOR_SIGNAL, true);
+
+    ASSERT_EQ(1, actions.size());
+    EXPECT_EQ("slideBack", actions[0].ruleName);
+    EXPECT_EQ(SeatId::Driver, actions[0].seat);
+    EXPECT_EQ(800, actions[0].position);
+}
+
+TEST(AutomationEngineTest, onSignalChanged_firstValue_doesNotFire) {
+    AutomationEngine engine(createDoorRuleConfig());
+    engine.onSignalChanged(SPEED_SIGNAL, 0.0);
+
+    EXPECT_TRUE(engine.onSignalChanged(DOOR_SIGNAL, true).empty());
+}
+
+TEST(AutomationEngineTest, onSignalChanged_unchangedValue_doesNotFire) {
+    AutomationEngine engine(createDoorRuleConfig());
+    engine.onSignalChanged(SPEED_SIGNAL, 0.0);
+    engine.onSignalChanged(DOOR_SIGNAL, false);
+
+    EXPECT_EQ(1, engine.onSignalChanged(DOOR_SIGNAL, true).size());
+    EXPECT_TRUE(engine.onSignalChanged(DOOR_SIGNAL, true).empty());
+}
+
+TEST(AutomationEngineTest, onSignalChanged_conditionNotMet_doesNotFire) {
+    AutomationEngine engine(createDoorRuleConfig());
+    engine.onSignalChanged(SPEED_SIGNAL, 30.0);
+    engine.onSignalChanged(DOOR_SIGNAL, false);
+
+    EXPECT_TRUE(engine.onSignalChanged(DOOR_SIGNAL, true).empty());
+}
+
+TEST(AutomationEngineTest, onSignalChanged_conditionSignalUnknown_doesNotFire) {
+    AutomationEngine engine(createDoorRuleConfig());
+    engine.onSignalChanged(DOOR_SIGNAL, false);
+
+    EXPECT_TRUE(engine.onSignalChanged(DOOR_SIGNAL, true).empty());
+}
+
+TEST(AutomationEngineTest, onSignalChanged_triggerValueNotMatching_doesNotFire) {
+    AutomationEngine engine(createDoorRuleConfig());
+    engine.onSignalChanged(SPEED_SIGNAL, 0.0);
+    engine.onSignalChanged(DOOR_SIGNAL, true);
+
+    EXPECT_TRUE(engine.onSignalChanged(DOOR_SIGNAL, false).empty());
+}
+
+TEST(AutomationEngineTest, constructor_invalidConfig_throws) {
+    EXPECT_THROW(AutomationEngine(nlohmann::json::object()), std::invalid_argument);
+    EXPECT_THROW(AutomationEngine(nlohmann::json::parse(R"({"rules": [{
+                     "name": "r", "trigger": {"signal": "Vehicle.Speed"},
+                     "action": {"seat": "Rear", "position": 1}}]})")),
+                 std::invalid_argument);
+    EXPECT_THROW(AutomationEngine(nlohmann::json::parse(R"({"rules": [{
+                     "name": "r", "trigger": {"signal": "Vehicle.Speed"},
+                     "conditions": [{"signal": "Vehicle.Speed", "op": "~", "value": 1}],
+                     "action": {"seat": "Driver", "position": 1}}]})")),
+                 std::invalid_argument);
+}
@@ -0,0 +1,217 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "FairRequestQueue.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace example;
+using namespace std::chrono_literals;
+
+namespace {
+
+FairRequestQueue::Config makeConfig(double rate, double burst) {
+    FairRequestQueue::Config config;
+    config.rate  = rate;
+    config.burst = burst;
+    return config;
+}
+
+} // namespace
+
+class FairRequestQueueTest : public ::testing::Test {
+protected:
+    FairRequestQueue::Admission submit(FairRequestQueue& queue, const std::string& clientId,
+                                       std::size_t cost = 1) {
+        return queue.submit(clientId, cost, [this, clientId]() { m_order.push_back(clientId); });
+    }
+
+    // New clients start with a single token, let them earn a full bucket
+    void addClients(FairRequestQueue& queue, const std::vector<std::string>& clientIds) {
+        for (const auto& clientId : clientIds) {
+            submit(queue, clientId);
+        }
+        while (queue.runNext()) {
+        }
+        m_timerService.advance(10s);
+        m_order.clear();
+    }
+
+    TimerService             m_timerService{TimerService::ManualClock{}};
+    std::vector<std::string> m_order;
+};
+
+TEST_F(FairRequestQueueTest, submit_burstUsedUp_rejectedUntilRefilled) {
+    FairRequestQueue queue(makeConfig(2.0, 3.0), m_timerService,
+                           FairRequestQueue::ManualDispatch{});
+    addClients(queue, {"a", "b"});
+
+    EXPECT_EQ(FairRequestQueue::Admission::Queued, submit(queue, "a"));
+    EXPECT_EQ(FairRequestQueue::Admission::Queued, submit(queue, "a"));
+    EXPECT_EQ(FairRequestQueue::Admission::Queued, submit(queue, "a"));
+    EXPECT_EQ(FairRequestQueue::Admission::RateLimited, submit(queue, "a"));
+    EXPECT_EQ(FairRequestQueue::Admission::Queued, submit(queue, "b"));
+
+    m_timerService.advance(500ms);
+    EXPECT_EQ(FairRequestQueue::Admission::Queued, submit(queue, "a"));
+    EXPECT_EQ(FairRequestQueue::Admission::RateLimited, submit(queue, "a"));
+}
+
+TEST_F(FairRequestQueueTest, submit_queueOfClientFull_rejected) {
+    auto config               = makeConfig(100.0, 100.0);
+    config.maxQueuedPerClient = 2;
+    FairRequestQueue queue(config, m_timerService, FairRequestQueue::ManualDispatch{});
+    addClients(queue, {"a"});
+
+    EXPECT_EQ(FairRequestQueue::Admission::Queued, submit(queue, "a"));
+    EXPECT_EQ(FairRequestQueue::Admission::Queued, submit(queue, "a"));
+    EXPECT_EQ(FairRequestQueue::Admission::QueueFull, submit(queue, "a"));
+
+    EXPECT_TRUE(queue.runNext());
+    EXPECT_EQ(FairRequestQueue::Admission::Queued, submit(queue, "a"));
+}
+
+TEST_F(FairRequestQueueTest, runNext_clientsServedRoundRobin) {
+    FairRequestQueue queue(makeConfig(100.0, 100.0), m_timerService,
+                           FairRequestQueue::ManualDispatch{});
+    addClients(queue, {"busy", "quiet"});
+    for (int request = 0; request < 4; ++request) {
+        submit(queue, "busy", FairRequestQueue::QUANTUM);
+    }
+    submit(queue, "quiet", FairRequestQueue::QUANTUM);
+    submit(queue, "quiet", FairRequestQueue::QUANTUM);
+
+    while (queue.runNext()) {
+    }
+
+    EXPECT_EQ((std::vector<std::string>{"busy", "quiet", "busy", "quiet", "busy", "busy"}),
+              m_order);
+}
+
+TEST_F(FairRequestQueueTest, runNext_smallRequests_servedByCostPerTurn) {
+    FairRequestQueue queue(makeConfig(100.0, 100.0), m_timerService,
+                           FairRequestQueue::ManualDispatch{});
+    addClients(queue, {"small", "large"});
+    for (int request = 0; request < 4; ++request) {
+        submit(queue, "small", FairRequestQueue::QUANTUM / 2);
+    }
+    submit(queue, "large", FairRequestQueue::QUANTUM);
+    submit(queue, "large", FairRequestQueue::QUANTUM);
+
+    while (queue.runNext()) {
+    }
+
+    EXPECT_EQ((std::vector<std::string>{"small", "small", "large", "small", "small", "large"}),
+              m_order);
+}
+
+TEST_F(FairRequestQueueTest, submit_moreClientsThanSlots_overflowSlotShared) {
+    auto config           = makeConfig(1.0, 1.0);
+    config.newClientRate  = 2 * FairRequestQueue::TABLE_SIZE;
+    config.newClientBurst = 2 * FairRequestQueue::TABLE_SIZE;
+    FairRequestQueue queue(config, m_timerService, FairRequestQueue::ManualDispatch{});
+    const auto       submitAll = [&]() {
+        std::size_t queued = 0;
+        for (std::size_t client = 0; client < 2 * FairRequestQueue::TABLE_SIZE; ++client) {
+            queued += submit(queue, "client" + std::to_string(client)) ==
+                              FairRequestQueue::Admission::Queued
+                          ? 1
+                          : 0;
+        }
+        return queued;
+    };
+
+    const auto queued = submitAll();
+    EXPECT_LE(FairRequestQueue::TABLE_SIZE / 2, queued);
+    EXPECT_GT(2 * FairRequestQueue::TABLE_SIZE, queued);
+
+    // Once the clients are idle again, their slots are available again
+    while (queue.runNext()) {
+    }
+    m_timerService.advance(1s);
+    EXPECT_EQ(queued, submitAll());
+}
+
+TEST_F(FairRequestQueueTest, submit_newClient_startsWithSingleToken) {
+    FairRequestQueue queue(makeConfig(2.0, 3.0), m_timerService,
+                           FairRequestQueue::ManualDispatch{});
+
+    EXPECT_EQ(FairRequestQueue::Admission::Queued, submit(queue, "a"));
+    EXPECT_EQ(FairRequestQueue::Admission::RateLimited, submit(queue, "a"));
+
+    m_timerService.advance(500ms);
+    EXPECT_EQ(FairRequestQueue::Admission::Queued, submit(queue, "a"));
+}
+
+TEST_F(FairRequestQueueTest, submit_rotatingClientIds_limitedByNewClientRate) {
+    auto config           = makeConfig(1.0, 3.0);
+    config.newClientRate  = 1.0;
+    config.newClientBurst = 2.0;
+    FairRequestQueue queue(config, m_timerService, FairRequestQueue::ManualDispatch{});
+
+    // Two clients get a slot of their own, the others share the overflow slot's burst
+    std::size_t queued = 0;
+    for (int client = 0; client < 20; ++client) {
+        queued += submit(queue, "rotating" + std::to_string(client)) ==
+                          FairRequestQueue::Admission::Queued
+                      ? 1
+                      : 0;
+    }
+    EXPECT_EQ(5U, queued);
+}
+
+TEST_F(FairRequestQueueTest, submit_anonymous_onlyLimitedIfConfigured) {
+    auto config               = makeConfig(1.0, 1.0);
+    config.maxQueuedAnonymous = 50;
+    FairRequestQueue unlimited(config, m_timerService, FairRequestQueue::ManualDispatch{});
+    for (int request = 0; request < 50; ++request) {
+        EXPECT_EQ(FairRequestQueue::Admission::Queued, submit(unlimited, ""));
+    }
+    EXPECT_EQ(FairRequestQueue::Admission::QueueFull, submit(unlimited, ""));
+
+    config.anonymousRate  = 2.0;
+    config.anonymousBurst = 2.0;
+    FairRequestQueue limited(config, m_timerService, FairRequestQueue::ManualDispatch{});
+    EXPECT_EQ(FairRequestQueue::Admission::Queued, submit(limited, ""));
+    EXPECT_EQ(FairRequestQueue::Admission::Queued, submit(limited, ""));
+    EXPECT_EQ(FairRequestQueue::Admission::RateLimited, submit(limited, ""));
+}
+
+TEST_F(FairRequestQueueTest, dispatcherThread_queuedRequestRun) {
+    FairRequestQueue   queue(makeConfig(10.0, 10.0), m_timerService);
+    std::promise<void> handled;
+
+    EXPECT_EQ(FairRequestQueue::Admission::Queued,
+              queue.submit("a", 10, [&handled]() { handled.set_value(); }));
+
+    EXPECT_EQ(std::future_status::ready, handled.get_future().wait_for(1s));
+}
+
+TEST_F(FairRequestQueueTest, construction_invalidRate_throws) {
+    EXPECT_THROW(FairRequestQueue(makeConfig(0.0, 10.0), m_timerService), std::invalid_argument);
+    EXPECT_THROW(FairRequestQueue(makeConfig(1.0, 0.5), m_timerService), std::invalid_argument);
+
+    auto config          = makeConfig(1.0, 1.0);
+    config.anonymousRate = 1.0;
+    EXPECT_THROW(FairRequestQueue(config, m_timerService), std::invalid_argument);
+}
@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "HoldToMoveController.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+
+using namespace example;
+using namespace std::chrono_literals;
+
+class HoldToMoveControllerTest : public ::testing::Test {
+protected:
+    HoldToMoveControllerTest()
+        : m_controller(m_timerService, 50ms, [this](SeatId seat, auto /*sessionId*/) {
+            m_expiredSeat = seat;
+            ++m_expiryCount;
+        }) {}
+
+    TimerService         m_timerService;
+    std::atomic<SeatId>  m_expiredSeat{SeatId::Driver};
+    std::atomic<int>     m_expiryCount{0};
+    HoldToMoveController m_controller;
+};
+
+TEST_F(HoldToMoveControllerTest, start_noHeartbeat_leaseExpires) {
+    m_controller.start(SeatId::CoDriver, MoveDirection::Backward);
+    EXPECT_EQ(MoveDirection::Backward, m_controller.getActiveDirection(SeatId::CoDriver));
+
+    std::this_thread::sleep_for(150ms);
+
+    EXPECT_EQ(1, m_expiryCount);
+    EXPECT_EQ(SeatId::CoDriver, m_expiredSeat);
+    EXPECT_FALSE(m_controller.getActiveDirection(SeatId::CoDriver).has_value());
+}
+
+TEST_F(HoldToMoveControllerTest, renew_heartbeatsWithinLease_sessionKeptAlive) {
+    m_controller.start(SeatId::Driver, MoveDirection::Forward);
+
+    for (int i = 0; i < 6; ++i) {
+        std::this_thread::sleep_for(20ms);
+        EXPECT_TRUE(m_controller.renew(SeatId::Driver));
+    }
+
+    EXPECT_EQ(0, m_expiryCount);
+    EXPECT_EQ(MoveDirection::Forward, m_controller.getActiveDirection(SeatId::Driver));
+
+    std::this_thread::sleep_for(150ms);
+    EXPECT_EQ(1, m_expiryCount);
+}
+
+TEST_F(HoldToMoveControllerTest, renew_noSession_returnsFalse) {
+    EXPECT_FALSE(m_controller.renew(SeatId::Driver));
+}
+
+TEST_F(HoldToMoveControllerTest, stop_runningSession_expiryNotInvoked) {
+    m_controller.start(SeatId::Driver, MoveDirection::Forward);
+
+    EXPECT_TRUE(m_controller.stop(SeatId::Driver));
+    EXPECT_FALSE(m_controller.stop(SeatId::Driver));
+
+    std::this_thread::sleep_for(100ms);
+    EXPECT_EQ(0, m_expiryCount);
+    EXPECT_FALSE(m_controller.renew(SeatId::Driver));
+}
+
+TEST(HoldToMoveControllerExpiryTest, start_afterExpiry_newSession) {
+    TimerService                                   timerService{TimerService::ManualClock{}};
+    std::optional<HoldToMoveController::SessionId> expiredSession;
+    std::optional<MoveDirection>                   directionOnExpiry{MoveDirection::Forward};
+
+    HoldToMoveController controller(timerService, 10ms, [&](SeatId seat, auto sessionId) {
+        // The session lock is not held, so the callback can query the controller
+        directionOnExpiry = controller.getActiveDirection(seat);
+        expiredSession    = sessionId;
+    });
+    controller.start(SeatId::Driver, MoveDirection::Forward);
+    timerService.advance(10ms);
+
+    ASSERT_TRUE(expiredSession.has_value());
+    EXPECT_FALSE(directionOnExpiry.has_value());
+    EXPECT_TRUE(controller.isCurrentSession(SeatId::Driver, *expiredSession));
+
+    controller.start(SeatId::Driver, MoveDirection::Backward);
+    EXPECT_FALSE(controller.isCurrentSession(SeatId::Driver, *expiredSession));
+    EXPECT_TRUE(controller.stop(SeatId::Driver));
+}
@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "IdempotencyCache.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace example;
+using namespace std::chrono_literals;
+
+TEST(IdempotencyCacheTest, find_identicalRequestWithinRetention_statusReturned) {
+    IdempotencyCache cache(1min);
+    const auto       now = TimerService::Clock::now();
+
+    cache.insert({SeatId::Driver, 7, 300, STATUS_FAIL, now});
+
+    EXPECT_EQ(STATUS_FAIL, cache.find(SeatId::Driver, 7, 300, now + 30s));
+    EXPECT_FALSE(cache.find(SeatId::Driver, 7, 400, now + 30s));
+    EXPECT_FALSE(cache.find(SeatId::CoDriver, 7, 300, now + 30s));
+    EXPECT_FALSE(cache.find(SeatId::Driver, 7, 300, now + 1min));
+}
+
+TEST(IdempotencyCacheTest, insert_cacheFull_oldestEntryReplaced) {
+    IdempotencyCache cache(1min);
+    const auto       now = TimerService::Clock::now();
+
+    const auto capacity = static_cast<int>(IdempotencyCache::CAPACITY);
+    for (int requestId = 0; requestId <= capacity; ++requestId) {
+        cache.insert({SeatId::Driver, requestId, 100, STATUS_OK, now});
+    }
+
+    EXPECT_FALSE(cache.find(SeatId::Driver, 0, 100, now));
+    EXPECT_TRUE(cache.find(SeatId::Driver, 1, 100, now));
+    const auto entries = cache.getEntries(now);
+    ASSERT_EQ(IdempotencyCache::CAPACITY, entries.size());
+    EXPECT_EQ(1, entries.front().requestId);
+    EXPECT_EQ(capacity, entries.back().requestId);
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "IdleMonitor.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+using namespace example;
+using namespace std::chrono_literals;
+
+class IdleMonitorTest : public ::testing::Test {
+protected:
+    IdleMonitorTest()
+        : m_monitor(m_timerService, 5min,
+                    [this](PowerMode mode) { m_modeChanges.push_back(mode); }) {}
+
+    TimerService           m_timerService{TimerService::ManualClock{}};
+    std::vector<PowerMode> m_modeChanges;
+    IdleMonitor            m_monitor;
+};
+
+TEST_F(IdleMonitorTest, noActivity_idleAfterTimeout) {
+    m_monitor.start();
+
+    m_timerService.advance(4min);
+    EXPECT_EQ(PowerMode::Active, m_monitor.getMode());
+
+    m_timerService.advance(1min);
+    EXPECT_EQ(PowerMode::Idle, m_monitor.getMode());
+    EXPECT_EQ((std::vector<PowerMode>{PowerMode::Idle}), m_modeChanges);
+}
+
+TEST_F(IdleMonitorTest, activity_idleTimeoutRestarted) {
+    m_monitor.start();
+
+    m_timerService.advance(4min);
+    m_monitor.onActivity();
+    m_timerService.advance(4min);
+
+    EXPECT_EQ(PowerMode::Active, m_monitor.getMode());
+    EXPECT_TRUE(m_modeChanges.empty());
+}
+
+TEST_F(IdleMonitorTest, activityWhileIdle_activeAgainAndNoWakeupsWhileIdle) {
+    m_monitor.start();
+    m_timerService.advance(5min);
+    const auto wakeupsWhenIdle = m_timerService.getWakeupCount();
+
+    m_timerService.advance(24h);
+    EXPECT_EQ(wakeupsWhenIdle, m_timerService.getWakeupCount());
+
+    m_monitor.onActivity();
+    EXPECT_EQ(PowerMode::Active, m_monitor.getMode());
+    EXPECT_EQ((std::vector<PowerMode>{PowerMode::Idle, PowerMode::Active}), m_modeChanges);
+
+    m_timerService.advance(5min);
+    EXPECT_EQ(PowerMode::Idle, m_monitor.getMode());
+}
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "LatencyHistogram.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace example::load;
+
+TEST(LatencyHistogramTest, record_valuesKeptWithSignificantDigits) {
+    LatencyHistogram histogram(3'600'000'000, 3);
+
+    histogram.record(1);
+    histogram.record(1'000);
+    histogram.record(123'456'789);
+
+    EXPECT_EQ(3U, histogram.getTotalCount());
+    EXPECT_EQ(1, histogram.getMin());
+    EXPECT_EQ(1'000, histogram.getValueAtPercentile(50.0));
+    EXPECT_NEAR(123'456'789, histogram.getMax(), 123'456'789 / 1'000);
+    EXPECT_GE(histogram.getMax(), 123'456'789);
+}
+
+TEST(LatencyHistogramTest, getValueAtPercentile_uniformValues) {
+    LatencyHistogram histogram(1'000'000, 3);
+    for (int64_t value = 1; value <= 10'000; ++value) {
+        histogram.record(value);
+    }
+
+    EXPECT_NEAR(5'000, histogram.getValueAtPercentile(50.0), 5);
+    EXPECT_NEAR(9'900, histogram.getValueAtPercentile(99.0), 10);
+    EXPECT_NEAR(9'990, histogram.getValueAtPercentile(99.9), 10);
+    EXPECT_NEAR(10'000, histogram.getValueAtPercentile(100.0), 10);
+    EXPECT_NEAR(5'000.5, histogram.getMean(), 5);
+}
+
+TEST(LatencyHistogramTest, record_valueAboveRange_clamped) {
+    LatencyHistogram histogram(1'000, 2);
+
+    histogram.record(5'000);
+
+    EXPECT_EQ(1U, histogram.getClampedCount());
+    EXPECT_GE(histogram.getMax(), 1'000);
+    EXPECT_LT(histogram.getMax(), 1'100);
+}
+
+TEST(LatencyHistogramTest, add_countsMerged) {
+    LatencyHistogram first(1'000'000, 3);
+    LatencyHistogram second(1'000'000, 3);
+    first.record(10);
+    second.record(20);
+    second.record(30);
+
+    first.add(second);
+
+    EXPECT_EQ(3U, first.getTotalCount());
+    EXPECT_EQ(30, first.getMax());
+    EXPECT_THROW(first.add(LatencyHistogram(1'000'000, 2)), std::invalid_argument);
+}
+
+TEST(LatencyHistogramTest, formatPercentileDistribution_hdrFormat) {
+    LatencyHistogram histogram(1'000'000, 3);
+    for (int64_t value = 1; value <= 100; ++value) {
+        histogram.record(value * 10);
+    }
+
+    const auto text = histogram.formatPercentileDistribution(5, 10.0);
+
+    EXPECT_EQ(0U, text.find("       Value     Percentile"));
+    EXPECT_NE(std::string::npos,
+              text.find("\n      50.000 0.500000000000         50           2.00\n"));
+    EXPECT_NE(std::string::npos, text.find("\n     100.000 1.000000000000        100\n"));
+    EXPECT_NE(std::string::npos,
+              text.find("\n#[Max     =      100.000, Total count    =          100]\n"));
+}
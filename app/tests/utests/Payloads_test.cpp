@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "Json.h"
+#include "Seat.h"
+#include "payloads/ActuatorRequest.h"
+#include "payloads/MoveSeatResponse.h"
+#include "payloads/PositionHistoryResponse.h"
+#include "payloads/PowerMetrics.h"
+#include "payloads/SetPositionRequest.h"
+#include "payloads/SetPositionResponse.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <string>
+
+using namespace example;
+using namespace example::payloads;
+
+TEST(PayloadsTest, serialize_nestedPayload_validJson) {
+    const auto text = serialize(SetPositionResponse{7, {STATUS_OK, "Set Seat position to: 300"}});
+
+    EXPECT_EQ(R"({"requestId":7,"result":{"status":0,"message":"Set Seat position to: 300"}})",
+              text);
+}
+
+TEST(PayloadsTest, serialize_optionalFields_omittedIfUnset) {
+    EXPECT_EQ(R"({"result":{"status":0,"message":""}})",
+              serialize(MoveSeatResponse{std::nullopt, {STATUS_OK, ""}}));
+    EXPECT_EQ(R"({"requestId":0})", serialize(ActuatorRequest{}));
+    EXPECT_EQ(R"({"requestId":1,"value":"WIPE"})",
+              serialize(ActuatorRequest{1, SignalValue(std::string("WIPE"))}));
+}
+
+TEST(PayloadsTest, serialize_specialValues_escaped) {
+    const std::string mode = "a \"b\"\\\n\x01";
+
+    const auto text = serialize(PowerMetrics{mode, std::numeric_limits<uint64_t>::max(),
+                                             std::numeric_limits<double>::quiet_NaN()});
+
+    const auto json = nlohmann::json::parse(text);
+    EXPECT_EQ(mode, json["mode"]);
+    EXPECT_EQ(std::numeric_limits<uint64_t>::max(), json["timerWakeups"].get<uint64_t>());
+    EXPECT_TRUE(json["wakeupsPerSecond"].is_null());
+}
+
+TEST(PayloadsTest, parse_serializedPayload_roundtrip) {
+    const PowerMetrics metrics{"idle", 42, 0.25};
+
+    PowerMetrics parsed;
+    ASSERT_FALSE(parse(serialize(metrics), parsed));
+    EXPECT_EQ(metrics.mode, parsed.mode);
+    EXPECT_EQ(metrics.timerWakeups, parsed.timerWakeups);
+    EXPECT_EQ(metrics.wakeupsPerSecond, parsed.wakeupsPerSecond);
+}
+
+TEST(PayloadsTest, parse_serializedArrays_roundtrip) {
+    PositionHistoryResponse response;
+    response.status = STATUS_OK;
+    response.points = {{1717000000000, 300}, {1717000001000, -5}, {}};
+    const auto text = serialize(response);
+    EXPECT_EQ(R"({"status":0,"points":[[1717000000000,300],[1717000001000,-5],[]]})", text);
+
+    PositionHistoryResponse parsed;
+    ASSERT_FALSE(parse(text, parsed));
+    EXPECT_EQ(response.points, parsed.points);
+
+    EXPECT_EQ("Field points has to be of type int64[][]",
+              parse(R"({"status": 0, "points": [[1, "x"]]})", parsed));
+    EXPECT_EQ("Field points has to be of type int64[][]",
+              parse(R"({"status": 0, "points": [{"a": 1}]})", parsed));
+}
+
+TEST(PayloadsTest, parse_optionalFieldsAndUnknownKeys_accepted) {
+    SetPositionRequest request;
+    ASSERT_FALSE(parse(R"({"requestId": 3, "position": null, "comment": "x"})", request));
+    EXPECT_EQ(3, request.requestId);
+    EXPECT_FALSE(request.position);
+
+    ActuatorRequest actuatorRequest;
+    ASSERT_FALSE(parse(R"({"value": 12.5})", actuatorRequest));
+    EXPECT_EQ(0, actuatorRequest.requestId);
+    EXPECT_EQ(SignalValue(12.5), actuatorRequest.value);
+}
+
+TEST(PayloadsTest, parse_unknownContainers_skipped) {
+    SetPositionResponse response;
+
+    ASSERT_FALSE(parse(R"({"extra": {"requestId": "x", "list": [[1], {"a": []}]},
+                           "requestId": 5, "tags": ["a", {"b": null}],
+                           "result": {"status": 1, "skipped": [2], "message": "m"}})",
+                       response));
+    EXPECT_EQ(5, response.requestId);
+    EXPECT_EQ(1, response.result.status);
+    EXPECT_EQ("m", response.result.message);
+}
+
+TEST(PayloadsTest, parse_invalidPayload_errorReported) {
+    SetPositionRequest request;
+
+    EXPECT_EQ("Malformed JSON", parse(R"({"requestId": )", request));
+    EXPECT_EQ("SetPositionRequest has to be an object", parse("[1]", request));
+    EXPECT_EQ("Missing field requestId", parse(R"({"position": 1})", request));
+    EXPECT_EQ("Field position has to be of type int32",
+              parse(R"({"requestId": 1, "position": "front"})", request));
+    EXPECT_EQ("Field requestId has to be of type int32",
+              parse(R"({"requestId": 4294967296})", request));
+    EXPECT_EQ("Field requestId has to be of type int32", parse(R"({"requestId": 1.5})", request));
+    EXPECT_EQ("Field requestId has to be of type int32", parse(R"({"requestId": [1]})", request));
+    EXPECT_EQ("Field position has to be of type int32",
+              parse(R"({"requestId": 1, "position": {}})", request));
+}
+
+TEST(PayloadsTest, parse_invalidNestedPayload_pathReported) {
+    SetPositionResponse response;
+
+    EXPECT_EQ("result: Missing field message",
+              parse(R"({"requestId": 1, "result": {"status": 0}})", response));
+    EXPECT_EQ("result: Field status has to be of type int32",
+              parse(R"({"requestId": 1, "result": {"status": "0", "message": ""}})", response));
+    EXPECT_EQ("result: RequestResult has to be an object",
+              parse(R"({"requestId": 1, "result": 0})", response));
+}
@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "PositionFilter.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+using namespace example;
+
+namespace {
+
+PositionFilter::Config makeConfig(PositionFilter::Mode mode, std::size_t windowSize,
+                                  int deadband) {
+    PositionFilter::Config config;
+    config.mode       = mode;
+    config.windowSize = windowSize;
+    config.deadband   = deadband;
+    return config;
+}
+
+std::vector<int> feed(PositionFilter& filter, const std::vector<int>& positions) {
+    std::vector<int> published;
+    for (const auto position : positions) {
+        if (const auto filtered = filter.update(SeatId::Driver, position)) {
+            published.push_back(*filtered);
+        }
+    }
+    return published;
+}
+
+} // namespace
+
+TEST(PositionFilterTest, median_jitterAtRest_publishedOnce) {
+    PositionFilter filter(makeConfig(PositionFilter::Mode::Median, 5, 1));
+
+    EXPECT_EQ((std::vector<int>{300}), feed(filter, {300, 301, 299, 300, 302, 300, 301, 299}));
+}
+
+TEST(PositionFilterTest, median_movement_followedWithDelay) {
+    PositionFilter filter(makeConfig(PositionFilter::Mode::Median, 3, 1));
+
+    EXPECT_EQ((std::vector<int>{300, 310, 320, 330}),
+              feed(filter, {300, 300, 300, 310, 320, 330, 330, 330}));
+}
+
+TEST(PositionFilterTest, median_settle_lastReportPublished) {
+    PositionFilter filter(makeConfig(PositionFilter::Mode::Median, 5, 1));
+    EXPECT_EQ((std::vector<int>{460, 470, 480}), feed(filter, {460, 470, 480, 490, 500}));
+
+    EXPECT_EQ(500, filter.settle(SeatId::Driver));
+    EXPECT_EQ(std::nullopt, filter.settle(SeatId::Driver));
+
+    // The window restarted from the settled position
+    EXPECT_EQ(std::nullopt, filter.update(SeatId::Driver, 501));
+}
+
+TEST(PositionFilterTest, deadband_jitterAtRest_suppressed) {
+    PositionFilter filter(makeConfig(PositionFilter::Mode::Deadband, 5, 1));
+
+    EXPECT_EQ((std::vector<int>{300}), feed(filter, {300, 301, 299, 300, 301, 300}));
+}
+
+TEST(PositionFilterTest, deadband_movement_endsAtExactPosition) {
+    PositionFilter filter(makeConfig(PositionFilter::Mode::Deadband, 5, 2));
+
+    // Once moving, steps within the deadband get through until the direction reverses
+    EXPECT_EQ((std::vector<int>{300, 305, 306, 307}), feed(filter, {300, 305, 306, 307, 306, 307}));
+    EXPECT_EQ((std::vector<int>{303, 302}), feed(filter, {303, 302, 303}));
+}
+
+TEST(PositionFilterTest, reset_nextPositionPublishedUnfiltered) {
+    PositionFilter filter(makeConfig(PositionFilter::Mode::Deadband, 5, 5));
+    feed(filter, {300});
+    EXPECT_EQ(std::nullopt, filter.update(SeatId::Driver, 302));
+
+    filter.reset(SeatId::Driver);
+    EXPECT_EQ(302, filter.update(SeatId::Driver, 302));
+}
+
+TEST(PositionFilterTest, seats_filteredIndependently) {
+    PositionFilter filter(makeConfig(PositionFilter::Mode::Deadband, 5, 1));
+
+    EXPECT_EQ(300, filter.update(SeatId::Driver, 300));
+    EXPECT_EQ(301, filter.update(SeatId::CoDriver, 301));
+    EXPECT_EQ(std::nullopt, filter.update(SeatId::Driver, 301));
+}
+
+TEST(PositionFilterTest, parseConfig_specification_parsed) {
+    const auto median = PositionFilter::parseConfig("median:7");
+    EXPECT_EQ(PositionFilter::Mode::Median, median.mode);
+    EXPECT_EQ(7U, median.windowSize);
+    EXPECT_EQ(std::chrono::milliseconds(500), median.settleTime);
+    EXPECT_EQ(std::chrono::milliseconds(200),
+              PositionFilter::parseConfig("median:3:200").settleTime);
+
+    const auto deadband = PositionFilter::parseConfig("deadband:3");
+    EXPECT_EQ(PositionFilter::Mode::Deadband, deadband.mode);
+    EXPECT_EQ(3, deadband.deadband);
+
+    EXPECT_THROW(PositionFilter::parseConfig("mean:3"), std::invalid_argument);
+    EXPECT_THROW(PositionFilter::parseConfig("median:"), std::invalid_argument);
+    EXPECT_THROW(PositionFilter::parseConfig("median:3:"), std::invalid_argument);
+    EXPECT_THROW(PositionFilter::parseConfig("deadband:-1"), std::invalid_argument);
+}
+
+TEST(PositionFilterTest, construction_invalidWindow_throws) {
+    EXPECT_THROW(PositionFilter(makeConfig(PositionFilter::Mode::Median, 4, 1)),
+                 std::invalid_argument);
+    EXPECT_THROW(PositionFilter(makeConfig(PositionFilter::Mode::Median,
+                                           PositionFilter::MAX_WINDOW_SIZE + 2, 1)),
+                 std::invalid_argument);
+    EXPECT_THROW(PositionFilter(makeConfig(PositionFilter::Mode::Deadband, 5, 0)),
+                 std::invalid_argument);
+}
@@ -0,0 +1,268 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "PositionHistory.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace example;
+
+namespace {
+
+constexpr int64_t START     = 1699999980000; // a full minute
+constexpr int64_t MINUTE    = 60 * 1000;
+constexpr int64_t HOUR      = 60 * MINUTE;
+constexpr int64_t UNLIMITED = std::numeric_limits<int64_t>::max();
+
+} // namespace
+
+class PositionHistoryTest : public ::testing::Test {
+protected:
+    PositionHistoryTest()
+        : m_path("/tmp/seatadjuster_history_test_" + std::to_string(getpid()) + ".bin") {}
+
+    ~PositionHistoryTest() override { ::unlink(m_path.c_str()); }
+
+    PositionHistory::Config makeConfig(uint32_t rawBlocks = 16) const {
+        PositionHistory::Config config;
+        config.path        = m_path;
+        config.blockCounts = {rawBlocks, 8, 4};
+        return config;
+    }
+
+    static std::vector<int> getPositions(const std::vector<PositionHistory::Point>& points) {
+        std::vector<int> positions;
+        for (const auto& point : points) {
+            positions.push_back(point.last);
+        }
+        return positions;
+    }
+
+    const std::string m_path;
+};
+
+TEST_F(PositionHistoryTest, append_queriedInOrder) {
+    PositionHistory history(makeConfig());
+    history.append(SeatId::Driver, START, 300);
+    history.append(SeatId::CoDriver, START + 5, 700);
+    history.append(SeatId::Driver, START + 10, 310);
+    history.append(SeatId::Driver, START + 1000, 290);
+
+    const auto points = history.query(SeatId::Driver, START, UNLIMITED, HistoryResolution::Raw);
+    ASSERT_EQ(3U, points.size());
+    EXPECT_EQ(START + 10, points[1].timestamp);
+    EXPECT_EQ((std::vector<int>{300, 310, 290}), getPositions(points));
+    EXPECT_EQ(1U, points[0].count);
+
+    EXPECT_EQ((std::vector<int>{310}),
+              getPositions(history.query(SeatId::Driver, START + 1, START + 999,
+                                         HistoryResolution::Raw)));
+    EXPECT_EQ((std::vector<int>{700}), getPositions(history.query(SeatId::CoDriver, 0, UNLIMITED,
+                                                                   HistoryResolution::Raw)));
+}
+
+TEST_F(PositionHistoryTest, regularReports_compressed) {
+    PositionHistory history(makeConfig(64));
+    for (int index = 0; index < 10000; ++index) {
+        history.append(SeatId::Driver, START + index * 1000, 300 + index % 2);
+    }
+
+    // About a byte per point instead of 12 for timestamp and position
+    EXPECT_LE(history.getUsedBlockCount(HistoryResolution::Raw), 12U);
+    const auto points = history.query(SeatId::Driver, 0, UNLIMITED, HistoryResolution::Raw);
+    ASSERT_EQ(10000U, points.size());
+    EXPECT_EQ(START + 9999 * 1000, points.back().timestamp);
+    EXPECT_EQ(301, points.back().last);
+}
+
+TEST_F(PositionHistoryTest, extremeValues_roundTrip) {
+    const std::vector<std::pair<int64_t, int>> reports{
+        {START, 0},
+        {START, std::numeric_limits<int>::max()},
+        {START + 1, std::numeric_limits<int>::min()},
+        {START + 40LL * 24 * HOUR, 1000},
+        {START + 40LL * 24 * HOUR + 3, -1000},
+        {START + 400LL * 24 * HOUR, 7},
+    };
+
+    std::vector<int> expected;
+    {
+        PositionHistory history(makeConfig());
+        for (const auto& [timestamp, position] : reports) {
+            history.append(SeatId::Driver, timestamp, position);
+            expected.push_back(position);
+        }
+    }
+
+    PositionHistory history(makeConfig());
+    const auto      points = history.query(SeatId::Driver, 0, UNLIMITED, HistoryResolution::Raw);
+    ASSERT_EQ(reports.size(), points.size());
+    for (std::size_t index = 0; index < reports.size(); ++index) {
+        EXPECT_EQ(reports[index].first, points[index].timestamp);
+    }
+    EXPECT_EQ(expected, getPositions(points));
+}
+
+TEST_F(PositionHistoryTest, buckets_aggregateReports) {
+    PositionHistory history(makeConfig());
+    history.append(SeatId::Driver, START + 1000, 300);
+    history.append(SeatId::Driver, START + 2000, 250);
+    history.append(SeatId::Driver, START + 3000, 280);
+    history.append(SeatId::Driver, START + MINUTE + 1000, 400);
+
+    const auto minutes = history.query(SeatId::Driver, 0, UNLIMITED, HistoryResolution::Minute);
+    ASSERT_EQ(2U, minutes.size());
+    EXPECT_EQ(START, minutes[0].timestamp);
+    EXPECT_EQ(250, minutes[0].min);
+    EXPECT_EQ(300, minutes[0].max);
+    EXPECT_EQ(280, minutes[0].last);
+    EXPECT_EQ(3U, minutes[0].count);
+    // The bucket still being filled is included
+    EXPECT_EQ(400, minutes[1].last);
+    EXPECT_EQ(1U, minutes[1].count);
+
+    const auto hours = history.query(SeatId::Driver, 0, UNLIMITED, HistoryResolution::Hour);
+    ASSERT_EQ(1U, hours.size());
+    EXPECT_EQ(START - START % HOUR, hours[0].timestamp);
+    EXPECT_EQ(250, hours[0].min);
+    EXPECT_EQ(400, hours[0].max);
+    EXPECT_EQ(400, hours[0].last);
+    EXPECT_EQ(4U, hours[0].count);
+
+    // A range within a bucket returns the overlapping bucket
+    EXPECT_EQ(1U, history.query(SeatId::Driver, START + 1500, START + 1600,
+                                HistoryResolution::Minute)
+                      .size());
+}
+
+TEST_F(PositionHistoryTest, rawRingWrapped_olderRangeServedByBuckets) {
+    PositionHistory history(makeConfig(4));
+    for (int index = 0; index < 20000; ++index) {
+        history.append(SeatId::Driver, START + index * 1000, 300 + (index * 37) % 200);
+    }
+
+    EXPECT_EQ(4U, history.getUsedBlockCount(HistoryResolution::Raw));
+    const auto raw = history.query(SeatId::Driver, 0, UNLIMITED, HistoryResolution::Raw);
+    EXPECT_LT(raw.size(), 20000U);
+    EXPECT_EQ(START + 19999 * 1000, raw.back().timestamp);
+
+    EXPECT_EQ(HistoryResolution::Minute,
+              history.selectResolution(SeatId::Driver, START, UNLIMITED, 100000));
+    EXPECT_EQ(HistoryResolution::Raw,
+              history.selectResolution(SeatId::Driver, raw.back().timestamp - 10000, UNLIMITED,
+                                       100000));
+    EXPECT_EQ(HistoryResolution::Hour,
+              history.selectResolution(SeatId::Driver, START, UNLIMITED, 10));
+
+    const auto aggregate = PositionHistory::aggregate(
+        history.query(SeatId::Driver, START, UNLIMITED, HistoryResolution::Minute));
+    ASSERT_TRUE(aggregate);
+    EXPECT_EQ(20000U, aggregate->count);
+    EXPECT_EQ(300, aggregate->min);
+    EXPECT_EQ(499, aggregate->max);
+}
+
+TEST_F(PositionHistoryTest, reopen_continuesHistory) {
+    {
+        PositionHistory history(makeConfig());
+        history.append(SeatId::Driver, START, 300);
+        history.append(SeatId::Driver, START + 1000, 310);
+    }
+    {
+        PositionHistory history(makeConfig());
+        history.append(SeatId::Driver, START + 2000, 320);
+    }
+
+    PositionHistory history(makeConfig());
+    EXPECT_EQ((std::vector<int>{300, 310, 320}),
+              getPositions(history.query(SeatId::Driver, 0, UNLIMITED, HistoryResolution::Raw)));
+    // Open buckets are written on destruction, so the minute holds all three reports
+    const auto aggregate = PositionHistory::aggregate(
+        history.query(SeatId::Driver, 0, UNLIMITED, HistoryResolution::Minute));
+    ASSERT_TRUE(aggregate);
+    EXPECT_EQ(3U, aggregate->count);
+}
+
+TEST_F(PositionHistoryTest, otherLayout_fileReset) {
+    {
+        PositionHistory history(makeConfig());
+        history.append(SeatId::Driver, START, 300);
+    }
+
+    PositionHistory history(makeConfig(32));
+    EXPECT_TRUE(history.query(SeatId::Driver, 0, UNLIMITED, HistoryResolution::Raw).empty());
+    EXPECT_EQ(0U, history.getUsedBlockCount(HistoryResolution::Raw));
+}
+
+TEST_F(PositionHistoryTest, corruptHeader_fileReset) {
+    {
+        PositionHistory history(makeConfig());
+        history.append(SeatId::Driver, START, 300);
+    }
+    {
+        std::fstream file(m_path, std::ios::in | std::ios::out | std::ios::binary);
+        file.write("garbage", 7);
+    }
+
+    PositionHistory history(makeConfig());
+    EXPECT_TRUE(history.query(SeatId::Driver, 0, UNLIMITED, HistoryResolution::Raw).empty());
+}
+
+TEST_F(PositionHistoryTest, clockSetBack_timestampClamped) {
+    PositionHistory history(makeConfig());
+    history.append(SeatId::Driver, START + 5000, 300);
+    history.append(SeatId::Driver, START, 310);
+
+    const auto points = history.query(SeatId::Driver, 0, UNLIMITED, HistoryResolution::Raw);
+    ASSERT_EQ(2U, points.size());
+    EXPECT_EQ(START + 5000, points[1].timestamp);
+}
+
+TEST_F(PositionHistoryTest, construction_tooFewBlocks_throws) {
+    EXPECT_THROW(PositionHistory(makeConfig(1)), std::invalid_argument);
+
+    auto config = makeConfig();
+    config.path = "/nonexistent/history.bin";
+    EXPECT_THROW(PositionHistory{config}, std::system_error);
+}
+
+TEST(PositionHistoryAggregateTest, aggregate_combinesBuckets) {
+    EXPECT_FALSE(PositionHistory::aggregate({}));
+
+    const auto aggregate = PositionHistory::aggregate({
+        {0, 250, 300, 280, 3},
+        {MINUTE, 200, 260, 260, 2},
+    });
+    ASSERT_TRUE(aggregate);
+    EXPECT_EQ(200, aggregate->min);
+    EXPECT_EQ(300, aggregate->max);
+    EXPECT_EQ(260, aggregate->last);
+    EXPECT_EQ(5U, aggregate->count);
+}
+
+TEST(PositionHistoryAggregateTest, resolutionNames_parsed) {
+    EXPECT_EQ(HistoryResolution::Minute, parseHistoryResolution("minute"));
+    EXPECT_STREQ("hour", toString(HistoryResolution::Hour));
+    EXPECT_FALSE(parseHistoryResolution("day"));
+}
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "ProfiledMutex.h"
+#include "Json.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#ifdef APP_ENABLE_LOCK_PROFILING
+#endif
+
+using namespace example;
+using namespace std::chrono_literals;
+
+TEST(ProfiledMutexTest, tryLock_lockedByOtherThread_fails) {
+    ProfiledMutex                  mutex("ProfiledMutexTest.tryLock");
+    std::lock_guard<ProfiledMutex> lock(mutex);
+
+    bool acquired = true;
+    std::thread([&]() { acquired = mutex.try_lock(); }).join();
+
+    EXPECT_FALSE(acquired);
+}
+
+TEST(ProfiledMutexTest, conditionVariable_waitFor_wokenByNotify) {
+    ProfiledMutex             mutex("ProfiledMutexTest.condition");
+    ProfiledConditionVariable condition;
+    bool                      ready = false;
+
+    std::thread notifier([&]() {
+        std::this_thread::sleep_for(10ms);
+        {
+            std::lock_guard<ProfiledMutex> lock(mutex);
+            ready = true;
+        }
+        condition.notify_one();
+    });
+
+    std::unique_lock<ProfiledMutex> lock(mutex);
+    const auto                      deadline = std::chrono::steady_clock::now() + 1s;
+    while (!ready && condition.wait_until(lock, deadline) == std::cv_status::no_timeout) {
+    }
+    EXPECT_TRUE(ready);
+    EXPECT_TRUE(lock.owns_lock());
+
+    lock.unlock();
+    notifier.join();
+}
+
+#ifdef APP_ENABLE_LOCK_PROFILING
+TEST(ProfiledMutexTest, lock_heldByOtherThread_contentionRecorded) {
+    ProfiledMutex mutex("ProfiledMutexTest.contention");
+
+    std::unique_lock<ProfiledMutex> lock(mutex);
+    std::thread                     waiter([&mutex]() {
+        std::lock_guard<ProfiledMutex> waiterLock(mutex);
+    });
+    std::this_thread::sleep_for(20ms);
+    lock.unlock();
+    waiter.join();
+
+    const auto profile = getLockProfile()["ProfiledMutexTest.contention"];
+    EXPECT_EQ(2, profile["acquisitions"]);
+    EXPECT_EQ(1, profile["contentions"]);
+    EXPECT_GE(profile["waitTime"]["maxNs"].get<uint64_t>(), 10'000'000U);
+    EXPECT_GE(profile["holdTime"]["totalNs"].get<uint64_t>(), 20'000'000U);
+}
+#endif
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "ResponseBatcher.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace example;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Publication = std::pair<std::string, std::string>;
+
+ResponseBatcher::Config makeConfig(std::size_t maxEntries) {
+    ResponseBatcher::Config config;
+    config.window     = 20ms;
+    config.maxEntries = maxEntries;
+    return config;
+}
+
+} // namespace
+
+class ResponseBatcherTest : public ::testing::Test {
+protected:
+    ResponseBatcher::PublishCallback recorder() {
+        return [this](const std::string& topic, const std::string& payload) {
+            m_published.emplace_back(topic, payload);
+        };
+    }
+
+    TimerService             m_timerService{TimerService::ManualClock{}};
+    std::vector<Publication> m_published;
+};
+
+TEST_F(ResponseBatcherTest, add_batchFull_publishedRightAway) {
+    ResponseBatcher batcher(makeConfig(3), m_timerService, recorder());
+
+    batcher.add("t", R"({"id":1})");
+    batcher.add("t", R"({"id":2})");
+    EXPECT_TRUE(m_published.empty());
+    batcher.add("t", R"({"id":3})");
+
+    EXPECT_EQ((std::vector<Publication>{{"t", R"([{"id":1},{"id":2},{"id":3}])"}}), m_published);
+
+    m_timerService.advance(1s);
+    EXPECT_EQ(1U, m_published.size());
+}
+
+TEST_F(ResponseBatcherTest, add_windowElapsed_partialBatchPublished) {
+    ResponseBatcher batcher(makeConfig(10), m_timerService, recorder());
+
+    batcher.add("t", R"({"id":1})");
+    m_timerService.advance(10ms);
+    batcher.add("t", R"({"id":2})");
+    m_timerService.advance(9ms);
+    EXPECT_TRUE(m_published.empty());
+
+    m_timerService.advance(1ms);
+    EXPECT_EQ((std::vector<Publication>{{"t", R"([{"id":1},{"id":2}])"}}), m_published);
+}
+
+TEST_F(ResponseBatcherTest, add_differentTopics_batchedSeparately) {
+    ResponseBatcher batcher(makeConfig(2), m_timerService, recorder());
+
+    batcher.add("a", R"({"id":1})");
+    batcher.add("b", R"({"id":2})");
+    batcher.add("a", R"({"id":3})");
+    m_timerService.advance(20ms);
+
+    EXPECT_EQ((std::vector<Publication>{{"a", R"([{"id":1},{"id":3}])"}, {"b", R"([{"id":2}])"}}),
+              m_published);
+}
+
+TEST_F(ResponseBatcherTest, add_afterFullBatch_nextBatchGetsOwnWindow) {
+    ResponseBatcher batcher(makeConfig(2), m_timerService, recorder());
+
+    batcher.add("t", R"({"id":1})");
+    batcher.add("t", R"({"id":2})");
+    m_timerService.advance(10ms);
+    batcher.add("t", R"({"id":3})");
+    m_timerService.advance(10ms);
+    EXPECT_EQ(1U, m_published.size());
+
+    m_timerService.advance(10ms);
+    ASSERT_EQ(2U, m_published.size());
+    EXPECT_EQ(R"([{"id":3}])", m_published[1].second);
+}
+
+TEST_F(ResponseBatcherTest, construction_invalidConfig_throws) {
+    EXPECT_THROW(ResponseBatcher(makeConfig(0), m_timerService, recorder()),
+                 std::invalid_argument);
+
+    auto config   = makeConfig(10);
+    config.window = 0ms;
+    EXPECT_THROW(ResponseBatcher(config, m_timerService, recorder()), std::invalid_argument);
+}
@@ -0,0 +1,635 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "SeatAdjuster.h"
+#include "Json.h"
+#include "WorkStealingScheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace example;
+using namespace std::chrono_literals;
+
+namespace {
+
+class FakeBackend : public ISeatAdjusterBackend {
+public:
+    double getVehicleSpeed() override { return speed; }
+
+    void setSeatPosition(SeatId seat, int position) override {
+        targets.emplace_back(seat, position);
+    }
+
+    void setActuatorValue(const std::string& signal, const SignalValue& value) override {
+        actuatorValues.emplace_back(signal, value);
+        if (onActuatorWrite) {
+            std::exchange(onActuatorWrite, nullptr)();
+        }
+    }
+
+    void publish(const std::string& topic, const std::string& payload) override {
+        messages.emplace_back(topic, nlohmann::json::parse(payload));
+    }
+
+    void runForSeat(SeatId /*seat*/, std::function<void()> task) override {
+        runForActuators(std::move(task));
+    }
+
+    void runForActuators(std::function<void()> task) override {
+        if (isDeferringTasks) {
+            deferredTasks.push_back(std::move(task));
+        } else {
+            task();
+        }
+    }
+
+    void runDeferredTasks() {
+        for (auto& task : std::exchange(deferredTasks, {})) {
+            task();
+        }
+    }
+
+    double                                              speed{0.0};
+    std::vector<std::pair<SeatId, int>>                 targets;
+    std::vector<std::pair<std::string, SignalValue>>    actuatorValues;
+    std::vector<std::pair<std::string, nlohmann::json>> messages;
+    std::function<void()>                               onActuatorWrite; // run once
+    bool                                                isDeferringTasks{false};
+    std::vector<std::function<void()>>                  deferredTasks;
+};
+
+// Runs the tasks of each seat on an executor of its own, the driver seat blocks until released
+class ExecutorBackend : public ISeatAdjusterBackend {
+public:
+    ExecutorBackend() {
+        for (auto& executor : m_executors) {
+            executor = std::make_unique<SerialExecutor>(m_scheduler);
+        }
+    }
+
+    double getVehicleSpeed() override { return 0.0; }
+
+    void setSeatPosition(SeatId seat, int position) override {
+        if (seat == SeatId::Driver) {
+            driverReleased.wait();
+        } else {
+            coDriverMoved.set_value(position);
+        }
+    }
+
+    void setActuatorValue(const std::string& /*signal*/, const SignalValue& /*value*/) override {}
+    void publish(const std::string& /*topic*/, const std::string& /*payload*/) override {}
+
+    void runForSeat(SeatId seat, std::function<void()> task) override {
+        m_executors[toIndex(seat)]->submit(std::move(task));
+    }
+
+    // Wait for the tasks submitted so far, before the SeatAdjuster goes away
+    void drain() {
+        for (auto& executor : m_executors) {
+            std::promise<void> isDrained;
+            executor->submit([&isDrained]() { isDrained.set_value(); });
+            isDrained.get_future().wait();
+        }
+    }
+
+    std::shared_future<void> driverReleased;
+    std::promise<int>        coDriverMoved;
+
+private:
+    // The scheduler finishes the running tasks before the executors go away
+    std::array<std::unique_ptr<SerialExecutor>, SEAT_COUNT> m_executors;
+    WorkStealingScheduler                                   m_scheduler{SEAT_COUNT};
+};
+
+} // namespace
+
+class SeatAdjusterTest : public ::testing::Test {
+protected:
+    std::size_t countMessages(const std::string& topic) const {
+        std::size_t count = 0;
+        for (const auto& [messageTopic, payload] : m_backend.messages) {
+            count += messageTopic == topic ? 1 : 0;
+        }
+        return count;
+    }
+
+    FakeBackend  m_backend;
+    TimerService m_timerService{TimerService::ManualClock{}};
+    SeatAdjuster m_seatAdjuster{m_backend, m_timerService};
+};
+
+TEST_F(SeatAdjusterTest, setPositionRequest_vehicleStanding_seatMoved) {
+    m_seatAdjuster.onSetPositionRequestReceived(SeatId::CoDriver,
+                                                R"({"requestId": 7, "position": 300})");
+
+    ASSERT_EQ(1U, m_backend.targets.size());
+    EXPECT_EQ(std::make_pair(SeatId::CoDriver, 300), m_backend.targets[0]);
+    ASSERT_EQ(1U, m_backend.messages.size());
+    EXPECT_EQ(TOPIC_CoDriver_RESPONSE, m_backend.messages[0].first);
+    EXPECT_EQ(7, m_backend.messages[0].second["requestId"]);
+    EXPECT_EQ(STATUS_OK, m_backend.messages[0].second["result"]["status"]);
+}
+
+TEST_F(SeatAdjusterTest, setPositionRequest_vehicleMoving_rejected) {
+    m_backend.speed = 30.0;
+
+    m_seatAdjuster.onSetPositionRequestReceived(SeatId::Driver,
+                                                R"({"requestId": 1, "position": 300})");
+
+    EXPECT_TRUE(m_backend.targets.empty());
+    ASSERT_EQ(1U, m_backend.messages.size());
+    EXPECT_EQ(STATUS_FAIL, m_backend.messages[0].second["result"]["status"]);
+}
+
+TEST_F(SeatAdjusterTest, setPositionRequest_invalidPayload_rejected) {
+    m_seatAdjuster.onSetPositionRequestReceived(SeatId::Driver, R"({"position": 300})");
+    m_seatAdjuster.onSetPositionRequestReceived(SeatId::Driver,
+                                                R"({"requestId": 2, "position": "front"})");
+    m_seatAdjuster.onSetPositionRequestReceived(SeatId::Driver, R"({"requestId": 3})");
+
+    EXPECT_TRUE(m_backend.targets.empty());
+    ASSERT_EQ(3U, m_backend.messages.size());
+    EXPECT_EQ("Invalid request: Missing field requestId",
+              m_backend.messages[0].second.value("message", ""));
+    EXPECT_EQ(STATUS_FAIL, m_backend.messages[1].second["status"]);
+    EXPECT_EQ(3, m_backend.messages[2].second["requestId"]);
+    EXPECT_EQ("No position specified", m_backend.messages[2].second.value("message", ""));
+}
+
+TEST_F(SeatAdjusterTest, clientFairness_rateExceeded_onlyThatClientRejected) {
+    FairRequestQueue::Config config;
+    config.rate  = 1.0;
+    config.burst = 1.0;
+    m_seatAdjuster.enableClientFairness(config);
+    m_backend.isDeferringTasks = true;
+
+    m_seatAdjuster.onSetPositionRequestReceived(
+        SeatId::Driver, R"({"requestId": 1, "position": 100, "clientId": "abuser"})");
+    m_seatAdjuster.onSetPositionRequestReceived(
+        SeatId::Driver, R"({"requestId": 2, "position": 200, "clientId": "abuser"})");
+    m_seatAdjuster.onSetPositionRequestReceived(
+        SeatId::Driver, R"({"requestId": 3, "position": 300, "clientId": "other"})");
+
+    ASSERT_EQ(1U, m_backend.messages.size());
+    EXPECT_EQ(2, m_backend.messages[0].second["requestId"]);
+    EXPECT_EQ(STATUS_FAIL, m_backend.messages[0].second["status"]);
+    EXPECT_TRUE(m_backend.targets.empty());
+
+    m_backend.runDeferredTasks();
+    ASSERT_EQ(2U, m_backend.targets.size());
+    EXPECT_EQ(std::make_pair(SeatId::Driver, 100), m_backend.targets[0]);
+    EXPECT_EQ(std::make_pair(SeatId::Driver, 300), m_backend.targets[1]);
+}
+
+TEST_F(SeatAdjusterTest, clientFairness_limitsPerSeat) {
+    FairRequestQueue::Config config;
+    config.rate  = 1.0;
+    config.burst = 1.0;
+    m_seatAdjuster.enableClientFairness(config);
+
+    m_seatAdjuster.onSetPositionRequestReceived(
+        SeatId::Driver, R"({"requestId": 1, "position": 100, "clientId": "fleet"})");
+    m_seatAdjuster.onSetPositionRequestReceived(
+        SeatId::CoDriver, R"({"requestId": 1, "position": 200, "clientId": "fleet"})");
+
+    EXPECT_EQ(2U, m_backend.targets.size());
+}
+
+TEST(SeatAdjusterExecutorTest, clientFairness_seatBlocked_otherSeatServed) {
+    TimerService       timerService{TimerService::ManualClock{}};
+    ExecutorBackend    backend;
+    std::promise<void> releaseDriver;
+    backend.driverReleased = releaseDriver.get_future().share();
+    SeatAdjuster seatAdjuster{backend, timerService};
+    seatAdjuster.enableClientFairness(FairRequestQueue::Config{});
+
+    seatAdjuster.onSetPositionRequestReceived(
+        SeatId::Driver, R"({"requestId": 1, "position": 100, "clientId": "fleet"})");
+    seatAdjuster.onSetPositionRequestReceived(
+        SeatId::CoDriver, R"({"requestId": 2, "position": 200, "clientId": "fleet"})");
+
+    auto coDriverMoved = backend.coDriverMoved.get_future();
+    const auto status  = coDriverMoved.wait_for(5s);
+    releaseDriver.set_value();
+    backend.drain();
+    ASSERT_EQ(std::future_status::ready, status);
+    EXPECT_EQ(200, coDriverMoved.get());
+}
+
+TEST_F(SeatAdjusterTest, responseBatching_requested_responsesPublishedAsArray) {
+    m_seatAdjuster.enableResponseBatching({20ms, 10});
+
+    m_seatAdjuster.onSetPositionRequestReceived(
+        SeatId::Driver, R"({"requestId": 1, "position": 100, "clientId": "fleet",
+                            "correlationId": "a", "batchResponse": true})");
+    m_seatAdjuster.onSetPositionRequestReceived(
+        SeatId::CoDriver, R"({"requestId": 1, "clientId": "fleet", "correlationId": "b",
+                              "batchResponse": true})");
+    m_seatAdjuster.onSetPositionRequestReceived(
+        SeatId::Driver, R"({"requestId": 2, "position": 200, "clientId": "fleet"})");
+    EXPECT_EQ(1U, m_backend.messages.size());
+    EXPECT_EQ(1U, countMessages(TOPIC_Driver_RESPONSE));
+
+    m_timerService.advance(20ms);
+    ASSERT_EQ(2U, m_backend.messages.size());
+    const auto& [topic, batch] = m_backend.messages[1];
+    EXPECT_EQ(std::string(TOPIC_BATCHED_RESPONSES_PREFIX) + "fleet", topic);
+    ASSERT_TRUE(batch.is_array());
+    ASSERT_EQ(2U, batch.size());
+    EXPECT_EQ("a", batch[0]["correlationId"]);
+    EXPECT_EQ(STATUS_OK, batch[0]["result"]["status"]);
+    EXPECT_EQ("b", batch[1]["correlationId"]);
+    EXPECT_EQ(STATUS_FAIL, batch[1]["status"]);
+}
+
+TEST_F(SeatAdjusterTest, positionFilter_jitter_notPublished) {
+    m_seatAdjuster.enablePositionFilter(
+        std::make_unique<PositionFilter>(PositionFilter::parseConfig("deadband:1")));
+
+    EXPECT_TRUE(m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 300));
+    EXPECT_FALSE(m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 301));
+    EXPECT_FALSE(m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 299));
+    EXPECT_TRUE(m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 310));
+
+    EXPECT_EQ(2U, countMessages(TOPIC_CURRENT_Driver_POSITION));
+    EXPECT_EQ(310, m_seatAdjuster.getCurrentPosition(SeatId::Driver));
+}
+
+TEST_F(SeatAdjusterTest, positionFilter_medianAfterMovement_settledToLastReport) {
+    m_seatAdjuster.enablePositionFilter(
+        std::make_unique<PositionFilter>(PositionFilter::parseConfig("median:5:500")));
+
+    for (int position = 460; position <= 500; position += 10) {
+        m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, position);
+        m_timerService.advance(std::chrono::milliseconds(100));
+    }
+    EXPECT_EQ(480, m_seatAdjuster.getCurrentPosition(SeatId::Driver));
+
+    m_timerService.advance(std::chrono::milliseconds(300));
+    EXPECT_EQ(480, m_seatAdjuster.getCurrentPosition(SeatId::Driver));
+    m_timerService.advance(std::chrono::milliseconds(100));
+    EXPECT_EQ(500, m_seatAdjuster.getCurrentPosition(SeatId::Driver));
+    EXPECT_EQ(500, m_backend.messages.back().second["position"]);
+}
+
+TEST_F(SeatAdjusterTest, positionChanged_sequenceIncreasedPerSeat) {
+    m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 100);
+    m_seatAdjuster.onSeatPositionChanged(SeatId::CoDriver, 50);
+    m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 200);
+    m_seatAdjuster.onSeatPositionUnavailable(SeatId::Driver, "sensor failure");
+
+    ASSERT_EQ(4U, m_backend.messages.size());
+    EXPECT_EQ(1U, m_backend.messages[0].second["sequence"]);
+    EXPECT_EQ(1U, m_backend.messages[1].second["sequence"]);
+    EXPECT_EQ(2U, m_backend.messages[2].second["sequence"]);
+    EXPECT_EQ(TOPIC_CURRENT_Driver_POSITION, m_backend.messages[3].first);
+    EXPECT_EQ(3U, m_backend.messages[3].second["sequence"]);
+    for (const auto& [topic, payload] : m_backend.messages) {
+        EXPECT_EQ(m_backend.messages[0].second["epoch"], payload["epoch"]);
+    }
+}
+
+TEST_F(SeatAdjusterTest, positionResyncRequest_lastPublishedPositionReturned) {
+    m_seatAdjuster.onPositionResyncRequestReceived(SeatId::Driver, R"({"requestId": 1})");
+    m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 100);
+    m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 200);
+    m_seatAdjuster.onPositionResyncRequestReceived(SeatId::Driver, R"({"requestId": 2})");
+    m_seatAdjuster.onPositionResyncRequestReceived(SeatId::Driver, "no json");
+
+    ASSERT_EQ(5U, m_backend.messages.size());
+    EXPECT_EQ(TOPIC_Driver_RESYNC_RESPONSE, m_backend.messages[0].first);
+    EXPECT_EQ(0U, m_backend.messages[0].second["sequence"]);
+    EXPECT_FALSE(m_backend.messages[0].second.contains("position"));
+    EXPECT_EQ(TOPIC_Driver_RESYNC_RESPONSE, m_backend.messages[3].first);
+    EXPECT_EQ(2, m_backend.messages[3].second["requestId"]);
+    EXPECT_EQ(2U, m_backend.messages[3].second["sequence"]);
+    EXPECT_EQ(200, m_backend.messages[3].second["position"]);
+    EXPECT_FALSE(m_backend.messages[4].second.contains("requestId"));
+    EXPECT_EQ(2U, m_backend.messages[4].second["sequence"]);
+    EXPECT_EQ(m_backend.messages[1].second["epoch"], m_backend.messages[3].second["epoch"]);
+}
+
+TEST_F(SeatAdjusterTest, positionChanged_newInstance_newEpoch) {
+    m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 100);
+    {
+        // A standby taking over restarts the sequence
+        SeatAdjuster takeover(m_backend, m_timerService);
+        takeover.onSeatPositionChanged(SeatId::Driver, 100);
+    }
+
+    ASSERT_EQ(2U, m_backend.messages.size());
+    EXPECT_EQ(1U, m_backend.messages[1].second["sequence"]);
+    EXPECT_NE(m_backend.messages[0].second["epoch"], m_backend.messages[1].second["epoch"]);
+}
+
+TEST_F(SeatAdjusterTest, positionHistoryRequest_recordedPositionsReturned) {
+    m_seatAdjuster.onPositionHistoryRequestReceived(SeatId::Driver, R"({"requestId": 1})");
+    EXPECT_EQ(STATUS_FAIL, m_backend.messages.back().second["status"]);
+
+    const auto historyPath =
+        "/tmp/seatadjuster_history_request_test_" + std::to_string(getpid()) + ".bin";
+    PositionHistory::Config config;
+    config.path = historyPath;
+    m_seatAdjuster.enablePositionHistory(std::make_unique<PositionHistory>(config));
+    m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 100);
+    m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 200);
+    m_seatAdjuster.onSeatPositionChanged(SeatId::CoDriver, 50);
+
+    m_seatAdjuster.onPositionHistoryRequestReceived(SeatId::Driver, R"({"requestId": 2})");
+    const auto& raw = m_backend.messages.back();
+    EXPECT_EQ(TOPIC_Driver_HISTORY_RESPONSE, raw.first);
+    EXPECT_EQ(2, raw.second["requestId"]);
+    EXPECT_EQ("raw", raw.second["resolution"]);
+    ASSERT_EQ(2U, raw.second["points"].size());
+    EXPECT_EQ(200, raw.second["points"][1][1]);
+
+    m_seatAdjuster.onPositionHistoryRequestReceived(
+        SeatId::Driver, R"({"requestId": 3, "resolution": "hour", "aggregate": true})");
+    const auto& aggregate = m_backend.messages.back().second;
+    EXPECT_EQ("hour", aggregate["resolution"]);
+    EXPECT_EQ(2U, aggregate["count"]);
+    EXPECT_EQ(100, aggregate["min"]);
+    EXPECT_EQ(200, aggregate["last"]);
+
+    m_seatAdjuster.onPositionHistoryRequestReceived(
+        SeatId::Driver, R"({"requestId": 4, "resolution": "day"})");
+    EXPECT_EQ(STATUS_FAIL, m_backend.messages.back().second["status"]);
+
+    ::unlink(historyPath.c_str());
+}
+
+TEST_F(SeatAdjusterTest, moveRequest_noHeartbeat_seatStoppedAtLastPosition) {
+    m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 500);
+    m_seatAdjuster.onMoveSeatRequestReceived(
+        SeatId::Driver, R"({"requestId": 1, "action": "start", "direction": "forward"})");
+    m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 420);
+
+    m_timerService.advance(1s);
+
+    ASSERT_EQ(2U, m_backend.targets.size());
+    EXPECT_EQ(std::make_pair(SeatId::Driver, SEAT_POSITION_MIN), m_backend.targets[0]);
+    EXPECT_EQ(std::make_pair(SeatId::Driver, 420), m_backend.targets[1]);
+    EXPECT_EQ(TOPIC_Driver_MOVE_RESPONSE, m_backend.messages.back().first);
+}
+
+TEST_F(SeatAdjusterTest, moveRequest_startedBeforeExpiryStopRan_notStopped) {
+    m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 500);
+    m_seatAdjuster.onMoveSeatRequestReceived(
+        SeatId::Driver, R"({"requestId": 1, "action": "start", "direction": "forward"})");
+    m_backend.isDeferringTasks = true;
+
+    // The new session is queued on the seat's executor before the expiry's stop
+    m_seatAdjuster.onMoveSeatRequestReceived(
+        SeatId::Driver, R"({"requestId": 2, "action": "start", "direction": "backward"})");
+    m_timerService.advance(1s);
+    m_backend.runDeferredTasks();
+
+    ASSERT_EQ(2U, m_backend.targets.size());
+    EXPECT_EQ(std::make_pair(SeatId::Driver, SEAT_POSITION_MAX), m_backend.targets[1]);
+    EXPECT_EQ(2, m_backend.messages.back().second["requestId"]);
+}
+
+TEST_F(SeatAdjusterTest, automationSignalChanged_ruleFires_seatMovedOnItsExecutor) {
+    m_seatAdjuster.enableAutomation(std::make_unique<AutomationEngine>(nlohmann::json::parse(R"({
+        "rules": [{
+            "name": "slideBack",
+            "trigger": {"signal": "Vehicle.Cabin.Door.Row1.DriverSide.IsOpen", "equals": true},
+            "action": {"seat": "CoDriver", "position": 800}
+        }]
+    })")));
+    m_backend.isDeferringTasks = true;
+
+    m_seatAdjuster.onAutomationSignalChanged("Vehicle.Cabin.Door.Row1.DriverSide.IsOpen", false);
+    m_seatAdjuster.onAutomationSignalChanged("Vehicle.Cabin.Door.Row1.DriverSide.IsOpen", true);
+    EXPECT_TRUE(m_backend.targets.empty());
+
+    m_backend.runDeferredTasks();
+    ASSERT_EQ(1U, m_backend.targets.size());
+    EXPECT_EQ(std::make_pair(SeatId::CoDriver, 800), m_backend.targets[0]);
+}
+
+TEST_F(SeatAdjusterTest, start_seatsInUse_statisticsPublishedPeriodically) {
+    m_seatAdjuster.start();
+
+    for (int minute = 0; minute < 32; ++minute) {
+        m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, minute);
+        m_timerService.advance(std::chrono::minutes(1));
+    }
+
+    EXPECT_EQ(PowerMode::Active, m_seatAdjuster.getPowerMode());
+    EXPECT_EQ(2U, countMessages(TOPIC_STATISTICS));
+}
+
+TEST_F(SeatAdjusterTest, start_seatsUnused_idleModeSuspendsMetrics) {
+    m_seatAdjuster.start();
+
+    m_timerService.advance(std::chrono::minutes(5));
+    ASSERT_EQ(PowerMode::Idle, m_seatAdjuster.getPowerMode());
+    const auto threadStatistics = countMessages(TOPIC_THREAD_STATISTICS);
+    EXPECT_EQ("idle", m_backend.messages.back().second.value("mode", ""));
+
+    m_timerService.advance(std::chrono::hours(3));
+    EXPECT_EQ(threadStatistics, countMessages(TOPIC_THREAD_STATISTICS));
+    EXPECT_EQ(2U, countMessages(TOPIC_STATISTICS));
+
+    m_seatAdjuster.onSetPositionRequestReceived(SeatId::Driver,
+                                                R"({"requestId": 1, "position": 300})");
+    EXPECT_EQ(PowerMode::Active, m_seatAdjuster.getPowerMode());
+    m_timerService.advance(std::chrono::minutes(2));
+    EXPECT_LT(threadStatistics, countMessages(TOPIC_THREAD_STATISTICS));
+}
+
+TEST_F(SeatAdjusterTest, setPositionRequest_retried_seatNotMovedAgain) {
+    const auto request = R"({"requestId": 7, "position": 300})";
+    m_seatAdjuster.onSetPositionRequestReceived(SeatId::Driver, request);
+    m_seatAdjuster.onSeatPositionChanged(SeatId::Driver, 250);
+
+    m_seatAdjuster.onSetPositionRequestReceived(SeatId::Driver, request);
+
+    EXPECT_EQ(1U, m_backend.targets.size());
+    EXPECT_EQ(STATUS_OK, m_backend.messages.back().second["result"]["status"]);
+}
+
+TEST_F(SeatAdjusterTest, setPositionRequest_retriedAfterVehicleStopped_seatMoved) {
+    const auto request = R"({"requestId": 7, "position": 300})";
+    m_backend.speed    = 30.0;
+    m_seatAdjuster.onSetPositionRequestReceived(SeatId::Driver, request);
+    EXPECT_EQ(STATUS_FAIL, m_backend.messages.back().second["result"]["status"]);
+
+    m_backend.speed = 0.0;
+    m_seatAdjuster.onSetPositionRequestReceived(SeatId::Driver, request);
+
+    ASSERT_EQ(1U, m_backend.targets.size());
+    EXPECT_EQ(std::make_pair(SeatId::Driver, 300), m_backend.targets[0]);
+    EXPECT_EQ(STATUS_OK, m_backend.messages.back().second["result"]["status"]);
+}
+
+TEST_F(SeatAdjusterTest, enableSnapshots_restart_stateRestored) {
+    const auto snapshotPath =
+        "/tmp/seatadjuster_restart_test_" + std::to_string(getpid()) + ".state";
+    {
+        FakeBackend  backend;
+        SeatAdjuster previousRun(backend, m_timerService);
+        previousRun.enableSnapshots(std::make_unique<StateSnapshotFile>(snapshotPath));
+        previousRun.start();
+        previousRun.onSeatPositionChanged(SeatId::Driver, 420);
+        previousRun.onSetPositionRequestReceived(SeatId::CoDriver,
+                                                 R"({"requestId": 7, "position": 300})");
+        m_timerService.advance(std::chrono::seconds(2));
+    }
+
+    EXPECT_TRUE(m_seatAdjuster.enableSnapshots(std::make_unique<StateSnapshotFile>(snapshotPath)));
+    EXPECT_EQ(420, m_seatAdjuster.getCurrentPosition(SeatId::Driver));
+    EXPECT_EQ(SeatAdjuster::POSITION_UNKNOWN, m_seatAdjuster.getCurrentPosition(SeatId::CoDriver));
+    m_seatAdjuster.onSetPositionRequestReceived(SeatId::CoDriver,
+                                                R"({"requestId": 7, "position": 300})");
+    EXPECT_TRUE(m_backend.targets.empty());
+
+    m_timerService.advance(std::chrono::minutes(2));
+    SeatAdjuster nextRun(m_backend, m_timerService);
+    EXPECT_FALSE(nextRun.enableSnapshots(std::make_unique<StateSnapshotFile>(snapshotPath)));
+    EXPECT_EQ(SeatAdjuster::POSITION_UNKNOWN, nextRun.getCurrentPosition(SeatId::Driver));
+
+    ::unlink(snapshotPath.c_str());
+}
+
+TEST_F(SeatAdjusterTest, actuatorRequest_valueWrittenAndChangesPublished) {
+    const std::string defroster = "Vehicle.Cabin.HVAC.IsFrontDefrosterActive";
+    m_seatAdjuster.enableActuators(std::make_unique<ActuatorEngine>(nlohmann::json(
+        {{"actuators", {{{"name", "defroster"}, {"signal", defroster}, {"type", "boolean"}}}}})));
+
+    m_seatAdjuster.onActuatorRequestReceived(0, R"({"requestId": 3, "value": true})");
+    m_seatAdjuster.onActuatorSignalChanged(defroster, true);
+    m_seatAdjuster.onActuatorSignalChanged(defroster, true);
+
+    ASSERT_EQ(1U, m_backend.actuatorValues.size());
+    EXPECT_EQ(defroster, m_backend.actuatorValues[0].first);
+    EXPECT_EQ(SignalValue(true), m_backend.actuatorValues[0].second);
+    ASSERT_EQ(2U, m_backend.messages.size());
+    EXPECT_EQ("seatadjuster/actuators/defroster/response", m_backend.messages[0].first);
+    EXPECT_EQ(3, m_backend.messages[0].second["requestId"]);
+    EXPECT_EQ(STATUS_OK, m_backend.messages[0].second["result"]["status"]);
+    EXPECT_EQ("seatadjuster/actuators/defroster/current", m_backend.messages[1].first);
+    EXPECT_EQ(true, m_backend.messages[1].second["value"]);
+}
+
+TEST_F(SeatAdjusterTest, actuatorRequest_auditLogFailing_rejectedAndAudited) {
+    const std::string auditPath =
+        "/tmp/seatadjuster_actuator_failing_test_" + std::to_string(getpid()) + ".log";
+    const auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit     previousLimit{};
+    ASSERT_EQ(0, ::getrlimit(RLIMIT_FSIZE, &previousLimit));
+    bool wasFailing = false;
+    {
+        AuditLog::Config config{auditPath};
+        config.retryInterval = 20ms;
+        auto         auditLog = std::make_unique<AuditLog>(config);
+        const auto&  log      = *auditLog;
+        SeatAdjuster seatAdjuster(m_backend, m_timerService);
+        seatAdjuster.enableAuditLog(std::move(auditLog));
+        seatAdjuster.enableActuators(std::make_unique<ActuatorEngine>(nlohmann::json(
+            {{"actuators",
+              {{{"name", "defroster"},
+                {"signal", "Vehicle.Cabin.HVAC.IsFrontDefrosterActive"},
+                {"type", "boolean"}}}}})));
+
+        // Writes beyond the header fail with EFBIG until the limit is lifted again
+        auto limit     = previousLimit;
+        limit.rlim_cur = sizeof(AuditLogHeader);
+        ASSERT_EQ(0, ::setrlimit(RLIMIT_FSIZE, &limit));
+        seatAdjuster.requestSeatPosition(SeatId::Driver, 100, CommandSource::Mqtt, 1);
+        for (int i = 0; i < 200 && !log.isFailing(); ++i) {
+            std::this_thread::sleep_for(10ms);
+        }
+        wasFailing = log.isFailing();
+
+        seatAdjuster.onActuatorRequestReceived(0, R"({"requestId": 2, "value": true})");
+        ::setrlimit(RLIMIT_FSIZE, &previousLimit);
+    }
+    std::signal(SIGXFSZ, previousHandler);
+    ASSERT_TRUE(wasFailing);
+
+    EXPECT_TRUE(m_backend.actuatorValues.empty());
+    ASSERT_EQ(1U, m_backend.messages.size());
+    EXPECT_EQ(2, m_backend.messages[0].second["requestId"]);
+    EXPECT_EQ(STATUS_FAIL, m_backend.messages[0].second["result"]["status"]);
+
+    std::vector<AuditRecord> records;
+    readAuditLog(auditPath, [&records](const AuditRecord& record) { records.push_back(record); });
+    ::unlink(auditPath.c_str());
+    ASSERT_EQ(2U, records.size());
+    EXPECT_EQ(static_cast<uint8_t>(AuditRecordKind::ActuatorNumber), records[1].kind);
+    EXPECT_EQ(2U, records[1].requestId);
+    EXPECT_EQ(STATUS_FAIL, records[1].status);
+}
+
+TEST_F(SeatAdjusterTest, actuatorRequest_supersededWhileWriting_failedAndAudited) {
+    const std::string auditPath =
+        "/tmp/seatadjuster_actuator_audit_test_" + std::to_string(getpid()) + ".log";
+    {
+        SeatAdjuster seatAdjuster(m_backend, m_timerService);
+        seatAdjuster.enableAuditLog(std::make_unique<AuditLog>(AuditLog::Config{auditPath}));
+        seatAdjuster.enableActuators(std::make_unique<ActuatorEngine>(nlohmann::json(
+            {{"actuators",
+              {{{"name", "wiperTarget"},
+                {"signal", "Vehicle.Body.Windshield.Front.Wiping.System.TargetPosition"},
+                {"type", "float"}}}}})));
+
+        // Requests 2 and 3 arrive while request 1 is written, 3 replaces 2
+        m_backend.onActuatorWrite = [&seatAdjuster]() {
+            seatAdjuster.onActuatorRequestReceived(0, R"({"requestId": 2, "value": 45})");
+            seatAdjuster.onActuatorRequestReceived(0, R"({"requestId": 3, "value": 90})");
+        };
+        seatAdjuster.onActuatorRequestReceived(0, R"({"requestId": 1, "value": 10})");
+    }
+
+    ASSERT_EQ(3U, m_backend.messages.size());
+    EXPECT_EQ(2, m_backend.messages[0].second["requestId"]);
+    EXPECT_EQ(STATUS_FAIL, m_backend.messages[0].second["result"]["status"]);
+    EXPECT_EQ(1, m_backend.messages[1].second["requestId"]);
+    EXPECT_EQ(3, m_backend.messages[2].second["requestId"]);
+    EXPECT_EQ(STATUS_OK, m_backend.messages[2].second["result"]["status"]);
+
+    std::vector<AuditRecord> records;
+    readAuditLog(auditPath, [&records](const AuditRecord& record) { records.push_back(record); });
+    ::unlink(auditPath.c_str());
+    ASSERT_EQ(3U, records.size());
+    EXPECT_EQ(static_cast<uint8_t>(AuditRecordKind::ActuatorNumber), records[0].kind);
+    EXPECT_EQ(2U, records[0].requestId);
+    EXPECT_EQ(STATUS_FAIL, records[0].status);
+    float value = 0.0F;
+    std::memcpy(&value, &records[0].position, sizeof(value));
+    EXPECT_EQ(45.0F, value);
+    EXPECT_EQ(1U, records[1].requestId);
+    EXPECT_EQ(3U, records[2].requestId);
+    EXPECT_EQ(STATUS_OK, records[2].status);
+}
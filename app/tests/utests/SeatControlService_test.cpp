@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "SeatControlService.h"
+
+#include <gtest/gtest.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/credentials.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+using namespace example;
+
+class SeatControlServiceTest : public ::testing::Test {
+protected:
+    SeatControlServiceTest()
+        : m_address("unix:/tmp/seatcontrol_test_" + std::to_string(getpid()) + ".sock")
+        , m_server(m_address, [this](SeatId seat, int position) {
+            m_requestedSeat     = seat;
+            m_requestedPosition = position;
+            return SeatRequestResult{STATUS_OK, "moved"};
+        })
+        , m_stub(seatadjuster::v1::SeatControl::NewStub(
+              grpc::CreateChannel(m_address, grpc::InsecureChannelCredentials()))) {}
+
+    std::string                                          m_address;
+    std::atomic<SeatId>                                  m_requestedSeat{SeatId::Driver};
+    std::atomic<int>                                     m_requestedPosition{-1};
+    SeatControlServer                                    m_server;
+    std::unique_ptr<seatadjuster::v1::SeatControl::Stub> m_stub;
+};
+
+TEST_F(SeatControlServiceTest, SetPosition_validRequest_handledByPipeline) {
+    grpc::ClientContext                   context;
+    seatadjuster::v1::SetPositionRequest  request;
+    seatadjuster::v1::SetPositionResponse response;
+    request.set_request_id(42);
+    request.set_seat(seatadjuster::v1::SEAT_CODRIVER);
+    request.set_position(300);
+
+    const auto status = m_stub->SetPosition(&context, request, &response);
+
+    ASSERT_TRUE(status.ok());
+    EXPECT_EQ(42, response.request_id());
+    EXPECT_EQ(STATUS_OK, response.status());
+    EXPECT_EQ("moved", response.message());
+    EXPECT_EQ(SeatId::CoDriver, m_requestedSeat);
+    EXPECT_EQ(300, m_requestedPosition);
+}
+
+TEST_F(SeatControlServiceTest, SetPosition_positionOutOfRange_invalidArgument) {
+    grpc::ClientContext                   context;
+    seatadjuster::v1::SetPositionRequest  request;
+    seatadjuster::v1::SetPositionResponse response;
+    request.set_position(SEAT_POSITION_MAX + 1);
+
+    const auto status = m_stub->SetPosition(&context, request, &response);
+
+    EXPECT_EQ(grpc::StatusCode::INVALID_ARGUMENT, status.error_code());
+    EXPECT_EQ(-1, m_requestedPosition);
+}
+
+TEST_F(SeatControlServiceTest, GetPositions_onlyKnownPositionsReturned) {
+    m_server.notifyPositionChanged(SeatId::Driver, 120);
+
+    grpc::ClientContext                    context;
+    seatadjuster::v1::GetPositionsResponse response;
+    ASSERT_TRUE(m_stub->GetPositions(&context, {}, &response).ok());
+
+    ASSERT_EQ(1, response.positions_size());
+    EXPECT_EQ(seatadjuster::v1::SEAT_DRIVER, response.positions(0).seat());
+    EXPECT_EQ(120, response.positions(0).position());
+}
+
+TEST_F(SeatControlServiceTest, WatchPositions_currentAndChangedPositionsStreamed) {
+    m_server.notifyPositionChanged(SeatId::Driver, 10);
+
+    grpc::ClientContext context;
+    auto                reader = m_stub->WatchPositions(&context, {});
+
+    seatadjuster::v1::SeatPosition position;
+    ASSERT_TRUE(reader->Read(&position));
+    EXPECT_EQ(seatadjuster::v1::SEAT_DRIVER, position.seat());
+    EXPECT_EQ(10, position.position());
+
+    m_server.notifyPositionChanged(SeatId::CoDriver, 20);
+    ASSERT_TRUE(reader->Read(&position));
+    EXPECT_EQ(seatadjuster::v1::SEAT_CODRIVER, position.seat());
+    EXPECT_EQ(20, position.position());
+
+    context.TryCancel();
+}
+
+TEST_F(SeatControlServiceTest, WatchPositions_cancelled_streamEnds) {
+    grpc::ClientContext context;
+    auto                reader = m_stub->WatchPositions(&context, {});
+    m_server.notifyPositionChanged(SeatId::Driver, 10);
+
+    seatadjuster::v1::SeatPosition position;
+    ASSERT_TRUE(reader->Read(&position));
+    context.TryCancel();
+
+    EXPECT_FALSE(reader->Read(&position));
+    EXPECT_EQ(grpc::StatusCode::CANCELLED, reader->Finish().error_code());
+}
+
+TEST(SeatControlServerTest, destructor_openStream_streamFinished) {
+    const auto address = "unix:/tmp/seatcontrol_stop_test_" + std::to_string(getpid()) + ".sock";
+    auto       server  = std::make_unique<SeatControlServer>(address, [](SeatId, int) {
+        return SeatRequestResult{STATUS_OK, ""};
+    });
+    auto stub = seatadjuster::v1::SeatControl::NewStub(
+        grpc::CreateChannel(address, grpc::InsecureChannelCredentials()));
+
+    grpc::ClientContext context;
+    auto                reader = stub->WatchPositions(&context, {});
+    server->notifyPositionChanged(SeatId::CoDriver, 30);
+    seatadjuster::v1::SeatPosition position;
+    ASSERT_TRUE(reader->Read(&position));
+
+    server.reset();
+    EXPECT_FALSE(reader->Read(&position));
+    EXPECT_TRUE(reader->Finish().ok());
+}
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "SeatUsageStatistics.h"
+#include "Json.h"
+
+#include <gtest/gtest.h>
+
+using namespace example;
+using namespace std::chrono_literals;
+
+class SeatUsageStatisticsTest : public ::testing::Test {
+protected:
+    SeatUsageStatistics::Clock::time_point m_start{SeatUsageStatistics::Clock::now()};
+    SeatUsageStatistics                    m_statistics{m_start};
+};
+
+TEST_F(SeatUsageStatisticsTest, takeSummary_positionsAndTimeBucketed) {
+    m_statistics.onPositionChanged(SeatId::Driver, 50, m_start);
+    m_statistics.onPositionChanged(SeatId::Driver, 550, m_start + 10s);
+
+    const auto summary = m_statistics.takeSummary(m_start + 40s);
+
+    EXPECT_EQ(40, summary["intervalSeconds"]);
+    const auto& driver = summary["seats"]["Driver"];
+    EXPECT_EQ(1, driver["positionHistogram"][0]);
+    EXPECT_EQ(1, driver["positionHistogram"][5]);
+    EXPECT_EQ(10, driver["secondsAtPosition"][0]);
+    EXPECT_EQ(30, driver["secondsAtPosition"][5]);
+    EXPECT_EQ(2, driver["positionUpdates"]);
+    EXPECT_EQ(550, driver["lastPosition"]);
+    EXPECT_FALSE(summary["seats"]["CoDriver"].contains("lastPosition"));
+}
+
+TEST_F(SeatUsageStatisticsTest, onPositionChanged_pauseBetweenUpdates_countedAsNewMove) {
+    m_statistics.onPositionChanged(SeatId::CoDriver, 0, m_start);
+    m_statistics.onPositionChanged(SeatId::CoDriver, 10, m_start + 100ms);
+    m_statistics.onPositionChanged(SeatId::CoDriver, 20, m_start + 200ms);
+    m_statistics.onPositionChanged(SeatId::CoDriver, 20, m_start + 300ms);
+    m_statistics.onPositionChanged(SeatId::CoDriver, 30, m_start + 10s);
+
+    const auto summary = m_statistics.takeSummary(m_start + 20s);
+
+    EXPECT_EQ(2, summary["seats"]["CoDriver"]["moves"]);
+    EXPECT_EQ(4, summary["seats"]["CoDriver"]["positionUpdates"]);
+}
+
+TEST_F(SeatUsageStatisticsTest, takeSummary_countersResetAndPositionCarriedOver) {
+    m_statistics.onPositionChanged(SeatId::Driver, 1000, m_start);
+    m_statistics.onRequest(SeatId::Driver, true);
+    m_statistics.onRequest(SeatId::Driver, false);
+    m_statistics.onRequest(SeatId::Driver, false);
+
+    const auto first = m_statistics.takeSummary(m_start + 5s);
+    EXPECT_EQ(1, first["seats"]["Driver"]["requests"]["accepted"]);
+    EXPECT_EQ(2, first["seats"]["Driver"]["requests"]["rejected"]);
+
+    const auto second = m_statistics.takeSummary(m_start + 15s);
+    const auto& driver = second["seats"]["Driver"];
+    EXPECT_EQ(0, driver["requests"]["accepted"]);
+    EXPECT_EQ(0, driver["positionUpdates"]);
+    EXPECT_EQ(10, driver["secondsAtPosition"][SeatUsageStatistics::BUCKET_COUNT - 1]);
+    EXPECT_EQ(1000, driver["lastPosition"]);
+}
@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "SignalCondition.h"
+#include "Json.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace example;
+
+TEST(SignalConditionTest, fromJson_numericComparison) {
+    const auto condition = SignalCondition::fromJson(
+        nlohmann::json::parse(R"({"signal": "Vehicle.Speed", "op": "<=", "value": 5})"));
+
+    EXPECT_EQ("Vehicle.Speed", condition.signal);
+    EXPECT_TRUE(condition.isMetBy(5.0));
+    EXPECT_FALSE(condition.isMetBy(5.5));
+}
+
+TEST(SignalConditionTest, isMetBy_otherType_notMet) {
+    const auto condition = SignalCondition::fromJson(
+        nlohmann::json::parse(R"({"signal": "Vehicle.Speed", "op": "!=", "value": 0})"));
+
+    EXPECT_FALSE(condition.isMetBy(true));
+    EXPECT_FALSE(condition.isMetBy(std::string("0")));
+}
+
+TEST(SignalConditionTest, isMetBy_orderingOfStrings_notMet) {
+    const auto condition = SignalCondition::fromJson(
+        nlohmann::json::parse(R"({"signal": "Mode", "op": "<", "value": "WIPE"})"));
+
+    EXPECT_FALSE(condition.isMetBy(std::string("STOP_HOLD")));
+}
+
+TEST(SignalConditionTest, fromJson_unknownOperator_throws) {
+    const auto config =
+        nlohmann::json::parse(R"({"signal": "Vehicle.Speed", "op": "~", "value": 0})");
+
+    EXPECT_THROW(SignalCondition::fromJson(config), std::invalid_argument);
+}
+
+TEST(SignalConditionTest, toJson_valueTypeKept) {
+    EXPECT_EQ(nlohmann::json(true), toJson(true));
+    EXPECT_EQ(nlohmann::json(1.5), toJson(1.5));
+    EXPECT_EQ(nlohmann::json("WIPE"), toJson(std::string("WIPE")));
+}
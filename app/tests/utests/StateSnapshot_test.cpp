@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "StateSnapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+using namespace example;
+
+class StateSnapshotFileTest : public ::testing::Test {
+protected:
+    StateSnapshotFileTest()
+        : m_path("/tmp/seatadjuster_snapshot_test_" + std::to_string(getpid()) + ".state") {}
+
+    ~StateSnapshotFileTest() override { ::unlink(m_path.c_str()); }
+
+    static StateSnapshot makeSnapshot(int64_t takenAt) {
+        StateSnapshot snapshot{};
+        snapshot.takenAt                = takenAt;
+        snapshot.seats[0].position      = 420;
+        snapshot.seats[1].moveDirection = StateSnapshot::MOVE_BACKWARD;
+        snapshot.requestCount           = 1;
+        snapshot.requests[0].requestId  = 7;
+        snapshot.requests[0].position   = 420;
+        return snapshot;
+    }
+
+    const std::string m_path;
+};
+
+TEST_F(StateSnapshotFileTest, newFile_noSnapshot) {
+    StateSnapshotFile file(m_path);
+
+    EXPECT_FALSE(file.load());
+}
+
+TEST_F(StateSnapshotFileTest, store_loadedByNextInstance) {
+    {
+        StateSnapshotFile file(m_path);
+        file.store(makeSnapshot(1));
+        file.store(makeSnapshot(2));
+    }
+
+    StateSnapshotFile file(m_path);
+    const auto        snapshot = file.load();
+    ASSERT_TRUE(snapshot);
+    EXPECT_EQ(2, snapshot->takenAt);
+    EXPECT_EQ(420, snapshot->seats[0].position);
+    EXPECT_EQ(StateSnapshot::MOVE_BACKWARD, snapshot->seats[1].moveDirection);
+    EXPECT_EQ(7, snapshot->requests[0].requestId);
+
+    // Generations continue, so the next snapshot is the newest one
+    file.store(makeSnapshot(3));
+    EXPECT_EQ(3, StateSnapshotFile(m_path).load()->takenAt);
+}
+
+TEST_F(StateSnapshotFileTest, fileOfOtherLayout_reset) {
+    {
+        std::ofstream stream(m_path);
+        stream << "not a snapshot";
+    }
+
+    StateSnapshotFile file(m_path);
+
+    EXPECT_FALSE(file.load());
+}
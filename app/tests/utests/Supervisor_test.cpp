@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "Supervisor.h"
+
+#include <gtest/gtest.h>
+
+#include <poll.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace example;
+
+TEST(SupervisorTest, activeProcessDies_standbyTakesOver) {
+    int takeoverPipe[2];
+    ASSERT_EQ(0, ::pipe(takeoverPipe));
+
+    Supervisor supervisor([&takeoverPipe](Supervisor::Role                  role,
+                                          const Supervisor::TakeoverWait& waitForTakeover) {
+        if (role == Supervisor::Role::Active) {
+            return 1; // simulated crash
+        }
+        const auto sinceActiveDied = waitForTakeover();
+        if (!sinceActiveDied) {
+            return 0;
+        }
+        const char takenOver = 'T';
+        [[maybe_unused]] const auto written = ::write(takeoverPipe[1], &takenOver, 1);
+        // Serve until terminated by the supervisor
+        for (;;) {
+            ::pause();
+        }
+    });
+    std::thread supervisorThread([&supervisor]() { EXPECT_EQ(0, supervisor.run()); });
+
+    pollfd pollFd{takeoverPipe[0], POLLIN, 0};
+    EXPECT_EQ(1, ::poll(&pollFd, 1, 5000));
+
+    supervisor.stop();
+    supervisorThread.join();
+    ::close(takeoverPipe[0]);
+    ::close(takeoverPipe[1]);
+}
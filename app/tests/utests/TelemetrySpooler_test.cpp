@@ -0,0 +1,247 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "TelemetrySpooler.h"
+#include "Json.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fmt/core.h>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include <zdict.h>
+
+using namespace example;
+
+namespace {
+
+std::string makePositionPayload(int index) {
+    return fmt::format(R"({{"position":{},"sequence":{}}})", 200 + index % 300, index + 1);
+}
+
+void writeFile(const std::string& path, const std::string& content) {
+    const auto fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0640);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(static_cast<ssize_t>(content.size()), ::write(fd, content.data(), content.size()));
+    ::close(fd);
+}
+
+} // namespace
+
+class TelemetrySpoolerTest : public ::testing::Test {
+protected:
+    TelemetrySpoolerTest()
+        : m_directory("/tmp/seatadjuster_telemetry_test_" + std::to_string(getpid())) {
+        ::mkdir(m_directory.c_str(), 0750);
+    }
+
+    ~TelemetrySpoolerTest() override {
+        for (const auto& name : listFiles()) {
+            ::unlink((m_directory + "/" + name).c_str());
+        }
+        ::rmdir(m_directory.c_str());
+    }
+
+    TelemetrySpooler::Config makeConfig() const {
+        TelemetrySpooler::Config config;
+        config.directory     = m_directory;
+        config.flushInterval = std::chrono::milliseconds(10);
+        return config;
+    }
+
+    std::vector<std::string> listFiles(const std::string& suffix = "") const {
+        std::vector<std::string> names;
+        if (auto* directory = opendir(m_directory.c_str())) {
+            while (const auto* entry = readdir(directory)) {
+                const std::string name = entry->d_name;
+                if (name[0] != '.' && name.size() >= suffix.size() &&
+                    name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                    names.push_back(name);
+                }
+            }
+            closedir(directory);
+        }
+        return names;
+    }
+
+    std::vector<std::string> waitForSealedFiles(std::size_t count) const {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        auto       files    = listFiles(".jsonl.zst");
+        while (files.size() < count && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            files = listFiles(".jsonl.zst");
+        }
+        return files;
+    }
+
+    std::vector<nlohmann::json> readRecords(const std::string& name,
+                                            const std::string& dictionary = "") const {
+        std::vector<nlohmann::json> records;
+        const auto result = readTelemetryRecords(
+            m_directory + "/" + name, dictionary, [&records](const std::string& record) {
+                records.push_back(nlohmann::json::parse(record));
+            });
+        EXPECT_TRUE(result.isComplete);
+        return records;
+    }
+
+    std::size_t getFileSize(const std::string& name) const {
+        struct stat fileStat {};
+        ::stat((m_directory + "/" + name).c_str(), &fileStat);
+        return static_cast<std::size_t>(fileStat.st_size);
+    }
+
+    const std::string m_directory;
+};
+
+TEST_F(TelemetrySpoolerTest, destruction_recordsSealed) {
+    {
+        TelemetrySpooler spooler(makeConfig());
+        spooler.append("seatadjuster/currentDriverPosition", makePositionPayload(1));
+        spooler.append("seatadjuster/statistics", R"({"moves":3})");
+    }
+
+    EXPECT_TRUE(listFiles(".part").empty());
+    const auto files = listFiles(".jsonl.zst");
+    ASSERT_EQ(1U, files.size());
+    const auto records = readRecords(files[0]);
+    ASSERT_EQ(2U, records.size());
+    EXPECT_EQ("seatadjuster/currentDriverPosition", records[0]["topic"]);
+    EXPECT_EQ(201, records[0]["payload"]["position"]);
+    EXPECT_GT(records[0]["timestamp"].get<int64_t>(), 0);
+    EXPECT_EQ(3, records[1]["payload"]["moves"]);
+}
+
+TEST_F(TelemetrySpoolerTest, maxFileBytes_fileSealedAfterBatch) {
+    auto config         = makeConfig();
+    config.maxFileBytes = 1;
+    TelemetrySpooler spooler(config);
+
+    spooler.append("seatadjuster/currentDriverPosition", makePositionPayload(1));
+    ASSERT_EQ(1U, waitForSealedFiles(1).size());
+    spooler.append("seatadjuster/currentDriverPosition", makePositionPayload(2));
+    const auto files = waitForSealedFiles(2);
+    ASSERT_EQ(2U, files.size());
+    EXPECT_EQ(1U, readRecords(files[0]).size());
+    EXPECT_EQ(1U, readRecords(files[1]).size());
+}
+
+TEST_F(TelemetrySpoolerTest, maxFileAge_fileSealedWhileIdle) {
+    auto config       = makeConfig();
+    config.maxFileAge = std::chrono::milliseconds(50);
+    TelemetrySpooler spooler(config);
+
+    spooler.append("seatadjuster/currentDriverPosition", makePositionPayload(1));
+
+    const auto files = waitForSealedFiles(1);
+    ASSERT_EQ(1U, files.size());
+    EXPECT_EQ(1U, readRecords(files[0]).size());
+}
+
+TEST_F(TelemetrySpoolerTest, dictionary_smallFileCompressedBetter) {
+    // Train on spooled records, as the telemetry_dict_trainer does
+    {
+        TelemetrySpooler spooler(makeConfig());
+        for (int index = 0; index < 4000; ++index) {
+            spooler.append(index % 2 == 0 ? "seatadjuster/currentDriverPosition"
+                                          : "seatadjuster/setCoDriverPosition/response",
+                           makePositionPayload(index * 7));
+        }
+    }
+    std::string         samples;
+    std::vector<size_t> sampleSizes;
+    readTelemetryRecords(m_directory + "/" + listFiles()[0], "",
+                         [&](const std::string& record) {
+                             samples += record;
+                             sampleSizes.push_back(record.size());
+                         });
+    std::string dictionary(16 * 1024, '\0');
+    const auto  dictionarySize =
+        ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), samples.data(),
+                              sampleSizes.data(), static_cast<unsigned>(sampleSizes.size()));
+    ASSERT_FALSE(ZDICT_isError(dictionarySize)) << ZDICT_getErrorName(dictionarySize);
+    dictionary.resize(dictionarySize);
+    const auto dictionaryPath = m_directory + "/trained.dict";
+    writeFile(dictionaryPath, dictionary);
+    ::unlink((m_directory + "/" + listFiles(".jsonl.zst")[0]).c_str());
+
+    const auto spoolBatch = [this](const std::string& dictionaryPath) {
+        auto config           = makeConfig();
+        config.dictionaryPath = dictionaryPath;
+        TelemetrySpooler spooler(config);
+        for (int index = 0; index < 10; ++index) {
+            spooler.append("seatadjuster/currentDriverPosition", makePositionPayload(index));
+        }
+    };
+    spoolBatch("");
+    const auto plainFile = listFiles(".jsonl.zst")[0];
+    spoolBatch(dictionaryPath);
+    auto files = listFiles(".jsonl.zst");
+    ASSERT_EQ(2U, files.size());
+    const auto dictionaryFile = files[0] == plainFile ? files[1] : files[0];
+
+    // The records share their structure with the dictionary from the first byte on
+    EXPECT_LT(getFileSize(dictionaryFile) * 3 / 2, getFileSize(plainFile));
+    EXPECT_EQ(10U, readRecords(dictionaryFile, dictionary).size());
+    EXPECT_FALSE(
+        readTelemetryRecords(m_directory + "/" + dictionaryFile, "", [](const std::string&) {})
+            .isComplete);
+}
+
+TEST_F(TelemetrySpoolerTest, leftoverPartFile_sealedOnStart) {
+    {
+        TelemetrySpooler spooler(makeConfig());
+        spooler.append("seatadjuster/currentDriverPosition", makePositionPayload(1));
+        spooler.append("seatadjuster/currentDriverPosition", makePositionPayload(2));
+    }
+    // Cut off the end of the frame (last empty block and checksum), as a crash would
+    const auto sealed     = m_directory + "/" + listFiles(".jsonl.zst")[0];
+    const auto compressed = readTelemetryFile(sealed);
+    ::unlink(sealed.c_str());
+    writeFile(m_directory + "/telemetry-1-0.jsonl.zst.part",
+              compressed.substr(0, compressed.size() - 7));
+
+    { TelemetrySpooler spooler(makeConfig()); }
+
+    EXPECT_TRUE(listFiles(".part").empty());
+    std::size_t records = 0;
+    const auto  result  = readTelemetryRecords(m_directory + "/telemetry-1-0.jsonl.zst", "",
+                                               [&records](const std::string&) { ++records; });
+    EXPECT_FALSE(result.isComplete);
+    EXPECT_EQ(2U, records);
+}
+
+TEST_F(TelemetrySpoolerTest, construction_invalidConfig_throws) {
+    auto config      = makeConfig();
+    config.directory = m_directory + "/missing";
+    EXPECT_THROW(TelemetrySpooler{config}, std::system_error);
+
+    config                = makeConfig();
+    config.dictionaryPath = m_directory + "/missing.dict";
+    EXPECT_THROW(TelemetrySpooler{config}, std::system_error);
+
+    writeFile(config.dictionaryPath, std::string("\x37\xA4\x30\xEC", 4) + "not a dictionary");
+    EXPECT_THROW(TelemetrySpooler{config}, std::invalid_argument);
+}
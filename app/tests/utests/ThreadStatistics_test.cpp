@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "ThreadStatistics.h"
+#include "Json.h"
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <thread>
+
+using namespace example;
+
+TEST(ThreadStatisticsTest, sampleThreadStatistics_namedThreadReported) {
+    std::promise<void> named;
+    std::promise<void> sampled;
+    std::thread        worker([&]() {
+        setCurrentThreadName("stats-test-thread-name-truncated");
+        named.set_value();
+        sampled.get_future().wait();
+    });
+    named.get_future().wait();
+
+    const auto statistics = sampleThreadStatistics();
+    sampled.set_value();
+    worker.join();
+
+    const nlohmann::json* workerStatistics = nullptr;
+    for (const auto& thread : statistics["threads"]) {
+        if (thread["name"] == "stats-test-thre") {
+            workerStatistics = &thread;
+        }
+    }
+    ASSERT_NE(nullptr, workerStatistics);
+    EXPECT_GE((*workerStatistics)["cpuUserMs"].get<double>(), 0.0);
+    EXPECT_TRUE(workerStatistics->contains("voluntaryContextSwitches"));
+    EXPECT_TRUE(workerStatistics->contains("involuntaryContextSwitches"));
+}
@@ -0,0 +1,162 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "TimerService.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace example;
+using namespace std::chrono_literals;
+
+TEST(TimerServiceTest, scheduleAfter_callbackInvoked) {
+    TimerService       timerService;
+    std::promise<void> fired;
+
+    timerService.scheduleAfter(10ms, [&fired]() { fired.set_value(); });
+
+    EXPECT_EQ(std::future_status::ready, fired.get_future().wait_for(1s));
+}
+
+TEST(TimerServiceTest, scheduleAt_callbacksInvokedInDeadlineOrder) {
+    TimerService       timerService;
+    std::mutex         mutex;
+    std::vector<int>   order;
+    std::promise<void> done;
+
+    const auto now = TimerService::Clock::now();
+    timerService.scheduleAt(now + 30ms, [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(3);
+        done.set_value();
+    });
+    timerService.scheduleAt(now + 10ms, [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(1);
+    });
+    timerService.scheduleAt(now + 20ms, [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(2);
+    });
+
+    ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(1s));
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), order);
+}
+
+TEST(TimerServiceTest, cancel_pendingTimer_callbackNotInvoked) {
+    TimerService      timerService;
+    std::atomic<bool> fired{false};
+
+    const auto timerId = timerService.scheduleAfter(20ms, [&fired]() { fired = true; });
+
+    EXPECT_TRUE(timerService.cancel(timerId));
+    std::this_thread::sleep_for(50ms);
+    EXPECT_FALSE(fired);
+    EXPECT_FALSE(timerService.cancel(timerId));
+}
+
+TEST(TimerServiceTest, cancel_runningCallback_waitsForIt) {
+    TimerService       timerService;
+    std::promise<void> started;
+    std::promise<void> release;
+    std::atomic<bool>  finished{false};
+
+    const auto timerId = timerService.scheduleAfter(0ms, [&]() {
+        started.set_value();
+        release.get_future().wait();
+        finished = true;
+    });
+    ASSERT_EQ(std::future_status::ready, started.get_future().wait_for(1s));
+
+    auto cancelled = std::async(std::launch::async, [&]() { return timerService.cancel(timerId); });
+    EXPECT_EQ(std::future_status::timeout, cancelled.wait_for(20ms));
+
+    release.set_value();
+    EXPECT_FALSE(cancelled.get());
+    EXPECT_TRUE(finished);
+}
+
+TEST(TimerServiceTest, cancel_ownTimerFromCallback_doesNotWait) {
+    TimerService          timerService;
+    std::promise<void>    done;
+    TimerService::TimerId timerId{0};
+    std::mutex            mutex;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        timerId = timerService.schedulePeriodic(1ms, [&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            EXPECT_TRUE(timerService.cancel(timerId));
+            done.set_value();
+        });
+    }
+
+    EXPECT_EQ(std::future_status::ready, done.get_future().wait_for(1s));
+}
+
+TEST(TimerServiceTest, schedulePeriodic_invokedRepeatedlyUntilCancelled) {
+    TimerService     timerService;
+    std::atomic<int> count{0};
+
+    const auto timerId = timerService.schedulePeriodic(10ms, [&count]() { ++count; });
+
+    std::this_thread::sleep_for(55ms);
+    EXPECT_TRUE(timerService.cancel(timerId));
+    const int countAtCancel = count;
+    EXPECT_GE(countAtCancel, 3);
+
+    std::this_thread::sleep_for(30ms);
+    EXPECT_EQ(countAtCancel, count);
+}
+
+TEST(TimerServiceTest, manualClock_advance_dueTimersRunAtTheirDeadline) {
+    TimerService                               timerService{TimerService::ManualClock{}};
+    const auto                                 start = timerService.now();
+    std::vector<TimerService::Clock::duration> firedAt;
+
+    timerService.schedulePeriodic(10s, [&]() { firedAt.push_back(timerService.now() - start); });
+    timerService.scheduleAfter(25s, [&]() { firedAt.push_back(timerService.now() - start); });
+
+    timerService.advance(35s);
+
+    EXPECT_EQ((std::vector<TimerService::Clock::duration>{10s, 20s, 25s, 30s}), firedAt);
+    EXPECT_EQ(start + 35s, timerService.now());
+}
+
+TEST(TimerServiceTest, manualClock_timersWithSlack_coalescedIntoOneWakeup) {
+    TimerService                               timerService{TimerService::ManualClock{}};
+    const auto                                 start = timerService.now();
+    std::vector<TimerService::Clock::duration> firedAt;
+
+    timerService.schedulePeriodic(
+        60s, [&]() { firedAt.push_back(timerService.now() - start); }, 30s);
+    timerService.schedulePeriodic(
+        70s, [&]() { firedAt.push_back(timerService.now() - start); }, 10s);
+
+    timerService.advance(80s);
+
+    // The second timer only allows waking up at 80s, the first one runs along with it
+    EXPECT_EQ((std::vector<TimerService::Clock::duration>{80s, 80s}), firedAt);
+    EXPECT_EQ(1U, timerService.getWakeupCount());
+}
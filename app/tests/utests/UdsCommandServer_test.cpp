@@ -0,0 +1,211 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "UdsCommandServer.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace example;
+
+namespace {
+
+int connectTo(const std::string& socketPath) {
+    const int   fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    socketPath.copy(address.sun_path, sizeof(address.sun_path) - 1);
+    EXPECT_EQ(0, ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)));
+    return fd;
+}
+
+void sendRequest(int fd, uint32_t requestId) {
+    SeatCommandRequestFrame request{};
+    request.version   = SEAT_COMMAND_PROTOCOL_VERSION;
+    request.requestId = requestId;
+    EXPECT_EQ(static_cast<ssize_t>(sizeof(request)),
+              ::send(fd, &request, sizeof(request), MSG_NOSIGNAL));
+}
+
+SeatCommandResponseFrame exchange(int fd, const void* frame, std::size_t size) {
+    SeatCommandResponseFrame response{};
+    EXPECT_EQ(static_cast<ssize_t>(size), ::send(fd, frame, size, MSG_NOSIGNAL));
+    EXPECT_EQ(static_cast<ssize_t>(sizeof(response)), ::recv(fd, &response, sizeof(response), 0));
+    return response;
+}
+
+} // namespace
+
+class UdsCommandServerTest : public ::testing::Test {
+protected:
+    UdsCommandServerTest()
+        : m_socketPath("/tmp/seatcommand_test_" + std::to_string(getpid()) + ".sock")
+        , m_server(m_socketPath, [this](const SeatCommandRequestFrame&    request,
+                                        UdsCommandServer::Responder respond) {
+            SeatCommandResponseFrame response{};
+            response.command   = request.command;
+            response.requestId = request.requestId;
+            response.position  = request.position * 2;
+            if (m_deferResponses) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_deferred.emplace_back([respond, response]() { respond(response); });
+            } else {
+                respond(response);
+            }
+            ++m_handledCount;
+        }) {}
+
+    bool waitForHandledCount(int count) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (m_handledCount < count) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    // Answer the deferred requests from another thread, as a worker would
+    void answerDeferred() {
+        std::vector<std::function<void()>> deferred;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            deferred.swap(m_deferred);
+        }
+        std::thread([&deferred]() {
+            for (const auto& answer : deferred) {
+                answer();
+            }
+        }).join();
+    }
+
+    std::string                        m_socketPath;
+    std::atomic<int>                   m_handledCount{0};
+    std::atomic<bool>                  m_deferResponses{false};
+    std::mutex                         m_mutex;
+    std::vector<std::function<void()>> m_deferred;
+    UdsCommandServer                   m_server;
+};
+
+TEST_F(UdsCommandServerTest, validFrame_handledAndAnswered) {
+    const int fd = connectTo(m_socketPath);
+
+    SeatCommandRequestFrame request{};
+    request.version   = SEAT_COMMAND_PROTOCOL_VERSION;
+    request.command   = static_cast<uint8_t>(SeatCommand::SetPosition);
+    request.requestId = 7;
+    request.position  = 21;
+
+    const auto response = exchange(fd, &request, sizeof(request));
+
+    EXPECT_EQ(SEAT_COMMAND_PROTOCOL_VERSION, response.version);
+    EXPECT_EQ(7u, response.requestId);
+    EXPECT_EQ(42, response.position);
+    EXPECT_EQ(1, m_handledCount);
+    ::close(fd);
+}
+
+TEST_F(UdsCommandServerTest, invalidFrameSizeOrVersion_rejectedWithoutHandler) {
+    const int fd = connectTo(m_socketPath);
+
+    const uint8_t shortFrame[3]{};
+    EXPECT_EQ(static_cast<uint8_t>(SeatCommandStatus::InvalidFrame),
+              exchange(fd, shortFrame, sizeof(shortFrame)).status);
+
+    SeatCommandRequestFrame request{};
+    request.version = SEAT_COMMAND_PROTOCOL_VERSION + 1;
+    EXPECT_EQ(static_cast<uint8_t>(SeatCommandStatus::InvalidFrame),
+              exchange(fd, &request, sizeof(request)).status);
+
+    EXPECT_EQ(0, m_handledCount);
+    ::close(fd);
+}
+
+TEST_F(UdsCommandServerTest, multipleConnections_servedIndependently) {
+    constexpr int CONNECTION_COUNT = 16;
+    int           fds[CONNECTION_COUNT];
+    for (auto& fd : fds) {
+        fd = connectTo(m_socketPath);
+    }
+
+    for (int i = 0; i < CONNECTION_COUNT; ++i) {
+        SeatCommandRequestFrame request{};
+        request.version   = SEAT_COMMAND_PROTOCOL_VERSION;
+        request.requestId = i;
+        EXPECT_EQ(static_cast<uint32_t>(i), exchange(fds[i], &request, sizeof(request)).requestId);
+    }
+
+    for (auto fd : fds) {
+        ::close(fd);
+    }
+    EXPECT_EQ(CONNECTION_COUNT, m_handledCount);
+}
+
+TEST_F(UdsCommandServerTest, responseFromOtherThread_sentWhenAnswered) {
+    m_deferResponses = true;
+    const int fd     = connectTo(m_socketPath);
+
+    sendRequest(fd, 1);
+    sendRequest(fd, 2);
+    ASSERT_TRUE(waitForHandledCount(2));
+
+    SeatCommandResponseFrame response{};
+    EXPECT_EQ(-1, ::recv(fd, &response, sizeof(response), MSG_DONTWAIT));
+
+    answerDeferred();
+    EXPECT_EQ(static_cast<ssize_t>(sizeof(response)), ::recv(fd, &response, sizeof(response), 0));
+    EXPECT_EQ(1u, response.requestId);
+    EXPECT_EQ(static_cast<ssize_t>(sizeof(response)), ::recv(fd, &response, sizeof(response), 0));
+    EXPECT_EQ(2u, response.requestId);
+    ::close(fd);
+}
+
+TEST_F(UdsCommandServerTest, tooManyPendingRequests_connectionNotReadUntilAnswered) {
+    m_deferResponses     = true;
+    const int fd         = connectTo(m_socketPath);
+    const int maxPending = static_cast<int>(UdsCommandServer::MAX_PENDING_REQUESTS);
+
+    for (int i = 0; i <= maxPending; ++i) {
+        sendRequest(fd, i);
+    }
+    ASSERT_TRUE(waitForHandledCount(maxPending));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(maxPending, m_handledCount);
+
+    answerDeferred();
+    ASSERT_TRUE(waitForHandledCount(maxPending + 1));
+    answerDeferred();
+
+    for (int i = 0; i <= maxPending; ++i) {
+        SeatCommandResponseFrame response{};
+        ASSERT_EQ(static_cast<ssize_t>(sizeof(response)),
+                  ::recv(fd, &response, sizeof(response), 0));
+        EXPECT_EQ(static_cast<uint32_t>(i), response.requestId);
+    }
+    ::close(fd);
+}
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "WorkStealingDeque.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace example;
+
+TEST(WorkStealingDequeTest, ownerPopsNewest_thiefStealsOldest) {
+    WorkStealingDeque<int> deque;
+    std::vector<int>       items{1, 2, 3};
+    for (auto& item : items) {
+        deque.push(&item);
+    }
+
+    EXPECT_EQ(&items[2], deque.pop());
+    EXPECT_EQ(&items[0], deque.steal());
+    EXPECT_EQ(&items[1], deque.pop());
+    EXPECT_EQ(nullptr, deque.pop());
+    EXPECT_EQ(nullptr, deque.steal());
+}
+
+TEST(WorkStealingDequeTest, push_full_bufferGrownAndItemsKept) {
+    WorkStealingDeque<int> deque(4);
+    std::vector<int>       items(10);
+    deque.push(&items[0]);
+    EXPECT_EQ(&items[0], deque.steal());
+    for (std::size_t index = 1; index < items.size(); ++index) {
+        deque.push(&items[index]);
+    }
+
+    EXPECT_EQ(16U, deque.capacity());
+    EXPECT_EQ(9U, deque.size());
+    for (std::size_t index = 1; index < items.size(); ++index) {
+        EXPECT_EQ(&items[index], deque.steal());
+    }
+}
+
+TEST(WorkStealingDequeTest, concurrentThieves_everyItemTakenExactlyOnce) {
+    constexpr int          ITEM_COUNT = 100'000;
+    constexpr int          THIEVES    = 3;
+    WorkStealingDeque<int> deque(8);
+    std::vector<int>       items(ITEM_COUNT);
+    std::iota(items.begin(), items.end(), 1);
+    std::atomic<bool>      isDone{false};
+    std::atomic<int64_t>   stolenSum{0};
+
+    std::vector<std::thread> thieves;
+    for (int thief = 0; thief < THIEVES; ++thief) {
+        thieves.emplace_back([&]() {
+            int64_t sum = 0;
+            while (!isDone.load()) {
+                if (auto* item = deque.steal()) {
+                    sum += *item;
+                }
+            }
+            stolenSum += sum;
+        });
+    }
+
+    int64_t poppedSum = 0;
+    for (int index = 0; index < ITEM_COUNT; ++index) {
+        deque.push(&items[static_cast<std::size_t>(index)]);
+        // Pop every third item right away, contending with the thieves for the last item
+        if (index % 3 == 0) {
+            if (auto* item = deque.pop()) {
+                poppedSum += *item;
+            }
+        }
+    }
+    while (auto* item = deque.pop()) {
+        poppedSum += *item;
+    }
+    isDone = true;
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+
+    const int64_t expectedSum = static_cast<int64_t>(ITEM_COUNT) * (ITEM_COUNT + 1) / 2;
+    EXPECT_EQ(expectedSum, poppedSum + stolenSum.load());
+}
@@ -0,0 +1,156 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "WorkStealingScheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace example;
+using namespace std::chrono_literals;
+
+TEST(WorkStealingSchedulerTest, destruction_allSubmittedTasksRun) {
+    std::atomic<int> runCount{0};
+    {
+        WorkStealingScheduler scheduler(3);
+        for (int task = 0; task < 1000; ++task) {
+            scheduler.submit([&runCount]() { ++runCount; });
+        }
+    }
+
+    EXPECT_EQ(1000, runCount);
+}
+
+TEST(WorkStealingSchedulerTest, tasksSubmittingTasks_wholeTreeRun) {
+    std::atomic<int>         runCount{0};
+    std::function<void(int)> spawn;
+    {
+        WorkStealingScheduler scheduler(4);
+        spawn = [&](int depth) {
+            ++runCount;
+            if (depth > 0) {
+                scheduler.submit([&spawn, depth]() { spawn(depth - 1); });
+                scheduler.submit([&spawn, depth]() { spawn(depth - 1); });
+            }
+        };
+        scheduler.submit([&spawn]() { spawn(10); });
+    }
+
+    EXPECT_EQ((1 << 11) - 1, runCount);
+}
+
+TEST(WorkStealingSchedulerTest, blockedWorker_localTaskStolen) {
+    WorkStealingScheduler scheduler(2);
+    std::promise<void>    stolenTaskRun;
+    std::promise<bool>    result;
+
+    scheduler.submit([&]() {
+        // Queued on this worker's deque, only another worker can run it while this one waits
+        scheduler.submit([&stolenTaskRun]() { stolenTaskRun.set_value(); });
+        result.set_value(stolenTaskRun.get_future().wait_for(5s) == std::future_status::ready);
+    });
+
+    EXPECT_TRUE(result.get_future().get());
+    EXPECT_LE(1U, scheduler.getStealCount());
+}
+
+TEST(WorkStealingSchedulerTest, construction_startedHandlerCalledOnEveryWorker) {
+    std::mutex                mutex;
+    std::set<std::size_t>     workerIndices;
+    std::set<std::thread::id> threadIds;
+    {
+        WorkStealingScheduler scheduler(3, [&](std::size_t workerIndex) {
+            std::lock_guard<std::mutex> lock(mutex);
+            workerIndices.insert(workerIndex);
+            threadIds.insert(std::this_thread::get_id());
+        });
+    }
+
+    EXPECT_EQ((std::set<std::size_t>{0, 1, 2}), workerIndices);
+    EXPECT_EQ(3U, threadIds.size());
+}
+
+TEST(SerialExecutorTest, submit_tasksRunInOrderOneAtATime) {
+    constexpr int    TASKS_PER_EXECUTOR = 2000;
+    std::atomic<int> overlaps{0};
+    struct Tenant {
+        std::unique_ptr<SerialExecutor> executor;
+        std::vector<int>                order;
+        std::atomic<int>                running{0};
+    };
+    std::vector<Tenant> tenants(4);
+    {
+        WorkStealingScheduler scheduler(4);
+        for (auto& tenant : tenants) {
+            tenant.executor = std::make_unique<SerialExecutor>(scheduler);
+        }
+        for (int task = 0; task < TASKS_PER_EXECUTOR; ++task) {
+            for (auto& tenant : tenants) {
+                tenant.executor->submit([&tenant, &overlaps, task]() {
+                    if (++tenant.running != 1) {
+                        ++overlaps;
+                    }
+                    tenant.order.push_back(task);
+                    --tenant.running;
+                });
+            }
+        }
+    }
+
+    EXPECT_EQ(0, overlaps);
+    for (const auto& tenant : tenants) {
+        ASSERT_EQ(static_cast<std::size_t>(TASKS_PER_EXECUTOR), tenant.order.size());
+        for (int task = 0; task < TASKS_PER_EXECUTOR; ++task) {
+            EXPECT_EQ(task, tenant.order[static_cast<std::size_t>(task)]);
+        }
+    }
+}
+
+TEST(SerialExecutorTest, busyExecutor_otherExecutorNotStarved) {
+    std::atomic<bool>     isOtherRun{false};
+    std::promise<void>    otherRun;
+    std::function<void()> spin;
+    auto                  scheduler = std::make_unique<WorkStealingScheduler>(1);
+    SerialExecutor        busy(*scheduler);
+    SerialExecutor        other(*scheduler);
+
+    // Keeps the only worker busy until the other executor got its turn
+    spin = [&]() {
+        if (!isOtherRun) {
+            busy.submit(spin);
+        }
+    };
+    busy.submit(spin);
+    other.submit([&]() {
+        isOtherRun = true;
+        otherRun.set_value();
+    });
+
+    EXPECT_EQ(std::future_status::ready, otherRun.get_future().wait_for(5s));
+    isOtherRun = true;
+    // Run the remaining tasks while the executors still exist
+    scheduler.reset();
+}
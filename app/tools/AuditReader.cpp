@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "AuditLog.h"
+#include "Json.h"
+
+#include <cstring>
+#include <ctime>
+#include <fmt/core.h>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+using namespace example;
+
+namespace {
+
+std::string formatTimestamp(int64_t unixTimeNs) {
+    const auto seconds = static_cast<std::time_t>(unixTimeNs / 1000000000);
+    std::tm    utcTime{};
+    ::gmtime_r(&seconds, &utcTime);
+    char dateTime[32];
+    std::strftime(dateTime, sizeof(dateTime), "%Y-%m-%dT%H:%M:%S", &utcTime);
+    return fmt::format("{}.{:09}Z", dateTime, unixTimeNs % 1000000000);
+}
+
+} // namespace
+
+/**
+ * Prints the records of SeatAdjuster audit log files as JSON lines and verifies
+ * their checksums and the continuity of their sequence numbers. Actuators are
+ * printed by their index in the actuator configuration, text values by their
+ * index in the actuator's allowed values.
+ *
+ * Usage: audit_reader <file>...   (oldest first, e.g. audit.log.2 audit.log.1 audit.log)
+ *
+ * Exits with 1 if a file is not an audit log, a record is corrupt or records are missing.
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file>... (oldest first)" << std::endl;
+        return 2;
+    }
+
+    bool     isComplete       = true;
+    uint64_t previousSequence = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string path = argv[i];
+        try {
+            const auto result = readAuditLog(path, [&](const AuditRecord& record) {
+                if (previousSequence != 0 && record.sequence != previousSequence + 1) {
+                    std::cerr << fmt::format("{}: sequence {} follows {}, records are missing",
+                                             path, record.sequence, previousSequence)
+                              << std::endl;
+                    isComplete = false;
+                }
+                previousSequence = record.sequence;
+
+                const auto     source = static_cast<CommandSource>(record.source);
+                nlohmann::json line({{"sequence", record.sequence},
+                                     {"time", formatTimestamp(record.timestamp)},
+                                     {"source", toString(source)}});
+                switch (static_cast<AuditRecordKind>(record.kind)) {
+                case AuditRecordKind::Seat: {
+                    const auto seat  = static_cast<SeatId>(record.seat);
+                    line["seat"]     = record.seat < SEAT_COUNT ? toString(seat) : "?";
+                    line["position"] = record.position;
+                    break;
+                }
+                case AuditRecordKind::ActuatorNumber: {
+                    float value = 0.0F;
+                    std::memcpy(&value, &record.position, sizeof(value));
+                    line["actuator"] = record.seat;
+                    line["value"]    = value;
+                    break;
+                }
+                case AuditRecordKind::ActuatorText:
+                    line["actuator"]          = record.seat;
+                    line["allowedValueIndex"] = record.position;
+                    break;
+                default:
+                    line["kind"] = record.kind;
+                    break;
+                }
+                line["status"]    = record.status;
+                line["requestId"] = record.requestId;
+                std::cout << line.dump() << '\n';
+            });
+
+            if (!result.validHeader) {
+                std::cerr << path << ": not a SeatAdjuster audit log" << std::endl;
+                isComplete = false;
+            }
+            if (result.corruptRecords > 0) {
+                std::cerr << fmt::format("{}: {} corrupt record(s)", path, result.corruptRecords)
+                          << std::endl;
+                isComplete = false;
+            }
+        } catch (const std::system_error& exception) {
+            std::cerr << exception.what() << std::endl;
+            isComplete = false;
+        }
+    }
+    return isComplete ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2024 Contributors to the Eclipse Foundation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "TelemetrySpooler.h"
+
+#include <cstdlib>
+#include <fmt/core.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <zdict.h>
+
+using namespace example;
+
+namespace {
+
+constexpr std::size_t DEFAULT_DICTIONARY_SIZE = 16 * 1024;
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void printUsage(const char* name) {
+    std::cerr << "Usage: " << name
+              << " [--size <bytes>] [--dictionary <previous>] <output> <file>..." << std::endl;
+}
+
+} // namespace
+
+/**
+ * Trains a zstd dictionary for the TelemetrySpooler from sample records, one per line.
+ *
+ * Usage: telemetry_dict_trainer [--size <bytes>] [--dictionary <previous>] <output> <file>...
+ *
+ * The samples are telemetry files ("*.zst", decompressed with the previous dictionary if
+ * given) or plain JSON lines files. The dictionary has 16 KiB by default; every app
+ * instance compressing with it and every consumer decompressing needs the same file, its
+ * ID is stored in each compressed file.
+ */
+int main(int argc, char** argv) {
+    std::size_t              dictionarySize = DEFAULT_DICTIONARY_SIZE;
+    std::string              previousDictionary;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--size" && i + 1 < argc) {
+            dictionarySize = static_cast<std::size_t>(std::atoll(argv[++i]));
+        } else if (argument == "--dictionary" && i + 1 < argc) {
+            try {
+                previousDictionary = readTelemetryFile(argv[++i]);
+            } catch (const std::system_error& exception) {
+                std::cerr << exception.what() << std::endl;
+                return 1;
+            }
+        } else {
+            paths.push_back(argument);
+        }
+    }
+    if (paths.size() < 2 || dictionarySize == 0) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    // All samples back to back, as the trainer expects them
+    std::string         samples;
+    std::vector<size_t> sampleSizes;
+    const auto          addSample = [&](const std::string& record) {
+        samples += record;
+        sampleSizes.push_back(record.size());
+    };
+    for (std::size_t i = 1; i < paths.size(); ++i) {
+        const auto& path = paths[i];
+        if (endsWith(path, ".zst")) {
+            try {
+                if (!readTelemetryRecords(path, previousDictionary, addSample).isComplete) {
+                    std::cerr << path << ": truncated or not decompressible" << std::endl;
+                }
+            } catch (const std::system_error& exception) {
+                std::cerr << exception.what() << std::endl;
+                return 1;
+            }
+            continue;
+        }
+
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << path << ": cannot be read" << std::endl;
+            return 1;
+        }
+        for (std::string line; std::getline(file, line);) {
+            if (!line.empty()) {
+                addSample(line);
+            }
+        }
+    }
+
+    std::vector<char> dictionary(dictionarySize);
+    const auto        size =
+        ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), samples.data(),
+                              sampleSizes.data(), static_cast<unsigned>(sampleSizes.size()));
+    if (ZDICT_isError(size)) {
+        std::cerr << fmt::format("Training failed on {} records: {}", sampleSizes.size(),
+                                 ZDICT_getErrorName(size))
+                  << std::endl;
+        return 1;
+    }
+
+    std::ofstream output(paths[0], std::ios::binary | std::ios::trunc);
+    output.write(dictionary.data(), static_cast<std::streamsize>(size));
+    if (!output) {
+        std::cerr << paths[0] << ": cannot be written" << std::endl;
+        return 1;
+    }
+    std::cout << fmt::format("Dictionary {} with {} bytes trained on {} records ({} bytes)",
+                             ZDICT_getDictID(dictionary.data(), size), size, sampleSizes.size(),
+                             samples.size())
+              << std::endl;
+    return 0;
+}